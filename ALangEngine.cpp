@@ -450,6 +450,10 @@ void ALangEngine::setImportBaseDir(const std::string& dir) {
 	impl->interpreter.setImportBaseDir(dir);
 }
 
+void ALangEngine::setWatchModules(bool on) {
+	impl->interpreter.setWatchModules(on);
+}
+
 // --- Host registration APIs ---
 void ALangEngine::setGlobal(const std::string& name, const NativeValue& value) {
 	try {
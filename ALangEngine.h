@@ -18,6 +18,8 @@ public:
     void registerModule(const char* moduleName, std::function<void()> initFunc);
     void setErrorColorMap(const std::unordered_map<std::string, std::string>& colorMap);
     void setImportBaseDir(const std::string& dir);
+    // Reload imported modules automatically when their files change (--watch)
+    void setWatchModules(bool on);
 
     using NativeValue = std::variant<std::monostate,double,std::string,bool>;
     using NativeFunc = std::function<NativeValue(const std::vector<NativeValue>&, void* thisHandle)>;
@@ -447,6 +447,7 @@ public:
         addBuiltin("isBoolean", 1);
         addBuiltin("isNull", 1);
         addBuiltin("sleep", 1);
+        addBuiltin("offload", -1);
         addBuiltin("setTimeout", -1);
         addBuiltin("setInterval", -1);
         addBuiltin("clearTimeout", 1);
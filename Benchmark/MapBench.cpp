@@ -0,0 +1,104 @@
+// MapBench.cpp
+// Map insert/lookup benchmark for Value keys.
+// Usage: map-bench [-n <keys>]
+//  - compares the runtime's seeded ValueHash against the previous std::hash based hash
+//  - "adversarial" keys are chosen so that every key lands in one bucket under the
+//    unseeded hash (what an attacker can precompute offline); the seeded hash keeps
+//    them spread out because the seed is unknown until the process starts
+
+#include "src/AsulRuntime.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace asul;
+
+namespace {
+
+// 旧实现：std::hash 加简单混合，没有种子
+struct LegacyValueHash {
+	size_t operator()(const Value& v) const noexcept {
+		std::hash<std::string> sh;
+		std::hash<double> dh;
+		switch (v.index()) {
+			case 0: return 0x9e3779b97f4a7c15ULL;
+			case 1: { double d = std::get<double>(v); return dh(d) ^ (0x9e3779b97f4a7c15ULL + (dh(d)<<6) + (dh(d)>>2)); }
+			case 2: return sh(std::get<std::string>(v));
+			case 3: return std::get<bool>(v) ? 1231u : 3413u;
+			default: return 0;
+		}
+	}
+};
+
+template <typename Hash>
+using ValueMap = std::unordered_map<Value, Value, Hash, ValueEq>;
+
+struct Result { double insertMs; double lookupMs; size_t hits; };
+
+template <typename Hash>
+Result run(const std::vector<Value>& keys, size_t reserve) {
+	ValueMap<Hash> m;
+	if (reserve) m.reserve(reserve);
+	auto t0 = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < keys.size(); ++i) m[keys[i]] = Value{ static_cast<double>(i) };
+	auto t1 = std::chrono::steady_clock::now();
+	size_t hits = 0;
+	for (int round = 0; round < 4; ++round) {
+		for (auto& k : keys) hits += m.count(k);
+	}
+	auto t2 = std::chrono::steady_clock::now();
+	return { std::chrono::duration<double, std::milli>(t1 - t0).count(), std::chrono::duration<double, std::milli>(t2 - t1).count(), hits };
+}
+
+void report(const char* name, const std::vector<Value>& keys, size_t reserve = 0) {
+	auto legacy = run<LegacyValueHash>(keys, reserve);
+	auto seeded = run<ValueHash>(keys, reserve);
+	std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+		<< " legacy: insert " << std::setw(9) << legacy.insertMs << " ms, lookup " << std::setw(9) << legacy.lookupMs << " ms"
+		<< " | seeded: insert " << std::setw(9) << seeded.insertMs << " ms, lookup " << std::setw(9) << seeded.lookupMs << " ms\n";
+	if (legacy.hits != seeded.hits) std::cerr << "  mismatch: " << legacy.hits << " vs " << seeded.hits << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	size_t n = 200000;
+	for (int i = 1; i < argc; ++i) {
+		std::string a(argv[i]);
+		if ((a == "-n" || a == "--keys") && i + 1 < argc) n = static_cast<size_t>(std::max(1000L, std::atol(argv[++i])));
+		else if (a == "-h" || a == "--help") { std::cout << "Usage: map-bench [-n <keys>]\n"; return 0; }
+	}
+	std::cout << "keys: " << n << ", seed: 0x" << std::hex << hashSeed() << std::dec << "\n";
+
+	std::vector<Value> ints, shortStrs, longStrs;
+	ints.reserve(n); shortStrs.reserve(n); longStrs.reserve(n);
+	for (size_t i = 0; i < n; ++i) {
+		ints.push_back(Value{ static_cast<double>(i) });
+		shortStrs.push_back(Value{ "k" + std::to_string(i) });
+		longStrs.push_back(Value{ "/api/v1/users/" + std::to_string(i * 7919) + "/sessions?token=" + std::string(48, 'x') + std::to_string(i) });
+	}
+	report("integer keys", ints);
+	report("short string keys", shortStrs);
+	report("long string keys", longStrs);
+
+	// 对抗输入：在已知 (无种子) 哈希下全部映射到同一个桶
+	size_t attackKeys = std::min<size_t>(n / 20, 8000);
+	ValueMap<LegacyValueHash> probe;
+	probe.reserve(attackKeys);
+	size_t buckets = probe.bucket_count();
+	size_t target = LegacyValueHash{}(Value{ std::string("seed") }) % buckets;
+	std::vector<Value> attack;
+	attack.reserve(attackKeys);
+	for (size_t i = 0; attack.size() < attackKeys; ++i) {
+		Value k{ "h" + std::to_string(i) };
+		if (LegacyValueHash{}(k) % buckets == target) attack.push_back(std::move(k));
+	}
+	report("adversarial keys", attack, attackKeys);
+	return 0;
+}
@@ -0,0 +1,178 @@
+// ParseBench.cpp
+// Lexer/parser throughput benchmark for ALang.
+// Usage: parse-bench [-n <iterations>] [file.alang ...]
+//  - without files a synthetic, expression-heavy corpus is generated
+//  - reports tokens/s and AST nodes/s for lexing + parsing
+
+#include "src/AsulLexer.h"
+#include "src/AsulParser.h"
+#include "src/AsulAst.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace asul;
+
+namespace {
+
+size_t countExpr(const Expr* e);
+size_t countStmt(const Stmt* s);
+
+size_t countPattern(const DestructuringPattern* p) {
+	if (!p) return 0;
+	size_t n = 1;
+	if (auto id = dynamic_cast<const IdentifierPattern*>(p)) return n + countExpr(id->defaultValue.get());
+	if (auto arr = dynamic_cast<const ArrayPattern*>(p)) { for (auto& e : arr->elements) n += countPattern(e.get()); return n; }
+	if (auto obj = dynamic_cast<const ObjectPattern*>(p)) {
+		for (auto& prop : obj->properties) n += countPattern(prop.pattern.get()) + countExpr(prop.defaultValue.get());
+	}
+	return n;
+}
+
+size_t countExprs(const std::vector<ExprPtr>& es) { size_t n = 0; for (auto& e : es) n += countExpr(e.get()); return n; }
+size_t countStmts(const std::vector<StmtPtr>& ss) { size_t n = 0; for (auto& s : ss) n += countStmt(s.get()); return n; }
+
+size_t countExpr(const Expr* e) {
+	if (!e) return 0;
+	size_t n = 1;
+	if (auto a = dynamic_cast<const AssignExpr*>(e)) return n + countExpr(a->value.get());
+	if (auto da = dynamic_cast<const DestructuringAssignExpr*>(e)) return n + countPattern(da->pattern.get()) + countExpr(da->value.get());
+	if (auto u = dynamic_cast<const UnaryExpr*>(e)) return n + countExpr(u->right.get());
+	if (auto up = dynamic_cast<const UpdateExpr*>(e)) return n + countExpr(up->operand.get());
+	if (auto b = dynamic_cast<const BinaryExpr*>(e)) return n + countExpr(b->left.get()) + countExpr(b->right.get());
+	if (auto l = dynamic_cast<const LogicalExpr*>(e)) return n + countExpr(l->left.get()) + countExpr(l->right.get());
+	if (auto c = dynamic_cast<const ConditionalExpr*>(e)) return n + countExpr(c->condition.get()) + countExpr(c->thenBranch.get()) + countExpr(c->elseBranch.get());
+	if (auto c = dynamic_cast<const CallExpr*>(e)) return n + countExpr(c->callee.get()) + countExprs(c->args);
+	if (auto nw = dynamic_cast<const NewExpr*>(e)) return n + countExpr(nw->callee.get()) + countExprs(nw->args);
+	if (auto g = dynamic_cast<const GetPropExpr*>(e)) return n + countExpr(g->object.get());
+	if (auto i = dynamic_cast<const IndexExpr*>(e)) return n + countExpr(i->object.get()) + countExpr(i->index.get());
+	if (auto s = dynamic_cast<const SetPropExpr*>(e)) return n + countExpr(s->object.get()) + countExpr(s->value.get());
+	if (auto s = dynamic_cast<const SetIndexExpr*>(e)) return n + countExpr(s->object.get()) + countExpr(s->index.get()) + countExpr(s->value.get());
+	if (auto a = dynamic_cast<const ArrayLiteralExpr*>(e)) return n + countExprs(a->elements);
+	if (auto o = dynamic_cast<const ObjectLiteralExpr*>(e)) { for (auto& p : o->props) n += countExpr(p.keyExpr.get()) + countExpr(p.value.get()); return n; }
+	if (auto s = dynamic_cast<const SpreadExpr*>(e)) return n + countExpr(s->expr.get());
+	if (auto a = dynamic_cast<const AwaitExpr*>(e)) return n + countExpr(a->expr.get());
+	if (auto o = dynamic_cast<const OptionalChainingExpr*>(e)) return n + countExpr(o->object.get());
+	if (auto y = dynamic_cast<const YieldExpr*>(e)) return n + countExpr(y->value.get());
+	if (auto f = dynamic_cast<const FunctionExpr*>(e)) { for (auto& p : f->params) n += countExpr(p.defaultValue.get()); return n + countStmt(f->body.get()); }
+	return n;
+}
+
+size_t countStmt(const Stmt* s) {
+	if (!s) return 0;
+	size_t n = 1;
+	if (auto e = dynamic_cast<const ExprStmt*>(s)) return n + countExpr(e->expr.get());
+	if (auto v = dynamic_cast<const VarDecl*>(s)) return n + countExpr(v->typeExpr.get()) + countExpr(v->init.get());
+	if (auto vd = dynamic_cast<const VarDeclDestructuring*>(s)) return n + countPattern(vd->pattern.get()) + countExpr(vd->init.get());
+	if (auto b = dynamic_cast<const BlockStmt*>(s)) return n + countStmts(b->statements);
+	if (auto i = dynamic_cast<const IfStmt*>(s)) return n + countExpr(i->cond.get()) + countStmt(i->thenB.get()) + countStmt(i->elseB.get());
+	if (auto w = dynamic_cast<const WhileStmt*>(s)) return n + countExpr(w->cond.get()) + countStmt(w->body.get());
+	if (auto dw = dynamic_cast<const DoWhileStmt*>(s)) return n + countExpr(dw->cond.get()) + countStmt(dw->body.get());
+	if (auto f = dynamic_cast<const ForStmt*>(s)) return n + countStmt(f->init.get()) + countExpr(f->cond.get()) + countExpr(f->post.get()) + countStmt(f->body.get());
+	if (auto fe = dynamic_cast<const ForEachStmt*>(s)) return n + countExpr(fe->iterable.get()) + countStmt(fe->body.get());
+	if (auto sw = dynamic_cast<const SwitchStmt*>(s)) { n += countExpr(sw->expr.get()); for (auto& c : sw->cases) n += countExpr(c.value.get()) + countStmts(c.body); return n; }
+	if (auto m = dynamic_cast<const MatchStmt*>(s)) { n += countExpr(m->expr.get()); for (auto& a : m->arms) n += countExpr(a.pattern.get()) + countExpr(a.guard.get()) + countStmt(a.body.get()); return n; }
+	if (auto r = dynamic_cast<const ReturnStmt*>(s)) return n + countExpr(r->value.get());
+	if (auto t = dynamic_cast<const ThrowStmt*>(s)) return n + countExpr(t->value.get());
+	if (auto tc = dynamic_cast<const TryCatchStmt*>(s)) return n + countStmt(tc->tryBlock.get()) + countStmt(tc->catchBlock.get()) + countStmt(tc->finallyBlock.get());
+	if (auto f = dynamic_cast<const FunctionStmt*>(s)) { for (auto& p : f->params) n += countExpr(p.defaultValue.get()); return n + countStmt(f->body.get()); }
+	if (auto c = dynamic_cast<const ClassStmt*>(s)) { for (auto& m : c->methods) n += countStmt(m.get()); return n; }
+	if (auto ex = dynamic_cast<const ExtendStmt*>(s)) { for (auto& m : ex->methods) n += countStmt(m.get()); return n; }
+	if (auto d = dynamic_cast<const DecoratorStmt*>(s)) return n + countExprs(d->decorators) + countStmt(d->target.get());
+	if (auto g = dynamic_cast<const GoStmt*>(s)) return n + countExpr(g->call.get());
+	return n;
+}
+
+// 生成以表达式为主的合成语料：覆盖所有二元优先级、三元、逻辑赋值、调用链
+std::string syntheticCorpus(int functions) {
+	std::ostringstream oss;
+	for (int i = 0; i < functions; ++i) {
+		oss << "function f" << i << "(a, b, c) {\n"
+			<< "    let x = a + b * c - (a % 7) / 3 << 2 >> 1;\n"
+			<< "    let y = (x & 255) | (b ^ c) & ~a;\n"
+			<< "    let z = x >= y && y != 0 || a == b ?? c;\n"
+			<< "    let w = z ? x * 2 + y : -x - y * (a + b);\n"
+			<< "    let obj = { name: \"n" << i << "\", list: [a, b, c, x + y], nested: { v: w } };\n"
+			<< "    obj.nested.v += obj.list[2] * math.sqrt(x * x + y * y);\n"
+			<< "    obj.name ??= \"fallback\";\n"
+			<< "    for (let k = 0; k < 10; k++) { x = x + k * (y - k) / (k + 1); }\n"
+			<< "    return obj.list.map([](v) { return v * 2 + 1; }).filter([](v) { return v % 3 == 0; }).len() + w;\n"
+			<< "}\n";
+	}
+	return oss.str();
+}
+
+bool readFile(const std::string& path, std::string& out) {
+	std::ifstream in(path, std::ios::in | std::ios::binary);
+	if (!in) return false;
+	std::ostringstream ss; ss << in.rdbuf(); out = ss.str();
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	int iterations = 20;
+	std::vector<std::string> files;
+	for (int i = 1; i < argc; ++i) {
+		std::string a(argv[i]);
+		if ((a == "-n" || a == "--iterations") && i + 1 < argc) iterations = std::max(1, std::atoi(argv[++i]));
+		else if (a == "-h" || a == "--help") {
+			std::cout << "Usage: parse-bench [-n <iterations>] [file.alang ...]\n";
+			return 0;
+		}
+		else files.push_back(a);
+	}
+
+	std::vector<std::pair<std::string, std::string>> sources;
+	if (files.empty()) {
+		sources.emplace_back("<synthetic>", syntheticCorpus(2000));
+	} else {
+		for (auto& f : files) {
+			std::string code;
+			if (!readFile(f, code)) { std::cerr << "Cannot open file: " << f << std::endl; return 1; }
+			sources.emplace_back(f, std::move(code));
+		}
+	}
+
+	size_t totalBytes = 0, totalTokens = 0, totalNodes = 0;
+	double lexSeconds = 0, parseSeconds = 0;
+	for (int it = 0; it < iterations; ++it) {
+		for (auto& src : sources) {
+			auto t0 = std::chrono::steady_clock::now();
+			Lexer lx(src.second);
+			auto tokens = lx.scanTokens();
+			auto t1 = std::chrono::steady_clock::now();
+			Parser ps(tokens, src.second);
+			std::vector<StmtPtr> stmts;
+			try {
+				stmts = ps.parse();
+			} catch (const std::exception& ex) {
+				std::cerr << src.first << ": parse error: " << ex.what() << std::endl;
+				return 1;
+			}
+			auto t2 = std::chrono::steady_clock::now();
+			lexSeconds += std::chrono::duration<double>(t1 - t0).count();
+			parseSeconds += std::chrono::duration<double>(t2 - t1).count();
+			totalBytes += src.second.size();
+			totalTokens += tokens.size();
+			totalNodes += countStmts(stmts);
+		}
+	}
+
+	double total = lexSeconds + parseSeconds;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "sources:     " << sources.size() << " x " << iterations << " iterations\n";
+	std::cout << "input:       " << (totalBytes / 1024.0 / 1024.0) << " MiB, " << totalTokens << " tokens, " << totalNodes << " nodes\n";
+	std::cout << "lex:         " << (lexSeconds * 1000.0) << " ms (" << (totalTokens / lexSeconds / 1e6) << " M tokens/s)\n";
+	std::cout << "parse:       " << (parseSeconds * 1000.0) << " ms (" << (totalTokens / parseSeconds / 1e6) << " M tokens/s, "
+		<< (totalNodes / parseSeconds / 1e6) << " M nodes/s)\n";
+	std::cout << "lex+parse:   " << (totalTokens / total / 1e6) << " M tokens/s, " << (totalNodes / total / 1e6) << " M nodes/s\n";
+	return 0;
+}
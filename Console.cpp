@@ -6,6 +6,7 @@
 //  - -f / --file <path>
 //  - -e / --eval <code>
 //  - -i    (interactive mode / drop into REPL after file/eval)
+//  - --watch (reload imported modules when their files change)
 
 #include "ALangEngine.h"
 #include <iostream>
@@ -31,6 +32,7 @@ int runConsole(int argc, char* argv[]) {
     bool showHelp = false;
     bool showVersion = false;
     bool interactive = false;
+    bool watch = false;
     std::string runFile;
     std::string evalCode;
 
@@ -40,6 +42,7 @@ int runConsole(int argc, char* argv[]) {
         if (a == "--help" || a == "-h") showHelp = true;
         else if (a == "--version" || a == "-v") showVersion = true;
         else if (a == "-i") interactive = true;
+        else if (a == "--watch") watch = true;
         else if (a == "-f" || a == "--file") {
             if (i + 1 < argc) runFile = argv[++i];
         } else if (a == "-e" || a == "--eval") {
@@ -57,7 +60,8 @@ int runConsole(int argc, char* argv[]) {
                   << "  -v, --version     Show version\n"
                   << "  -f, --file <path> Execute file and exit (use -i to drop into REPL after)\n"
                   << "  -e, --eval <code> Execute code string and exit (use -i to drop into REPL after)\n"
-                  << "  -i                Interactive: REPL mode (or after file/eval)\n";
+                  << "  -i                Interactive: REPL mode (or after file/eval)\n"
+                  << "  --watch           Reload imported modules when their files change\n";
         return 0;
     }
 
@@ -68,6 +72,7 @@ int runConsole(int argc, char* argv[]) {
 
     ALangEngine engine;
     engine.initialize();
+    if (watch) engine.setWatchModules(true);
 
     // Optional error colors and small helper registration (keeps parity with examples)
     engine.setErrorColorMap({
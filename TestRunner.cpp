@@ -159,7 +159,31 @@ std::vector<std::string> funcFiles = {
     "destructuring_test.alang",
     "optional_chaining_test.alang",
     "pattern_matching_test.alang",
-    "yield_test.alang"
+    "yield_test.alang",
+    "scope_closure_test.alang",
+    "global_cache_test.alang",
+    "string_slice_test.alang",
+    "string_simd_test.alang",
+    "hash_keys_test.alang",
+    "immutable_test.alang",
+    "sketch_test.alang",
+    "bitset_test.alang",
+    "trie_test.alang",
+    "sync_test.alang",
+    "offload_test.alang",
+    "socket_dgram_test.alang",
+    "tls_test.alang",
+    "websocket_test.alang",
+    "fetch_stream_test.alang",
+    "dns_cache_test.alang",
+    "shm_test.alang",
+    "streams_test.alang",
+    "for_await_test.alang",
+    "hot_reload_test.alang",
+    "template_test.alang",
+    "fmt_test.alang",
+    "csv_writer_test.alang",
+    "json_schema_test.alang"
 };
 
 // Run a command and return exit code
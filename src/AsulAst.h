@@ -4,6 +4,7 @@
 #include "AsulLexer.h"
 #include "AsulRuntime.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -22,7 +23,11 @@ using ExprPtr = std::shared_ptr<Expr>;
 // ----------- Expressions -----------
 struct Expr { virtual ~Expr() = default; };
 struct LiteralExpr : Expr { Value value; explicit LiteralExpr(Value v): value(std::move(v)){} };
-struct VariableExpr : Expr { std::string name; int line{0}; int column{1}; int length{1}; VariableExpr(std::string n, int l, int c, int len): name(std::move(n)), line(l), column(c), length(len){} };
+struct VariableExpr : Expr {
+	std::string name; int line{0}; int column{1}; int length{1};
+	// 全局符号缓存 (见 Interpreter::lookupVariable)
+	const Value* cachedSlot{nullptr}; const void* cacheOwner{nullptr}; uint64_t cacheVersion{0};
+	VariableExpr(std::string n, int l, int c, int len): name(std::move(n)), line(l), column(c), length(len){} };
 struct AssignExpr : Expr { std::string name; ExprPtr value; int line{0}; AssignExpr(std::string n, ExprPtr v, int l): name(std::move(n)), value(std::move(v)), line(l){} };
 struct DestructuringPattern; using PatternPtr = std::shared_ptr<DestructuringPattern>;
 struct DestructuringAssignExpr : Expr { PatternPtr pattern; ExprPtr value; int line{0}; DestructuringAssignExpr(PatternPtr p, ExprPtr v, int l): pattern(std::move(p)), value(std::move(v)), line(l){} };
@@ -31,9 +36,16 @@ struct UpdateExpr : Expr { Token op; ExprPtr operand; bool isPrefix; int line{0}
 struct BinaryExpr : Expr { ExprPtr left; Token op; ExprPtr right; BinaryExpr(ExprPtr l, Token o, ExprPtr r): left(std::move(l)), op(std::move(o)), right(std::move(r)){} };
 struct LogicalExpr : Expr { ExprPtr left; Token op; ExprPtr right; LogicalExpr(ExprPtr l, Token o, ExprPtr r): left(std::move(l)), op(std::move(o)), right(std::move(r)){} };
 struct ConditionalExpr : Expr { ExprPtr condition; ExprPtr thenBranch; ExprPtr elseBranch; int line{0}, column{1}, length{1}; ConditionalExpr(ExprPtr c, ExprPtr t, ExprPtr e, int l, int col, int len): condition(std::move(c)), thenBranch(std::move(t)), elseBranch(std::move(e)), line(l), column(col), length(len){} };
-struct CallExpr : Expr { ExprPtr callee; std::vector<ExprPtr> args; int line{0}, column{1}, length{1}; CallExpr(ExprPtr c, std::vector<ExprPtr> a, int l, int c0, int len): callee(std::move(c)), args(std::move(a)), line(l), column(c0), length(len){} };
+struct CallExpr : Expr {
+	ExprPtr callee; std::vector<ExprPtr> args; int line{0}, column{1}, length{1};
+	int argsPure{-1}; // 参数是否无副作用 (-1 未分析)，用于字符串方法快速路径
+	CallExpr(ExprPtr c, std::vector<ExprPtr> a, int l, int c0, int len): callee(std::move(c)), args(std::move(a)), line(l), column(c0), length(len){} };
 struct NewExpr : Expr { ExprPtr callee; std::vector<ExprPtr> args; int line{0}, column{1}, length{1}; NewExpr(ExprPtr c, std::vector<ExprPtr> a, int l, int c0, int len): callee(std::move(c)), args(std::move(a)), line(l), column(c0), length(len){} };
-struct GetPropExpr : Expr { ExprPtr object; std::string name; int line{0}, column{1}, length{1}; GetPropExpr(ExprPtr o, std::string n, int l, int c0, int len): object(std::move(o)), name(std::move(n)), line(l), column(c0), length(len){} };
+struct GetPropExpr : Expr {
+	ExprPtr object; std::string name; int line{0}, column{1}, length{1};
+	// 包成员缓存 (包对象地址 + 全局版本号)
+	const Value* cachedSlot{nullptr}; const void* cacheOwner{nullptr}; uint64_t cacheVersion{0};
+	GetPropExpr(ExprPtr o, std::string n, int l, int c0, int len): object(std::move(o)), name(std::move(n)), line(l), column(c0), length(len){} };
 struct IndexExpr : Expr { ExprPtr object; ExprPtr index; int line{0}, column{1}, length{1}; IndexExpr(ExprPtr o, ExprPtr i, int l, int c0, int len): object(std::move(o)), index(std::move(i)), line(l), column(c0), length(len){} };
 struct SetPropExpr : Expr { ExprPtr object; std::string name; ExprPtr value; int line{0}, column{1}, length{1}; SetPropExpr(ExprPtr o, std::string n, ExprPtr v, int l, int c0, int len): object(std::move(o)), name(std::move(n)), value(std::move(v)), line(l), column(c0), length(len){} };
 struct SetIndexExpr : Expr { ExprPtr object; ExprPtr index; ExprPtr value; int line{0}, column{1}, length{1}; SetIndexExpr(ExprPtr o, ExprPtr i, ExprPtr v, int l, int c0, int len): object(std::move(o)), index(std::move(i)), value(std::move(v)), line(l), column(c0), length(len){} };
@@ -88,26 +100,27 @@ struct Param {
 		name(std::move(n)), type(std::move(t)), isRest(rest), defaultValue(std::move(defVal)) {} 
 };
 
-struct FunctionExpr : Expr { std::vector<Param> params; StmtPtr body; bool isGenerator{false}; FunctionExpr(std::vector<Param> p, StmtPtr b, bool g=false): params(std::move(p)), body(std::move(b)), isGenerator(g){} };
+struct FunctionExpr : Expr { std::vector<Param> params; StmtPtr body; bool isGenerator{false}; int scopeFlags{-1}; FunctionExpr(std::vector<Param> p, StmtPtr b, bool g=false): params(std::move(p)), body(std::move(b)), isGenerator(g){} };
 
 // ----------- Statements -----------
 struct Stmt { virtual ~Stmt() = default; int line{0}; int column{1}; int length{1}; };
 struct ExprStmt : Stmt { ExprPtr expr; explicit ExprStmt(ExprPtr e): expr(std::move(e)){} };
 struct VarDecl : Stmt { std::string name; std::optional<std::string> type; ExprPtr typeExpr; ExprPtr init; bool isExported{false}; VarDecl(std::string n, std::optional<std::string> t, ExprPtr te, ExprPtr i, bool exported=false, int l=0, int c=1, int len=1): name(std::move(n)), type(std::move(t)), typeExpr(std::move(te)), init(std::move(i)), isExported(exported){ line=l; column=c; length=len; } };
 struct VarDeclDestructuring : Stmt { PatternPtr pattern; ExprPtr init; bool isExported{false}; VarDeclDestructuring(PatternPtr p, ExprPtr i, bool exported=false, int l=0, int c=1, int len=1): pattern(std::move(p)), init(std::move(i)), isExported(exported){ line=l; column=c; length=len; } };
-struct BlockStmt : Stmt { std::vector<StmtPtr> statements; explicit BlockStmt(std::vector<StmtPtr> s, int l=0, int c=1, int len=1): statements(std::move(s)){ line=l; column=c; length=len; } };
+struct BlockStmt : Stmt { std::vector<StmtPtr> statements; int scopeFlags{-1}; /* 作用域分析缓存, -1 = 未分析 */ explicit BlockStmt(std::vector<StmtPtr> s, int l=0, int c=1, int len=1): statements(std::move(s)){ line=l; column=c; length=len; } };
 struct IfStmt : Stmt { ExprPtr cond; StmtPtr thenB; StmtPtr elseB; IfStmt(ExprPtr c, StmtPtr t, StmtPtr e, int l=0, int col=1, int len=1): cond(std::move(c)), thenB(std::move(t)), elseB(std::move(e)){ line=l; column=col; length=len; } };
 struct WhileStmt : Stmt { ExprPtr cond; StmtPtr body; WhileStmt(ExprPtr c, StmtPtr b, int l=0, int col=1, int len=1): cond(std::move(c)), body(std::move(b)){ line=l; column=col; length=len; } };
 struct DoWhileStmt : Stmt { ExprPtr cond; StmtPtr body; DoWhileStmt(ExprPtr c, StmtPtr b, int l=0, int col=1, int len=1): cond(std::move(c)), body(std::move(b)){ line=l; column=col; length=len; } };
 struct ReturnStmt : Stmt { Token keyword; ExprPtr value; ReturnStmt(Token k, ExprPtr v, int l=0, int c=1, int len=1): keyword(std::move(k)), value(std::move(v)){ line=l; column=c; length=len; } };
-struct FunctionStmt : Stmt { std::string name; std::vector<Param> params; StmtPtr body; bool isAsync{false}; bool isGenerator{false}; std::optional<std::string> returnType; bool isStatic{false}; bool isExported{false}; std::vector<ExprPtr> decorators; FunctionStmt(std::string n, std::vector<Param> p, StmtPtr b, bool a=false, bool g=false, std::optional<std::string> r = std::nullopt, bool s=false, bool exported=false, int l=0, int c=1, int len=1, std::vector<ExprPtr> decs = {}): name(std::move(n)), params(std::move(p)), body(std::move(b)), isAsync(a), isGenerator(g), returnType(std::move(r)), isStatic(s), isExported(exported), decorators(std::move(decs)){ line=l; column=c; length=len; } };
+struct FunctionStmt : Stmt { std::string name; std::vector<Param> params; StmtPtr body; bool isAsync{false}; bool isGenerator{false}; std::optional<std::string> returnType; bool isStatic{false}; bool isExported{false}; std::vector<ExprPtr> decorators; int scopeFlags{-1}; FunctionStmt(std::string n, std::vector<Param> p, StmtPtr b, bool a=false, bool g=false, std::optional<std::string> r = std::nullopt, bool s=false, bool exported=false, int l=0, int c=1, int len=1, std::vector<ExprPtr> decs = {}): name(std::move(n)), params(std::move(p)), body(std::move(b)), isAsync(a), isGenerator(g), returnType(std::move(r)), isStatic(s), isExported(exported), decorators(std::move(decs)){ line=l; column=c; length=len; } };
 struct ClassStmt : Stmt { std::string name; std::vector<std::string> superNames; std::vector<std::shared_ptr<FunctionStmt>> methods; bool isExported{false}; };
 struct ExtendStmt : Stmt { std::string name; std::vector<std::shared_ptr<FunctionStmt>> methods; };
 struct InterfaceStmt : Stmt { std::string name; std::vector<std::string> methodNames; bool isExported{false}; };
 struct BreakStmt : Stmt {};
 struct ContinueStmt : Stmt {};
 struct ForStmt : Stmt { StmtPtr init; ExprPtr cond; ExprPtr post; StmtPtr body; ForStmt(StmtPtr i, ExprPtr c, ExprPtr p, StmtPtr b): init(std::move(i)), cond(std::move(c)), post(std::move(p)), body(std::move(b)){} };
-struct ForEachStmt : Stmt { std::string varName; ExprPtr iterable; StmtPtr body; ForEachStmt(std::string v, ExprPtr i, StmtPtr b): varName(std::move(v)), iterable(std::move(i)), body(std::move(b)){} };
+// isAwait: for await (x in source) —— 每轮 await 异步迭代器的下一个值
+struct ForEachStmt : Stmt { std::string varName; ExprPtr iterable; StmtPtr body; bool isAwait{false}; ForEachStmt(std::string v, ExprPtr i, StmtPtr b): varName(std::move(v)), iterable(std::move(i)), body(std::move(b)){} };
 struct SwitchStmt : Stmt {
 	struct CaseClause {
 		ExprPtr value; // null for default case
@@ -50,6 +50,10 @@ public:
 	
 	// Dispatch promise callbacks after settlement
 	virtual void dispatchPromiseCallbacks(std::shared_ptr<PromiseState> promise) = 0;
+	
+	// Run pure native work on the shared worker pool; the promise settles on the event loop.
+	// work must not touch interpreter state (environments, script functions, call stack).
+	virtual std::shared_ptr<PromiseState> offload(std::function<Value()> work) = 0;
 };
 
 } // namespace asul
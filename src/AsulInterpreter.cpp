@@ -40,6 +40,11 @@ void registerExternalPackages(asul::Interpreter &interp)
     asul::registerStdUuidPackage(interp);
     asul::registerStdUrlPackage(interp);
     asul::registerStdEventsPackage(interp);
+    asul::registerStdImmutablePackage(interp);
+    asul::registerStdSyncPackage(interp);
+    asul::registerStdShmPackage(interp);
+    asul::registerStdTemplatePackage(interp);
+    asul::registerStdFmtPackage(interp);
     asul::registerCsvPackage(interp);
     asul::registerJsonPackage(interp);
     asul::registerXmlPackage(interp);
@@ -63,6 +68,7 @@ namespace asul
             return it->second;
         auto pkg = std::make_shared<Object>();
         packages[name] = pkg;
+        packageObjects.insert(pkg.get());
         if (stdRoot && name.rfind("std.", 0) == 0)
         {
             std::string suffix = name.substr(4);
@@ -104,8 +110,9 @@ namespace asul
             return;
         for (auto &kv : *(it->second))
         {
-            env->define(kv.first, kv.second);
+            bindImported(kv.first, kv.second);
         }
+        invalidateGlobalCaches();
     }
 
     void Interpreter::registerPackageSymbol(const std::string &pkgName, const std::string &symbol, const Value &value)
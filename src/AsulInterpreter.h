@@ -5,6 +5,10 @@
 #include "AsulRuntime.h"
 #include "AsulParser.h"
 #include "AsulAsync.h"
+#include "AsulScopeAnalysis.h"
+#include "AsulStringOps.h"
+#include "AsulWorkerPool.h"
+#include "AsulModuleWatcher.h"
 
 #include <algorithm>
 #include <atomic>
@@ -46,6 +50,14 @@
     #include <unistd.h>
     #include <netdb.h>
     #include <sys/wait.h>
+    #include <sys/mman.h>
+#endif
+
+#if defined(__linux__)
+    // async 函数 / go 任务运行在独立的协程栈上 (ucontext)
+    #define ASUL_HAS_FIBERS 1
+    #include <ucontext.h>
+    #include <cxxabi.h>
 #endif
 
 #include "AsulFormatString/AsulFormatString.h"
@@ -72,6 +84,11 @@ void globalSignalHandler(int sig);
 class Interpreter : public AsulAsync {
 public:
 	Interpreter() { globals = std::make_shared<Environment>(); env = globals; installBuiltins(); }
+	// 其他线程 (fetch、http.Server 连接线程) 可能仍在 postTask / settlePromise 中：
+	// 主线程看到结果后就可能退出，必须等这些调用离开解释器再析构
+	~Interpreter() {
+		while (inFlightCalls.load(std::memory_order_acquire) > 0) std::this_thread::yield();
+	}
 
 	void registerPackageSymbol(const std::string& pkgName, const std::string& symbol, const Value& value);
 	std::shared_ptr<Object> ensurePackage(const std::string& name);
@@ -79,6 +96,30 @@ public:
 
 	// Package registration for external packages
 	void registerLazyPackage(const std::string& name, std::function<void(std::shared_ptr<Object>)> init);
+	// 若 name 是尚未初始化的惰性包则立即初始化；原生代码使用其他包的导出前调用
+	bool loadLazyPackage(const std::string& name) {
+		auto it = lazyPackages.find(name);
+		if (it != lazyPackages.end()) {
+			auto pkg = ensurePackage(name);
+			it->second(pkg);
+			lazyPackages.erase(it);
+			return true;
+		}
+		return false;
+	}
+
+	// ---- for await 异步迭代 ----
+	// next() 返回本轮的值或其 Promise；step (可为空) 把 await 后的结果转换为循环变量并返回 false 表示结束，
+	// 为空时以 null 表示结束；close (可为空) 在 break / return / 异常提前退出循环时调用
+	struct AsyncIterator {
+		std::function<Value()> next;
+		std::function<bool(Value&)> step;
+		std::function<void()> close;
+	};
+	// 原生包注册自己的异步可迭代类型 (流、套接字、FileStream 等)；provider 不认识该值时返回 false
+	void registerAsyncIterable(std::function<bool(const Value&, AsyncIterator&)> provider) {
+		asyncIterableProviders.push_back(std::move(provider));
+	}
 
 	// Signal handler setter for external packages
 	void setSignalHandler(int sig, const Value& callback) { signalHandlers[sig] = callback; }
@@ -94,6 +135,7 @@ public:
 
 	// 事件循环：用于分发 then/catch 与 go 任务
 	void postTask(std::function<void()> fn) override {
+		InFlightGuard guard(inFlightCalls);
 		{
 			std::lock_guard<std::mutex> lk(loopMutex);
 			taskQueue.push(std::move(fn));
@@ -124,15 +166,258 @@ public:
 			std::function<void()> fn;
 			{
 				std::unique_lock<std::mutex> lk(loopMutex);
-				if (taskQueue.empty()) break;
+				// 仍有挂起在 await 上的协程或未完成的 offload 时，等待它们投递回来的任务
+				if (taskQueue.empty() && suspendedFibers == 0 && pendingOffloads == 0) break;
+				loopCv.wait(lk, [&]{ return !taskQueue.empty(); });
+				fn = std::move(taskQueue.front()); taskQueue.pop();
+			}
+			if (fn) fn();
+		}
+	}
+
+	// await 的等待逻辑：协程内挂起让出主栈；主栈上则边等边执行事件循环任务
+	void waitForPromise(const std::shared_ptr<PromiseState>& p) {
+#ifdef ASUL_HAS_FIBERS
+		if (currentFiber) {
+			Fiber* f = currentFiber;
+			{
+				std::lock_guard<std::mutex> lk(p->mtx);
+				if (p->settled) return;
+				p->waiters.push_back([this, f]{ postTask([this, f]{ resumeFiber(f); }); });
+			}
+			++suspendedFibers;
+			suspendFiber();
+			--suspendedFibers;
+			return;
+		}
+#endif
+		auto settled = [&p]{ std::lock_guard<std::mutex> lk(p->mtx); return p->settled; };
+		for (;;) {
+			std::function<void()> fn;
+			{
+				std::unique_lock<std::mutex> lk(loopMutex);
+				loopCv.wait(lk, [&]{ return !taskQueue.empty() || settled(); });
+				if (settled()) return;
 				fn = std::move(taskQueue.front()); taskQueue.pop();
 			}
 			if (fn) fn();
 		}
 	}
 
+	// for await (x in source)：每轮一次 await。原生来源 (注册的 provider) 直接交付数据块；
+	// 数组逐个 await 元素；对象/实例依次尝试 asyncIterator()、next() -> {value, done}、read() -> 块|null
+	void executeForAwait(const ForEachStmt& fe) {
+		Value source = evaluate(fe.iterable);
+		AsyncIterator it = asyncIteratorFor(source);
+		auto loopEnv = std::make_shared<Environment>(env);
+		noteLocalBinding(fe.varName);
+		loopEnv->define(fe.varName, Value{std::monostate{}});
+		bool exhausted = false;
+		try {
+			for (;;) {
+				Value v = it.next();
+				if (auto pp = std::get_if<std::shared_ptr<PromiseState>>(&v)) {
+					auto p = *pp;
+					if (p) {
+						waitForPromise(p);
+						std::lock_guard<std::mutex> lk(p->mtx);
+						if (p->rejected) throw ExceptionSignal{ p->result };
+						v = p->result;
+					} else {
+						v = Value{std::monostate{}};
+					}
+				}
+				if (it.step ? !it.step(v) : std::holds_alternative<std::monostate>(v)) { exhausted = true; break; }
+				loopEnv->assign(fe.varName, v);
+				auto prevEnv = env;
+				env = loopEnv;
+				try { execute(fe.body); }
+				catch (const ContinueSignal&) { }
+				catch (const BreakSignal&) { env = prevEnv; break; }
+				catch (...) { env = prevEnv; throw; }
+				env = prevEnv;
+			}
+		} catch (...) {
+			if (it.close) { try { it.close(); } catch (...) { } }
+			throw;
+		}
+		if (!exhausted && it.close) it.close();
+	}
+
+	AsyncIterator asyncIteratorFor(const Value& source) {
+		AsyncIterator it;
+		for (auto& provider : asyncIterableProviders) {
+			if (provider(source, it)) return it;
+		}
+		if (auto arr = std::get_if<std::shared_ptr<std::vector<Value>>>(&source)) {
+			auto items = *arr;
+			auto idx = std::make_shared<size_t>(0);
+			// 数组元素本身可以是 null：用下标而不是值判断结束
+			auto done = std::make_shared<bool>(false);
+			it.next = [items, idx, done]() -> Value {
+				if (*idx >= items->size()) { *done = true; return Value{std::monostate{}}; }
+				return (*items)[(*idx)++];
+			};
+			it.step = [done](Value&) { return !*done; };
+			return it;
+		}
+		if (!std::holds_alternative<std::shared_ptr<Object>>(source) && !std::holds_alternative<std::shared_ptr<Instance>>(source)) {
+			throw std::runtime_error("for await requires an async iterable (stream, socket, FileStream, array, or an object with next()/read())");
+		}
+		auto member = [this](const Value& obj, const char* name) -> Value {
+			Value m = getProperty(obj, name);
+			return std::holds_alternative<std::shared_ptr<Function>>(m) ? m : Value{std::monostate{}};
+		};
+		Value target = source;
+		Value factory = member(source, "asyncIterator");
+		if (!std::holds_alternative<std::monostate>(factory)) {
+			target = callValue(factory, {});
+			for (auto& provider : asyncIterableProviders) {
+				if (provider(target, it)) return it;
+			}
+		}
+		Value next = member(target, "next");
+		if (!std::holds_alternative<std::monostate>(next)) {
+			// 迭代器协议：next() 返回 {value, done} 或其 Promise
+			it.next = [this, next]() { return callValue(next, {}); };
+			it.step = [this](Value& r) {
+				if (!std::holds_alternative<std::shared_ptr<Object>>(r) && !std::holds_alternative<std::shared_ptr<Instance>>(r)) {
+					throw std::runtime_error("for await: iterator next() must return {value, done}");
+				}
+				if (isTruthy(getProperty(r, "done"))) return false;
+				r = getProperty(r, "value");
+				return true;
+			};
+			Value ret = member(target, "return");
+			if (!std::holds_alternative<std::monostate>(ret)) it.close = [this, ret]() { callValue(ret, {}); };
+			return it;
+		}
+		Value read = member(target, "read");
+		if (!std::holds_alternative<std::monostate>(read)) {
+			// 读取器协议：read() 返回下一块或其 Promise，null 表示结束 (例如 fetch 的响应体)
+			it.next = [this, read]() { return callValue(read, {}); };
+			Value cancel = member(target, "cancel");
+			if (!std::holds_alternative<std::monostate>(cancel)) it.close = [this, cancel]() { callValue(cancel, {}); };
+			return it;
+		}
+		throw std::runtime_error("for await requires an async iterable (stream, socket, FileStream, array, or an object with next()/read())");
+	}
+
+	// offload：work 在共享工作线程池上执行，结果回到事件循环线程再 settle。
+	// 只能从事件循环线程调用；work (及其捕获的参数) 也在事件循环线程上析构。
+	std::shared_ptr<PromiseState> offload(std::function<Value()> work) override {
+		return offload(std::move(work), nullptr);
+	}
+	// finish (可为空) 在事件循环线程上把工作线程的结果转换为最终值，可以安全地访问解释器与脚本对象
+	std::shared_ptr<PromiseState> offload(std::function<Value()> work, std::function<Value(Value)> finish) {
+		auto p = createPromise();
+		++pendingOffloads;
+		auto job = std::make_shared<std::function<Value()>>(std::move(work));
+		WorkerPool::shared().submit([this, p, job, finish = std::move(finish)]() mutable {
+			bool failed = false;
+			Value result{std::monostate{}};
+			try {
+				result = (*job)();
+			} catch (const ExceptionSignal& ex) {
+				failed = true; result = ex.value;
+			} catch (const std::exception& ex) {
+				failed = true; result = Value{ std::string(ex.what()) };
+			} catch (...) {
+				failed = true; result = Value{ std::string("offloaded task failed") };
+			}
+			postTask([this, p, job = std::move(job), finish = std::move(finish), failed, result = std::move(result)]() mutable {
+				--pendingOffloads;
+				job.reset();
+				if (!failed && finish) {
+					try {
+						result = finish(std::move(result));
+					} catch (const ExceptionSignal& ex) {
+						failed = true; result = ex.value;
+					} catch (const std::exception& ex) {
+						failed = true; result = Value{ std::string(ex.what()) };
+					}
+				}
+				settlePromise(p, failed, failed ? ensureExceptionValue(result) : result);
+			});
+		});
+		return p;
+	}
+
+	// 在工作线程上调用 offloadable builtin；数组/对象参数先在事件循环线程上深拷贝，
+	// 工作线程只读快照，调用返回后脚本继续修改原容器也不会与之竞争
+	std::shared_ptr<PromiseState> offloadCall(const std::shared_ptr<Function>& fn, std::vector<Value> args) {
+		if (!fn || !fn->isBuiltin || !fn->offloadable) throw std::runtime_error("offload: function is not safe to run off the event loop (only pure native builtins are)");
+		std::unordered_map<const void*, Value> copied;
+		for (auto& a : args) {
+			auto f = std::get_if<std::shared_ptr<Function>>(&a);
+			if (f && *f && !(*f)->isBuiltin) throw std::runtime_error("offload: script functions cannot be passed to worker threads");
+			a = snapshotForOffload(a, copied);
+		}
+		return offload([fn, args = std::move(args)]{ return fn->builtin(args, nullptr); });
+	}
+
+	// 深拷贝 Array/Object (共享与循环引用按原样保留)；实例、类与 Promise 的状态无法安全复制，直接拒绝
+	static Value snapshotForOffload(const Value& v, std::unordered_map<const void*, Value>& copied) {
+		if (auto arr = std::get_if<std::shared_ptr<Array>>(&v); arr && *arr) {
+			auto it = copied.find(arr->get());
+			if (it != copied.end()) return it->second;
+			auto out = std::make_shared<Array>();
+			copied.emplace(arr->get(), Value{ out });
+			out->reserve((*arr)->size());
+			for (auto& item : **arr) out->push_back(snapshotForOffload(item, copied));
+			return Value{ out };
+		}
+		if (auto obj = std::get_if<std::shared_ptr<Object>>(&v); obj && *obj) {
+			auto it = copied.find(obj->get());
+			if (it != copied.end()) return it->second;
+			auto out = std::make_shared<Object>();
+			copied.emplace(obj->get(), Value{ out });
+			out->reserve((*obj)->size());
+			for (auto& kv : **obj) (*out)[kv.first] = snapshotForOffload(kv.second, copied);
+			return Value{ out };
+		}
+		if (std::holds_alternative<std::shared_ptr<Instance>>(v) || std::holds_alternative<std::shared_ptr<ClassInfo>>(v) || std::holds_alternative<std::shared_ptr<PromiseState>>(v)) {
+			throw std::runtime_error("offload: class instances and promises cannot be passed to worker threads");
+		}
+		return v;
+	}
+
+	// 把纯本地 builtin 标记为 offloadable，并返回它的 Promise 版本 (供各包注册 xxxAsync)
+	std::shared_ptr<Function> makeOffloadedBuiltin(const std::shared_ptr<Function>& fn) {
+		fn->offloadable = true;
+		auto wrapper = std::make_shared<Function>(); wrapper->isBuiltin = true;
+		wrapper->builtin = [this, fn](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			return Value{ offloadCall(fn, args) };
+		};
+		return wrapper;
+	}
+
+	// 热重载 (import.reload / --watch)：重新执行模块文件，然后原地替换导出。import "m" as x 持有的模块对象、
+	// import "m" / from "m" import f 绑定的名字都换成新的导出；其他模块、缓存与连接池等堆状态保持不变。
+	// 重新执行失败时抛出异常并保留旧模块。已经传给别处的旧函数值 (例如交给 server.listen 的处理函数) 不会被替换，
+	// 需要热替换的回调应经模块对象间接调用
+	std::shared_ptr<Object> reloadModule(const std::string& rawPath) { return importFilePath(rawPath, true); }
+
+	// --watch：之后导入的模块文件被改写时自动重载 (在事件循环线程上执行)，失败时打印错误并继续使用旧模块
+	void setWatchModules(bool on) {
+		if (!on) { moduleWatcher.reset(); return; }
+		if (moduleWatcher) return;
+		moduleWatcher = std::make_unique<ModuleWatcher>([this](const std::string& path) {
+			postTask([this, path] {
+				try {
+					reloadModule(path);
+					std::cerr << "[watch] reloaded " << path << std::endl;
+				} catch (const std::exception& ex) {
+					std::cerr << "[watch] reload failed, keeping the previous version: " << ex.what() << std::endl;
+				}
+			});
+		});
+		for (auto& kv : importedModules) moduleWatcher->watch(kv.first);
+	}
+
 	// Import external file: resolve path, read, parse and execute in isolated env, then return module object
-	std::shared_ptr<Object> importFilePath(const std::string& rawPath) {
+	// (reload 为 true 时即使已缓存也重新执行，并把新导出换入缓存中的模块对象)
+	std::shared_ptr<Object> importFilePath(const std::string& rawPath, bool reload = false) {
 		// capture context for error pretty-printing + import chain
 		std::string ctxCode; std::string ctxFile;
 		try {
@@ -163,7 +448,14 @@ public:
 			}
 			std::string key = finalPath.string();
 			ctxFile = key;
-			if (importedModules.find(key) != importedModules.end()) return importedModules[key];
+			std::shared_ptr<Object> previous;
+			if (auto cached = importedModules.find(key); cached != importedModules.end()) {
+				if (!reload) return cached->second;
+				if (std::find(importStack.begin(), importStack.end(), key) != importStack.end()) {
+					throw std::runtime_error(std::string("Cannot reload a module while it is being imported: ") + key);
+				}
+				previous = cached->second;
+			}
 
 			// Read file content
 			std::ifstream in(key, std::ios::in | std::ios::binary);
@@ -184,7 +476,10 @@ public:
 
 			// Execute in an isolated environment that can see globals (builtins/classes)
 			auto fileEnv = std::make_shared<Environment>(globals);
+			noteScopeBindings(stmts);
 			// Run
+			moduleScopes.push_back(fileEnv);
+			struct ScopeGuard { std::vector<std::shared_ptr<Environment>>& st; ~ScopeGuard(){ st.pop_back(); } } scopeGuard{moduleScopes};
 			executeBlock(stmts, fileEnv);
 
 			// Create module object with exported symbols
@@ -200,8 +495,15 @@ public:
 				}
 			}
 
+			if (previous) {
+				swapModuleExports(previous, *modObj);
+				auto listeners = reloadListeners;
+				for (auto& cb : listeners) callValue(cb, { Value{key}, Value{previous} });
+				return previous;
+			}
 			// Cache and return
 			importedModules[key] = modObj;
+			if (moduleWatcher) moduleWatcher->watch(key);
 			return modObj;
 		} catch (const ExceptionSignal& ex) {
 			// Record error source for upper-level pretty printing
@@ -228,7 +530,7 @@ public:
 		if (auto lit = std::dynamic_pointer_cast<LiteralExpr>(expr)) return lit->value;
 			if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr)) {
 				try {
-					return env->get(var->name);
+					return lookupVariable(*var);
 				} catch (const std::exception& ex) {
 					std::ostringstream oss;
 					oss << ex.what() << " at line " << var->line << ", column " << var->column << ", length " << var->length;
@@ -313,6 +615,19 @@ public:
 				}
 			}
 			Value o = evaluate(gp->object);
+			// 包成员缓存：包对象常驻 packages 表，地址稳定，可按 (对象, 版本) 缓存成员槽位
+			if (auto po = std::get_if<std::shared_ptr<Object>>(&o)) {
+				if (gp->cacheOwner == po->get() && gp->cacheVersion == globalVersion) return *gp->cachedSlot;
+				if (packageObjects.count(po->get())) {
+					auto it = (*po)->find(gp->name);
+					if (it != (*po)->end()) {
+						gp->cachedSlot = &it->second;
+						gp->cacheOwner = po->get();
+						gp->cacheVersion = globalVersion;
+						return it->second;
+					}
+				}
+			}
 			try {
 				return getProperty(o, gp->name);
 			} catch (const std::exception& ex) {
@@ -901,8 +1216,8 @@ public:
 			}
 			auto p = std::get<std::shared_ptr<PromiseState>>(v);
 			if (!p) return Value{std::monostate{}};
-			std::unique_lock<std::mutex> lk(p->mtx);
-			p->cv.wait(lk, [&]{ return p->settled; });
+			waitForPromise(p);
+			std::lock_guard<std::mutex> lk(p->mtx);
 			if (p->rejected) throw ExceptionSignal{ p->result };
 			return p->result;
 		}
@@ -926,13 +1241,48 @@ public:
 			callStack.push_back(calleeDesc + std::string(" at line ") + std::to_string(call->line));
 			struct FrameGuard { std::vector<std::string>& st; ~FrameGuard(){ st.pop_back(); } } _fg{callStack};
 			try {
-				Value cal = evaluate(call->callee);
+				Value cal;
+				bool haveCallee = false;
+				std::vector<Value> args; args.reserve(call->args.size());
+				bool haveArgs = false;
+				// 字符串方法快速路径：s.method(...) 直接作用于接收者，不复制字符串，也不创建绑定函数
+				if (auto gp = dynamic_cast<GetPropExpr*>(call->callee.get())) {
+					if (isStringMethod(gp->name)) {
+						auto recvVar = dynamic_cast<VariableExpr*>(gp->object.get());
+						Value recvHolder;
+						const Value* recv = nullptr;
+						if (recvVar && callArgsArePure(*call)) {
+							// 与普通调用一样先读接收者，再求值参数；参数无副作用，槽位在此期间不会被改写，可以按引用读取
+							recv = &lookupVariable(*recvVar);
+							for (auto& a : call->args) args.push_back(evaluate(a));
+							haveArgs = true;
+						} else {
+							recvHolder = evaluate(gp->object);
+							recv = &recvHolder;
+						}
+						if (auto ps = std::get_if<std::string>(recv)) {
+							if (!haveArgs) { for (auto& a : call->args) args.push_back(evaluate(a)); haveArgs = true; }
+							try { return callStringMethod(*ps, gp->name, args); }
+							catch (const std::exception& ex) {
+								Value ev = ensureExceptionValue(Value{ std::string(ex.what()) }, call->line, call->column, call->length);
+								ExceptionSignal es; es.value = ev; es.stackTrace = callStack; throw es;
+							}
+						}
+						// 不是字符串 (例如数组的 includes/slice)：复用已求值的接收者
+						try {
+							cal = getProperty(*recv, gp->name);
+						} catch (const std::exception& ex) {
+							std::ostringstream oss; oss << ex.what() << " at line " << gp->line << ", column " << gp->column << ", length " << gp->length; throw std::runtime_error(oss.str());
+						}
+						haveCallee = true;
+					}
+				}
+				if (!haveCallee) cal = evaluate(call->callee);
 			if (!std::holds_alternative<std::shared_ptr<Function>>(cal)) {
 				std::ostringstream oss; oss << "Can only call functions at line " << call->line << ", column " << call->column << ", length " << call->length; throw std::runtime_error(oss.str());
 			}
 			auto fn = std::get<std::shared_ptr<Function>>(cal);
-			std::vector<Value> args; args.reserve(call->args.size());
-			for (auto& a : call->args) args.push_back(evaluate(a));
+			if (!haveArgs) for (auto& a : call->args) args.push_back(evaluate(a));
 			if (fn->isBuiltin) {
 				try { return fn->builtin(args, fn->closure); }
 				catch (const ExceptionSignal& ex) {
@@ -952,7 +1302,7 @@ public:
 				// 返回一个 Promise，并将函数体作为任务投递
 				auto p = std::make_shared<PromiseState>();
 				p->loopPtr = this;
-				postTask([this, fn, args, p]{
+				postTask([this, fn, args, p]{ spawnFiber([this, fn, args, p]{
 					// 在闭包环境基础上创建局部环境并执行
 					auto local = std::make_shared<Environment>(fn->closure);
 					
@@ -1012,7 +1362,7 @@ public:
 						settlePromise(p, true, ev); return;
 					}
 					settlePromise(p, false, ret);
-				});
+				}); });
 				return Value{p};
 			}
 			
@@ -1032,7 +1382,8 @@ public:
 					throw std::runtime_error(oss.str());
 				}
 				
-				auto local = std::make_shared<Environment>(fn->closure);
+				EnvLease frame{*this, newCallFrame(fn)};
+				auto& local = frame.env;
 				// Bind provided normal parameters
 				for (int i = 0; i < fn->restParamIndex && i < static_cast<int>(args.size()); ++i) {
 					local->define(fn->params[i], args[i]);
@@ -1086,7 +1437,8 @@ public:
 				throw std::runtime_error(oss.str());
 			}
 			
-			auto local = std::make_shared<Environment>(fn->closure);
+			EnvLease frame{*this, newCallFrame(fn)};
+			auto& local = frame.env;
 			// Bind provided arguments
 			for (size_t i = 0; i < args.size(); ++i) {
 				local->define(fn->params[i], args[i]);
@@ -1132,6 +1484,7 @@ public:
 				}
 			}
 			if (auto innerBlock = std::dynamic_pointer_cast<BlockStmt>(fexpr->body)) fn->body = innerBlock->statements; else fn->body = { fexpr->body };
+			fn->capturesScope = (functionScopeFlags(*fexpr) & ScopeCaptures) != 0;
 			fn->closure = env; // 关闭环境捕获
 			fn->isGenerator = fexpr->isGenerator;
 			return Value{fn};
@@ -1188,7 +1541,8 @@ public:
 		if (fn->isBuiltin) {
 			return fn->builtin(args, fn->closure);
 		}
-		auto local = std::make_shared<Environment>(fn->closure);
+		EnvLease frame{*this, newCallFrame(fn)};
+		auto& local = frame.env;
 		for (size_t i=0; i<args.size() && i<fn->params.size(); ++i) local->define(fn->params[i], args[i]);
 		try {
 			executeBlock(fn->body, local);
@@ -1216,6 +1570,7 @@ public:
 		if (auto e = std::dynamic_pointer_cast<ExprStmt>(stmt)) { (void)evaluate(e->expr); return; }
 		if (std::dynamic_pointer_cast<EmptyStmt>(stmt)) { return; }
 		if (auto imp = std::dynamic_pointer_cast<ImportStmt>(stmt)) {
+			invalidateGlobalCaches();
 			for (auto& ent : imp->entries) {
 				if (ent.isFile) {
 					try {
@@ -1229,15 +1584,17 @@ public:
 								throw std::runtime_error(oss.str());
 							}
 							std::string varName = ent.alias.has_value() ? ent.alias.value() : ent.symbol;
-							env->define(varName, fit->second);
+							bindImported(varName, fit->second);
+							noteModuleBinding(modObj.get(), varName, ent.symbol);
 						} else if (ent.alias.has_value()) {
 							// import "file" as alias
-							env->define(ent.alias.value(), Value{modObj});
+							bindImported(ent.alias.value(), Value{modObj});
 						} else {
 							// import "file" (merge symbols)
 							for (auto& kv : *modObj) {
-								env->define(kv.first, kv.second);
+								bindImported(kv.first, kv.second);
 							}
+							noteModuleBinding(modObj.get(), std::string(), "*");
 						}
 					}
 					catch (const std::exception& ex) {
@@ -1267,7 +1624,7 @@ public:
 					size_t p = pkg.rfind('.');
 					std::string varName = (p == std::string::npos) ? pkg : pkg.substr(p+1);
 					if (ent.alias.has_value()) varName = ent.alias.value();
-					env->define(varName, Value{pobj});
+					bindImported(varName, Value{pobj});
 				} else if (ent.symbol == "*") {
 					// Load all lazy sub-packages
 					std::string prefix = ent.packageName + ".";
@@ -1279,7 +1636,7 @@ public:
 					}
 					for (const auto& name : toLoad) loadLazyPackage(name);
 
-					for (auto& kv : *pobj) env->define(kv.first, kv.second);
+					for (auto& kv : *pobj) bindImported(kv.first, kv.second);
 				} else {
 					auto fit = pobj->find(ent.symbol);
 					if (fit == pobj->end()) {
@@ -1290,7 +1647,7 @@ public:
 						if (subIt != packages.end()) {
 							std::string varName = ent.symbol;
 							if (ent.alias.has_value()) varName = ent.alias.value();
-							env->define(varName, Value{subIt->second});
+							bindImported(varName, Value{subIt->second});
 							continue;
 						}
 
@@ -1300,7 +1657,7 @@ public:
 					}
 					std::string varName = ent.symbol;
 					if (ent.alias.has_value()) varName = ent.alias.value();
-					env->define(varName, fit->second);
+					bindImported(varName, fit->second);
 				}
 			}
 			return;
@@ -1337,7 +1694,19 @@ public:
 			destructurePattern(vd->pattern, init);
 			return;
 		}
-		if (auto b = std::dynamic_pointer_cast<BlockStmt>(stmt)) { executeBlock(b->statements, std::make_shared<Environment>(env)); return; }
+		if (auto b = std::dynamic_pointer_cast<BlockStmt>(stmt)) {
+			if (b->scopeFlags < 0) {
+				std::vector<std::string> names;
+				b->scopeFlags = analyzeScope(b->statements, &names);
+				noteLocalBindings(names);
+			}
+			// 块内没有任何声明：直接在当前环境执行，无需分配新作用域
+			if (!(b->scopeFlags & ScopeDeclares)) { for (auto& s : b->statements) execute(s); return; }
+			if (b->scopeFlags & ScopeCaptures) { executeBlock(b->statements, std::make_shared<Environment>(env)); return; }
+			EnvLease scope{*this, acquireEnv(env)};
+			executeBlock(b->statements, scope.env);
+			return;
+		}
 		if (auto i = std::dynamic_pointer_cast<IfStmt>(stmt)) {
 			if (isTruthy(evaluate(i->cond))) execute(i->thenB); else if (i->elseB) execute(i->elseB);
 			return;
@@ -1370,11 +1739,13 @@ public:
 			return;
 		}
 		if (auto fe = std::dynamic_pointer_cast<ForEachStmt>(stmt)) {
+			if (fe->isAwait) { executeForAwait(*fe); return; }
 			// foreach (varName in iterable) body
 			Value iterableValue = evaluate(fe->iterable);
 			
 			// 创建新的作用域用于循环变量
 			auto loopEnv = std::make_shared<Environment>(env);
+			noteLocalBinding(fe->varName);
 			loopEnv->define(fe->varName, Value{std::monostate{}});
 			
 			// 根据 iterable 类型进行迭代
@@ -1391,7 +1762,7 @@ public:
 					catch (const ContinueSignal&) { /* continue to next iteration */ }
 					catch (const BreakSignal&) { break; }
 				}
-			} else if (auto obj = std::get_if<std::shared_ptr<std::unordered_map<std::string,Value>>>(&iterableValue)) {
+			} else if (auto obj = std::get_if<std::shared_ptr<Object>>(&iterableValue)) {
 				// 对象：遍历每个键
 				for (const auto& [key, value] : **obj) {
 					loopEnv->assign(fe->varName, Value{key});
@@ -1512,6 +1883,7 @@ public:
 			} catch (const ExceptionSignal& ex) {
 				exceptionCaught = true;
 				auto local = std::make_shared<Environment>(env);
+				noteLocalBinding(tc->catchName);
 				local->define(tc->catchName, ex.value);
 				// 在新的局部环境中执行 catch 块
 				if (auto block = std::dynamic_pointer_cast<BlockStmt>(tc->catchBlock)) {
@@ -1524,6 +1896,7 @@ public:
 				// Catch C++ runtime errors and expose them as ALang exceptions
 				auto local = std::make_shared<Environment>(env);
 				Value errVal = buildExceptionValue(ex.what());
+				noteLocalBinding(tc->catchName);
 				local->define(tc->catchName, errVal);
 				if (auto block = std::dynamic_pointer_cast<BlockStmt>(tc->catchBlock)) {
 					executeBlock(block->statements, local);
@@ -1616,6 +1989,7 @@ public:
 			// 将语句体包装成块：函数体如果是单个语句，处理成block便于复用
 			if (auto innerBlock = std::dynamic_pointer_cast<BlockStmt>(f->body)) fn->body = innerBlock->statements;
 			else fn->body = { f->body };
+			fn->capturesScope = (functionScopeFlags(*f) & ScopeCaptures) != 0;
 			fn->closure = env;
 			fn->isAsync = f->isAsync;
 			fn->isGenerator = f->isGenerator;
@@ -1642,6 +2016,7 @@ public:
 					fn->defaultValues.push_back(p.defaultValue);
 				}
 				if (auto innerBlock = std::dynamic_pointer_cast<BlockStmt>(m->body)) fn->body = innerBlock->statements; else fn->body = { m->body };
+				fn->capturesScope = (functionScopeFlags(*m) & ScopeCaptures) != 0;
 				fn->closure = env;
 				fn->isAsync = m->isAsync;
 				fn->isGenerator = m->isGenerator;
@@ -1734,6 +2109,7 @@ public:
 					fn->defaultValues.push_back(p.defaultValue);
 				}
 				if (auto innerBlock = std::dynamic_pointer_cast<BlockStmt>(m->body)) fn->body = innerBlock->statements; else fn->body = { m->body };
+				fn->capturesScope = (functionScopeFlags(*m) & ScopeCaptures) != 0;
 				fn->closure = env;
 				fn->isAsync = m->isAsync;
 				fn->isGenerator = m->isGenerator;
@@ -1759,12 +2135,12 @@ public:
 			// 调度一个任务在事件循环中执行表达式（通常为调用表达式）
 			auto exprCopy = go->call;
 			auto envSnap = env;
-			postTask([this, exprCopy, envSnap]{
+			postTask([this, exprCopy, envSnap]{ spawnFiber([this, exprCopy, envSnap]{
 				auto prev = env;
 				env = envSnap;
 				try { (void) evaluate(exprCopy); } catch (...) { /* 丢弃 go 任务中的异常 */ }
 				env = prev;
-			});
+			}); });
 			return;
 		}
 		throw std::runtime_error("Unknown statement type");
@@ -1781,6 +2157,86 @@ public:
 		env = previous;
 	}
 
+	// ----------- Environment pool -----------
+	// 由作用域分析判定不会被闭包捕获的块作用域/函数帧从池中取环境，退出时若无人再引用 (use_count == 1)
+	// 则清空后放回池中；eval/反射等运行时捕获会使引用计数 > 1，此时环境按原样交给 shared_ptr 释放。
+	std::shared_ptr<Environment> acquireEnv(const std::shared_ptr<Environment>& parent) {
+		if (envPool.empty()) return std::make_shared<Environment>(parent);
+		auto e = std::move(envPool.back());
+		envPool.pop_back();
+		e->parent = parent;
+		return e;
+	}
+	void releaseEnv(std::shared_ptr<Environment>& e) noexcept {
+		if (!e || e.use_count() != 1 || envPool.size() >= kEnvPoolLimit) return;
+		try {
+			e->values.clear();
+			e->declaredTypes.clear();
+			e->explicitExports.clear();
+			e->parent.reset();
+			envPool.push_back(std::move(e));
+		} catch (...) { e.reset(); }
+	}
+	std::shared_ptr<Environment> newCallFrame(const std::shared_ptr<Function>& fn) {
+		if (fn->capturesScope) return std::make_shared<Environment>(fn->closure);
+		return acquireEnv(fn->closure);
+	}
+	struct EnvLease {
+		Interpreter& interp;
+		std::shared_ptr<Environment> env;
+		~EnvLease() { interp.releaseEnv(env); }
+	};
+	template <typename FnNode>
+	int functionScopeFlags(FnNode& f) {
+		if (f.scopeFlags < 0) {
+			std::vector<std::string> names;
+			f.scopeFlags = analyzeFunctionScope(f.params, f.body, &names);
+			noteLocalBindings(names);
+		}
+		return f.scopeFlags;
+	}
+
+	// ----------- Global symbol cache -----------
+	// 全局绑定就是 globals->values 中的节点，unordered_map 在 rehash 时不移动节点，可以直接当作 cell 缓存；
+	// 重新定义同名全局是原地赋值，缓存自动看到新值。
+	// 站点缓存 (VariableExpr、包成员 GetPropExpr) 记录 cell 指针 + globalVersion，以下情况版本递增使其失效：
+	//  - 某个名字第一次可能在非全局作用域中绑定（可能遮蔽同名全局）
+	//  - 执行 import（模块/包符号被重新绑定）
+	// 曾在局部作用域出现过的名字从不走缓存，保证遮蔽语义与逐层查找一致。
+	void noteLocalBinding(const std::string& name) {
+		if (localBindingNames.insert(name).second) ++globalVersion;
+	}
+	void noteLocalBindings(const std::vector<std::string>& names) {
+		for (auto& n : names) noteLocalBinding(n);
+	}
+	// 即将在非全局环境中执行一段语句 (模块顶层、eval) 前调用
+	void noteScopeBindings(const std::vector<StmtPtr>& stmts) {
+		std::vector<std::string> names;
+		(void)analyzeScope(stmts, &names);
+		noteLocalBindings(names);
+	}
+	void invalidateGlobalCaches() { ++globalVersion; }
+	uint64_t globalCacheVersion() const { return globalVersion; }
+
+	const Value& lookupVariable(VariableExpr& var) {
+		if (var.cacheVersion == globalVersion && var.cacheOwner == globals.get()) return *var.cachedSlot;
+		for (Environment* e = env.get(); e; e = e->parent.get()) {
+			auto it = e->values.find(var.name);
+			if (it == e->values.end()) continue;
+			if (e == globals.get() && localBindingNames.find(var.name) == localBindingNames.end()) {
+				var.cachedSlot = &it->second;
+				var.cacheOwner = e;
+				var.cacheVersion = globalVersion;
+			}
+			return it->second;
+		}
+		throw std::runtime_error("Undefined variable '" + var.name + "'");
+	}
+	void bindImported(const std::string& name, const Value& value) {
+		env->define(name, value);
+		if (env != globals) noteLocalBinding(name);
+	}
+
 	std::shared_ptr<Environment> globalsEnv() const { return globals; }
 	std::shared_ptr<Environment> currentEnv() const { return env; }
 	void setCurrentEnv(std::shared_ptr<Environment> newEnv) { env = newEnv; }
@@ -1810,9 +2266,120 @@ private:
 	std::mutex loopMutex;
 	std::condition_variable loopCv;
 	std::queue<std::function<void()>> taskQueue;
+	size_t suspendedFibers{0}; // 仅在事件循环线程上修改
+	std::vector<std::function<bool(const Value&, AsyncIterator&)>> asyncIterableProviders;
+	size_t pendingOffloads{0}; // 已提交到工作线程池、结果尚未回到事件循环的任务数 (仅在事件循环线程上修改)
+	std::atomic<int> inFlightCalls{0}; // 正在执行 postTask / settlePromise 的调用数 (见析构函数)
+	struct InFlightGuard {
+		std::atomic<int>& n;
+		explicit InFlightGuard(std::atomic<int>& c) : n(c) { n.fetch_add(1, std::memory_order_relaxed); }
+		~InFlightGuard() { n.fetch_sub(1, std::memory_order_release); }
+	};
+
+#ifdef ASUL_HAS_FIBERS
+	// ---- 协程 ----
+	// 每个 async 调用 / go 任务在自己的栈上运行；await 未完成的 Promise 时切回调度者，
+	// Promise 完成后由事件循环任务 resumeFiber 继续执行。切换时交换解释器的执行状态
+	// (env / callStack) 以及 C++ 异常处理的线程全局状态 (catch 块内 await 时需要)。
+	struct EhGlobals {
+		void* caughtExceptions;
+		unsigned int uncaughtExceptions;
+#ifdef __ARM_EABI_UNWINDER__
+		void* propagatingExceptions;
+#endif
+	};
+	struct Fiber {
+		ucontext_t ctx;
+		ucontext_t* caller{nullptr};
+		char* stack{nullptr};
+		std::function<void()> body;
+		bool finished{false};
+		std::shared_ptr<Environment> env;
+		std::vector<std::string> callStack;
+		EhGlobals eh{};
+	};
+	// 只保留地址空间，页面按需提交；与主线程默认栈同为 8 MiB，递归深度不受影响
+	static constexpr size_t kFiberStackSize = 8 * 1024 * 1024;
+	static constexpr size_t kFiberGuardSize = 64 * 1024;
+	static constexpr size_t kFiberStackPoolLimit = 64;
+	static inline thread_local Fiber* startingFiber = nullptr;
+	Fiber* currentFiber{nullptr};
+	std::vector<char*> fiberStackPool;
+
+	char* acquireFiberStack() {
+		if (!fiberStackPool.empty()) { char* s = fiberStackPool.back(); fiberStackPool.pop_back(); return s; }
+		void* mem = mmap(nullptr, kFiberStackSize + kFiberGuardSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (mem == MAP_FAILED) return nullptr;
+		mprotect(mem, kFiberGuardSize, PROT_NONE); // 栈向下增长，低端做保护页
+		return static_cast<char*>(mem);
+	}
+	void releaseFiberStack(char* s) {
+		if (fiberStackPool.size() < kFiberStackPoolLimit) fiberStackPool.push_back(s);
+		else munmap(s, kFiberStackSize + kFiberGuardSize);
+	}
+	static EhGlobals& ehGlobals() { return *reinterpret_cast<EhGlobals*>(abi::__cxa_get_globals()); }
+
+	static void fiberEntry() {
+		Fiber* f = startingFiber;
+		try { f->body(); } catch (...) {}
+		f->body = nullptr;
+		f->finished = true;
+		setcontext(f->caller);
+	}
+	void spawnFiber(std::function<void()> body) {
+		char* stack = acquireFiberStack();
+		if (!stack) { body(); return; } // 地址空间不足时退回到直接执行
+		auto f = new Fiber();
+		f->body = std::move(body);
+		f->stack = stack;
+		f->env = env;
+		getcontext(&f->ctx);
+		f->ctx.uc_stack.ss_sp = stack + kFiberGuardSize;
+		f->ctx.uc_stack.ss_size = kFiberStackSize;
+		f->ctx.uc_link = nullptr;
+		makecontext(&f->ctx, &Interpreter::fiberEntry, 0);
+		startingFiber = f;
+		resumeFiber(f);
+	}
+	void resumeFiber(Fiber* f) {
+		auto prevEnv = std::move(env);
+		auto prevCallStack = std::move(callStack);
+		Fiber* prevFiber = currentFiber;
+		EhGlobals prevEh = ehGlobals();
+		env = std::move(f->env);
+		callStack = std::move(f->callStack);
+		ehGlobals() = f->eh;
+		ucontext_t here;
+		f->caller = &here;
+		currentFiber = f;
+		swapcontext(&here, &f->ctx);
+		currentFiber = prevFiber;
+		env = std::move(prevEnv);
+		callStack = std::move(prevCallStack);
+		ehGlobals() = prevEh;
+		if (f->finished) {
+			releaseFiberStack(f->stack);
+			delete f;
+		}
+	}
+	void suspendFiber() {
+		Fiber* f = currentFiber;
+		f->env = env;
+		f->callStack = std::move(callStack);
+		f->eh = ehGlobals();
+		swapcontext(&f->ctx, f->caller);
+	}
+#else
+	void spawnFiber(std::function<void()> body) { body(); }
+#endif
 	std::unordered_map<std::string, std::shared_ptr<Object>> packages;
 	std::shared_ptr<Object> stdRoot;
 	std::unordered_map<std::string, std::shared_ptr<Object>> importedModules; // cache for file imports
+	static constexpr size_t kEnvPoolLimit = 256;
+	std::vector<std::shared_ptr<Environment>> envPool;
+	uint64_t globalVersion{1};
+	std::unordered_set<std::string> localBindingNames{ "this" };
+	std::unordered_set<const Object*> packageObjects; // 常驻 packages 表的包对象
 	std::filesystem::path importBaseDir;
 
 	// Signal handlers map: signal number -> callback function
@@ -1824,20 +2391,49 @@ private:
 	std::vector<std::string> importStack;
 	std::vector<std::string> callStack;
 
-	// Lazy loading support
-	std::map<std::string, std::function<void(std::shared_ptr<Object>)>> lazyPackages;
+	// 热重载：import "m" / from "m" import f 在各作用域里绑定的名字 (模块对象 -> 绑定)，重载时一并更新；
+	// symbol 为 "*" 表示 import "m" 合并了全部导出 (包括重载后新增的)
+	struct ModuleBinding { std::weak_ptr<Environment> env; std::string name; std::string symbol; };
+	std::unordered_map<const Object*, std::vector<ModuleBinding>> moduleBindings;
+	std::vector<std::shared_ptr<Environment>> moduleScopes; // 正在执行的模块顶层作用域 (与 importStack 对应)
+	std::vector<Value> reloadListeners; // import.onReload 注册的回调
+	std::unique_ptr<ModuleWatcher> moduleWatcher; // 声明在事件循环状态之后：先析构并停止监视线程，之后才销毁任务队列
 
-	bool loadLazyPackage(const std::string& name) {
-		auto it = lazyPackages.find(name);
-		if (it != lazyPackages.end()) {
-			auto pkg = ensurePackage(name);
-			it->second(pkg);
-			lazyPackages.erase(it);
-			return true;
+	// 只记录脚本与模块顶层作用域里的绑定；函数调用帧会被 envPool 复用，不能长期引用
+	void noteModuleBinding(const Object* mod, const std::string& name, const std::string& symbol) {
+		if (env != globals && (moduleScopes.empty() || env != moduleScopes.back())) return;
+		auto& list = moduleBindings[mod];
+		list.erase(std::remove_if(list.begin(), list.end(), [&](const ModuleBinding& b) {
+			auto scope = b.env.lock();
+			return !scope || (scope == env && b.name == name && b.symbol == symbol);
+		}), list.end());
+		list.push_back({ env, name, symbol });
+	}
+
+	void swapModuleExports(const std::shared_ptr<Object>& target, Object& fresh) {
+		auto it = moduleBindings.find(target.get());
+		if (it != moduleBindings.end()) {
+			for (auto& b : it->second) {
+				auto scope = b.env.lock();
+				if (!scope) continue;
+				if (b.symbol == "*") {
+					for (auto& kv : fresh) {
+						scope->define(kv.first, kv.second);
+						if (scope != globals) noteLocalBinding(kv.first);
+					}
+					continue;
+				}
+				auto sym = fresh.find(b.symbol);
+				if (sym != fresh.end()) scope->define(b.name, sym->second);
+			}
 		}
-		return false;
+		*target = std::move(fresh);
+		invalidateGlobalCaches();
 	}
 
+	// Lazy loading support
+	std::map<std::string, std::function<void(std::shared_ptr<Object>)>> lazyPackages;
+
 	// 构建带有增强信息的异常对象：{ message, line, column, length, stack: [...], type: "Error" }
 	Value buildExceptionValue(const std::string& msg, int line = -1, int column = -1, int length = -1) {
 		// 如果已有对象则补充 stack
@@ -1893,11 +2489,18 @@ public:
 	}
 
 	void settlePromise(std::shared_ptr<PromiseState> p, bool rejected, const Value& result) override {
+		InFlightGuard guard(inFlightCalls);
+		std::vector<std::function<void()>> waiters;
 		{
 			std::lock_guard<std::mutex> lk(p->mtx);
 			p->settled = true; p->rejected = rejected; p->result = result;
+			waiters.swap(p->waiters);
 		}
 		p->cv.notify_all();
+		for (auto& w : waiters) w();
+		// 唤醒在主栈上 await 的等待者
+		{ std::lock_guard<std::mutex> lk(loopMutex); }
+		loopCv.notify_all();
 		dispatchPromiseCallbacks(p);
 	}
 
@@ -2115,6 +2718,152 @@ public:
 		}
 		return nullptr;
 	}
+	// ----------- String methods -----------
+	// 字符串方法直接作用于 string_view：调用方可以按引用传入接收者，避免复制整个字符串
+	static bool isStringMethod(const std::string& name) {
+		static const std::unordered_set<std::string> names = {
+			"len", "trim", "trimLeft", "trimRight", "toLowerCase", "toUpperCase", "startsWith", "endsWith",
+			"includes", "indexOf", "split", "substring", "replace", "replaceAll", "lastIndexOf", "slice", "padStart", "padEnd"
+		};
+		return names.count(name) != 0;
+	}
+	static Value callStringMethod(std::string_view s, const std::string& name, const std::vector<Value>& args) {
+		// 扫描类操作 (大小写、空白、查找、切分、替换) 走 strops 的向量化实现
+		if (name == "len") return Value{ static_cast<double>(s.size()) };
+		if (name == "trim") {
+			size_t start = strops::skipSpaceForward(s);
+			size_t end = strops::skipSpaceBackward(s, s.size());
+			if (end < start) end = start;
+			return Value{ std::string(s.substr(start, end - start)) };
+		}
+		if (name == "trimLeft") return Value{ std::string(s.substr(strops::skipSpaceForward(s))) };
+		if (name == "trimRight") return Value{ std::string(s.substr(0, strops::skipSpaceBackward(s, s.size()))) };
+		if (name == "toLowerCase") return Value{ strops::toLowerAscii(s) };
+		if (name == "toUpperCase") return Value{ strops::toUpperAscii(s) };
+		if (name == "startsWith") {
+			if (args.size()!=1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("startsWith expects 1 string arg");
+			const auto& pre = std::get<std::string>(args[0]);
+			return Value{ s.substr(0, pre.size()) == pre };
+		}
+		if (name == "endsWith") {
+			if (args.size()!=1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("endsWith expects 1 string arg");
+			const auto& suf = std::get<std::string>(args[0]);
+			if (suf.size()>s.size()) return Value{false};
+			return Value{ s.substr(s.size() - suf.size()) == suf };
+		}
+		if (name == "includes") {
+			if (args.size()!=1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("includes expects 1 string arg");
+			return Value{ strops::find(s, std::get<std::string>(args[0])) != strops::npos };
+		}
+		if (name == "indexOf") {
+			if (args.size()<1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("indexOf expects search string and optional start index");
+			size_t start=0;
+			if (args.size()>=2) start = static_cast<size_t>(std::max(0, static_cast<int>(getNumber(args[1], "indexOf start"))));
+			auto pos = strops::find(s, std::get<std::string>(args[0]), start);
+			if (pos==strops::npos) return Value{ -1.0 };
+			return Value{ static_cast<double>(pos) };
+		}
+		if (name == "split") {
+			if (args.size() < 1) throw std::runtime_error("split expects a delimiter string");
+			if (!std::holds_alternative<std::string>(args[0])) throw std::runtime_error("split delimiter must be a string");
+			const auto& delim = std::get<std::string>(args[0]);
+			auto out = std::make_shared<Array>();
+			if (delim.empty()) out->reserve(s.size()); // split into chars
+			strops::split(s, delim, [&](std::string_view part) { out->push_back(Value{ std::string(part) }); });
+			return Value{out};
+		}
+		if (name == "substring") {
+			if (args.size() < 1) throw std::runtime_error("substring expects start and optional end");
+			double start = getNumber(args[0], "substring start");
+			size_t si = static_cast<size_t>(std::max(0, static_cast<int>(start)));
+			size_t len = s.size();
+			if (args.size() >= 2) {
+				double end = getNumber(args[1], "substring end");
+				size_t ei = static_cast<size_t>(std::max(0, static_cast<int>(end)));
+				if (ei > len) ei = len;
+				if (si >= ei) return Value{ std::string("") };
+				return Value{ std::string(s.substr(si, ei - si)) };
+			}
+			if (si >= len) return Value{ std::string("") };
+			return Value{ std::string(s.substr(si)) };
+		}
+		if (name == "replace") {
+			if (args.size() < 2) throw std::runtime_error("replace expects search and replacement strings");
+			if (!std::holds_alternative<std::string>(args[0]) || !std::holds_alternative<std::string>(args[1])) throw std::runtime_error("replace expects string arguments");
+			const auto& search = std::get<std::string>(args[0]);
+			const auto& repl = std::get<std::string>(args[1]);
+			if (search.empty()) return Value{ std::string(s) };
+			size_t pos = strops::find(s, search);
+			if (pos == strops::npos) return Value{ std::string(s) };
+			std::string out;
+			out.reserve(s.size() - search.size() + repl.size());
+			out.append(s.substr(0, pos)).append(repl).append(s.substr(pos + search.size()));
+			return Value{ out };
+		}
+		if (name == "replaceAll") {
+			if (args.size() < 2) throw std::runtime_error("replaceAll expects search and replacement strings");
+			if (!std::holds_alternative<std::string>(args[0]) || !std::holds_alternative<std::string>(args[1])) throw std::runtime_error("replaceAll expects string arguments");
+			return Value{ strops::replaceAll(s, std::get<std::string>(args[0]), std::get<std::string>(args[1])) };
+		}
+		if (name == "lastIndexOf") {
+			if (args.size() < 1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("lastIndexOf expects search string");
+			size_t pos = std::string_view::npos;
+			if (args.size() >= 2) {
+				double d = getNumber(args[1], "lastIndexOf position");
+				if (d >= 0) pos = static_cast<size_t>(d);
+			}
+			auto found = s.rfind(std::get<std::string>(args[0]), pos);
+			if (found == std::string_view::npos) return Value{ -1.0 };
+			return Value{ static_cast<double>(found) };
+		}
+		if (name == "slice") {
+			double start = 0, end = static_cast<double>(s.size());
+			if (args.size() >= 1) start = getNumber(args[0], "slice start");
+			if (args.size() >= 2) end = getNumber(args[1], "slice end");
+			if (start < 0) start += s.size();
+			if (end < 0) end += s.size();
+			if (start < 0) start = 0;
+			if (end < 0) end = 0;
+			size_t si = static_cast<size_t>(start);
+			size_t ei = static_cast<size_t>(end);
+			if (si > s.size()) si = s.size();
+			if (ei > s.size()) ei = s.size();
+			if (ei < si) return Value{ std::string("") };
+			return Value{ std::string(s.substr(si, ei - si)) };
+		}
+		if (name == "padStart" || name == "padEnd") {
+			bool atStart = name == "padStart";
+			if (args.size() < 1) throw std::runtime_error(name + " expects target length");
+			size_t targetLen = static_cast<size_t>(std::max(0.0, getNumber(args[0], atStart ? "padStart length" : "padEnd length")));
+			if (s.size() >= targetLen) return Value{ std::string(s) };
+			std::string pad = " ";
+			if (args.size() >= 2) pad = toString(args[1]);
+			if (pad.empty()) return Value{ std::string(s) };
+			size_t padLen = targetLen - s.size();
+			std::string fill;
+			fill.reserve(padLen + pad.size());
+			while (fill.size() < padLen) fill += pad;
+			fill.resize(padLen);
+			return Value{ atStart ? fill + std::string(s) : std::string(s) + fill };
+		}
+		return Value{std::string("undefined")};
+	}
+	// 只有字面量、普通变量和对字面量的一元运算 (-1) 才算无副作用：
+	// 二元运算/属性/下标都可能调用用户的 __add__ 等重载，进而改写接收者变量
+	static bool isPureArgExpr(const Expr* e) {
+		if (!e) return true;
+		if (dynamic_cast<const LiteralExpr*>(e) || dynamic_cast<const VariableExpr*>(e)) return true;
+		if (auto u = dynamic_cast<const UnaryExpr*>(e)) return dynamic_cast<const LiteralExpr*>(u->right.get()) != nullptr;
+		return false;
+	}
+	static bool callArgsArePure(CallExpr& call) {
+		if (call.argsPure < 0) {
+			call.argsPure = 1;
+			for (auto& a : call.args) if (!isPureArgExpr(a.get())) { call.argsPure = 0; break; }
+		}
+		return call.argsPure == 1;
+	}
+
 	Value getProperty(const Value& obj, const std::string& name) {
 		// Instance: fields then methods
 		if (auto pins = std::get_if<std::shared_ptr<Instance>>(&obj)) {
@@ -2176,6 +2925,40 @@ public:
 				std::stable_sort(a->begin(), a->end(), [this,cmp](const Value& lhs, const Value& rhs){ if (cmp) { Value ret{std::monostate{}}; if (cmp->isBuiltin) { std::vector<Value> carg{lhs,rhs}; ret=cmp->builtin(carg, cmp->closure); } else { auto local=std::make_shared<Environment>(cmp->closure); if (cmp->params.size()>0) local->define(cmp->params[0], lhs); if (cmp->params.size()>1) local->define(cmp->params[1], rhs); try { executeBlock(cmp->body, local); } catch (const ReturnSignal& rs) { ret=rs.value; } } return isTruthy(ret); }
 				// default compare: numbers numeric asc, else string lexicographical
 				auto ln=std::get_if<double>(&lhs); auto rn=std::get_if<double>(&rhs); if (ln && rn) return *ln < *rn; std::string ls=toString(lhs); std::string rs=toString(rhs); return ls < rs; }); return Value{a}; }; return fn; }
+			// sortAsync(): 默认比较规则与 sort() 相同；排序键在事件循环线程上预先计算，工作线程只对键排序，
+			// 完成后在事件循环线程上写回原数组并 resolve 该数组。比较函数需要执行脚本，因此不支持。
+			if (name == "sortAsync") {
+				auto fn = std::make_shared<Function>(); fn->isBuiltin = true; auto a = *parr;
+				fn->builtin = [this,a](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+					if (!args.empty()) throw std::runtime_error("sortAsync does not accept a comparator (script code cannot run on worker threads); use sort(cmp)");
+					struct SortKey { const double* num; std::string str; };
+					auto snapshot = std::make_shared<Array>(a ? *a : Array{});
+					auto keys = std::make_shared<std::vector<SortKey>>();
+					keys->reserve(snapshot->size());
+					bool allNumbers = true;
+					for (auto& v : *snapshot) { auto n = std::get_if<double>(&v); keys->push_back(SortKey{ n, {} }); if (!n) allNumbers = false; }
+					if (!allNumbers) for (size_t i = 0; i < snapshot->size(); ++i) (*keys)[i].str = toString((*snapshot)[i]);
+					auto order = std::make_shared<std::vector<size_t>>();
+					auto work = [keys, order]()->Value {
+						order->resize(keys->size());
+						for (size_t i = 0; i < order->size(); ++i) (*order)[i] = i;
+						std::stable_sort(order->begin(), order->end(), [&k = *keys](size_t l, size_t r) {
+							if (k[l].num && k[r].num) return *k[l].num < *k[r].num;
+							return k[l].str < k[r].str;
+						});
+						return Value{std::monostate{}};
+					};
+					auto finish = [a, snapshot, order](Value)->Value {
+						if (!a) return Value{std::monostate{}};
+						Array sorted; sorted.reserve(order->size());
+						for (size_t i : *order) sorted.push_back(std::move((*snapshot)[i]));
+						a->swap(sorted);
+						return Value{a};
+					};
+					return Value{ offload(work, finish) };
+				};
+				return fn;
+			}
 			if (name == "splice") { auto fn=std::make_shared<Function>(); fn->isBuiltin=true; auto a=*parr; fn->builtin=[a](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value { if (!a) return Value{std::monostate{}}; if (args.empty()) throw std::runtime_error("splice expects start index"); double startD=getNumber(args[0], "splice start"); if (startD<0) startD+=a->size(); if (startD<0) startD=0; size_t start = static_cast<size_t>(startD); if (start>a->size()) start=a->size(); size_t deleteCount=0; size_t insertFrom=1; if (args.size()>=2) { double delD=getNumber(args[1], "splice deleteCount"); if (delD<0) delD=0; deleteCount=static_cast<size_t>(delD); insertFrom=2; } if (start+deleteCount>a->size()) deleteCount = a->size()-start; auto removed=std::make_shared<Array>(); for (size_t i=0;i<deleteCount;++i) removed->push_back((*a)[start+i]); a->erase(a->begin()+start, a->begin()+start+deleteCount); // insert new items
 				for (size_t i=insertFrom;i<args.size();++i) a->insert(a->begin()+start+(i-insertFrom), args[i]); return Value{removed}; }; return fn; }
 			if (name == "map") {
@@ -2348,161 +3131,14 @@ public:
 		}
 		// String synthetic methods
 		if (auto ps = std::get_if<std::string>(&obj)) {
-			if (name == "len") { auto s = *ps; auto fn = std::make_shared<Function>(); fn->isBuiltin = true; fn->builtin = [s](const std::vector<Value>&, std::shared_ptr<Environment>)->Value { return Value{ static_cast<double>(s.size()) }; }; return fn; }
-			// Added extended string methods
-			if (name == "trim") {
-				auto s = *ps; auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
-				fn->builtin = [s](const std::vector<Value>&, std::shared_ptr<Environment>)->Value {
-					size_t start = 0, end = s.size();
-					while (start < end && std::isspace(static_cast<unsigned char>(s[start]))) start++;
-					while (end > start && std::isspace(static_cast<unsigned char>(s[end-1]))) end--;
-					return Value{ s.substr(start, end - start) };
-				}; return fn;
-			}
-			if (name == "trimLeft") {
-				auto s = *ps; auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
-				fn->builtin = [s](const std::vector<Value>&, std::shared_ptr<Environment>)->Value {
-					size_t start = 0;
-					while (start < s.size() && std::isspace(static_cast<unsigned char>(s[start]))) start++;
-					return Value{ s.substr(start) };
-				}; return fn;
-			}
-			if (name == "trimRight") {
-				auto s = *ps; auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
-				fn->builtin = [s](const std::vector<Value>&, std::shared_ptr<Environment>)->Value {
-					size_t end = s.size();
-					while (end > 0 && std::isspace(static_cast<unsigned char>(s[end-1]))) end--;
-					return Value{ s.substr(0, end) };
-				}; return fn;
-			}
-			if (name == "toLowerCase") { auto s = *ps; auto fn = std::make_shared<Function>(); fn->isBuiltin = true; fn->builtin = [s](const std::vector<Value>&, std::shared_ptr<Environment>)->Value { std::string out=s; for (auto &c: out) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c))); return Value{out}; }; return fn; }
-			if (name == "toUpperCase") { auto s = *ps; auto fn = std::make_shared<Function>(); fn->isBuiltin = true; fn->builtin = [s](const std::vector<Value>&, std::shared_ptr<Environment>)->Value { std::string out=s; for (auto &c: out) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c))); return Value{out}; }; return fn; }
-			if (name == "startsWith") { auto s=*ps; auto fn=std::make_shared<Function>(); fn->isBuiltin=true; fn->builtin=[s](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value { if (args.size()!=1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("startsWith expects 1 string arg"); std::string pre=std::get<std::string>(args[0]); return Value{ s.rfind(pre,0)==0 }; }; return fn; }
-			if (name == "endsWith") { auto s=*ps; auto fn=std::make_shared<Function>(); fn->isBuiltin=true; fn->builtin=[s](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value { if (args.size()!=1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("endsWith expects 1 string arg"); std::string suf=std::get<std::string>(args[0]); if (suf.size()>s.size()) return Value{false}; return Value{ std::equal(suf.rbegin(), suf.rend(), s.rbegin()) }; }; return fn; }
-			if (name == "includes") { auto s=*ps; auto fn=std::make_shared<Function>(); fn->isBuiltin=true; fn->builtin=[s](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value { if (args.size()!=1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("includes expects 1 string arg"); std::string sub=std::get<std::string>(args[0]); return Value{ s.find(sub)!=std::string::npos }; }; return fn; }
-			if (name == "indexOf") { auto s=*ps; auto fn=std::make_shared<Function>(); fn->isBuiltin=true; fn->builtin=[s](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value { if (args.size()<1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("indexOf expects search string and optional start index"); std::string search=std::get<std::string>(args[0]); size_t start=0; if (args.size()>=2) start = static_cast<size_t>(std::max(0, static_cast<int>(getNumber(args[1], "indexOf start")))); auto pos = s.find(search, start); if (pos==std::string::npos) return Value{ -1.0 }; return Value{ static_cast<double>(pos) }; }; return fn; }
-			if (name == "split") {
-				auto s = *ps;
-				auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
-				fn->builtin = [s](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
-					if (args.size() < 1) throw std::runtime_error("split expects a delimiter string");
-					if (!std::holds_alternative<std::string>(args[0])) throw std::runtime_error("split delimiter must be a string");
-					std::string delim = std::get<std::string>(args[0]);
-					auto out = std::make_shared<Array>();
-					if (delim.empty()) { // split into chars
-						for (char c : s) { out->push_back(Value{ std::string(1, c) }); }
-						return Value{out};
-					}
-					size_t pos = 0, found;
-					while ((found = s.find(delim, pos)) != std::string::npos) {
-						out->push_back(Value{ s.substr(pos, found - pos) });
-						pos = found + delim.size();
-					}
-					out->push_back(Value{ s.substr(pos) });
-					return Value{out};
-				};
-				return fn;
-			}
-			if (name == "substring") {
-				auto s = *ps;
-				auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
-				fn->builtin = [s](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
-					if (args.size() < 1) throw std::runtime_error("substring expects start and optional end");
-					double start = getNumber(args[0], "substring start");
-					size_t si = static_cast<size_t>(std::max(0, static_cast<int>(start)));
-					size_t len = s.size();
-					if (args.size() >= 2) {
-						double end = getNumber(args[1], "substring end");
-						size_t ei = static_cast<size_t>(std::max(0, static_cast<int>(end)));
-						if (ei > len) ei = len;
-						if (si >= ei) return Value{ std::string("") };
-						return Value{ s.substr(si, ei - si) };
-					}
-					if (si >= len) return Value{ std::string("") };
-					return Value{ s.substr(si) };
-				};
-				return fn;
-			}
-			if (name == "replace") {
-				auto s = *ps;
-				auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
-				fn->builtin = [s](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
-					if (args.size() < 2) throw std::runtime_error("replace expects search and replacement strings");
-					if (!std::holds_alternative<std::string>(args[0]) || !std::holds_alternative<std::string>(args[1])) throw std::runtime_error("replace expects string arguments");
-					std::string search = std::get<std::string>(args[0]);
-					std::string repl = std::get<std::string>(args[1]);
-					if (search.empty()) return Value{ s };
-					size_t pos = s.find(search);
-					if (pos == std::string::npos) return Value{ s };
-					std::string out = s.substr(0, pos) + repl + s.substr(pos + search.size());
-					return Value{ out };
-				};
-				return fn;
-			}
-			if (name == "lastIndexOf") {
-				auto s = *ps; auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
-				fn->builtin = [s](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
-					if (args.size() < 1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("lastIndexOf expects search string");
-					std::string search = std::get<std::string>(args[0]);
-					size_t pos = std::string::npos;
-					if (args.size() >= 2) {
-						double d = getNumber(args[1], "lastIndexOf position");
-						if (d >= 0) pos = static_cast<size_t>(d);
-					}
-					auto found = s.rfind(search, pos);
-					if (found == std::string::npos) return Value{ -1.0 };
-					return Value{ static_cast<double>(found) };
-				}; return fn;
-			}
-			if (name == "slice") {
-				auto s = *ps; auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
-				fn->builtin = [s](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
-					double start = 0, end = static_cast<double>(s.size());
-					if (args.size() >= 1) start = getNumber(args[0], "slice start");
-					if (args.size() >= 2) end = getNumber(args[1], "slice end");
-					if (start < 0) start += s.size();
-					if (end < 0) end += s.size();
-					if (start < 0) start = 0;
-					if (end < 0) end = 0;
-					size_t si = static_cast<size_t>(start);
-					size_t ei = static_cast<size_t>(end);
-					if (si > s.size()) si = s.size();
-					if (ei > s.size()) ei = s.size();
-					if (ei < si) return Value{ std::string("") };
-					return Value{ s.substr(si, ei - si) };
-				}; return fn;
-			}
-			if (name == "padStart") {
-				auto s = *ps; auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
-				fn->builtin = [s](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
-					if (args.size() < 1) throw std::runtime_error("padStart expects target length");
-					size_t targetLen = static_cast<size_t>(std::max(0.0, getNumber(args[0], "padStart length")));
-					if (s.size() >= targetLen) return Value{s};
-					std::string pad = " ";
-					if (args.size() >= 2) pad = toString(args[1]);
-					if (pad.empty()) return Value{s};
-					std::string out;
-					size_t padLen = targetLen - s.size();
-					while (out.size() < padLen) out += pad;
-					out = out.substr(0, padLen);
-					return Value{ out + s };
-				}; return fn;
-			}
-			if (name == "padEnd") {
-				auto s = *ps; auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
-				fn->builtin = [s](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
-					if (args.size() < 1) throw std::runtime_error("padEnd expects target length");
-					size_t targetLen = static_cast<size_t>(std::max(0.0, getNumber(args[0], "padEnd length")));
-					if (s.size() >= targetLen) return Value{s};
-					std::string pad = " ";
-					if (args.size() >= 2) pad = toString(args[1]);
-					if (pad.empty()) return Value{s};
-					std::string out = s;
-					while (out.size() < targetLen) out += pad;
-					return Value{ out.substr(0, targetLen) };
-				}; return fn;
-			}
-			return Value{std::string("undefined")};
+			if (!isStringMethod(name)) return Value{std::string("undefined")};
+			// 接收者只复制一次并在绑定函数间共享；直接调用 s.method(...) 走 CallExpr 快速路径，不经过这里
+			auto s = std::make_shared<const std::string>(*ps);
+			auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
+			fn->builtin = [s, name](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+				return callStringMethod(*s, name, args);
+			};
+			return fn;
 		}
 		// For numbers and other primitives, return "undefined" instead of null
 		if (std::get_if<double>(&obj) || std::get_if<bool>(&obj)) {
@@ -2742,12 +3378,35 @@ public:
 		}
 	}
 
+	// import 是关键字，脚本只能经 import.reload(...) 这样的成员访问拿到这个对象
+	void installImportObject() {
+		auto importObj = std::make_shared<Object>();
+		// import.reload(path) -> 模块对象：重新执行已导入的模块并换入新的导出 (未导入过时等同首次导入)
+		auto reload = std::make_shared<Function>(); reload->isBuiltin = true;
+		reload->builtin = [this](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			if (args.size() != 1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("import.reload expects 1 argument (module path)");
+			return Value{ reloadModule(std::get<std::string>(args[0])) };
+		};
+		(*importObj)["reload"] = Value{reload};
+		// import.onReload(callback)：每次重载成功后以 (绝对路径, 模块对象) 调用，用于重新挂接处理函数等
+		auto onReload = std::make_shared<Function>(); onReload->isBuiltin = true;
+		onReload->builtin = [this](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			if (args.size() != 1 || !std::holds_alternative<std::shared_ptr<Function>>(args[0])) throw std::runtime_error("import.onReload expects 1 argument (function)");
+			reloadListeners.push_back(args[0]);
+			return Value{std::monostate{}};
+		};
+		(*importObj)["onReload"] = Value{onReload};
+		globals->define("import", Value{importObj});
+	}
+
 	void installBuiltins() {
 		stdRoot = std::make_shared<Object>();
 		globals->define("std", Value{stdRoot});
 		// Define 'undefined' as a global variable equivalent to null (monostate)
 		globals->define("undefined", Value{std::monostate{}});
 		packages["std"] = stdRoot;
+		packageObjects.insert(stdRoot.get());
+		installImportObject();
 
 		// Register all external packages
 		// This includes: std.path, std.string, std.math, std.time, std.os, std.regex,
@@ -0,0 +1,107 @@
+#include "AsulModuleWatcher.h"
+
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace asul {
+
+ModuleWatcher::ModuleWatcher(std::function<void(const std::string&)> onChange) : onChange(std::move(onChange)) {
+#ifdef __linux__
+	inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (pipe2(wakeFds, O_NONBLOCK | O_CLOEXEC) != 0) wakeFds[0] = wakeFds[1] = -1;
+#endif
+}
+
+ModuleWatcher::~ModuleWatcher() {
+	{
+		std::lock_guard<std::mutex> lk(mtx);
+		stopping = true;
+	}
+	cv.notify_all();
+#ifdef __linux__
+	if (wakeFds[1] >= 0) { char b = 1; (void)!::write(wakeFds[1], &b, 1); }
+#endif
+	if (worker.joinable()) worker.join();
+#ifdef __linux__
+	if (inotifyFd >= 0) ::close(inotifyFd);
+	if (wakeFds[0] >= 0) ::close(wakeFds[0]);
+	if (wakeFds[1] >= 0) ::close(wakeFds[1]);
+#endif
+}
+
+void ModuleWatcher::watch(const std::string& path) {
+	std::lock_guard<std::mutex> lk(mtx);
+	if (!files.insert(path).second) return;
+#ifdef __linux__
+	if (inotifyFd < 0 || wakeFds[0] < 0) return;
+	// 监视目录而不是文件本身：编辑器常以“写临时文件再 rename”的方式保存，文件的 inode 会变
+	std::string dir = std::filesystem::path(path).parent_path().string();
+	int wd = inotify_add_watch(inotifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (wd < 0) return;
+	watchedDirs[wd] = dir;
+#else
+	std::error_code ec;
+	auto t = std::filesystem::last_write_time(path, ec);
+	mtimes[path] = ec ? 0 : static_cast<long long>(t.time_since_epoch().count());
+#endif
+	if (!worker.joinable()) worker = std::thread([this]{ run(); });
+}
+
+#ifdef __linux__
+void ModuleWatcher::run() {
+	std::vector<char> buf(64 * 1024);
+	std::set<std::string> changed;
+	for (;;) {
+		pollfd fds[2] = { { inotifyFd, POLLIN, 0 }, { wakeFds[0], POLLIN, 0 } };
+		// 有待报告的变化时只再等 50ms：一次保存通常产生多个事件，合并后再回调
+		int n = ::poll(fds, 2, changed.empty() ? -1 : 50);
+		if (n < 0) continue;
+		if (fds[1].revents) return;
+		if (n == 0) {
+			for (auto& path : changed) onChange(path);
+			changed.clear();
+			continue;
+		}
+		ssize_t len = ::read(inotifyFd, buf.data(), buf.size());
+		if (len <= 0) continue;
+		std::lock_guard<std::mutex> lk(mtx);
+		for (ssize_t off = 0; off < len;) {
+			auto* ev = reinterpret_cast<inotify_event*>(buf.data() + off);
+			off += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+			auto dir = watchedDirs.find(ev->wd);
+			if (dir == watchedDirs.end() || ev->len == 0) continue;
+			std::string path = (std::filesystem::path(dir->second) / ev->name).string();
+			if (files.count(path)) changed.insert(path);
+		}
+	}
+}
+#else
+void ModuleWatcher::run() {
+	std::unique_lock<std::mutex> lk(mtx);
+	while (!stopping) {
+		cv.wait_for(lk, std::chrono::milliseconds(500), [this]{ return stopping; });
+		if (stopping) return;
+		std::vector<std::string> changed;
+		for (auto& path : files) {
+			std::error_code ec;
+			auto t = std::filesystem::last_write_time(path, ec);
+			if (ec) continue;
+			long long stamp = static_cast<long long>(t.time_since_epoch().count());
+			if (stamp != mtimes[path]) { mtimes[path] = stamp; changed.push_back(path); }
+		}
+		lk.unlock();
+		for (auto& path : changed) onChange(path);
+		lk.lock();
+	}
+}
+#endif
+
+} // namespace asul
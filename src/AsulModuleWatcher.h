@@ -0,0 +1,48 @@
+#ifndef ASUL_MODULE_WATCHER_H
+#define ASUL_MODULE_WATCHER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace asul {
+
+// ----------- Module watcher (--watch) -----------
+// 监视已导入的模块文件，文件被改写 (保存或原子替换) 后在监视线程上回调 onChange(path)。
+// Linux 上用 inotify 监视模块所在目录，其他平台每 500ms 比较一次修改时间。
+// 回调应只把工作投递回事件循环；连续的写入事件会合并为一次回调。
+class ModuleWatcher {
+public:
+	explicit ModuleWatcher(std::function<void(const std::string&)> onChange);
+	~ModuleWatcher();
+	ModuleWatcher(const ModuleWatcher&) = delete;
+	ModuleWatcher& operator=(const ModuleWatcher&) = delete;
+
+	// path 为规范化后的绝对路径；首次调用时启动监视线程
+	void watch(const std::string& path);
+
+private:
+	void run();
+
+	std::function<void(const std::string&)> onChange;
+	std::thread worker;
+	std::mutex mtx;
+	std::condition_variable cv;
+	bool stopping{false};
+	std::set<std::string> files;
+#ifdef __linux__
+	int inotifyFd{-1};
+	int wakeFds[2]{-1, -1};
+	std::unordered_map<int, std::string> watchedDirs; // wd -> 目录
+#else
+	std::unordered_map<std::string, long long> mtimes;
+#endif
+};
+
+} // namespace asul
+
+#endif // ASUL_MODULE_WATCHER_H
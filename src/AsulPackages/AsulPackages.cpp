@@ -83,7 +83,8 @@ const std::vector<PackageMeta>& getPackageMetadata() {
     {
         PackageMeta pkg;
         pkg.name = "std.io";
-        pkg.exports = { "stdin", "stdout", "stderr", "mkdir", "rmdir", "stat", "copy", "move", "chmod", "walk", "writeFile", "appendFile", "readFile" };
+        pkg.exports = { "stdin", "stdout", "stderr", "mkdir", "rmdir", "stat", "copy", "move", "chmod", "walk", "writeFile", "appendFile", "readFile",
+            "createReadStream", "createWriteStream", "createGzip", "createGunzip", "createHash", "pipeline" };
 
         ClassMeta fileStreamClass;
         fileStreamClass.name = "FileStream";
@@ -100,6 +101,21 @@ const std::vector<PackageMeta>& getPackageMetadata() {
         dirClass.methods = { {"list"}, {"exists"}, {"create"}, {"delete"}, {"rename"}, {"walk"} };
         pkg.classes.push_back(dirClass);
 
+        ClassMeta readableClass;
+        readableClass.name = "Readable";
+        readableClass.methods = { {"constructor"}, {"push"}, {"end"}, {"read"}, {"readLine"}, {"text"}, {"pipe"}, {"readableLength"}, {"finished"}, {"destroy"}, {"from"}, {"fromFd"}, {"fromFileStream"} };
+        pkg.classes.push_back(readableClass);
+
+        ClassMeta writableClass;
+        writableClass.name = "Writable";
+        writableClass.methods = { {"constructor"}, {"write"}, {"drain"}, {"end"}, {"writableLength"}, {"finished"}, {"destroy"}, {"fromFd"}, {"fromFileStream"} };
+        pkg.classes.push_back(writableClass);
+
+        ClassMeta transformClass;
+        transformClass.name = "Transform";
+        transformClass.methods = { {"constructor"}, {"push"}, {"read"}, {"readLine"}, {"text"}, {"pipe"}, {"write"}, {"drain"}, {"end"}, {"finished"}, {"destroy"} };
+        pkg.classes.push_back(transformClass);
+
         packages.push_back(pkg);
     }
 
@@ -107,11 +123,12 @@ const std::vector<PackageMeta>& getPackageMetadata() {
     {
         PackageMeta pkg;
         pkg.name = "std.network";
-        pkg.exports = { "parseHeaders", "fetch", "get", "post", "put", "delete", "patch", "head", "request", "http" };
+        pkg.exports = { "parseHeaders", "fetch", "get", "post", "put", "delete", "patch", "head", "request", "http", "tls", "dns", "WebSocket" };
         
         ClassMeta socketClass;
         socketClass.name = "Socket";
-        socketClass.methods = { {"constructor"}, {"bind"}, {"listen"}, {"connect"}, {"accept"}, {"read"}, {"write"}, {"close"} };
+        socketClass.methods = { {"constructor"}, {"bind"}, {"listen"}, {"connect"}, {"accept"}, {"read"}, {"write"}, {"close"},
+            {"fileno"}, {"localAddress"}, {"setOption"}, {"sendTo"}, {"sendBatch"}, {"recvFrom"}, {"recvBatch"}, {"sendFd"}, {"recvFd"}, {"fromFd"}, {"pair"} };
         pkg.classes.push_back(socketClass);
 
         ClassMeta urlClass;
@@ -119,6 +136,11 @@ const std::vector<PackageMeta>& getPackageMetadata() {
         urlClass.methods = { {"constructor"}, {"parseQuery"} };
         pkg.classes.push_back(urlClass);
 
+        ClassMeta wsClass;
+        wsClass.name = "WebSocket";
+        wsClass.methods = { {"connect"}, {"send"}, {"sendBinary"}, {"receive"}, {"ping"}, {"close"}, {"on"}, {"bufferedAmount"}, {"readyState"} };
+        pkg.classes.push_back(wsClass);
+
         packages.push_back(pkg);
     }
 
@@ -182,11 +204,135 @@ const std::vector<PackageMeta>& getPackageMetadata() {
         packages.push_back(pkg);
     }
 
+    // std.immutable
+    {
+        PackageMeta pkg;
+        pkg.name = "std.immutable";
+        pkg.exports = { "map", "set", "vector" };
+
+        ClassMeta mapClass;
+        mapClass.name = "Map";
+        mapClass.methods = { {"constructor"}, {"get"}, {"has"}, {"set"}, {"delete"}, {"update"}, {"merge"}, {"size"}, {"keys"}, {"values"}, {"entries"}, {"equals"}, {"transient"}, {"withMutations"} };
+        pkg.classes.push_back(mapClass);
+
+        ClassMeta setClass;
+        setClass.name = "Set";
+        setClass.methods = { {"constructor"}, {"has"}, {"add"}, {"delete"}, {"size"}, {"values"}, {"union"}, {"intersection"}, {"difference"}, {"equals"}, {"transient"}, {"withMutations"} };
+        pkg.classes.push_back(setClass);
+
+        ClassMeta vectorClass;
+        vectorClass.name = "Vector";
+        vectorClass.methods = { {"constructor"}, {"get"}, {"set"}, {"push"}, {"pop"}, {"last"}, {"size"}, {"slice"}, {"concat"}, {"toArray"}, {"equals"}, {"transient"}, {"withMutations"} };
+        pkg.classes.push_back(vectorClass);
+
+        ClassMeta tmapClass;
+        tmapClass.name = "TransientMap";
+        tmapClass.methods = { {"get"}, {"has"}, {"set"}, {"delete"}, {"size"}, {"persistent"} };
+        pkg.classes.push_back(tmapClass);
+
+        ClassMeta tsetClass;
+        tsetClass.name = "TransientSet";
+        tsetClass.methods = { {"has"}, {"add"}, {"delete"}, {"size"}, {"persistent"} };
+        pkg.classes.push_back(tsetClass);
+
+        ClassMeta tvectorClass;
+        tvectorClass.name = "TransientVector";
+        tvectorClass.methods = { {"get"}, {"set"}, {"push"}, {"pop"}, {"size"}, {"persistent"} };
+        pkg.classes.push_back(tvectorClass);
+
+        packages.push_back(pkg);
+    }
+
+    // std.sync
+    {
+        PackageMeta pkg;
+        pkg.name = "std.sync";
+
+        ClassMeta mutexClass;
+        mutexClass.name = "Mutex";
+        mutexClass.methods = { {"constructor"}, {"lock"}, {"tryLock"}, {"unlock"}, {"isLocked"}, {"withLock"} };
+        pkg.classes.push_back(mutexClass);
+
+        ClassMeta rwClass;
+        rwClass.name = "RWLock";
+        rwClass.methods = { {"constructor"}, {"readLock"}, {"writeLock"}, {"tryReadLock"}, {"tryWriteLock"}, {"readUnlock"}, {"writeUnlock"}, {"withRead"}, {"withWrite"} };
+        pkg.classes.push_back(rwClass);
+
+        ClassMeta semClass;
+        semClass.name = "Semaphore";
+        semClass.methods = { {"constructor"}, {"acquire"}, {"tryAcquire"}, {"release"}, {"available"}, {"waiting"}, {"run"} };
+        pkg.classes.push_back(semClass);
+
+        ClassMeta wgClass;
+        wgClass.name = "WaitGroup";
+        wgClass.methods = { {"constructor"}, {"add"}, {"done"}, {"wait"}, {"count"} };
+        pkg.classes.push_back(wgClass);
+
+        ClassMeta onceClass;
+        onceClass.name = "Once";
+        onceClass.methods = { {"constructor"}, {"run"}, {"isDone"} };
+        pkg.classes.push_back(onceClass);
+
+        ClassMeta atomicClass;
+        atomicClass.name = "AtomicInt";
+        atomicClass.methods = { {"constructor"}, {"get"}, {"set"}, {"add"}, {"sub"}, {"increment"}, {"decrement"}, {"exchange"}, {"compareAndSet"} };
+        pkg.classes.push_back(atomicClass);
+
+        packages.push_back(pkg);
+    }
+
+    // std.shm
+    {
+        PackageMeta pkg;
+        pkg.name = "std.shm";
+        pkg.exports = { "unlink", "available" };
+
+        ClassMeta ringClass;
+        ringClass.name = "Ring";
+        ringClass.methods = { {"constructor"}, {"push"}, {"pop"}, {"send"}, {"receive"}, {"size"}, {"close"} };
+        pkg.classes.push_back(ringClass);
+
+        ClassMeta counterClass;
+        counterClass.name = "Counter";
+        counterClass.methods = { {"constructor"}, {"get"}, {"set"}, {"add"}, {"increment"}, {"decrement"}, {"exchange"}, {"compareAndSet"}, {"close"} };
+        pkg.classes.push_back(counterClass);
+
+        packages.push_back(pkg);
+    }
+
+    // std.template
+    {
+        PackageMeta pkg;
+        pkg.name = "std.template";
+        pkg.exports = { "compile", "render", "registerPartial", "escapeHtml" };
+
+        ClassMeta templateClass;
+        templateClass.name = "Template";
+        templateClass.methods = { {"constructor"}, {"render"}, {"renderTo"} };
+        pkg.classes.push_back(templateClass);
+
+        packages.push_back(pkg);
+    }
+
+    // std.fmt
+    {
+        PackageMeta pkg;
+        pkg.name = "std.fmt";
+        pkg.exports = { "format", "compile" };
+
+        ClassMeta formatterClass;
+        formatterClass.name = "Formatter";
+        formatterClass.methods = { {"constructor"}, {"format"} };
+        pkg.classes.push_back(formatterClass);
+
+        packages.push_back(pkg);
+    }
+
     // std.crypto
     {
         PackageMeta pkg;
         pkg.name = "std.crypto";
-        pkg.exports = { "randomUUID", "getRandomValues", "md5", "sha1", "sha256" };
+        pkg.exports = { "randomUUID", "getRandomValues", "md5", "sha1", "sha256", "md5Async", "sha1Async", "sha256Async" };
         packages.push_back(pkg);
     }
 
@@ -194,7 +340,13 @@ const std::vector<PackageMeta>& getPackageMetadata() {
     {
         PackageMeta pkg;
         pkg.name = "csv";
-        pkg.exports = { "parse", "stringify", "read", "write" };
+        pkg.exports = { "parse", "stringify", "read", "write", "parseAsync", "stringifyAsync", "writer" };
+
+        ClassMeta writerClass;
+        writerClass.name = "Writer";
+        writerClass.methods = { {"constructor"}, {"writeRow"}, {"writeRows"}, {"flush"}, {"close"}, {"rowCount"} };
+        pkg.classes.push_back(writerClass);
+
         packages.push_back(pkg);
     }
 
@@ -202,7 +354,13 @@ const std::vector<PackageMeta>& getPackageMetadata() {
     {
         PackageMeta pkg;
         pkg.name = "json";
-        pkg.exports = { "parse", "stringify" };
+        pkg.exports = { "parse", "stringify", "parseAsync", "stringifyAsync", "compileSchema" };
+
+        ClassMeta schemaClass;
+        schemaClass.name = "Schema";
+        schemaClass.methods = { {"constructor"}, {"validate"}, {"isValid"}, {"assert"}, {"parse"} };
+        pkg.classes.push_back(schemaClass);
+
         packages.push_back(pkg);
     }
 
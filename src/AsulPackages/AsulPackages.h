@@ -27,6 +27,11 @@
 #include "Std/Uuid/StdUuid.h"
 #include "Std/Url/StdUrl.h"
 #include "Std/Events/StdEvents.h"
+#include "Std/Immutable/StdImmutable.h"
+#include "Std/Sync/StdSync.h"
+#include "Std/Shm/StdShm.h"
+#include "Std/Template/StdTemplate.h"
+#include "Std/Fmt/StdFmt.h"
 #include "Csv/Csv.h"
 #include "Json/Json.h"
 #include "Xml/Xml.h"
@@ -1,12 +1,201 @@
 #include "Csv.h"
 #include "../../AsulInterpreter.h"
+#include "../../AsulStringOps.h"
+#include <charconv>
+#include <cmath>
 #include <fstream>
 #include <sstream>
 
 namespace asul {
 
+namespace {
+
+enum class QuoteMode { Minimal, All, NonNumeric, None };
+
+// 字段编码选项
+struct CsvDialect {
+    char delimiter{','};
+    QuoteMode quoteMode{QuoteMode::Minimal};
+};
+
+// 用 strops::findAnyOf4 (SIMD) 找第一个分隔符/引号/换行，没有就整段拷贝；
+// 有则从该位置起按段拷贝，每个 " 变成 ""
+void appendQuoted(std::string& out, const char* s, size_t n, const CsvDialect& d, bool forceQuote) {
+    std::string_view sv(s, n);
+    size_t i = strops::findAnyOf4(sv, d.delimiter, '"', '\n', '\r');
+    if (i == strops::npos && !forceQuote) { out.append(s, n); return; }
+    if (d.quoteMode == QuoteMode::None) throw std::runtime_error("csv: field needs quoting but quoteMode is 'none'");
+    out.push_back('"');
+    size_t pos = 0;
+    for (size_t q = i == strops::npos ? i : strops::findByte(sv, '"', i); q != strops::npos; q = strops::findByte(sv, '"', pos)) {
+        out.append(s + pos, q + 1 - pos);
+        out.push_back('"');
+        pos = q + 1;
+    }
+    out.append(s + pos, n - pos);
+    out.push_back('"');
+}
+
+void appendField(std::string& out, const Value& v, const CsvDialect& d) {
+    if (auto num = std::get_if<double>(&v)) {
+        bool force = d.quoteMode == QuoteMode::All;
+        // 整数走 long long 的 to_chars，其余用最短可回读表示 (不再截成 6 位有效数字)
+        char buf[32];
+        std::to_chars_result r;
+        if (std::floor(*num) == *num && std::fabs(*num) < 1e15) r = std::to_chars(buf, buf + sizeof(buf), static_cast<long long>(*num));
+        else r = std::to_chars(buf, buf + sizeof(buf), *num);
+        appendQuoted(out, buf, static_cast<size_t>(r.ptr - buf), d, force);
+        return;
+    }
+    bool force = d.quoteMode == QuoteMode::All || d.quoteMode == QuoteMode::NonNumeric;
+    if (auto str = std::get_if<std::string>(&v)) { appendQuoted(out, str->data(), str->size(), d, force); return; }
+    std::string text = toString(v);
+    appendQuoted(out, text.data(), text.size(), d, force);
+}
+
+void appendRow(std::string& out, const Array& row, const CsvDialect& d) {
+    for (size_t j = 0; j < row.size(); ++j) {
+        if (j) out.push_back(d.delimiter);
+        appendField(out, row[j], d);
+    }
+}
+
+std::string stringifyRows(const Array& rows, const CsvDialect& d) {
+    std::string out;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        auto row = std::get_if<std::shared_ptr<Array>>(&rows[i]);
+        if (!row || !*row) throw std::runtime_error("Row must be Array");
+        if (i) out.push_back('\n');
+        appendRow(out, **row, d);
+    }
+    return out;
+}
+
+// csv.writer 的底层状态：行先编码进 buffer，攒满 64KB 再一次性写到文件或 dest.write(chunk)
+struct CsvWriterHandle {
+    static constexpr size_t kFlushThreshold = 64 * 1024;
+
+    CsvDialect dialect;
+    std::vector<std::string> header;  // 非空时对象行按列名取值
+    std::ofstream file;
+    Value dest;                       // 非文件目标：带 write 方法的对象
+    std::string buffer;
+    double rows{0};
+    double bytes{0};
+    bool closed{false};
+
+    ~CsvWriterHandle() {
+        // 文件目标在析构时补写剩余数据；流目标需要显式 flush()/close()
+        if (file.is_open()) { file.write(buffer.data(), static_cast<std::streamsize>(buffer.size())); file.close(); }
+    }
+};
+
+CsvDialect parseDialect(const Value* options, std::vector<std::string>* header) {
+    CsvDialect d;
+    auto po = options ? std::get_if<std::shared_ptr<Object>>(options) : nullptr;
+    if (options && !std::holds_alternative<std::monostate>(*options) && (!po || !*po)) throw std::runtime_error("csv.writer options must be an object");
+    if (!po || !*po) return d;
+    auto& opts = **po;
+    if (auto it = opts.find("delimiter"); it != opts.end()) {
+        auto s = std::get_if<std::string>(&it->second);
+        if (!s || s->size() != 1 || *s == "\"" || *s == "\n" || *s == "\r") throw std::runtime_error("csv.writer: delimiter must be a single character other than a quote or newline");
+        d.delimiter = (*s)[0];
+    }
+    if (auto it = opts.find("quoteMode"); it != opts.end()) {
+        auto s = std::get_if<std::string>(&it->second);
+        if (s && *s == "minimal") d.quoteMode = QuoteMode::Minimal;
+        else if (s && *s == "all") d.quoteMode = QuoteMode::All;
+        else if (s && *s == "nonnumeric") d.quoteMode = QuoteMode::NonNumeric;
+        else if (s && *s == "none") d.quoteMode = QuoteMode::None;
+        else throw std::runtime_error("csv.writer: quoteMode must be 'minimal', 'all', 'nonnumeric' or 'none'");
+    }
+    if (auto it = opts.find("header"); it != opts.end() && header) {
+        auto arr = std::get_if<std::shared_ptr<Array>>(&it->second);
+        if (!arr || !*arr) throw std::runtime_error("csv.writer: header must be an array of column names");
+        for (auto& col : **arr) header->push_back(toString(col));
+    }
+    return d;
+}
+
+CsvWriterHandle* writerHandle(const std::shared_ptr<Environment>& clos, const char* what) {
+    if (!clos) throw std::runtime_error("internal: instance method called without closure");
+    Value tv = clos->get("this");
+    auto pins = std::get_if<std::shared_ptr<Instance>>(&tv);
+    if (!pins || !*pins) throw std::runtime_error("internal: invalid 'this' value");
+    auto h = static_cast<CsvWriterHandle*>(static_cast<InstanceExt*>(pins->get())->nativeHandle);
+    if (!h) throw std::runtime_error(std::string(what) + ": writer not initialized");
+    if (h->closed) throw std::runtime_error(std::string(what) + ": writer is closed");
+    return h;
+}
+
+void flushWriter(Interpreter* interp, CsvWriterHandle& h) {
+    if (h.buffer.empty()) return;
+    h.bytes += static_cast<double>(h.buffer.size());
+    if (h.file.is_open()) {
+        h.file.write(h.buffer.data(), static_cast<std::streamsize>(h.buffer.size()));
+        if (!h.file) throw std::runtime_error("csv.writer: write failed");
+        h.buffer.clear();
+        return;
+    }
+    std::string chunk;
+    chunk.swap(h.buffer);
+    h.buffer.reserve(CsvWriterHandle::kFlushThreshold + 4096);
+    interp->callValue(h.dest, { Value{ std::move(chunk) } });
+}
+
+void encodeRow(CsvWriterHandle& h, const Value& rowV) {
+    if (auto row = std::get_if<std::shared_ptr<Array>>(&rowV); row && *row) {
+        appendRow(h.buffer, **row, h.dialect);
+    } else {
+        auto po = std::get_if<std::shared_ptr<Object>>(&rowV);
+        auto pins = std::get_if<std::shared_ptr<Instance>>(&rowV);
+        if (!(po && *po) && !(pins && *pins)) throw std::runtime_error("csv.writer: row must be an Array or an object");
+        if (h.header.empty()) throw std::runtime_error("csv.writer: object rows need the 'header' option");
+        // 对象行按表头列名取值，缺失的列写空
+        for (size_t j = 0; j < h.header.size(); ++j) {
+            if (j) h.buffer.push_back(h.dialect.delimiter);
+            if (po && *po) {
+                auto it = (*po)->find(h.header[j]);
+                if (it != (*po)->end()) appendField(h.buffer, it->second, h.dialect);
+            } else {
+                auto it = (*pins)->fields.find(h.header[j]);
+                if (it != (*pins)->fields.end()) appendField(h.buffer, it->second, h.dialect);
+            }
+        }
+    }
+    h.buffer.push_back('\n');
+    h.rows += 1;
+}
+
+void openWriter(Interpreter* interp, InstanceExt* inst, const std::vector<Value>& args, const char* what) {
+    if (args.empty() || args.size() > 2) throw std::runtime_error(std::string(what) + " expects (pathOrStream[, options])");
+    auto h = std::make_unique<CsvWriterHandle>();
+    h->dialect = parseDialect(args.size() > 1 ? &args[1] : nullptr, &h->header);
+    if (auto path = std::get_if<std::string>(&args[0])) {
+        h->file.open(*path, std::ios::binary | std::ios::trunc);
+        if (!h->file) throw std::runtime_error(std::string(what) + ": cannot open '" + *path + "' for writing");
+    } else {
+        h->dest = interp->getProperty(args[0], "write");
+        if (!std::holds_alternative<std::shared_ptr<Function>>(h->dest)) throw std::runtime_error(std::string(what) + ": target must be a path or have a write(chunk) method");
+    }
+    h->buffer.reserve(CsvWriterHandle::kFlushThreshold + 4096);
+    if (!h->header.empty()) {
+        for (size_t j = 0; j < h->header.size(); ++j) {
+            if (j) h->buffer.push_back(h->dialect.delimiter);
+            appendField(h->buffer, Value{ h->header[j] }, h->dialect);
+        }
+        h->buffer.push_back('\n');
+    }
+    if (inst->nativeHandle && inst->nativeDestructor) inst->nativeDestructor(inst->nativeHandle);
+    inst->nativeHandle = h.release();
+    inst->nativeDestructor = [](void* p) { delete static_cast<CsvWriterHandle*>(p); };
+}
+
+} // namespace
+
 void registerCsvPackage(Interpreter& interp) {
-    auto init = [](std::shared_ptr<Object> csvPkg) {
+    Interpreter* interpPtr = &interp;
+    auto init = [interpPtr](std::shared_ptr<Object> csvPkg) {
         // parse(text) -> Array<Array<string>>
         auto parseFn = std::make_shared<Function>();
         parseFn->isBuiltin = true;
@@ -44,32 +233,14 @@ void registerCsvPackage(Interpreter& interp) {
             if (args.size() < 1 || !std::holds_alternative<std::shared_ptr<Array>>(args[0])) {
                 throw std::runtime_error("csv.stringify expects rows: Array<Array<string|number|bool>>");
             }
-            auto rows = std::get<std::shared_ptr<Array>>(args[0]);
-            std::ostringstream out;
-            auto escapeField = [](const Value& v) {
-                std::string s = toString(v);
-                bool needQuote = s.find(',') != std::string::npos || s.find('"') != std::string::npos || s.find('\n') != std::string::npos || s.find('\r') != std::string::npos;
-                if (!needQuote) return s;
-                std::string q; q.reserve(s.size() + 2);
-                q.push_back('"');
-                for (char c : s) { if (c == '"') { q.push_back('"'); q.push_back('"'); } else { q.push_back(c); } }
-                q.push_back('"');
-                return q;
-            };
-            for (size_t i = 0; i < rows->size(); ++i) {
-                const Value& rowV = (*rows)[i];
-                if (!std::holds_alternative<std::shared_ptr<Array>>(rowV)) throw std::runtime_error("Row must be Array");
-                auto row = std::get<std::shared_ptr<Array>>(rowV);
-                for (size_t j = 0; j < row->size(); ++j) {
-                    if (j) out << ',';
-                    out << escapeField((*row)[j]);
-                }
-                if (i + 1 < rows->size()) out << '\n';
-            }
-            return Value{out.str()};
+            return Value{stringifyRows(*std::get<std::shared_ptr<Array>>(args[0]), CsvDialect{})};
         };
         (*csvPkg)["stringify"] = Value{stringifyFn};
 
+        // parseAsync / stringifyAsync: 在工作线程上执行，返回 Promise
+        (*csvPkg)["parseAsync"] = Value{interpPtr->makeOffloadedBuiltin(parseFn)};
+        (*csvPkg)["stringifyAsync"] = Value{interpPtr->makeOffloadedBuiltin(stringifyFn)};
+
         // read(path) -> rows
         auto readFn = std::make_shared<Function>();
         readFn->isBuiltin = true;
@@ -111,35 +282,79 @@ void registerCsvPackage(Interpreter& interp) {
             }
             std::string path = std::get<std::string>(args[0]);
             auto rows = std::get<std::shared_ptr<Array>>(args[1]);
-            // build CSV text via stringify
-            std::ostringstream out;
-            auto escapeField = [](const Value& v) {
-                std::string s = toString(v);
-                bool needQuote = s.find(',') != std::string::npos || s.find('"') != std::string::npos || s.find('\n') != std::string::npos || s.find('\r') != std::string::npos;
-                if (!needQuote) return s;
-                std::string q; q.reserve(s.size() + 2);
-                q.push_back('"');
-                for (char c : s) { if (c == '"') { q.push_back('"'); q.push_back('"'); } else { q.push_back(c); } }
-                q.push_back('"');
-                return q;
-            };
-            for (size_t i = 0; i < rows->size(); ++i) {
-                const Value& rowV = (*rows)[i];
-                if (!std::holds_alternative<std::shared_ptr<Array>>(rowV)) throw std::runtime_error("Row must be Array");
-                auto row = std::get<std::shared_ptr<Array>>(rowV);
-                for (size_t j = 0; j < row->size(); ++j) {
-                    if (j) out << ',';
-                    out << escapeField((*row)[j]);
-                }
-                if (i + 1 < rows->size()) out << '\n';
-            }
+            std::string out = stringifyRows(*rows, CsvDialect{});
             std::ofstream ofs(path);
             if (!ofs) throw std::runtime_error("Failed to open file for writing");
-            ofs << out.str();
+            ofs << out;
             ofs.close();
             return Value{true};
         };
         (*csvPkg)["write"] = Value{writeFn};
+        // writer(pathOrStream[, {delimiter, quoteMode, header}]) -> Writer
+        // 行编码进 64KB 缓冲后批量写出，导出大表时内存占用恒定
+        auto writerClass = std::make_shared<ClassInfo>(); writerClass->name = "Writer"; writerClass->isNative = true;
+        auto method = [](std::function<Value(const std::vector<Value>&, std::shared_ptr<Environment>)> fn) {
+            auto f = std::make_shared<Function>();
+            f->isBuiltin = true;
+            f->builtin = std::move(fn);
+            return f;
+        };
+        writerClass->methods["constructor"] = method([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos) -> Value {
+            Value tv = clos ? clos->get("this") : Value{};
+            auto pins = std::get_if<std::shared_ptr<Instance>>(&tv);
+            if (!pins || !*pins) throw std::runtime_error("internal: invalid 'this' value");
+            openWriter(interpPtr, static_cast<InstanceExt*>(pins->get()), args, "csv.Writer");
+            return Value{std::monostate{}};
+        });
+        writerClass->methods["writeRow"] = method([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos) -> Value {
+            auto h = writerHandle(clos, "Writer.writeRow");
+            if (args.size() != 1) throw std::runtime_error("Writer.writeRow expects 1 argument (row)");
+            encodeRow(*h, args[0]);
+            if (h->buffer.size() >= CsvWriterHandle::kFlushThreshold) flushWriter(interpPtr, *h);
+            return Value{std::monostate{}};
+        });
+        writerClass->methods["writeRows"] = method([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos) -> Value {
+            auto h = writerHandle(clos, "Writer.writeRows");
+            if (args.size() != 1 || !std::holds_alternative<std::shared_ptr<Array>>(args[0])) throw std::runtime_error("Writer.writeRows expects an array of rows");
+            auto rows = std::get<std::shared_ptr<Array>>(args[0]);
+            for (auto& row : *rows) {
+                encodeRow(*h, row);
+                if (h->buffer.size() >= CsvWriterHandle::kFlushThreshold) flushWriter(interpPtr, *h);
+            }
+            return Value{static_cast<double>(rows->size())};
+        });
+        writerClass->methods["flush"] = method([interpPtr](const std::vector<Value>&, std::shared_ptr<Environment> clos) -> Value {
+            auto h = writerHandle(clos, "Writer.flush");
+            flushWriter(interpPtr, *h);
+            if (h->file.is_open()) h->file.flush();
+            return Value{std::monostate{}};
+        });
+        // close() -> number：写出剩余数据并关闭文件，返回总字节数 (流目标不会被 end)
+        writerClass->methods["close"] = method([interpPtr](const std::vector<Value>&, std::shared_ptr<Environment> clos) -> Value {
+            auto h = writerHandle(clos, "Writer.close");
+            flushWriter(interpPtr, *h);
+            if (h->file.is_open()) {
+                h->file.close();
+                if (h->file.fail()) throw std::runtime_error("csv.writer: close failed");
+            }
+            h->closed = true;
+            return Value{h->bytes};
+        });
+        writerClass->methods["rowCount"] = method([](const std::vector<Value>&, std::shared_ptr<Environment> clos) -> Value {
+            if (!clos) throw std::runtime_error("internal: instance method called without closure");
+            Value tv = clos->get("this");
+            auto pins = std::get_if<std::shared_ptr<Instance>>(&tv);
+            auto h = pins && *pins ? static_cast<CsvWriterHandle*>(static_cast<InstanceExt*>(pins->get())->nativeHandle) : nullptr;
+            return Value{h ? h->rows : 0.0};
+        });
+        (*csvPkg)["Writer"] = Value{writerClass};
+        std::weak_ptr<ClassInfo> weakWriterClass = writerClass;
+        (*csvPkg)["writer"] = Value{method([interpPtr, weakWriterClass](const std::vector<Value>& args, std::shared_ptr<Environment>) -> Value {
+            auto inst = std::make_shared<InstanceExt>();
+            inst->klass = weakWriterClass.lock();
+            openWriter(interpPtr, inst.get(), args, "csv.writer");
+            return Value{std::shared_ptr<Instance>(inst)};
+        })};
     };
     // Register under both names for compatibility
     interp.registerLazyPackage("csv", init);
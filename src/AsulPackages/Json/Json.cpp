@@ -1,11 +1,13 @@
 #include "Json.h"
+#include "JsonSchema.h"
 #include "../../AsulInterpreter.h"
 #include <sstream>
 
 namespace asul {
 
 void registerJsonPackage(Interpreter& interp) {
-	interp.registerLazyPackage("json", [](std::shared_ptr<Object> jsonPkg) {
+	Interpreter* interpPtr = &interp;
+	interp.registerLazyPackage("json", [interpPtr](std::shared_ptr<Object> jsonPkg) {
 
 		// parse(jsonString) -> ALang Value (simple JSON parser)
 		auto parseFn = std::make_shared<Function>(); parseFn->isBuiltin = true; parseFn->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
@@ -85,6 +87,13 @@ void registerJsonPackage(Interpreter& interp) {
 			};
 			return Value{ emit(args[0]) };
 		}; (*jsonPkg)["stringify"] = Value{ stringifyFn };
+
+		// parseAsync / stringifyAsync: 在工作线程上执行，返回 Promise
+		(*jsonPkg)["parseAsync"] = Value{ interpPtr->makeOffloadedBuiltin(parseFn) };
+		(*jsonPkg)["stringifyAsync"] = Value{ interpPtr->makeOffloadedBuiltin(stringifyFn) };
+
+		// compileSchema(schema) -> Schema：预编译的 JSON Schema 校验器
+		installJsonSchema(jsonPkg, parseFn);
 	});
 }
 
@@ -0,0 +1,664 @@
+#include "JsonSchema.h"
+#include "../../AsulInterpreter.h"
+#include <cmath>
+#include <optional>
+#include <regex>
+#include <sstream>
+
+namespace asul {
+
+namespace {
+
+// ----------- 编译后的校验树 -----------
+// schema 对象在 compileSchema 时一次性编译成 Node 数组：关键字拆成字段，pattern 预编译成 std::regex，
+// $ref 解析成节点下标 (可递归)。校验时只沿着节点走，不再查 schema 对象。
+enum TypeBit : uint32_t {
+	TNull = 1, TBoolean = 2, TObject = 4, TArray = 8, TNumber = 16, TInteger = 32, TString = 64
+};
+
+struct CompiledRegex {
+	std::string source;
+	std::regex re;
+};
+
+struct Node {
+	bool rejectAll{false};           // false schema
+	uint32_t types{0};               // 0 表示不限类型
+	int ref{-1};
+	std::optional<Value> constValue;
+	std::vector<Value> enumValues;
+	bool hasEnum{false};
+	std::optional<double> minimum, maximum, exclusiveMinimum, exclusiveMaximum, multipleOf;
+	std::optional<size_t> minLength, maxLength, minItems, maxItems, minProperties, maxProperties;
+	std::shared_ptr<CompiledRegex> pattern;
+	int items{-1};
+	std::vector<int> prefixItems;
+	int contains{-1};
+	bool uniqueItems{false};
+	std::unordered_map<std::string, int> properties;
+	std::vector<std::string> required;
+	std::vector<std::pair<std::shared_ptr<CompiledRegex>, int>> patternProperties;
+	int additionalProperties{-1};
+	int propertyNames{-1};
+	std::vector<std::pair<std::string, std::vector<std::string>>> dependentRequired;
+	std::vector<int> allOf, anyOf, oneOf;
+	int notSchema{-1}, ifSchema{-1}, thenSchema{-1}, elseSchema{-1};
+};
+
+struct SchemaError {
+	std::string path;     // JSON Pointer，根为 ""
+	std::string keyword;
+	std::string message;
+};
+
+struct CompiledSchema {
+	std::vector<Node> nodes;
+	int root{0};
+};
+
+using CompiledSchemaPtr = std::shared_ptr<const CompiledSchema>;
+
+const char* typeName(const Value& v) {
+	if (std::holds_alternative<std::monostate>(v)) return "null";
+	if (std::holds_alternative<bool>(v)) return "boolean";
+	if (std::holds_alternative<double>(v)) return "number";
+	if (std::holds_alternative<std::string>(v)) return "string";
+	if (std::holds_alternative<std::shared_ptr<Array>>(v)) return "array";
+	if (std::holds_alternative<std::shared_ptr<Object>>(v)) return "object";
+	return "unsupported value";
+}
+
+bool valueEquals(const Value& a, const Value& b) {
+	if (a.index() != b.index()) return false;
+	if (std::holds_alternative<std::monostate>(a)) return true;
+	if (auto x = std::get_if<double>(&a)) return *x == std::get<double>(b);
+	if (auto x = std::get_if<bool>(&a)) return *x == std::get<bool>(b);
+	if (auto x = std::get_if<std::string>(&a)) return *x == std::get<std::string>(b);
+	if (auto x = std::get_if<std::shared_ptr<Array>>(&a)) {
+		auto& y = std::get<std::shared_ptr<Array>>(b);
+		if (!*x || !y) return *x == y;
+		if ((*x)->size() != y->size()) return false;
+		for (size_t i = 0; i < y->size(); ++i) if (!valueEquals((**x)[i], (*y)[i])) return false;
+		return true;
+	}
+	if (auto x = std::get_if<std::shared_ptr<Object>>(&a)) {
+		auto& y = std::get<std::shared_ptr<Object>>(b);
+		if (!*x || !y) return *x == y;
+		if ((*x)->size() != y->size()) return false;
+		for (auto& kv : **x) {
+			auto it = y->find(kv.first);
+			if (it == y->end() || !valueEquals(kv.second, it->second)) return false;
+		}
+		return true;
+	}
+	return false;
+}
+
+// 与 valueEquals 一致的结构哈希：标量直接用 valueHash，数组按顺序组合，对象按键值对无序累加
+// (valueHash 对数组/对象只哈希地址，不能用来判断内容相同)
+size_t structuralHash(const Value& v) {
+	if (auto pa = std::get_if<std::shared_ptr<Array>>(&v); pa && *pa) {
+		uint64_t h = hashMix(0x5a, (*pa)->size());
+		for (auto& e : **pa) h = hashMix(h, structuralHash(e));
+		return static_cast<size_t>(h);
+	}
+	if (auto po = std::get_if<std::shared_ptr<Object>>(&v); po && *po) {
+		uint64_t h = 0;
+		for (auto& kv : **po) h += hashMix(hashBytes(kv.first.data(), kv.first.size()), structuralHash(kv.second));
+		return static_cast<size_t>(hashMix(h, (*po)->size()));
+	}
+	if (auto d = std::get_if<double>(&v); d && std::isnan(*d)) return 0; // NaN 彼此不等，放进同一桶也只是多比较几次
+	return valueHash(v);
+}
+
+size_t utf8Length(const std::string& s) {
+	size_t n = 0;
+	for (unsigned char c : s) if ((c & 0xC0) != 0x80) ++n;
+	return n;
+}
+
+std::string formatNumber(double d) {
+	std::ostringstream o; o << d; return o.str();
+}
+
+void appendPointerToken(std::string& path, const std::string& token) {
+	path.push_back('/');
+	for (char c : token) {
+		if (c == '~') path += "~0";
+		else if (c == '/') path += "~1";
+		else path.push_back(c);
+	}
+}
+
+// ----------- 编译 -----------
+class SchemaCompiler {
+public:
+	explicit SchemaCompiler(const Value& root) : root_(root) { out_ = std::make_shared<CompiledSchema>(); }
+
+	CompiledSchemaPtr run() {
+		out_->root = compile(root_, "#");
+		return out_;
+	}
+
+private:
+	const Value& root_;
+	std::shared_ptr<CompiledSchema> out_;
+	std::unordered_map<std::string, int> byPointer_;
+	std::unordered_map<std::string, std::shared_ptr<CompiledRegex>> regexes_;
+
+	[[noreturn]] void fail(const std::string& where, const std::string& msg) {
+		throw std::runtime_error("json.compileSchema: " + msg + " at " + where);
+	}
+
+	std::shared_ptr<CompiledRegex> regex(const std::string& src, const std::string& where) {
+		auto it = regexes_.find(src);
+		if (it != regexes_.end()) return it->second;
+		auto r = std::make_shared<CompiledRegex>();
+		r->source = src;
+		try { r->re = std::regex(src, std::regex::ECMAScript | std::regex::optimize); }
+		catch (const std::regex_error& e) { fail(where, "invalid pattern '" + src + "' (" + e.what() + ")"); }
+		regexes_.emplace(src, r);
+		return r;
+	}
+
+	double number(const Value& v, const std::string& where, const char* kw) {
+		auto d = std::get_if<double>(&v);
+		if (!d) fail(where, std::string("'") + kw + "' must be a number");
+		return *d;
+	}
+
+	size_t count(const Value& v, const std::string& where, const char* kw) {
+		auto d = std::get_if<double>(&v);
+		if (!d || *d < 0 || std::floor(*d) != *d) fail(where, std::string("'") + kw + "' must be a non-negative integer");
+		return static_cast<size_t>(*d);
+	}
+
+	std::vector<std::string> strings(const Value& v, const std::string& where, const char* kw) {
+		auto arr = std::get_if<std::shared_ptr<Array>>(&v);
+		if (!arr || !*arr) fail(where, std::string("'") + kw + "' must be an array of strings");
+		std::vector<std::string> out;
+		for (auto& item : **arr) {
+			auto s = std::get_if<std::string>(&item);
+			if (!s) fail(where, std::string("'") + kw + "' must be an array of strings");
+			out.push_back(*s);
+		}
+		return out;
+	}
+
+	std::vector<int> schemaList(const Value& v, const std::string& where, const char* kw) {
+		auto arr = std::get_if<std::shared_ptr<Array>>(&v);
+		if (!arr || !*arr || (*arr)->empty()) fail(where, std::string("'") + kw + "' must be a non-empty array of schemas");
+		std::vector<int> out;
+		for (size_t i = 0; i < (*arr)->size(); ++i) out.push_back(compile((**arr)[i], where + "/" + kw + "/" + std::to_string(i)));
+		return out;
+	}
+
+	uint32_t typeBit(const std::string& name, const std::string& where) {
+		if (name == "null") return TNull;
+		if (name == "boolean") return TBoolean;
+		if (name == "object") return TObject;
+		if (name == "array") return TArray;
+		if (name == "number") return TNumber;
+		if (name == "integer") return TInteger;
+		if (name == "string") return TString;
+		fail(where, "unknown type '" + name + "'");
+	}
+
+	// "#/$defs/x" 形式的本地引用，按 JSON Pointer 从根 schema 找到目标后编译
+	int resolveRef(const std::string& ref, const std::string& where) {
+		if (ref.empty() || ref[0] != '#') fail(where, "only local $ref ('#...') is supported, got '" + ref + "'");
+		auto it = byPointer_.find(ref);
+		if (it != byPointer_.end()) return it->second;
+		const Value* cur = &root_;
+		size_t i = 1;
+		if (i < ref.size() && ref[i] != '/') fail(where, "unsupported $ref '" + ref + "'");
+		while (i < ref.size()) {
+			size_t next = ref.find('/', i + 1);
+			std::string raw = ref.substr(i + 1, (next == std::string::npos ? ref.size() : next) - i - 1);
+			std::string token;
+			for (size_t k = 0; k < raw.size(); ++k) {
+				if (raw[k] == '~' && k + 1 < raw.size() && (raw[k + 1] == '0' || raw[k + 1] == '1')) { token.push_back(raw[k + 1] == '0' ? '~' : '/'); ++k; }
+				else token.push_back(raw[k]);
+			}
+			if (auto po = std::get_if<std::shared_ptr<Object>>(cur); po && *po) {
+				auto f = (*po)->find(token);
+				if (f == (*po)->end()) fail(where, "unresolvable $ref '" + ref + "'");
+				cur = &f->second;
+			} else if (auto pa = std::get_if<std::shared_ptr<Array>>(cur); pa && *pa) {
+				size_t idx = 0;
+				try { idx = static_cast<size_t>(std::stoul(token)); } catch (...) { fail(where, "unresolvable $ref '" + ref + "'"); }
+				if (idx >= (*pa)->size()) fail(where, "unresolvable $ref '" + ref + "'");
+				cur = &(**pa)[idx];
+			} else {
+				fail(where, "unresolvable $ref '" + ref + "'");
+			}
+			i = next == std::string::npos ? ref.size() : next;
+		}
+		return compile(*cur, ref);
+	}
+
+	int compile(const Value& schema, const std::string& where) {
+		auto known = byPointer_.find(where);
+		if (known != byPointer_.end()) return known->second;
+		int index = static_cast<int>(out_->nodes.size());
+		out_->nodes.emplace_back();
+		byPointer_.emplace(where, index);
+		// 子节点编译时 nodes 会扩容，所以先在局部构造，最后再放回
+		Node node;
+		if (auto b = std::get_if<bool>(&schema)) {
+			node.rejectAll = !*b;
+			out_->nodes[static_cast<size_t>(index)] = std::move(node);
+			return index;
+		}
+		auto po = std::get_if<std::shared_ptr<Object>>(&schema);
+		if (!po || !*po) fail(where, "schema must be an object or a boolean");
+		const Object& s = **po;
+		auto get = [&s](const char* key) -> const Value* {
+			auto it = s.find(key);
+			return it == s.end() ? nullptr : &it->second;
+		};
+
+		if (auto v = get("$ref")) {
+			auto r = std::get_if<std::string>(v);
+			if (!r) fail(where, "'$ref' must be a string");
+			node.ref = resolveRef(*r, where);
+		}
+		if (auto v = get("type")) {
+			if (auto t = std::get_if<std::string>(v)) node.types = typeBit(*t, where);
+			else for (auto& t : strings(*v, where, "type")) node.types |= typeBit(t, where);
+		}
+		if (auto v = get("const")) node.constValue = *v;
+		if (auto v = get("enum")) {
+			auto arr = std::get_if<std::shared_ptr<Array>>(v);
+			if (!arr || !*arr) fail(where, "'enum' must be an array");
+			node.enumValues = **arr;
+			node.hasEnum = true;
+		}
+
+		if (auto v = get("minimum")) node.minimum = number(*v, where, "minimum");
+		if (auto v = get("maximum")) node.maximum = number(*v, where, "maximum");
+		if (auto v = get("exclusiveMinimum")) node.exclusiveMinimum = number(*v, where, "exclusiveMinimum");
+		if (auto v = get("exclusiveMaximum")) node.exclusiveMaximum = number(*v, where, "exclusiveMaximum");
+		if (auto v = get("multipleOf")) {
+			node.multipleOf = number(*v, where, "multipleOf");
+			if (*node.multipleOf <= 0) fail(where, "'multipleOf' must be greater than 0");
+		}
+
+		if (auto v = get("minLength")) node.minLength = count(*v, where, "minLength");
+		if (auto v = get("maxLength")) node.maxLength = count(*v, where, "maxLength");
+		if (auto v = get("pattern")) {
+			auto p = std::get_if<std::string>(v);
+			if (!p) fail(where, "'pattern' must be a string");
+			node.pattern = regex(*p, where);
+		}
+
+		if (auto v = get("prefixItems")) node.prefixItems = schemaList(*v, where, "prefixItems");
+		if (auto v = get("items")) {
+			// draft-07 的数组形式 items 等价于 prefixItems，此时 additionalItems 约束其余元素
+			if (std::holds_alternative<std::shared_ptr<Array>>(*v)) {
+				node.prefixItems = schemaList(*v, where, "items");
+				if (auto extra = get("additionalItems")) node.items = compile(*extra, where + "/additionalItems");
+			} else {
+				node.items = compile(*v, where + "/items");
+			}
+		}
+		if (auto v = get("contains")) node.contains = compile(*v, where + "/contains");
+		if (auto v = get("minItems")) node.minItems = count(*v, where, "minItems");
+		if (auto v = get("maxItems")) node.maxItems = count(*v, where, "maxItems");
+		if (auto v = get("uniqueItems")) node.uniqueItems = isTruthy(*v);
+
+		if (auto v = get("properties")) {
+			auto props = std::get_if<std::shared_ptr<Object>>(v);
+			if (!props || !*props) fail(where, "'properties' must be an object");
+			for (auto& kv : **props) {
+				std::string at = where + "/properties";
+				appendPointerToken(at, kv.first);
+				node.properties.emplace(kv.first, compile(kv.second, at));
+			}
+		}
+		if (auto v = get("required")) node.required = strings(*v, where, "required");
+		if (auto v = get("patternProperties")) {
+			auto props = std::get_if<std::shared_ptr<Object>>(v);
+			if (!props || !*props) fail(where, "'patternProperties' must be an object");
+			for (auto& kv : **props) {
+				std::string at = where + "/patternProperties";
+				appendPointerToken(at, kv.first);
+				node.patternProperties.emplace_back(regex(kv.first, at), compile(kv.second, at));
+			}
+		}
+		if (auto v = get("additionalProperties")) node.additionalProperties = compile(*v, where + "/additionalProperties");
+		if (auto v = get("propertyNames")) node.propertyNames = compile(*v, where + "/propertyNames");
+		if (auto v = get("minProperties")) node.minProperties = count(*v, where, "minProperties");
+		if (auto v = get("maxProperties")) node.maxProperties = count(*v, where, "maxProperties");
+		if (auto v = get("dependentRequired")) {
+			auto deps = std::get_if<std::shared_ptr<Object>>(v);
+			if (!deps || !*deps) fail(where, "'dependentRequired' must be an object");
+			for (auto& kv : **deps) node.dependentRequired.emplace_back(kv.first, strings(kv.second, where, "dependentRequired"));
+		}
+
+		if (auto v = get("allOf")) node.allOf = schemaList(*v, where, "allOf");
+		if (auto v = get("anyOf")) node.anyOf = schemaList(*v, where, "anyOf");
+		if (auto v = get("oneOf")) node.oneOf = schemaList(*v, where, "oneOf");
+		if (auto v = get("not")) node.notSchema = compile(*v, where + "/not");
+		if (auto v = get("if")) {
+			node.ifSchema = compile(*v, where + "/if");
+			if (auto t = get("then")) node.thenSchema = compile(*t, where + "/then");
+			if (auto e = get("else")) node.elseSchema = compile(*e, where + "/else");
+		}
+
+		out_->nodes[static_cast<size_t>(index)] = std::move(node);
+		return index;
+	}
+};
+
+// ----------- 校验 -----------
+// errors 为 nullptr 时只求真假：遇到第一个错误立即返回，也不拼接路径
+class SchemaChecker {
+public:
+	SchemaChecker(const CompiledSchema& schema, std::vector<SchemaError>* errors, size_t maxErrors = 100)
+		: schema_(schema), errors_(errors), maxErrors_(maxErrors) {}
+
+	bool run(const Value& v) {
+		std::string path;
+		return check(schema_.root, v, path);
+	}
+
+private:
+	const CompiledSchema& schema_;
+	std::vector<SchemaError>* errors_;
+	size_t maxErrors_;
+	size_t depth_{0};
+
+	bool report(const std::string& path, const char* keyword, std::string message) {
+		if (errors_ && errors_->size() < maxErrors_) errors_->push_back(SchemaError{ path, keyword, std::move(message) });
+		return false;
+	}
+
+	bool full() const { return !errors_ || errors_->size() >= maxErrors_; }
+
+	// 组合关键字只需要真假，用不收集错误的子校验器
+	bool matches(int node, const Value& v) {
+		SchemaChecker probe(schema_, nullptr);
+		probe.depth_ = depth_;
+		std::string path;
+		return probe.check(node, v, path);
+	}
+
+	bool checkChild(int node, const Value& v, std::string& path, const std::string& token) {
+		size_t mark = path.size();
+		if (errors_) appendPointerToken(path, token);
+		bool ok = check(node, v, path);
+		path.resize(mark);
+		return ok;
+	}
+
+	bool check(int index, const Value& v, std::string& path) {
+		if (++depth_ > 512) { --depth_; throw std::runtime_error("json schema: validation nested too deeply (recursive $ref?)"); }
+		bool ok = checkNode(schema_.nodes[static_cast<size_t>(index)], v, path);
+		--depth_;
+		return ok;
+	}
+
+	bool checkNode(const Node& n, const Value& v, std::string& path) {
+		if (n.rejectAll) return report(path, "false", "no value is allowed here");
+		bool ok = true;
+		auto step = [&](bool passed) {
+			if (!passed) ok = false;
+			return passed || !full();
+		};
+
+		if (n.ref >= 0 && !step(check(n.ref, v, path))) return false;
+
+		if (n.types) {
+			uint32_t bit = 0;
+			if (std::holds_alternative<std::monostate>(v)) bit = TNull;
+			else if (std::holds_alternative<bool>(v)) bit = TBoolean;
+			else if (auto d = std::get_if<double>(&v)) bit = TNumber | (std::isfinite(*d) && std::floor(*d) == *d ? static_cast<uint32_t>(TInteger) : 0u);
+			else if (std::holds_alternative<std::string>(v)) bit = TString;
+			else if (std::holds_alternative<std::shared_ptr<Array>>(v)) bit = TArray;
+			else if (std::holds_alternative<std::shared_ptr<Object>>(v)) bit = TObject;
+			if (!(n.types & bit)) {
+				std::string expected;
+				static const char* names[] = { "null", "boolean", "object", "array", "number", "integer", "string" };
+				for (int i = 0; i < 7; ++i) if (n.types & (1u << i)) { if (!expected.empty()) expected += " or "; expected += names[i]; }
+				// 类型不对时其余关键字大多没有意义，直接返回
+				return report(path, "type", "expected " + expected + ", got " + typeName(v));
+			}
+		}
+		if (n.constValue && !step(valueEquals(v, *n.constValue) || report(path, "const", "must be equal to the constant " + toString(*n.constValue)))) return false;
+		if (n.hasEnum) {
+			bool found = false;
+			for (auto& e : n.enumValues) if (valueEquals(v, e)) { found = true; break; }
+			if (!step(found || report(path, "enum", "must be one of the allowed values"))) return false;
+		}
+
+		if (auto d = std::get_if<double>(&v)) {
+			if (n.minimum && !step(*d >= *n.minimum || report(path, "minimum", "must be >= " + formatNumber(*n.minimum)))) return false;
+			if (n.maximum && !step(*d <= *n.maximum || report(path, "maximum", "must be <= " + formatNumber(*n.maximum)))) return false;
+			if (n.exclusiveMinimum && !step(*d > *n.exclusiveMinimum || report(path, "exclusiveMinimum", "must be > " + formatNumber(*n.exclusiveMinimum)))) return false;
+			if (n.exclusiveMaximum && !step(*d < *n.exclusiveMaximum || report(path, "exclusiveMaximum", "must be < " + formatNumber(*n.exclusiveMaximum)))) return false;
+			if (n.multipleOf) {
+				double q = *d / *n.multipleOf;
+				bool multiple = std::isfinite(q) && std::fabs(q - std::round(q)) <= 1e-9 * std::max(1.0, std::fabs(q));
+				if (!step(multiple || report(path, "multipleOf", "must be a multiple of " + formatNumber(*n.multipleOf)))) return false;
+			}
+		} else if (auto s = std::get_if<std::string>(&v)) {
+			if (n.minLength || n.maxLength) {
+				size_t len = utf8Length(*s);
+				if (n.minLength && !step(len >= *n.minLength || report(path, "minLength", "must have at least " + std::to_string(*n.minLength) + " characters"))) return false;
+				if (n.maxLength && !step(len <= *n.maxLength || report(path, "maxLength", "must have at most " + std::to_string(*n.maxLength) + " characters"))) return false;
+			}
+			if (n.pattern && !step(std::regex_search(*s, n.pattern->re) || report(path, "pattern", "must match pattern '" + n.pattern->source + "'"))) return false;
+		} else if (auto pa = std::get_if<std::shared_ptr<Array>>(&v); pa && *pa) {
+			const Array& arr = **pa;
+			if (n.minItems && !step(arr.size() >= *n.minItems || report(path, "minItems", "must have at least " + std::to_string(*n.minItems) + " items"))) return false;
+			if (n.maxItems && !step(arr.size() <= *n.maxItems || report(path, "maxItems", "must have at most " + std::to_string(*n.maxItems) + " items"))) return false;
+			for (size_t i = 0; i < arr.size(); ++i) {
+				int item = i < n.prefixItems.size() ? n.prefixItems[i] : n.items;
+				if (item >= 0 && !step(checkChild(item, arr[i], path, std::to_string(i)))) return false;
+			}
+			if (n.contains >= 0) {
+				bool any = false;
+				for (auto& item : arr) if (matches(n.contains, item)) { any = true; break; }
+				if (!step(any || report(path, "contains", "must contain at least one matching item"))) return false;
+			}
+			if (n.uniqueItems) {
+				// 按结构哈希分桶，只在桶内用 valueEquals 比较：O(n) 而不是两两比较的 O(n²)
+				std::unordered_map<size_t, std::vector<size_t>> buckets;
+				buckets.reserve(arr.size());
+				for (size_t i = 0; i < arr.size(); ++i) {
+					auto& bucket = buckets[structuralHash(arr[i])];
+					for (size_t j : bucket) {
+						if (valueEquals(arr[i], arr[j])) {
+							if (!step(report(path, "uniqueItems", "items " + std::to_string(j) + " and " + std::to_string(i) + " are identical"))) return false;
+							i = arr.size();
+							break;
+						}
+					}
+					if (i < arr.size()) bucket.push_back(i);
+				}
+			}
+		} else if (auto po = std::get_if<std::shared_ptr<Object>>(&v); po && *po) {
+			const Object& obj = **po;
+			if (n.minProperties && !step(obj.size() >= *n.minProperties || report(path, "minProperties", "must have at least " + std::to_string(*n.minProperties) + " properties"))) return false;
+			if (n.maxProperties && !step(obj.size() <= *n.maxProperties || report(path, "maxProperties", "must have at most " + std::to_string(*n.maxProperties) + " properties"))) return false;
+			for (auto& name : n.required) {
+				if (obj.find(name) != obj.end()) continue;
+				ok = false;
+				if (errors_) {
+					size_t mark = path.size();
+					appendPointerToken(path, name);
+					report(path, "required", "is required");
+					path.resize(mark);
+				}
+				if (full()) return false;
+			}
+			for (auto& dep : n.dependentRequired) {
+				if (obj.find(dep.first) == obj.end()) continue;
+				for (auto& name : dep.second) {
+					if (obj.find(name) != obj.end()) continue;
+					ok = false;
+					if (errors_) {
+						size_t mark = path.size();
+						appendPointerToken(path, name);
+						report(path, "dependentRequired", "is required when '" + dep.first + "' is present");
+						path.resize(mark);
+					}
+					if (full()) return false;
+				}
+			}
+			bool perKey = !n.properties.empty() || !n.patternProperties.empty() || n.additionalProperties >= 0 || n.propertyNames >= 0;
+			if (perKey) {
+				for (auto& kv : obj) {
+					if (n.propertyNames >= 0 && !step(matches(n.propertyNames, Value{ kv.first }) || report(path, "propertyNames", "property name '" + kv.first + "' is invalid"))) return false;
+					bool matched = false;
+					auto prop = n.properties.find(kv.first);
+					if (prop != n.properties.end()) {
+						matched = true;
+						if (!step(checkChild(prop->second, kv.second, path, kv.first))) return false;
+					}
+					for (auto& pp : n.patternProperties) {
+						if (!std::regex_search(kv.first, pp.first->re)) continue;
+						matched = true;
+						if (!step(checkChild(pp.second, kv.second, path, kv.first))) return false;
+					}
+					if (!matched && n.additionalProperties >= 0) {
+						const Node& extra = schema_.nodes[static_cast<size_t>(n.additionalProperties)];
+						if (extra.rejectAll) {
+							size_t mark = path.size();
+							if (errors_) appendPointerToken(path, kv.first);
+							report(path, "additionalProperties", "is not an allowed property");
+							path.resize(mark);
+							ok = false;
+							if (full()) return false;
+						} else if (!step(checkChild(n.additionalProperties, kv.second, path, kv.first))) {
+							return false;
+						}
+					}
+				}
+			}
+		}
+
+		for (int sub : n.allOf) if (!step(check(sub, v, path))) return false;
+		if (!n.anyOf.empty()) {
+			bool any = false;
+			for (int sub : n.anyOf) if (matches(sub, v)) { any = true; break; }
+			if (!step(any || report(path, "anyOf", "must match at least one schema in anyOf"))) return false;
+		}
+		if (!n.oneOf.empty()) {
+			size_t hits = 0;
+			for (int sub : n.oneOf) if (matches(sub, v) && ++hits > 1) break;
+			if (!step(hits == 1 || report(path, "oneOf", hits ? "must match exactly one schema in oneOf, matched several" : "must match exactly one schema in oneOf, matched none"))) return false;
+		}
+		if (n.notSchema >= 0 && !step(!matches(n.notSchema, v) || report(path, "not", "must not match the schema in 'not'"))) return false;
+		if (n.ifSchema >= 0) {
+			int branch = matches(n.ifSchema, v) ? n.thenSchema : n.elseSchema;
+			if (branch >= 0 && !step(check(branch, v, path))) return false;
+		}
+		return ok;
+	}
+};
+
+std::string describe(const SchemaError& e) {
+	return (e.path.empty() ? std::string("(root)") : e.path) + ": " + e.message;
+}
+
+struct SchemaHandle {
+	CompiledSchemaPtr schema;
+};
+
+using NativeFn = std::function<Value(const std::vector<Value>&, std::shared_ptr<Environment>)>;
+
+std::shared_ptr<Function> builtin(NativeFn fn) {
+	auto f = std::make_shared<Function>();
+	f->isBuiltin = true;
+	f->builtin = std::move(fn);
+	return f;
+}
+
+InstanceExt* thisInstance(const std::shared_ptr<Environment>& clos) {
+	if (!clos) throw std::runtime_error("internal: instance method called without closure");
+	Value tv = clos->get("this");
+	auto pins = std::get_if<std::shared_ptr<Instance>>(&tv);
+	if (!pins || !*pins) throw std::runtime_error("internal: invalid 'this' value");
+	return static_cast<InstanceExt*>(pins->get());
+}
+
+const CompiledSchema& schemaOf(const std::shared_ptr<Environment>& clos, const char* what) {
+	auto h = static_cast<SchemaHandle*>(thisInstance(clos)->nativeHandle);
+	if (!h || !h->schema) throw std::runtime_error(std::string(what) + ": schema not initialized");
+	return *h->schema;
+}
+
+void attachSchema(InstanceExt* inst, const std::vector<Value>& args, const char* what) {
+	if (args.size() != 1) throw std::runtime_error(std::string(what) + " expects 1 argument (schema object)");
+	auto compiled = SchemaCompiler(args[0]).run();
+	if (inst->nativeHandle && inst->nativeDestructor) inst->nativeDestructor(inst->nativeHandle);
+	inst->nativeHandle = new SchemaHandle{ std::move(compiled) };
+	inst->nativeDestructor = [](void* p) { delete static_cast<SchemaHandle*>(p); };
+}
+
+// 校验失败时抛出第一条错误 (路径 + 原因)
+void assertValid(const CompiledSchema& schema, const Value& v) {
+	std::vector<SchemaError> errors;
+	if (SchemaChecker(schema, &errors, 1).run(v)) return;
+	throw std::runtime_error("json schema validation failed at " + describe(errors.front()));
+}
+
+} // namespace
+
+void installJsonSchema(std::shared_ptr<Object> jsonPkg, std::shared_ptr<Function> parseFn) {
+	auto schemaClass = std::make_shared<ClassInfo>(); schemaClass->name = "Schema"; schemaClass->isNative = true;
+	schemaClass->methods["constructor"] = builtin([](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		attachSchema(thisInstance(clos), args, "Schema");
+		return Value{ std::monostate{} };
+	});
+	// validate(value) -> { valid, errors: [{ path, keyword, message }] }
+	schemaClass->methods["validate"] = builtin([](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		if (args.size() != 1) throw std::runtime_error("Schema.validate expects 1 argument (value)");
+		std::vector<SchemaError> errors;
+		bool valid = SchemaChecker(schemaOf(clos, "Schema.validate"), &errors).run(args[0]);
+		auto list = std::make_shared<Array>();
+		for (auto& e : errors) {
+			auto item = std::make_shared<Object>();
+			(*item)["path"] = Value{ e.path };
+			(*item)["keyword"] = Value{ e.keyword };
+			(*item)["message"] = Value{ describe(e) };
+			list->push_back(Value{ item });
+		}
+		auto result = std::make_shared<Object>();
+		(*result)["valid"] = Value{ valid };
+		(*result)["errors"] = Value{ list };
+		return Value{ result };
+	});
+	// isValid(value) -> bool：不收集错误，遇到第一处不符即返回
+	schemaClass->methods["isValid"] = builtin([](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		if (args.size() != 1) throw std::runtime_error("Schema.isValid expects 1 argument (value)");
+		return Value{ SchemaChecker(schemaOf(clos, "Schema.isValid"), nullptr).run(args[0]) };
+	});
+	// assert(value) -> value，不符合时抛出带路径的错误
+	schemaClass->methods["assert"] = builtin([](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		if (args.size() != 1) throw std::runtime_error("Schema.assert expects 1 argument (value)");
+		assertValid(schemaOf(clos, "Schema.assert"), args[0]);
+		return args[0];
+	});
+	// parse(text) -> value：解析 JSON 并立即校验，中间值不经过脚本层
+	schemaClass->methods["parse"] = builtin([parseFn](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		const CompiledSchema& schema = schemaOf(clos, "Schema.parse");
+		Value parsed = parseFn->builtin(args, nullptr);
+		assertValid(schema, parsed);
+		return parsed;
+	});
+	(*jsonPkg)["Schema"] = Value{ schemaClass };
+
+	// compileSchema(schema) -> Schema
+	std::weak_ptr<ClassInfo> weakClass = schemaClass;
+	(*jsonPkg)["compileSchema"] = Value{ builtin([weakClass](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+		auto inst = std::make_shared<InstanceExt>();
+		inst->klass = weakClass.lock();
+		attachSchema(inst.get(), args, "json.compileSchema");
+		return Value{ std::shared_ptr<Instance>(inst) };
+	}) };
+}
+
+} // namespace asul
@@ -0,0 +1,14 @@
+#ifndef JSON_SCHEMA_H
+#define JSON_SCHEMA_H
+
+#include "../../AsulRuntime.h"
+
+namespace asul {
+
+// Install json.compileSchema and the native Schema class into the json package object.
+// parseFn is json.parse, reused by Schema.parse(text) to parse and validate in one native call.
+void installJsonSchema(std::shared_ptr<Object> jsonPkg, std::shared_ptr<Function> parseFn);
+
+} // namespace asul
+
+#endif // JSON_SCHEMA_H
@@ -262,6 +262,7 @@ void registerStdBuiltinPackage(Interpreter& interp) {
 							auto s2 = ps2.parse();
 							if (s2.size() == 1) {
 								if (auto es = std::dynamic_pointer_cast<ExprStmt>(s2[0])) {
+									interpPtr->noteScopeBindings(s2);
 									auto evalEnv = std::make_shared<Environment>(interpPtr->currentEnv());
 									auto prev = interpPtr->currentEnv(); interpPtr->setCurrentEnv(evalEnv);
 									try { Value v = interpPtr->evaluate(es->expr); interpPtr->setCurrentEnv(prev); return v; } catch(...) { interpPtr->setCurrentEnv(prev); throw; }
@@ -272,6 +273,7 @@ void registerStdBuiltinPackage(Interpreter& interp) {
 					}
 				}
 				// execute in a child environment so we don't pollute caller
+				interpPtr->noteScopeBindings(stmts);
 				auto evalEnv = std::make_shared<Environment>(interpPtr->currentEnv());
 				if (stmts.empty()) return Value{std::monostate{}};
 				if (stmts.size() == 1) {
@@ -315,6 +317,16 @@ void registerStdBuiltinPackage(Interpreter& interp) {
 			};
 			globals->define("sleep", sleepFn);
 
+			// offload(fn, ...args): 在共享工作线程池上调用纯本地 builtin (如 json.parse)，返回 Promise
+			auto offloadFn = std::make_shared<Function>();
+			offloadFn->isBuiltin = true;
+			offloadFn->builtin = [interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment>) -> Value{
+				if (args.empty() || !std::holds_alternative<std::shared_ptr<Function>>(args[0])) throw std::runtime_error("offload 需要 (fn, ...args)，fn 为可卸载的内建函数");
+				std::vector<Value> rest(args.begin() + 1, args.end());
+				return Value{ interpPtr->offloadCall(std::get<std::shared_ptr<Function>>(args[0]), std::move(rest)) };
+			};
+			globals->define("offload", offloadFn);
+
 			// Promise 对象：resolve / reject
 			auto promiseObj = std::make_shared<Object>();
 			// Promise.resolve(value)
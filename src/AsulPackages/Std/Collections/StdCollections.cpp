@@ -3,9 +3,639 @@
 #include <algorithm>
 #include <queue>
 #include <deque>
+#include <cmath>
+#include <cstring>
 
 namespace asul {
 
+namespace {
+
+// ----------- Binary serialization -----------
+// 小端序定长编码，serialize() 的结果与平台无关
+
+struct ByteWriter {
+	std::string out;
+	void u8(uint8_t v) { out.push_back(static_cast<char>(v)); }
+	void u16(uint16_t v) { u8(static_cast<uint8_t>(v)); u8(static_cast<uint8_t>(v >> 8)); }
+	void u32(uint32_t v) { for (int i = 0; i < 4; ++i) u8(static_cast<uint8_t>(v >> (8 * i))); }
+	void u64(uint64_t v) { for (int i = 0; i < 8; ++i) u8(static_cast<uint8_t>(v >> (8 * i))); }
+	void f64(double d) { uint64_t bits; std::memcpy(&bits, &d, sizeof(bits)); u64(bits); }
+};
+
+struct ByteReader {
+	const std::string& in;
+	const char* what;
+	size_t pos{0};
+	ByteReader(const std::string& data, const char* name) : in(data), what(name) {}
+	void need(size_t n) { if (in.size() - pos < n) throw std::runtime_error(std::string(what) + ": truncated data"); }
+	uint8_t u8() { need(1); return static_cast<uint8_t>(in[pos++]); }
+	uint16_t u16() { uint16_t lo = u8(); return static_cast<uint16_t>(lo | (u8() << 8)); }
+	uint32_t u32() { uint32_t v = 0; for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(u8()) << (8 * i); return v; }
+	uint64_t u64() { uint64_t v = 0; for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(u8()) << (8 * i); return v; }
+	double f64() { uint64_t bits = u64(); double d; std::memcpy(&d, &bits, sizeof(d)); return d; }
+	void magic(const char* tag) {
+		need(4);
+		if (in.compare(pos, 4, tag) != 0) throw std::runtime_error(std::string(what) + ": not a " + tag + " payload");
+		pos += 4;
+	}
+	void finish() { if (pos != in.size()) throw std::runtime_error(std::string(what) + ": trailing bytes"); }
+};
+
+// ----------- Probabilistic sketches -----------
+// 哈希使用固定种子的 valueHash(v, seed)：序列化后的结构在别的进程里仍可查询、合并。
+// k 个位置由双重哈希 h1 + i*h2 生成 (Kirsch-Mitzenmacher)。
+
+constexpr uint64_t kSketchSeed = 0x6a09e667f3bcc909ULL;
+
+inline uint64_t sketchHash(const Value& v) { return valueHash(v, kSketchSeed); }
+inline uint64_t secondHash(uint64_t h) { return hashMix(h, 0x9e3779b97f4a7c15ULL) | 1; }
+
+struct NativeBloomFilter {
+	uint64_t bits{0};
+	uint32_t hashes{0};
+	uint64_t capacity{0};
+	double fpRate{0};
+	std::vector<uint64_t> words;
+
+	bool add(uint64_t h) {
+		bool changed = false;
+		uint64_t h2 = secondHash(h);
+		for (uint32_t i = 0; i < hashes; ++i) {
+			uint64_t bit = (h + i * h2) % bits;
+			uint64_t mask = uint64_t{1} << (bit & 63);
+			changed |= (words[bit >> 6] & mask) == 0;
+			words[bit >> 6] |= mask;
+		}
+		return changed;
+	}
+	bool has(uint64_t h) const {
+		uint64_t h2 = secondHash(h);
+		for (uint32_t i = 0; i < hashes; ++i) {
+			uint64_t bit = (h + i * h2) % bits;
+			if (!(words[bit >> 6] & (uint64_t{1} << (bit & 63)))) return false;
+		}
+		return true;
+	}
+	uint64_t setBits() const {
+		uint64_t n = 0;
+		for (uint64_t w : words) n += static_cast<uint64_t>(__builtin_popcountll(w));
+		return n;
+	}
+};
+
+// 按期望元素数 n 与误判率 p 计算位数 m = -n ln p / ln²2，哈希个数 k = m/n ln2
+NativeBloomFilter* newBloomFilter(const std::vector<Value>& args) {
+	if (args.empty() || args.size() > 2) throw std::runtime_error("BloomFilter expects (expectedItems [, falsePositiveRate])");
+	double n = getNumber(args[0], "BloomFilter expectedItems");
+	double p = args.size() == 2 ? getNumber(args[1], "BloomFilter falsePositiveRate") : 0.01;
+	if (!(n >= 1)) throw std::runtime_error("BloomFilter: expectedItems must be >= 1");
+	if (!(p > 0 && p < 1)) throw std::runtime_error("BloomFilter: falsePositiveRate must be in (0, 1)");
+	const double ln2 = std::log(2.0);
+	double m = std::ceil(-n * std::log(p) / (ln2 * ln2));
+	if (m > 68719476736.0) throw std::runtime_error("BloomFilter: filter would exceed 8 GiB");
+	auto bf = new NativeBloomFilter();
+	bf->bits = std::max<uint64_t>(64, (static_cast<uint64_t>(m) + 63) & ~uint64_t{63});
+	bf->hashes = static_cast<uint32_t>(std::max(1.0, std::round(static_cast<double>(bf->bits) / n * ln2)));
+	bf->capacity = static_cast<uint64_t>(n);
+	bf->fpRate = p;
+	bf->words.assign(bf->bits / 64, 0);
+	return bf;
+}
+
+struct NativeHyperLogLog {
+	uint32_t precision{14};
+	std::vector<uint8_t> registers;
+
+	bool add(uint64_t h) {
+		uint64_t idx = h >> (64 - precision);
+		uint64_t w = (h << precision) | (uint64_t{1} << (precision - 1));
+		uint8_t rank = static_cast<uint8_t>(__builtin_clzll(w) + 1);
+		if (registers[idx] >= rank) return false;
+		registers[idx] = rank;
+		return true;
+	}
+	double estimate() const {
+		const double m = static_cast<double>(registers.size());
+		double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+		double sum = 0; size_t zeros = 0;
+		for (uint8_t r : registers) { sum += std::ldexp(1.0, -r); if (!r) ++zeros; }
+		double e = alpha * m * m / sum;
+		// 小基数时改用线性计数；64 位哈希不需要大基数修正
+		if (e <= 2.5 * m && zeros) e = m * std::log(m / static_cast<double>(zeros));
+		return std::round(e);
+	}
+	double standardError() const { return 1.04 / std::sqrt(static_cast<double>(registers.size())); }
+};
+
+NativeHyperLogLog* newHyperLogLog(const std::vector<Value>& args) {
+	if (args.size() > 1) throw std::runtime_error("HyperLogLog expects ([precision])");
+	double p = args.empty() ? 14 : getNumber(args[0], "HyperLogLog precision");
+	if (!(p >= 4 && p <= 18) || std::floor(p) != p) throw std::runtime_error("HyperLogLog: precision must be an integer in [4, 18]");
+	auto hll = new NativeHyperLogLog();
+	hll->precision = static_cast<uint32_t>(p);
+	hll->registers.assign(size_t{1} << hll->precision, 0);
+	return hll;
+}
+
+struct NativeCountMinSketch {
+	uint32_t width{0};
+	uint32_t depth{0};
+	double epsilon{0};
+	double delta{0};
+	uint64_t total{0};
+	std::vector<uint64_t> table; // depth 行 x width 列
+
+	uint64_t add(uint64_t h, uint64_t count) {
+		uint64_t h2 = secondHash(h), est = UINT64_MAX;
+		for (uint32_t r = 0; r < depth; ++r) {
+			uint64_t& c = table[static_cast<size_t>(r) * width + (h + r * h2) % width];
+			c += count;
+			est = std::min(est, c);
+		}
+		total += count;
+		return est;
+	}
+	uint64_t estimate(uint64_t h) const {
+		uint64_t h2 = secondHash(h), est = UINT64_MAX;
+		for (uint32_t r = 0; r < depth; ++r) est = std::min(est, table[static_cast<size_t>(r) * width + (h + r * h2) % width]);
+		return est;
+	}
+};
+
+// 宽度 w = ⌈e/ε⌉、深度 d = ⌈ln(1/δ)⌉：估计值至多高出 ε·total 的概率不超过 δ
+NativeCountMinSketch* newCountMinSketch(const std::vector<Value>& args) {
+	if (args.size() > 2) throw std::runtime_error("CountMinSketch expects ([epsilon [, delta]])");
+	double eps = args.size() >= 1 ? getNumber(args[0], "CountMinSketch epsilon") : 0.001;
+	double delta = args.size() == 2 ? getNumber(args[1], "CountMinSketch delta") : 0.01;
+	if (!(eps > 0 && eps < 1)) throw std::runtime_error("CountMinSketch: epsilon must be in (0, 1)");
+	if (!(delta > 0 && delta < 1)) throw std::runtime_error("CountMinSketch: delta must be in (0, 1)");
+	double w = std::ceil(std::exp(1.0) / eps), d = std::ceil(std::log(1.0 / delta));
+	if (w * d > 1073741824.0) throw std::runtime_error("CountMinSketch: table would exceed 8 GiB");
+	auto cms = new NativeCountMinSketch();
+	cms->width = static_cast<uint32_t>(w);
+	cms->depth = static_cast<uint32_t>(std::max(1.0, d));
+	cms->epsilon = eps;
+	cms->delta = delta;
+	cms->table.assign(static_cast<size_t>(cms->width) * cms->depth, 0);
+	return cms;
+}
+
+// ----------- Roaring bitmap -----------
+// 32 位整数按高 16 位分桶；每个桶 (container) 稀疏时是有序 uint16 数组，
+// 超过 4096 个元素后换成 65536 位的位图。位图之间的并/交/差是定长逐字循环，编译器会向量化。
+
+constexpr uint32_t kArrayMax = 4096;
+constexpr size_t kBitmapWords = 1024;
+
+inline uint32_t popcountWords(const uint64_t* w) {
+	uint32_t n = 0;
+	for (size_t i = 0; i < kBitmapWords; ++i) n += static_cast<uint32_t>(__builtin_popcountll(w[i]));
+	return n;
+}
+
+struct RoaringContainer {
+	uint16_t key{0};
+	uint32_t card{0};
+	std::vector<uint16_t> array;  // 有序，card <= kArrayMax
+	std::vector<uint64_t> bitmap; // kBitmapWords 个字，card > kArrayMax
+
+	bool isBitmap() const { return !bitmap.empty(); }
+	bool contains(uint16_t low) const {
+		if (isBitmap()) return (bitmap[low >> 6] >> (low & 63)) & 1;
+		return std::binary_search(array.begin(), array.end(), low);
+	}
+	void loadWords(std::vector<uint64_t>& words) const {
+		if (isBitmap()) { words = bitmap; return; }
+		words.assign(kBitmapWords, 0);
+		for (uint16_t v : array) words[v >> 6] |= uint64_t{1} << (v & 63);
+	}
+	void toBitmap() {
+		if (isBitmap()) return;
+		loadWords(bitmap);
+		std::vector<uint16_t>().swap(array);
+	}
+	// 位图元素不多时退回数组形式
+	void normalize() {
+		if (!isBitmap() || card > kArrayMax) return;
+		array.clear();
+		array.reserve(card);
+		for (size_t i = 0; i < kBitmapWords; ++i) {
+			for (uint64_t w = bitmap[i]; w; w &= w - 1) array.push_back(static_cast<uint16_t>(i * 64 + __builtin_ctzll(w)));
+		}
+		std::vector<uint64_t>().swap(bitmap);
+	}
+	bool add(uint16_t low) {
+		if (isBitmap()) {
+			uint64_t& w = bitmap[low >> 6];
+			uint64_t m = uint64_t{1} << (low & 63);
+			if (w & m) return false;
+			w |= m; ++card;
+			return true;
+		}
+		auto it = std::lower_bound(array.begin(), array.end(), low);
+		if (it != array.end() && *it == low) return false;
+		array.insert(it, low); ++card;
+		if (card > kArrayMax) toBitmap();
+		return true;
+	}
+	bool remove(uint16_t low) {
+		if (isBitmap()) {
+			uint64_t& w = bitmap[low >> 6];
+			uint64_t m = uint64_t{1} << (low & 63);
+			if (!(w & m)) return false;
+			w &= ~m; --card;
+			normalize();
+			return true;
+		}
+		auto it = std::lower_bound(array.begin(), array.end(), low);
+		if (it == array.end() || *it != low) return false;
+		array.erase(it); --card;
+		return true;
+	}
+	// 按升序访问低 16 位落在 [from, to] 内的元素
+	template <typename Fn>
+	void each(uint32_t from, uint32_t to, Fn&& fn) const {
+		uint32_t base = static_cast<uint32_t>(key) << 16;
+		if (!isBitmap()) {
+			for (auto it = std::lower_bound(array.begin(), array.end(), static_cast<uint16_t>(from)); it != array.end() && *it <= to; ++it) fn(base | *it);
+			return;
+		}
+		for (size_t i = from >> 6; i <= (to >> 6); ++i) {
+			uint64_t w = bitmap[i];
+			if (i == (from >> 6)) w &= ~uint64_t{0} << (from & 63);
+			if (i == (to >> 6) && (to & 63) != 63) w &= (uint64_t{1} << ((to & 63) + 1)) - 1;
+			for (; w; w &= w - 1) fn(base | static_cast<uint32_t>(i * 64 + __builtin_ctzll(w)));
+		}
+	}
+};
+
+RoaringContainer containerOr(const RoaringContainer& a, const RoaringContainer& b) {
+	RoaringContainer out; out.key = a.key;
+	if (!a.isBitmap() && !b.isBitmap() && a.card + b.card <= kArrayMax) {
+		out.array.reserve(a.card + b.card);
+		std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), std::back_inserter(out.array));
+		out.card = static_cast<uint32_t>(out.array.size());
+		return out;
+	}
+	const RoaringContainer& big = a.isBitmap() ? a : b;
+	const RoaringContainer& rest = a.isBitmap() ? b : a;
+	big.loadWords(out.bitmap);
+	if (rest.isBitmap()) {
+		uint64_t* w = out.bitmap.data();
+		const uint64_t* r = rest.bitmap.data();
+		for (size_t i = 0; i < kBitmapWords; ++i) w[i] |= r[i];
+	} else {
+		for (uint16_t v : rest.array) out.bitmap[v >> 6] |= uint64_t{1} << (v & 63);
+	}
+	out.card = popcountWords(out.bitmap.data());
+	out.normalize();
+	return out;
+}
+
+RoaringContainer containerAnd(const RoaringContainer& a, const RoaringContainer& b) {
+	RoaringContainer out; out.key = a.key;
+	if (a.isBitmap() && b.isBitmap()) {
+		out.bitmap.resize(kBitmapWords);
+		uint64_t* w = out.bitmap.data();
+		const uint64_t* x = a.bitmap.data();
+		const uint64_t* y = b.bitmap.data();
+		for (size_t i = 0; i < kBitmapWords; ++i) w[i] = x[i] & y[i];
+		out.card = popcountWords(w);
+		out.normalize();
+		return out;
+	}
+	if (!a.isBitmap() && !b.isBitmap()) {
+		std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), std::back_inserter(out.array));
+	} else {
+		const RoaringContainer& arr = a.isBitmap() ? b : a;
+		const RoaringContainer& bm = a.isBitmap() ? a : b;
+		for (uint16_t v : arr.array) if (bm.contains(v)) out.array.push_back(v);
+	}
+	out.card = static_cast<uint32_t>(out.array.size());
+	return out;
+}
+
+RoaringContainer containerAndNot(const RoaringContainer& a, const RoaringContainer& b) {
+	RoaringContainer out; out.key = a.key;
+	if (!a.isBitmap()) {
+		if (!b.isBitmap()) std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), std::back_inserter(out.array));
+		else for (uint16_t v : a.array) if (!b.contains(v)) out.array.push_back(v);
+		out.card = static_cast<uint32_t>(out.array.size());
+		return out;
+	}
+	out.bitmap = a.bitmap;
+	if (b.isBitmap()) {
+		uint64_t* w = out.bitmap.data();
+		const uint64_t* y = b.bitmap.data();
+		for (size_t i = 0; i < kBitmapWords; ++i) w[i] &= ~y[i];
+	} else {
+		for (uint16_t v : b.array) out.bitmap[v >> 6] &= ~(uint64_t{1} << (v & 63));
+	}
+	out.card = popcountWords(out.bitmap.data());
+	out.normalize();
+	return out;
+}
+
+inline bool containerKeyLess(const RoaringContainer& c, uint16_t k) { return c.key < k; }
+
+struct NativeBitset {
+	std::vector<RoaringContainer> containers; // 按 key 升序，不含空 container
+
+	const RoaringContainer* find(uint16_t key) const {
+		auto it = std::lower_bound(containers.begin(), containers.end(), key, containerKeyLess);
+		return it != containers.end() && it->key == key ? &*it : nullptr;
+	}
+	RoaringContainer& obtain(uint16_t key) {
+		auto it = std::lower_bound(containers.begin(), containers.end(), key, containerKeyLess);
+		if (it == containers.end() || it->key != key) {
+			it = containers.insert(it, RoaringContainer{});
+			it->key = key;
+		}
+		return *it;
+	}
+	bool add(uint32_t x) { return obtain(static_cast<uint16_t>(x >> 16)).add(static_cast<uint16_t>(x)); }
+	bool remove(uint32_t x) {
+		auto it = std::lower_bound(containers.begin(), containers.end(), static_cast<uint16_t>(x >> 16), containerKeyLess);
+		if (it == containers.end() || it->key != (x >> 16) || !it->remove(static_cast<uint16_t>(x))) return false;
+		if (it->card == 0) containers.erase(it);
+		return true;
+	}
+	bool has(uint32_t x) const {
+		auto c = find(static_cast<uint16_t>(x >> 16));
+		return c && c->contains(static_cast<uint16_t>(x));
+	}
+	// 闭区间 [lo, hi]：整字置位后再视基数转回数组
+	void addRange(uint32_t lo, uint32_t hi) {
+		for (uint32_t key = lo >> 16; key <= (hi >> 16); ++key) {
+			uint32_t from = key == (lo >> 16) ? (lo & 0xFFFF) : 0;
+			uint32_t to = key == (hi >> 16) ? (hi & 0xFFFF) : 0xFFFF;
+			RoaringContainer& c = obtain(static_cast<uint16_t>(key));
+			c.toBitmap();
+			for (uint32_t v = from; v <= to;) {
+				if ((v & 63) == 0 && v + 63 <= to) { c.bitmap[v >> 6] = ~uint64_t{0}; v += 64; }
+				else { c.bitmap[v >> 6] |= uint64_t{1} << (v & 63); ++v; }
+			}
+			c.card = popcountWords(c.bitmap.data());
+			c.normalize();
+		}
+	}
+	uint64_t cardinality() const {
+		uint64_t n = 0;
+		for (auto& c : containers) n += c.card;
+		return n;
+	}
+	size_t sizeInBytes() const {
+		size_t n = sizeof(NativeBitset);
+		for (auto& c : containers) n += sizeof(RoaringContainer) + c.array.capacity() * sizeof(uint16_t) + c.bitmap.capacity() * sizeof(uint64_t);
+		return n;
+	}
+	// 按升序访问 [lo, hi] 内的元素
+	template <typename Fn>
+	void each(uint32_t lo, uint32_t hi, Fn&& fn) const {
+		auto it = std::lower_bound(containers.begin(), containers.end(), static_cast<uint16_t>(lo >> 16), containerKeyLess);
+		for (; it != containers.end() && it->key <= (hi >> 16); ++it) {
+			uint32_t from = it->key == (lo >> 16) ? (lo & 0xFFFF) : 0;
+			uint32_t to = it->key == (hi >> 16) ? (hi & 0xFFFF) : 0xFFFF;
+			it->each(from, to, fn);
+		}
+	}
+};
+
+enum class BitsetOp { Or, And, AndNot };
+
+// 按 key 有序归并，只有两边都存在的 container 才需要容器级运算
+NativeBitset* bitsetCombine(const NativeBitset& a, const NativeBitset& b, BitsetOp op) {
+	auto out = new NativeBitset();
+	size_t i = 0, j = 0;
+	while (i < a.containers.size() || j < b.containers.size()) {
+		const RoaringContainer* x = i < a.containers.size() ? &a.containers[i] : nullptr;
+		const RoaringContainer* y = j < b.containers.size() ? &b.containers[j] : nullptr;
+		if (x && (!y || x->key < y->key)) {
+			if (op != BitsetOp::And) out->containers.push_back(*x);
+			++i;
+		} else if (y && (!x || y->key < x->key)) {
+			if (op == BitsetOp::Or) out->containers.push_back(*y);
+			++j;
+		} else {
+			RoaringContainer c = op == BitsetOp::Or ? containerOr(*x, *y) : op == BitsetOp::And ? containerAnd(*x, *y) : containerAndNot(*x, *y);
+			if (c.card) out->containers.push_back(std::move(c));
+			++i; ++j;
+		}
+	}
+	return out;
+}
+
+uint32_t bitsetValue(const Value& v, const char* what) {
+	double d = getNumber(v, what);
+	if (!(d >= 0 && d <= 4294967295.0) || std::floor(d) != d) throw std::runtime_error(std::string(what) + ": expected an integer in [0, 2^32)");
+	return static_cast<uint32_t>(d);
+}
+
+// 格式: "ARB1" u32 容器数，每个容器 u16 key、u8 类型 (0 数组 / 1 位图)、u32 基数、数据
+std::string serializeBitset(const NativeBitset& bs) {
+	ByteWriter w;
+	w.out = "ARB1";
+	w.u32(static_cast<uint32_t>(bs.containers.size()));
+	for (auto& c : bs.containers) {
+		w.u16(c.key);
+		w.u8(c.isBitmap() ? 1 : 0);
+		w.u32(c.card);
+		if (c.isBitmap()) for (uint64_t word : c.bitmap) w.u64(word);
+		else for (uint16_t v : c.array) w.u16(v);
+	}
+	return w.out;
+}
+
+NativeBitset* deserializeBitset(const std::string& data) {
+	ByteReader r(data, "Bitset.deserialize");
+	r.magic("ARB1");
+	uint32_t n = r.u32();
+	std::unique_ptr<NativeBitset> bs(new NativeBitset());
+	for (uint32_t i = 0; i < n; ++i) {
+		RoaringContainer c;
+		c.key = r.u16();
+		uint8_t kind = r.u8();
+		c.card = r.u32();
+		if (!bs->containers.empty() && bs->containers.back().key >= c.key) throw std::runtime_error("Bitset.deserialize: container keys out of order");
+		if (kind == 1) {
+			if (c.card <= kArrayMax || c.card > 65536) throw std::runtime_error("Bitset.deserialize: bad bitmap cardinality");
+			r.need(kBitmapWords * 8);
+			c.bitmap.resize(kBitmapWords);
+			for (auto& word : c.bitmap) word = r.u64();
+			if (popcountWords(c.bitmap.data()) != c.card) throw std::runtime_error("Bitset.deserialize: cardinality mismatch");
+		} else if (kind == 0) {
+			if (c.card == 0 || c.card > kArrayMax) throw std::runtime_error("Bitset.deserialize: bad array cardinality");
+			r.need(static_cast<size_t>(c.card) * 2);
+			c.array.resize(c.card);
+			for (auto& v : c.array) v = r.u16();
+			for (size_t k = 1; k < c.array.size(); ++k) {
+				if (c.array[k - 1] >= c.array[k]) throw std::runtime_error("Bitset.deserialize: array container not sorted");
+			}
+		} else {
+			throw std::runtime_error("Bitset.deserialize: unknown container type");
+		}
+		bs->containers.push_back(std::move(c));
+	}
+	r.finish();
+	return bs.release();
+}
+
+// ----------- Radix tree -----------
+// 压缩前缀树：每条边是一段字节串，兄弟节点按首字节升序，遍历即字典序。
+// count 记录子树内的键数，countPrefix 只需走完前缀。
+
+struct TrieNode {
+	std::string label; // 从父节点到本节点的边
+	bool hasValue{false};
+	Value value;
+	size_t count{0};
+	std::vector<std::unique_ptr<TrieNode>> children;
+
+	std::vector<std::unique_ptr<TrieNode>>::iterator childFor(unsigned char c) {
+		return std::lower_bound(children.begin(), children.end(), c, [](const std::unique_ptr<TrieNode>& n, unsigned char k) { return static_cast<unsigned char>(n->label[0]) < k; });
+	}
+	TrieNode* child(unsigned char c) {
+		auto it = childFor(c);
+		return it != children.end() && static_cast<unsigned char>((*it)->label[0]) == c ? it->get() : nullptr;
+	}
+};
+
+struct NativeTrie {
+	TrieNode root;
+
+	// 返回 true 表示新增了键
+	bool set(const std::string& key, const Value& value) {
+		std::vector<TrieNode*> path{&root};
+		TrieNode* cur = &root;
+		size_t pos = 0;
+		while (pos < key.size()) {
+			auto it = cur->childFor(static_cast<unsigned char>(key[pos]));
+			if (it == cur->children.end() || (*it)->label[0] != key[pos]) {
+				auto leaf = std::make_unique<TrieNode>();
+				leaf->label = key.substr(pos);
+				cur = cur->children.insert(it, std::move(leaf))->get();
+				path.push_back(cur);
+				pos = key.size();
+				break;
+			}
+			TrieNode* next = it->get();
+			size_t l = 0;
+			while (l < next->label.size() && pos + l < key.size() && next->label[l] == key[pos + l]) ++l;
+			if (l < next->label.size()) {
+				// 在公共前缀处拆边
+				auto mid = std::make_unique<TrieNode>();
+				mid->label = next->label.substr(0, l);
+				mid->count = next->count;
+				next->label.erase(0, l);
+				mid->children.push_back(std::move(*it));
+				*it = std::move(mid);
+				next = it->get();
+			}
+			cur = next;
+			path.push_back(cur);
+			pos += l;
+		}
+		bool added = !cur->hasValue;
+		cur->hasValue = true;
+		cur->value = value;
+		if (added) for (TrieNode* n : path) ++n->count;
+		return added;
+	}
+	TrieNode* find(const std::string& key) {
+		TrieNode* cur = &root;
+		size_t pos = 0;
+		while (pos < key.size()) {
+			TrieNode* next = cur->child(static_cast<unsigned char>(key[pos]));
+			if (!next || key.compare(pos, next->label.size(), next->label) != 0) return nullptr;
+			pos += next->label.size();
+			cur = next;
+		}
+		return cur->hasValue ? cur : nullptr;
+	}
+	bool remove(const std::string& key) {
+		std::vector<TrieNode*> path{&root};
+		TrieNode* cur = &root;
+		size_t pos = 0;
+		while (pos < key.size()) {
+			TrieNode* next = cur->child(static_cast<unsigned char>(key[pos]));
+			if (!next || key.compare(pos, next->label.size(), next->label) != 0) return false;
+			pos += next->label.size();
+			cur = next;
+			path.push_back(cur);
+		}
+		if (!cur->hasValue) return false;
+		cur->hasValue = false;
+		cur->value = Value{std::monostate{}};
+		for (TrieNode* n : path) --n->count;
+		// 删掉空叶子，再把只剩一个孩子的无值节点与孩子合并
+		for (size_t i = path.size() - 1; i > 0; --i) {
+			TrieNode* node = path[i];
+			TrieNode* parent = path[i - 1];
+			auto it = parent->childFor(static_cast<unsigned char>(node->label[0]));
+			if (!node->hasValue && node->children.empty()) {
+				parent->children.erase(it);
+				continue;
+			}
+			if (!node->hasValue && node->children.size() == 1) {
+				std::unique_ptr<TrieNode> only = std::move(node->children.front());
+				only->label = node->label + only->label;
+				*it = std::move(only);
+			}
+			break;
+		}
+		return true;
+	}
+	// 定位包含全部以 prefix 开头的键的子树；fullKey 是该子树根对应的完整键
+	TrieNode* locatePrefix(const std::string& prefix, std::string& fullKey) {
+		TrieNode* cur = &root;
+		size_t pos = 0;
+		fullKey.clear();
+		while (pos < prefix.size()) {
+			TrieNode* next = cur->child(static_cast<unsigned char>(prefix[pos]));
+			if (!next) return nullptr;
+			size_t rest = prefix.size() - pos;
+			if (rest <= next->label.size()) {
+				if (next->label.compare(0, rest, prefix, pos, rest) != 0) return nullptr;
+			} else if (prefix.compare(pos, next->label.size(), next->label) != 0) {
+				return nullptr;
+			}
+			fullKey += next->label;
+			pos += next->label.size();
+			cur = next;
+		}
+		return cur;
+	}
+	// 在 text 的所有前缀中找最长的已存在键
+	TrieNode* longestPrefix(const std::string& text, size_t& matched) {
+		TrieNode* cur = &root;
+		TrieNode* best = root.hasValue ? &root : nullptr;
+		size_t pos = 0;
+		matched = 0;
+		while (pos < text.size()) {
+			TrieNode* next = cur->child(static_cast<unsigned char>(text[pos]));
+			if (!next || text.compare(pos, next->label.size(), next->label) != 0) break;
+			pos += next->label.size();
+			cur = next;
+			if (cur->hasValue) { best = cur; matched = pos; }
+		}
+		return best;
+	}
+	// 字典序遍历；fn 返回 false 时停止
+	template <typename Fn>
+	static bool walk(const TrieNode* node, std::string& key, Fn&& fn) {
+		if (node->hasValue && !fn(key, node->value)) return false;
+		for (auto& c : node->children) {
+			key += c->label;
+			bool more = walk(c.get(), key, fn);
+			key.resize(key.size() - c->label.size());
+			if (!more) return false;
+		}
+		return true;
+	}
+};
+
+} // namespace
+
 
 void registerStdCollectionsPackage(Interpreter& interp) {
 	auto globals = interp.globalsEnv();
@@ -361,6 +991,586 @@ void registerStdCollectionsPackage(Interpreter& interp) {
 					interp.registerPackageSymbol("std.collections", "PriorityQueue", Value{pqClass});
 					interp.registerPackageSymbol("std.collections", "priorityQueue", Value{pqCtor});
 
+					// ---- Probabilistic sketches (native) ----
+					// 固定内存的近似结构：BloomFilter (成员判断)、HyperLogLog (基数估计)、CountMinSketch (频次估计)
+					auto sameClassHandle = [](const Value& v, const std::shared_ptr<ClassInfo>& klass, const char* what)->void* {
+						auto pins = std::get_if<std::shared_ptr<Instance>>(&v);
+						if (!pins || !*pins || (*pins)->klass != klass) throw std::runtime_error(std::string(what) + " expects a " + klass->name);
+						return static_cast<InstanceExt*>(pins->get())->nativeHandle;
+					};
+					auto payloadArg = [](const std::vector<Value>& args, const char* what)->const std::string& {
+						if (args.size() != 1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error(std::string(what) + " expects a serialized string");
+						return std::get<std::string>(args[0]);
+					};
+
+					// BloomFilter(expectedItems, falsePositiveRate = 0.01)
+					auto bfClass = std::make_shared<ClassInfo>(); bfClass->name = "BloomFilter"; bfClass->isNative = true;
+					auto wrapBloom = [bfClass](NativeBloomFilter* bf)->Value {
+						auto inst = std::make_shared<InstanceExt>(); inst->klass = bfClass;
+						inst->nativeHandle = bf; inst->nativeDestructor = [](void* p){ delete static_cast<NativeBloomFilter*>(p); };
+						return Value{inst};
+					};
+					auto bfConstructor = std::make_shared<Function>(); bfConstructor->isBuiltin = true;
+					bfConstructor->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						InstanceExt* ie = getThisInstanceExt(clos);
+						ie->nativeHandle = newBloomFilter(args);
+						ie->nativeDestructor = [](void* p){ delete static_cast<NativeBloomFilter*>(p); };
+						return Value{std::monostate{}};
+					};
+					bfClass->methods["constructor"] = bfConstructor;
+					auto bfAdd = std::make_shared<Function>(); bfAdd->isBuiltin = true; bfAdd->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("bloomFilter.add expects 1 argument");
+						auto bf = static_cast<NativeBloomFilter*>(getThisInstanceExt(clos)->nativeHandle);
+						return Value{ bf->add(sketchHash(args[0])) };
+					};
+					bfClass->methods["add"] = bfAdd;
+					auto bfHas = std::make_shared<Function>(); bfHas->isBuiltin = true; bfHas->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("bloomFilter.has expects 1 argument");
+						auto bf = static_cast<NativeBloomFilter*>(getThisInstanceExt(clos)->nativeHandle);
+						return Value{ bf->has(sketchHash(args[0])) };
+					};
+					bfClass->methods["has"] = bfHas;
+					// count(): 由置位比例反推插入的不同元素数 n ≈ -(m/k)·ln(1 - X/m)
+					auto bfCount = std::make_shared<Function>(); bfCount->isBuiltin = true; bfCount->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto bf = static_cast<NativeBloomFilter*>(getThisInstanceExt(clos)->nativeHandle);
+						double m = static_cast<double>(bf->bits), x = static_cast<double>(bf->setBits());
+						if (x >= m) return Value{ m };
+						return Value{ std::round(-m / bf->hashes * std::log(1.0 - x / m)) };
+					};
+					bfClass->methods["count"] = bfCount;
+					auto bfBounds = std::make_shared<Function>(); bfBounds->isBuiltin = true; bfBounds->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto bf = static_cast<NativeBloomFilter*>(getThisInstanceExt(clos)->nativeHandle);
+						auto o = std::make_shared<Object>();
+						(*o)["falsePositiveRate"] = Value{ bf->fpRate };
+						(*o)["currentFalsePositiveRate"] = Value{ std::pow(static_cast<double>(bf->setBits()) / static_cast<double>(bf->bits), bf->hashes) };
+						(*o)["capacity"] = Value{ static_cast<double>(bf->capacity) };
+						(*o)["bits"] = Value{ static_cast<double>(bf->bits) };
+						(*o)["hashes"] = Value{ static_cast<double>(bf->hashes) };
+						return Value{o};
+					};
+					bfClass->methods["errorBounds"] = bfBounds;
+					auto bfMerge = std::make_shared<Function>(); bfMerge->isBuiltin = true; bfMerge->builtin = [getThisInstanceExt, sameClassHandle, bfClass](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("bloomFilter.merge expects 1 argument");
+						auto bf = static_cast<NativeBloomFilter*>(getThisInstanceExt(clos)->nativeHandle);
+						auto other = static_cast<NativeBloomFilter*>(sameClassHandle(args[0], bfClass, "bloomFilter.merge"));
+						if (other->bits != bf->bits || other->hashes != bf->hashes) throw std::runtime_error("bloomFilter.merge: filters must have the same size and hash count");
+						for (size_t i = 0; i < bf->words.size(); ++i) bf->words[i] |= other->words[i];
+						return Value{std::monostate{}};
+					};
+					bfClass->methods["merge"] = bfMerge;
+					auto bfClear = std::make_shared<Function>(); bfClear->isBuiltin = true; bfClear->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto bf = static_cast<NativeBloomFilter*>(getThisInstanceExt(clos)->nativeHandle);
+						std::fill(bf->words.begin(), bf->words.end(), 0);
+						return Value{std::monostate{}};
+					};
+					bfClass->methods["clear"] = bfClear;
+					auto bfSerialize = std::make_shared<Function>(); bfSerialize->isBuiltin = true; bfSerialize->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto bf = static_cast<NativeBloomFilter*>(getThisInstanceExt(clos)->nativeHandle);
+						ByteWriter w; w.out = "ABF1";
+						w.u64(bf->bits); w.u32(bf->hashes); w.u64(bf->capacity); w.f64(bf->fpRate);
+						for (uint64_t word : bf->words) w.u64(word);
+						return Value{ std::move(w.out) };
+					};
+					bfClass->methods["serialize"] = bfSerialize;
+					auto bfDeserialize = std::make_shared<Function>(); bfDeserialize->isBuiltin = true; bfDeserialize->builtin = [payloadArg, wrapBloom](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+						ByteReader r(payloadArg(args, "BloomFilter.deserialize"), "BloomFilter.deserialize");
+						r.magic("ABF1");
+						std::unique_ptr<NativeBloomFilter> bf(new NativeBloomFilter());
+						bf->bits = r.u64(); bf->hashes = r.u32(); bf->capacity = r.u64(); bf->fpRate = r.f64();
+						if (!bf->bits || bf->bits % 64 || !bf->hashes) throw std::runtime_error("BloomFilter.deserialize: corrupt header");
+						r.need(bf->bits / 8);
+						bf->words.resize(bf->bits / 64);
+						for (auto& word : bf->words) word = r.u64();
+						r.finish();
+						return wrapBloom(bf.release());
+					};
+					bfClass->staticMethods["deserialize"] = bfDeserialize;
+					auto bfCtor = std::make_shared<Function>(); bfCtor->isBuiltin = true; bfCtor->builtin = [wrapBloom](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value { return wrapBloom(newBloomFilter(args)); };
+					interp.registerPackageSymbol("std.collections", "BloomFilter", Value{bfClass});
+					interp.registerPackageSymbol("std.collections", "bloomFilter", Value{bfCtor});
+
+					// HyperLogLog(precision = 14)：2^precision 个 6 位寄存器，标准误差 1.04/√m
+					auto hllClass = std::make_shared<ClassInfo>(); hllClass->name = "HyperLogLog"; hllClass->isNative = true;
+					auto wrapHll = [hllClass](NativeHyperLogLog* hll)->Value {
+						auto inst = std::make_shared<InstanceExt>(); inst->klass = hllClass;
+						inst->nativeHandle = hll; inst->nativeDestructor = [](void* p){ delete static_cast<NativeHyperLogLog*>(p); };
+						return Value{inst};
+					};
+					auto hllConstructor = std::make_shared<Function>(); hllConstructor->isBuiltin = true;
+					hllConstructor->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						InstanceExt* ie = getThisInstanceExt(clos);
+						ie->nativeHandle = newHyperLogLog(args);
+						ie->nativeDestructor = [](void* p){ delete static_cast<NativeHyperLogLog*>(p); };
+						return Value{std::monostate{}};
+					};
+					hllClass->methods["constructor"] = hllConstructor;
+					auto hllAdd = std::make_shared<Function>(); hllAdd->isBuiltin = true; hllAdd->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.empty()) throw std::runtime_error("hyperLogLog.add expects at least 1 argument");
+						auto hll = static_cast<NativeHyperLogLog*>(getThisInstanceExt(clos)->nativeHandle);
+						bool changed = false;
+						for (auto& v : args) changed |= hll->add(sketchHash(v));
+						return Value{ changed };
+					};
+					hllClass->methods["add"] = hllAdd;
+					auto hllCount = std::make_shared<Function>(); hllCount->isBuiltin = true; hllCount->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						return Value{ static_cast<NativeHyperLogLog*>(getThisInstanceExt(clos)->nativeHandle)->estimate() };
+					};
+					hllClass->methods["count"] = hllCount;
+					auto hllBounds = std::make_shared<Function>(); hllBounds->isBuiltin = true; hllBounds->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto hll = static_cast<NativeHyperLogLog*>(getThisInstanceExt(clos)->nativeHandle);
+						auto o = std::make_shared<Object>();
+						(*o)["standardError"] = Value{ hll->standardError() };
+						(*o)["precision"] = Value{ static_cast<double>(hll->precision) };
+						(*o)["registers"] = Value{ static_cast<double>(hll->registers.size()) };
+						return Value{o};
+					};
+					hllClass->methods["errorBounds"] = hllBounds;
+					auto hllMerge = std::make_shared<Function>(); hllMerge->isBuiltin = true; hllMerge->builtin = [getThisInstanceExt, sameClassHandle, hllClass](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("hyperLogLog.merge expects 1 argument");
+						auto hll = static_cast<NativeHyperLogLog*>(getThisInstanceExt(clos)->nativeHandle);
+						auto other = static_cast<NativeHyperLogLog*>(sameClassHandle(args[0], hllClass, "hyperLogLog.merge"));
+						if (other->precision != hll->precision) throw std::runtime_error("hyperLogLog.merge: precision mismatch");
+						for (size_t i = 0; i < hll->registers.size(); ++i) hll->registers[i] = std::max(hll->registers[i], other->registers[i]);
+						return Value{std::monostate{}};
+					};
+					hllClass->methods["merge"] = hllMerge;
+					auto hllClear = std::make_shared<Function>(); hllClear->isBuiltin = true; hllClear->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto hll = static_cast<NativeHyperLogLog*>(getThisInstanceExt(clos)->nativeHandle);
+						std::fill(hll->registers.begin(), hll->registers.end(), 0);
+						return Value{std::monostate{}};
+					};
+					hllClass->methods["clear"] = hllClear;
+					auto hllSerialize = std::make_shared<Function>(); hllSerialize->isBuiltin = true; hllSerialize->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto hll = static_cast<NativeHyperLogLog*>(getThisInstanceExt(clos)->nativeHandle);
+						ByteWriter w; w.out = "AHL1";
+						w.u8(static_cast<uint8_t>(hll->precision));
+						w.out.append(reinterpret_cast<const char*>(hll->registers.data()), hll->registers.size());
+						return Value{ std::move(w.out) };
+					};
+					hllClass->methods["serialize"] = hllSerialize;
+					auto hllDeserialize = std::make_shared<Function>(); hllDeserialize->isBuiltin = true; hllDeserialize->builtin = [payloadArg, wrapHll](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+						ByteReader r(payloadArg(args, "HyperLogLog.deserialize"), "HyperLogLog.deserialize");
+						r.magic("AHL1");
+						uint32_t precision = r.u8();
+						if (precision < 4 || precision > 18) throw std::runtime_error("HyperLogLog.deserialize: corrupt header");
+						std::unique_ptr<NativeHyperLogLog> hll(new NativeHyperLogLog());
+						hll->precision = precision;
+						hll->registers.resize(size_t{1} << precision);
+						for (auto& reg : hll->registers) {
+							reg = r.u8();
+							if (reg > 64 - precision + 1) throw std::runtime_error("HyperLogLog.deserialize: corrupt register");
+						}
+						r.finish();
+						return wrapHll(hll.release());
+					};
+					hllClass->staticMethods["deserialize"] = hllDeserialize;
+					auto hllCtor = std::make_shared<Function>(); hllCtor->isBuiltin = true; hllCtor->builtin = [wrapHll](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value { return wrapHll(newHyperLogLog(args)); };
+					interp.registerPackageSymbol("std.collections", "HyperLogLog", Value{hllClass});
+					interp.registerPackageSymbol("std.collections", "hyperLogLog", Value{hllCtor});
+
+					// CountMinSketch(epsilon = 0.001, delta = 0.01)
+					auto cmsClass = std::make_shared<ClassInfo>(); cmsClass->name = "CountMinSketch"; cmsClass->isNative = true;
+					auto wrapCms = [cmsClass](NativeCountMinSketch* cms)->Value {
+						auto inst = std::make_shared<InstanceExt>(); inst->klass = cmsClass;
+						inst->nativeHandle = cms; inst->nativeDestructor = [](void* p){ delete static_cast<NativeCountMinSketch*>(p); };
+						return Value{inst};
+					};
+					auto cmsConstructor = std::make_shared<Function>(); cmsConstructor->isBuiltin = true;
+					cmsConstructor->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						InstanceExt* ie = getThisInstanceExt(clos);
+						ie->nativeHandle = newCountMinSketch(args);
+						ie->nativeDestructor = [](void* p){ delete static_cast<NativeCountMinSketch*>(p); };
+						return Value{std::monostate{}};
+					};
+					cmsClass->methods["constructor"] = cmsConstructor;
+					auto cmsAdd = std::make_shared<Function>(); cmsAdd->isBuiltin = true; cmsAdd->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.empty() || args.size() > 2) throw std::runtime_error("countMinSketch.add expects value [, count]");
+						auto cms = static_cast<NativeCountMinSketch*>(getThisInstanceExt(clos)->nativeHandle);
+						double count = args.size() == 2 ? getNumber(args[1], "countMinSketch.add count") : 1;
+						if (!(count >= 0) || std::floor(count) != count) throw std::runtime_error("countMinSketch.add: count must be a non-negative integer");
+						return Value{ static_cast<double>(cms->add(sketchHash(args[0]), static_cast<uint64_t>(count))) };
+					};
+					cmsClass->methods["add"] = cmsAdd;
+					auto cmsEstimate = std::make_shared<Function>(); cmsEstimate->isBuiltin = true; cmsEstimate->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("countMinSketch.estimate expects 1 argument");
+						auto cms = static_cast<NativeCountMinSketch*>(getThisInstanceExt(clos)->nativeHandle);
+						return Value{ static_cast<double>(cms->estimate(sketchHash(args[0]))) };
+					};
+					cmsClass->methods["estimate"] = cmsEstimate;
+					auto cmsTotal = std::make_shared<Function>(); cmsTotal->isBuiltin = true; cmsTotal->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						return Value{ static_cast<double>(static_cast<NativeCountMinSketch*>(getThisInstanceExt(clos)->nativeHandle)->total) };
+					};
+					cmsClass->methods["total"] = cmsTotal;
+					auto cmsBounds = std::make_shared<Function>(); cmsBounds->isBuiltin = true; cmsBounds->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto cms = static_cast<NativeCountMinSketch*>(getThisInstanceExt(clos)->nativeHandle);
+						auto o = std::make_shared<Object>();
+						(*o)["epsilon"] = Value{ cms->epsilon };
+						(*o)["delta"] = Value{ cms->delta };
+						(*o)["width"] = Value{ static_cast<double>(cms->width) };
+						(*o)["depth"] = Value{ static_cast<double>(cms->depth) };
+						(*o)["maxOvercount"] = Value{ cms->epsilon * static_cast<double>(cms->total) };
+						return Value{o};
+					};
+					cmsClass->methods["errorBounds"] = cmsBounds;
+					auto cmsMerge = std::make_shared<Function>(); cmsMerge->isBuiltin = true; cmsMerge->builtin = [getThisInstanceExt, sameClassHandle, cmsClass](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("countMinSketch.merge expects 1 argument");
+						auto cms = static_cast<NativeCountMinSketch*>(getThisInstanceExt(clos)->nativeHandle);
+						auto other = static_cast<NativeCountMinSketch*>(sameClassHandle(args[0], cmsClass, "countMinSketch.merge"));
+						if (other->width != cms->width || other->depth != cms->depth) throw std::runtime_error("countMinSketch.merge: sketches must have the same width and depth");
+						for (size_t i = 0; i < cms->table.size(); ++i) cms->table[i] += other->table[i];
+						cms->total += other->total;
+						return Value{std::monostate{}};
+					};
+					cmsClass->methods["merge"] = cmsMerge;
+					auto cmsClear = std::make_shared<Function>(); cmsClear->isBuiltin = true; cmsClear->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto cms = static_cast<NativeCountMinSketch*>(getThisInstanceExt(clos)->nativeHandle);
+						std::fill(cms->table.begin(), cms->table.end(), 0);
+						cms->total = 0;
+						return Value{std::monostate{}};
+					};
+					cmsClass->methods["clear"] = cmsClear;
+					auto cmsSerialize = std::make_shared<Function>(); cmsSerialize->isBuiltin = true; cmsSerialize->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto cms = static_cast<NativeCountMinSketch*>(getThisInstanceExt(clos)->nativeHandle);
+						ByteWriter w; w.out = "ACM1";
+						w.u32(cms->width); w.u32(cms->depth); w.f64(cms->epsilon); w.f64(cms->delta); w.u64(cms->total);
+						for (uint64_t c : cms->table) w.u64(c);
+						return Value{ std::move(w.out) };
+					};
+					cmsClass->methods["serialize"] = cmsSerialize;
+					auto cmsDeserialize = std::make_shared<Function>(); cmsDeserialize->isBuiltin = true; cmsDeserialize->builtin = [payloadArg, wrapCms](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+						ByteReader r(payloadArg(args, "CountMinSketch.deserialize"), "CountMinSketch.deserialize");
+						r.magic("ACM1");
+						std::unique_ptr<NativeCountMinSketch> cms(new NativeCountMinSketch());
+						cms->width = r.u32(); cms->depth = r.u32(); cms->epsilon = r.f64(); cms->delta = r.f64(); cms->total = r.u64();
+						if (!cms->width || !cms->depth) throw std::runtime_error("CountMinSketch.deserialize: corrupt header");
+						size_t cells = static_cast<size_t>(cms->width) * cms->depth;
+						r.need(cells * 8);
+						cms->table.resize(cells);
+						for (auto& c : cms->table) c = r.u64();
+						r.finish();
+						return wrapCms(cms.release());
+					};
+					cmsClass->staticMethods["deserialize"] = cmsDeserialize;
+					auto cmsCtor = std::make_shared<Function>(); cmsCtor->isBuiltin = true; cmsCtor->builtin = [wrapCms](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value { return wrapCms(newCountMinSketch(args)); };
+					interp.registerPackageSymbol("std.collections", "CountMinSketch", Value{cmsClass});
+					interp.registerPackageSymbol("std.collections", "countMinSketch", Value{cmsCtor});
+
+					// ---- Bitset / RoaringBitmap (native) ----
+					// 压缩位图，元素为 [0, 2^32) 的整数；union/intersection/difference 返回新的 Bitset
+					auto bsClass = std::make_shared<ClassInfo>(); bsClass->name = "Bitset"; bsClass->isNative = true;
+					auto wrapBitset = [bsClass](NativeBitset* bs)->Value {
+						auto inst = std::make_shared<InstanceExt>(); inst->klass = bsClass;
+						inst->nativeHandle = bs; inst->nativeDestructor = [](void* p){ delete static_cast<NativeBitset*>(p); };
+						return Value{inst};
+					};
+					auto fillBitset = [](NativeBitset* bs, const std::vector<Value>& args, const char* what) {
+						if (args.empty()) return;
+						if (args.size() != 1 || !std::holds_alternative<std::shared_ptr<Array>>(args[0])) throw std::runtime_error(std::string(what) + " expects ([values])");
+						for (auto& v : *std::get<std::shared_ptr<Array>>(args[0])) bs->add(bitsetValue(v, what));
+					};
+					// 半开区间 [start, end)，end 可取 2^32
+					auto rangeArgs = [](const std::vector<Value>& args, const char* what, uint32_t& lo, uint32_t& hi)->bool {
+						if (args.size() != 2) throw std::runtime_error(std::string(what) + " expects (start, end)");
+						double end = getNumber(args[1], what);
+						if (!(end >= 0 && end <= 4294967296.0) || std::floor(end) != end) throw std::runtime_error(std::string(what) + ": end must be an integer in [0, 2^32]");
+						lo = bitsetValue(args[0], what);
+						if (end <= lo) return false;
+						hi = static_cast<uint32_t>(end - 1);
+						return true;
+					};
+					auto bsConstructor = std::make_shared<Function>(); bsConstructor->isBuiltin = true;
+					bsConstructor->builtin = [getThisInstanceExt, fillBitset](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						InstanceExt* ie = getThisInstanceExt(clos);
+						std::unique_ptr<NativeBitset> bs(new NativeBitset());
+						fillBitset(bs.get(), args, "Bitset");
+						ie->nativeHandle = bs.release();
+						ie->nativeDestructor = [](void* p){ delete static_cast<NativeBitset*>(p); };
+						return Value{std::monostate{}};
+					};
+					bsClass->methods["constructor"] = bsConstructor;
+					auto bsAdd = std::make_shared<Function>(); bsAdd->isBuiltin = true; bsAdd->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("bitset.add expects 1 argument");
+						auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						return Value{ bs->add(bitsetValue(args[0], "bitset.add")) };
+					};
+					bsClass->methods["add"] = bsAdd;
+					auto bsAddAll = std::make_shared<Function>(); bsAddAll->isBuiltin = true; bsAddAll->builtin = [getThisInstanceExt, fillBitset](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("bitset.addAll expects (values)");
+						fillBitset(static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle), args, "bitset.addAll");
+						return Value{std::monostate{}};
+					};
+					bsClass->methods["addAll"] = bsAddAll;
+					auto bsAddRange = std::make_shared<Function>(); bsAddRange->isBuiltin = true; bsAddRange->builtin = [getThisInstanceExt, rangeArgs](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						uint32_t lo, hi;
+						if (rangeArgs(args, "bitset.addRange", lo, hi)) bs->addRange(lo, hi);
+						return Value{std::monostate{}};
+					};
+					bsClass->methods["addRange"] = bsAddRange;
+					auto bsRemove = std::make_shared<Function>(); bsRemove->isBuiltin = true; bsRemove->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("bitset.remove expects 1 argument");
+						auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						return Value{ bs->remove(bitsetValue(args[0], "bitset.remove")) };
+					};
+					bsClass->methods["remove"] = bsRemove;
+					auto bsHas = std::make_shared<Function>(); bsHas->isBuiltin = true; bsHas->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("bitset.has expects 1 argument");
+						auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						// 非整数或越界的值不可能是成员
+						auto n = std::get_if<double>(&args[0]);
+						if (!n || !(*n >= 0 && *n <= 4294967295.0) || std::floor(*n) != *n) return Value{false};
+						return Value{ bs->has(static_cast<uint32_t>(*n)) };
+					};
+					bsClass->methods["has"] = bsHas;
+					auto bsCardinality = std::make_shared<Function>(); bsCardinality->isBuiltin = true; bsCardinality->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						return Value{ static_cast<double>(bs->cardinality()) };
+					};
+					bsClass->methods["cardinality"] = bsCardinality;
+					bsClass->methods["size"] = bsCardinality;
+					auto bsMin = std::make_shared<Function>(); bsMin->isBuiltin = true; bsMin->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						if (bs->containers.empty()) return Value{std::monostate{}};
+						auto& c = bs->containers.front();
+						uint32_t low = 0;
+						if (c.isBitmap()) { size_t i = 0; while (!c.bitmap[i]) ++i; low = static_cast<uint32_t>(i * 64 + __builtin_ctzll(c.bitmap[i])); }
+						else low = c.array.front();
+						return Value{ static_cast<double>((static_cast<uint32_t>(c.key) << 16) | low) };
+					};
+					bsClass->methods["min"] = bsMin;
+					auto bsMax = std::make_shared<Function>(); bsMax->isBuiltin = true; bsMax->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						if (bs->containers.empty()) return Value{std::monostate{}};
+						auto& c = bs->containers.back();
+						uint32_t low = 0;
+						if (c.isBitmap()) { size_t i = kBitmapWords - 1; while (!c.bitmap[i]) --i; low = static_cast<uint32_t>(i * 64 + 63 - __builtin_clzll(c.bitmap[i])); }
+						else low = c.array.back();
+						return Value{ static_cast<double>((static_cast<uint32_t>(c.key) << 16) | low) };
+					};
+					bsClass->methods["max"] = bsMax;
+					auto makeBitsetOp = [getThisInstanceExt, sameClassHandle, bsClass, wrapBitset](BitsetOp op, const char* what) {
+						auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
+						fn->builtin = [getThisInstanceExt, sameClassHandle, bsClass, wrapBitset, op, what](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+							if (args.size()!=1) throw std::runtime_error(std::string(what) + " expects 1 argument");
+							auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+							auto other = static_cast<NativeBitset*>(sameClassHandle(args[0], bsClass, what));
+							return wrapBitset(bitsetCombine(*bs, *other, op));
+						};
+						return fn;
+					};
+					bsClass->methods["union"] = makeBitsetOp(BitsetOp::Or, "bitset.union");
+					bsClass->methods["intersection"] = makeBitsetOp(BitsetOp::And, "bitset.intersection");
+					bsClass->methods["difference"] = makeBitsetOp(BitsetOp::AndNot, "bitset.difference");
+					auto bsEquals = std::make_shared<Function>(); bsEquals->isBuiltin = true; bsEquals->builtin = [getThisInstanceExt, bsClass](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("bitset.equals expects 1 argument");
+						auto pins = std::get_if<std::shared_ptr<Instance>>(&args[0]);
+						if (!pins || !*pins || (*pins)->klass != bsClass) return Value{false};
+						auto a = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						auto b = static_cast<NativeBitset*>(static_cast<InstanceExt*>(pins->get())->nativeHandle);
+						if (a->containers.size() != b->containers.size()) return Value{false};
+						// container 形式由基数唯一决定，逐个比较即可
+						for (size_t i = 0; i < a->containers.size(); ++i) {
+							auto& x = a->containers[i]; auto& y = b->containers[i];
+							if (x.key != y.key || x.card != y.card || x.array != y.array || x.bitmap != y.bitmap) return Value{false};
+						}
+						return Value{true};
+					};
+					bsClass->methods["equals"] = bsEquals;
+					auto bsToArray = std::make_shared<Function>(); bsToArray->isBuiltin = true; bsToArray->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						auto arr = std::make_shared<Array>();
+						arr->reserve(static_cast<size_t>(bs->cardinality()));
+						bs->each(0, 0xFFFFFFFFu, [&](uint32_t v) { arr->push_back(Value{ static_cast<double>(v) }); });
+						return Value{arr};
+					};
+					bsClass->methods["toArray"] = bsToArray;
+					// range(start, end): [start, end) 内的成员，升序
+					auto bsRange = std::make_shared<Function>(); bsRange->isBuiltin = true; bsRange->builtin = [getThisInstanceExt, rangeArgs](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						auto arr = std::make_shared<Array>();
+						uint32_t lo, hi;
+						if (rangeArgs(args, "bitset.range", lo, hi)) bs->each(lo, hi, [&](uint32_t v) { arr->push_back(Value{ static_cast<double>(v) }); });
+						return Value{arr};
+					};
+					bsClass->methods["range"] = bsRange;
+					auto bsForEach = std::make_shared<Function>(); bsForEach->isBuiltin = true; bsForEach->builtin = [getThisInstanceExt, interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("bitset.forEach expects (callback)");
+						auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						// 回调可能修改集合，先取快照
+						NativeBitset snapshot = *bs;
+						snapshot.each(0, 0xFFFFFFFFu, [&](uint32_t v) { interpPtr->callValue(args[0], { Value{ static_cast<double>(v) } }); });
+						return Value{std::monostate{}};
+					};
+					bsClass->methods["forEach"] = bsForEach;
+					auto bsClear = std::make_shared<Function>(); bsClear->isBuiltin = true; bsClear->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle)->containers.clear();
+						return Value{std::monostate{}};
+					};
+					bsClass->methods["clear"] = bsClear;
+					auto bsSizeInBytes = std::make_shared<Function>(); bsSizeInBytes->isBuiltin = true; bsSizeInBytes->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto bs = static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle);
+						return Value{ static_cast<double>(bs->sizeInBytes()) };
+					};
+					bsClass->methods["sizeInBytes"] = bsSizeInBytes;
+					auto bsSerialize = std::make_shared<Function>(); bsSerialize->isBuiltin = true; bsSerialize->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						return Value{ serializeBitset(*static_cast<NativeBitset*>(getThisInstanceExt(clos)->nativeHandle)) };
+					};
+					bsClass->methods["serialize"] = bsSerialize;
+					auto bsDeserialize = std::make_shared<Function>(); bsDeserialize->isBuiltin = true; bsDeserialize->builtin = [payloadArg, wrapBitset](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+						return wrapBitset(deserializeBitset(payloadArg(args, "Bitset.deserialize")));
+					};
+					bsClass->staticMethods["deserialize"] = bsDeserialize;
+					auto bsCtor = std::make_shared<Function>(); bsCtor->isBuiltin = true; bsCtor->builtin = [wrapBitset, fillBitset](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+						std::unique_ptr<NativeBitset> bs(new NativeBitset());
+						fillBitset(bs.get(), args, "bitset");
+						return wrapBitset(bs.release());
+					};
+					interp.registerPackageSymbol("std.collections", "Bitset", Value{bsClass});
+					interp.registerPackageSymbol("std.collections", "RoaringBitmap", Value{bsClass});
+					interp.registerPackageSymbol("std.collections", "bitset", Value{bsCtor});
+
+					// ---- Trie (native radix tree) ----
+					// 字符串键；get/has/delete/countPrefix/longestPrefix 的代价只与键长有关
+					auto trieClass = std::make_shared<ClassInfo>(); trieClass->name = "Trie"; trieClass->isNative = true;
+					auto trieKey = [](const Value& v, const char* what)->const std::string& {
+						if (!std::holds_alternative<std::string>(v)) throw std::runtime_error(std::string(what) + ": keys must be strings");
+						return std::get<std::string>(v);
+					};
+					auto trieLimit = [](const std::vector<Value>& args, size_t idx, const char* what)->size_t {
+						if (args.size() <= idx || std::holds_alternative<std::monostate>(args[idx])) return SIZE_MAX;
+						double n = getNumber(args[idx], what);
+						if (!(n >= 0)) throw std::runtime_error(std::string(what) + ": limit must be >= 0");
+						return n >= 9007199254740992.0 ? SIZE_MAX : static_cast<size_t>(n);
+					};
+					// 接受 {key: value} 对象，或字符串数组 (值为 true)
+					auto fillTrie = [trieKey](NativeTrie* t, const std::vector<Value>& args, const char* what) {
+						if (args.empty()) return;
+						if (args.size() != 1) throw std::runtime_error(std::string(what) + " expects ([object | array of strings])");
+						if (auto obj = std::get_if<std::shared_ptr<Object>>(&args[0])) {
+							for (auto& kv : **obj) t->set(kv.first, kv.second);
+						} else if (auto arr = std::get_if<std::shared_ptr<Array>>(&args[0])) {
+							for (auto& v : **arr) t->set(trieKey(v, what), Value{true});
+						} else {
+							throw std::runtime_error(std::string(what) + " expects ([object | array of strings])");
+						}
+					};
+					auto wrapTrie = [trieClass](NativeTrie* t)->Value {
+						auto inst = std::make_shared<InstanceExt>(); inst->klass = trieClass;
+						inst->nativeHandle = t; inst->nativeDestructor = [](void* p){ delete static_cast<NativeTrie*>(p); };
+						return Value{inst};
+					};
+					auto trieConstructor = std::make_shared<Function>(); trieConstructor->isBuiltin = true;
+					trieConstructor->builtin = [getThisInstanceExt, fillTrie](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						InstanceExt* ie = getThisInstanceExt(clos);
+						std::unique_ptr<NativeTrie> t(new NativeTrie());
+						fillTrie(t.get(), args, "Trie");
+						ie->nativeHandle = t.release();
+						ie->nativeDestructor = [](void* p){ delete static_cast<NativeTrie*>(p); };
+						return Value{std::monostate{}};
+					};
+					trieClass->methods["constructor"] = trieConstructor;
+					auto trieSet = std::make_shared<Function>(); trieSet->isBuiltin = true; trieSet->builtin = [getThisInstanceExt, trieKey](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.empty() || args.size() > 2) throw std::runtime_error("trie.set expects (key [, value])");
+						auto t = static_cast<NativeTrie*>(getThisInstanceExt(clos)->nativeHandle);
+						t->set(trieKey(args[0], "trie.set"), args.size() == 2 ? args[1] : Value{true});
+						return Value{std::monostate{}};
+					};
+					trieClass->methods["set"] = trieSet;
+					trieClass->methods["insert"] = trieSet;
+					auto trieGet = std::make_shared<Function>(); trieGet->isBuiltin = true; trieGet->builtin = [getThisInstanceExt, trieKey](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.empty() || args.size() > 2) throw std::runtime_error("trie.get expects (key [, default])");
+						auto t = static_cast<NativeTrie*>(getThisInstanceExt(clos)->nativeHandle);
+						TrieNode* n = t->find(trieKey(args[0], "trie.get"));
+						if (n) return n->value;
+						return args.size() == 2 ? args[1] : Value{std::monostate{}};
+					};
+					trieClass->methods["get"] = trieGet;
+					auto trieHas = std::make_shared<Function>(); trieHas->isBuiltin = true; trieHas->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("trie.has expects 1 argument");
+						auto t = static_cast<NativeTrie*>(getThisInstanceExt(clos)->nativeHandle);
+						auto key = std::get_if<std::string>(&args[0]);
+						return Value{ key && t->find(*key) != nullptr };
+					};
+					trieClass->methods["has"] = trieHas;
+					auto trieDelete = std::make_shared<Function>(); trieDelete->isBuiltin = true; trieDelete->builtin = [getThisInstanceExt](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("trie.delete expects 1 argument");
+						auto t = static_cast<NativeTrie*>(getThisInstanceExt(clos)->nativeHandle);
+						auto key = std::get_if<std::string>(&args[0]);
+						return Value{ key && t->remove(*key) };
+					};
+					trieClass->methods["delete"] = trieDelete;
+					auto trieSize = std::make_shared<Function>(); trieSize->isBuiltin = true; trieSize->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						return Value{ static_cast<double>(static_cast<NativeTrie*>(getThisInstanceExt(clos)->nativeHandle)->root.count) };
+					};
+					trieClass->methods["size"] = trieSize;
+					auto trieCountPrefix = std::make_shared<Function>(); trieCountPrefix->isBuiltin = true; trieCountPrefix->builtin = [getThisInstanceExt, trieKey](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("trie.countPrefix expects (prefix)");
+						auto t = static_cast<NativeTrie*>(getThisInstanceExt(clos)->nativeHandle);
+						std::string full;
+						TrieNode* n = t->locatePrefix(trieKey(args[0], "trie.countPrefix"), full);
+						return Value{ static_cast<double>(n ? n->count : 0) };
+					};
+					trieClass->methods["countPrefix"] = trieCountPrefix;
+					// keysWithPrefix(prefix = "", limit) / entriesWithPrefix(prefix = "", limit)：字典序，最多 limit 个
+					auto makePrefixQuery = [getThisInstanceExt, trieKey, trieLimit](bool entries, const char* what) {
+						auto fn = std::make_shared<Function>(); fn->isBuiltin = true;
+						fn->builtin = [getThisInstanceExt, trieKey, trieLimit, entries, what](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+							if (args.size() > 2) throw std::runtime_error(std::string(what) + " expects ([prefix [, limit]])");
+							auto t = static_cast<NativeTrie*>(getThisInstanceExt(clos)->nativeHandle);
+							static const std::string empty;
+							const std::string& prefix = args.empty() ? empty : trieKey(args[0], what);
+							size_t limit = trieLimit(args, 1, what);
+							auto out = std::make_shared<Array>();
+							std::string key;
+							TrieNode* n = t->locatePrefix(prefix, key);
+							if (!n || limit == 0) return Value{out};
+							NativeTrie::walk(n, key, [&](const std::string& k, const Value& v) {
+								if (entries) {
+									auto pair = std::make_shared<Array>();
+									pair->push_back(Value{k});
+									pair->push_back(v);
+									out->push_back(Value{pair});
+								} else {
+									out->push_back(Value{k});
+								}
+								return out->size() < limit;
+							});
+							return Value{out};
+						};
+						return fn;
+					};
+					trieClass->methods["keysWithPrefix"] = makePrefixQuery(false, "trie.keysWithPrefix");
+					trieClass->methods["entriesWithPrefix"] = makePrefixQuery(true, "trie.entriesWithPrefix");
+					trieClass->methods["keys"] = trieClass->methods["keysWithPrefix"];
+					trieClass->methods["entries"] = trieClass->methods["entriesWithPrefix"];
+					// longestPrefix(text): text 的最长前缀键，返回 {key, value}，没有则 null
+					auto trieLongest = std::make_shared<Function>(); trieLongest->isBuiltin = true; trieLongest->builtin = [getThisInstanceExt, trieKey](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+						if (args.size()!=1) throw std::runtime_error("trie.longestPrefix expects (text)");
+						auto t = static_cast<NativeTrie*>(getThisInstanceExt(clos)->nativeHandle);
+						const std::string& text = trieKey(args[0], "trie.longestPrefix");
+						size_t matched = 0;
+						TrieNode* n = t->longestPrefix(text, matched);
+						if (!n) return Value{std::monostate{}};
+						auto o = std::make_shared<Object>();
+						(*o)["key"] = Value{ text.substr(0, matched) };
+						(*o)["value"] = n->value;
+						return Value{o};
+					};
+					trieClass->methods["longestPrefix"] = trieLongest;
+					auto trieClear = std::make_shared<Function>(); trieClear->isBuiltin = true; trieClear->builtin = [getThisInstanceExt](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+						auto t = static_cast<NativeTrie*>(getThisInstanceExt(clos)->nativeHandle);
+						t->root = TrieNode{};
+						return Value{std::monostate{}};
+					};
+					trieClass->methods["clear"] = trieClear;
+					auto trieCtor = std::make_shared<Function>(); trieCtor->isBuiltin = true; trieCtor->builtin = [wrapTrie, fillTrie](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+						std::unique_ptr<NativeTrie> t(new NativeTrie());
+						fillTrie(t.get(), args, "trie");
+						return wrapTrie(t.release());
+					};
+					interp.registerPackageSymbol("std.collections", "Trie", Value{trieClass});
+					interp.registerPackageSymbol("std.collections", "trie", Value{trieCtor});
+
 					// ---- binarySearch (function) ----
 					auto binarySearchFn = std::make_shared<Function>(); binarySearchFn->isBuiltin = true; binarySearchFn->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
 						if (args.size()!=2) throw std::runtime_error("binarySearch expects (array, target)");
@@ -38,7 +38,8 @@ static std::string generateUUIDv4() {
 }
 
 void registerStdCryptoPackage(Interpreter& interp) {
-    interp.registerLazyPackage("std.crypto", [](std::shared_ptr<Object> pkg){
+    Interpreter* interpPtr = &interp;
+    interp.registerLazyPackage("std.crypto", [interpPtr](std::shared_ptr<Object> pkg){
         // crypto.randomUUID() -> string
         auto uuidFn = std::make_shared<Function>(); uuidFn->isBuiltin = true;
         uuidFn->builtin = [](const std::vector<Value>&, std::shared_ptr<Environment>)->Value {
@@ -120,6 +121,12 @@ void registerStdCryptoPackage(Interpreter& interp) {
         (*pkg)["sha256"] = Value{ mkStub("sha256") };
 #endif
 
+        // md5Async / sha1Async / sha256Async: 在工作线程上计算摘要，返回 Promise
+        for (const char* name : {"md5", "sha1", "sha256"}) {
+            auto fn = std::get<std::shared_ptr<Function>>((*pkg)[name]);
+            (*pkg)[std::string(name) + "Async"] = Value{ interpPtr->makeOffloadedBuiltin(fn) };
+        }
+
 #ifdef ASUL_HAS_OPENSSL
         // AES-256-CBC encryption
         // aes.encrypt(plaintext: string, key: string, iv: string) -> base64 string
@@ -245,6 +252,8 @@ void registerStdCryptoPackage(Interpreter& interp) {
             }
         };
         (*aesObj)["decrypt"] = Value{ aesDecryptFn };
+        (*aesObj)["encryptAsync"] = Value{ interpPtr->makeOffloadedBuiltin(aesEncryptFn) };
+        (*aesObj)["decryptAsync"] = Value{ interpPtr->makeOffloadedBuiltin(aesDecryptFn) };
         
         // aes.generateKey() -> 32-byte hex string
         auto aesGenKeyFn = std::make_shared<Function>(); aesGenKeyFn->isBuiltin = true;
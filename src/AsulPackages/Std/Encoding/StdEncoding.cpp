@@ -57,6 +57,9 @@ void registerStdEncodingPackage(Interpreter& interp) {
 		return Value{out};
 	};
 	(*base64Obj)["decode"] = Value{b64dec};
+	// encodeAsync / decodeAsync: 在工作线程上编解码，返回 Promise
+	(*base64Obj)["encodeAsync"] = Value{interp.makeOffloadedBuiltin(b64enc)};
+	(*base64Obj)["decodeAsync"] = Value{interp.makeOffloadedBuiltin(b64dec)};
 
 	// Base64URL (URL-safe variant)
 	auto base64urlObj = std::make_shared<Object>();
@@ -0,0 +1,434 @@
+#include "StdFmt.h"
+#include "../../../AsulInterpreter.h"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace asul {
+
+namespace {
+
+// ----------- 格式串编译 -----------
+// "{[字段][:规格]}"，规格为 [[填充]对齐][符号][#][0][宽度][,|_][.精度][类型]，与 Python / {fmt} 相同。
+// 格式串只解析一次：字面文本拼进 text，每个占位符的规格预先拆成 FormatSpec，渲染时直接写入同一个输出缓冲。
+struct FormatSpec {
+	std::string fill{ " " };
+	char align{0};    // '<' '>' '^' '='，0 表示按类型默认 (数字右对齐、其余左对齐)
+	char sign{'-'};   // '-' '+' ' '
+	bool alt{false};  // '#'：0x / 0o / 0b 前缀，g 保留末尾的 0
+	size_t width{0};
+	char grouping{0}; // ',' 或 '_'
+	int precision{-1};
+	char type{0};
+};
+
+struct Segment {
+	uint32_t textOffset{0};
+	uint32_t textLength{0};   // 字面文本；字段前的文本与字段合并在同一段里
+	bool hasField{false};
+	int argIndex{-1};         // 位置参数下标；-1 表示按名字取
+	std::string name;         // 从最后一个 (对象) 参数里取的字段名
+	FormatSpec spec;
+};
+
+struct Compiled {
+	std::string source;
+	std::string text;
+	std::vector<Segment> segments;
+	int positional{0};        // 需要的位置参数个数
+	bool named{false};
+};
+
+using CompiledPtr = std::shared_ptr<const Compiled>;
+
+[[noreturn]] void formatError(const std::string& msg) { throw std::runtime_error("fmt: " + msg); }
+
+size_t utf8Length(const char* s, size_t n) {
+	size_t count = 0;
+	for (size_t i = 0; i < n; ++i) if ((static_cast<unsigned char>(s[i]) & 0xC0) != 0x80) ++count;
+	return count;
+}
+
+// 前 n 个码点占用的字节数
+size_t utf8Prefix(const std::string& s, size_t n) {
+	size_t i = 0;
+	while (i < s.size() && n > 0) {
+		++i;
+		while (i < s.size() && (static_cast<unsigned char>(s[i]) & 0xC0) == 0x80) ++i;
+		--n;
+	}
+	return i;
+}
+
+bool parseNumber(const std::string& s, size_t& i, size_t& out) {
+	size_t start = i;
+	out = 0;
+	while (i < s.size() && s[i] >= '0' && s[i] <= '9') {
+		out = out * 10 + static_cast<size_t>(s[i] - '0');
+		if (out > 100000) formatError("width or precision too large in '" + s + "'");
+		++i;
+	}
+	return i > start;
+}
+
+FormatSpec parseSpec(const std::string& s) {
+	FormatSpec spec;
+	size_t i = 0;
+	auto isAlign = [](char c) { return c == '<' || c == '>' || c == '^' || c == '='; };
+	size_t first = utf8Prefix(s, 1);
+	if (first < s.size() && isAlign(s[first])) {
+		spec.fill = s.substr(0, first);
+		spec.align = s[first];
+		i = first + 1;
+	} else if (!s.empty() && isAlign(s[0])) {
+		spec.align = s[0];
+		i = 1;
+	}
+	if (i < s.size() && (s[i] == '+' || s[i] == '-' || s[i] == ' ')) spec.sign = s[i++];
+	if (i < s.size() && s[i] == '#') { spec.alt = true; ++i; }
+	if (i < s.size() && s[i] == '0') {
+		// 0 标志：数字在符号之后补 0 (显式给出对齐方式时不生效)
+		if (!spec.align) { spec.fill = "0"; spec.align = '='; }
+		++i;
+	}
+	size_t n = 0;
+	if (parseNumber(s, i, n)) spec.width = n;
+	if (i < s.size() && (s[i] == ',' || s[i] == '_')) spec.grouping = s[i++];
+	if (i < s.size() && s[i] == '.') {
+		++i;
+		if (!parseNumber(s, i, n)) formatError("missing precision after '.' in '" + s + "'");
+		spec.precision = static_cast<int>(n);
+	}
+	if (i < s.size()) {
+		if (!std::strchr("sdxXobfFeEgG%", s[i])) formatError(std::string("unknown format type '") + s[i] + "' in '" + s + "'");
+		spec.type = s[i++];
+	}
+	if (i != s.size()) formatError("invalid format spec '" + s + "'");
+	if (spec.grouping && spec.type && std::strchr("sxXob", spec.type) && !(spec.grouping == '_' && spec.type != 's')) {
+		formatError(std::string("cannot use '") + spec.grouping + "' with type '" + spec.type + "'");
+	}
+	if (spec.precision >= 0 && spec.type && std::strchr("dxXob", spec.type)) formatError("precision not allowed for integer type '" + std::string(1, spec.type) + "'");
+	return spec;
+}
+
+CompiledPtr compileFormat(const std::string& src) {
+	auto c = std::make_shared<Compiled>();
+	c->source = src;
+	Segment seg;
+	auto flushText = [&](size_t from, size_t to) { c->text.append(src, from, to - from); seg.textLength += static_cast<uint32_t>(to - from); };
+	int autoIndex = 0;
+	bool manual = false, automatic = false;
+	size_t i = 0, textStart = 0;
+	while (i < src.size()) {
+		char ch = src[i];
+		if (ch == '}') {
+			if (i + 1 < src.size() && src[i + 1] == '}') { flushText(textStart, i + 1); i += 2; textStart = i; continue; }
+			formatError("single '}' in format string \"" + src + "\"");
+		}
+		if (ch != '{') { ++i; continue; }
+		if (i + 1 < src.size() && src[i + 1] == '{') { flushText(textStart, i + 1); i += 2; textStart = i; continue; }
+		flushText(textStart, i);
+		size_t close = src.find('}', i + 1);
+		if (close == std::string::npos) formatError("unmatched '{' in format string \"" + src + "\"");
+		std::string field = src.substr(i + 1, close - i - 1);
+		if (field.find('{') != std::string::npos) formatError("nested replacement fields are not supported in \"" + src + "\"");
+		size_t colon = field.find(':');
+		std::string id = field.substr(0, colon);
+		seg.hasField = true;
+		if (id.empty()) {
+			if (manual) formatError("cannot switch from manual to automatic field numbering");
+			automatic = true;
+			seg.argIndex = autoIndex++;
+		} else if (id[0] >= '0' && id[0] <= '9') {
+			if (automatic) formatError("cannot switch from automatic to manual field numbering");
+			manual = true;
+			size_t p = 0, n = 0;
+			parseNumber(id, p, n);
+			if (p != id.size()) formatError("invalid field '" + id + "'");
+			seg.argIndex = static_cast<int>(n);
+		} else {
+			seg.argIndex = -1;
+			seg.name = id;
+			c->named = true;
+		}
+		if (seg.argIndex >= 0) c->positional = std::max(c->positional, seg.argIndex + 1);
+		if (colon != std::string::npos) seg.spec = parseSpec(field.substr(colon + 1));
+		seg.textOffset = static_cast<uint32_t>(c->text.size() - seg.textLength);
+		c->segments.push_back(std::move(seg));
+		seg = Segment{};
+		seg.textOffset = static_cast<uint32_t>(c->text.size());
+		i = close + 1;
+		textStart = i;
+	}
+	flushText(textStart, src.size());
+	if (seg.textLength) {
+		seg.textOffset = static_cast<uint32_t>(c->text.size() - seg.textLength);
+		c->segments.push_back(std::move(seg));
+	}
+	return c;
+}
+
+// ----------- 值格式化 -----------
+void pad(std::string& out, const std::string& fill, size_t count) {
+	if (fill.size() == 1) { out.append(count, fill[0]); return; }
+	for (size_t i = 0; i < count; ++i) out += fill;
+}
+
+// 在整数部分插入千分位 (每 3 位) 或十六进制等的下划线 (每 4 位)
+std::string grouped(const std::string& digits, char sep, size_t every) {
+	if (!sep || digits.size() <= every) return digits;
+	std::string r;
+	r.reserve(digits.size() + digits.size() / every);
+	size_t lead = digits.size() % every;
+	if (lead == 0) lead = every;
+	r.append(digits, 0, lead);
+	for (size_t i = lead; i < digits.size(); i += every) { r.push_back(sep); r.append(digits, i, every); }
+	return r;
+}
+
+// 最短的可回读表示 (15 位不够时再试 16、17 位)
+std::string shortestRepr(double v) {
+	char buf[40];
+	for (int prec = 15; prec <= 17; ++prec) {
+		std::snprintf(buf, sizeof(buf), "%.*g", prec, v);
+		if (prec == 17 || std::strtod(buf, nullptr) == v) break;
+	}
+	return buf;
+}
+
+std::string integerDigits(double mag, int base, bool upper) {
+	if (mag < 9007199254740992.0) {
+		char buf[72];
+		auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), static_cast<uint64_t>(mag), base);
+		(void)ec;
+		std::string s(buf, end);
+		if (upper) for (auto& ch : s) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+		return s;
+	}
+	if (base != 10) formatError("integer too large for base " + std::to_string(base) + " formatting");
+	char buf[400];
+	std::snprintf(buf, sizeof(buf), "%.0f", mag);
+	return buf;
+}
+
+const char* typeName(const Value& v) {
+	if (std::holds_alternative<std::string>(v)) return "string";
+	if (std::holds_alternative<bool>(v)) return "bool";
+	if (std::holds_alternative<std::monostate>(v)) return "null";
+	return "non-number";
+}
+
+void formatNumber(std::string& out, double v, const FormatSpec& spec) {
+	char type = spec.type;
+	bool negative = std::signbit(v) && !std::isnan(v);
+	double mag = std::fabs(v);
+	std::string prefix, body;
+	if (negative) prefix = "-";
+	else if (spec.sign == '+') prefix = "+";
+	else if (spec.sign == ' ') prefix = " ";
+
+	bool integral = std::isfinite(v) && std::floor(v) == v;
+	if (!std::isfinite(v)) {
+		body = std::isnan(v) ? "nan" : "inf";
+		if (type && std::isupper(static_cast<unsigned char>(type))) body = std::isnan(v) ? "NAN" : "INF";
+	} else if (type == 'd' || type == 'x' || type == 'X' || type == 'o' || type == 'b') {
+		if (!integral) formatError(std::string("'") + type + "' requires an integer, got " + shortestRepr(v));
+		int base = type == 'd' ? 10 : type == 'o' ? 8 : type == 'b' ? 2 : 16;
+		body = grouped(integerDigits(mag, base, type == 'X'), spec.grouping, base == 10 ? 3 : 4);
+		if (spec.alt && base != 10) prefix += type == 'x' ? "0x" : type == 'X' ? "0X" : type == 'o' ? "0o" : "0b";
+	} else if (type == 0 && spec.precision < 0) {
+		// 未指定类型：整数原样输出，其余用最短的可回读表示
+		if (integral && mag < 1e16) body = grouped(integerDigits(mag, 10, false), spec.grouping, 3);
+		else body = shortestRepr(mag);
+	} else {
+		char conv = type ? type : 'g';
+		double x = mag;
+		if (conv == '%') { x *= 100; conv = 'f'; }
+		int prec = spec.precision >= 0 ? spec.precision : 6;
+		char fmtBuf[8];
+		std::snprintf(fmtBuf, sizeof(fmtBuf), spec.alt ? "%%#.*%c" : "%%.*%c", conv);
+		char buf[512];
+		int n = std::snprintf(buf, sizeof(buf), fmtBuf, prec, x);
+		if (n < 0 || n >= static_cast<int>(sizeof(buf))) {
+			std::vector<char> big(static_cast<size_t>(n > 0 ? n : 0) + 1);
+			std::snprintf(big.data(), big.size(), fmtBuf, prec, x);
+			body.assign(big.data());
+		} else {
+			body.assign(buf, static_cast<size_t>(n));
+		}
+		if (spec.grouping) {
+			size_t intEnd = body.find_first_not_of("0123456789");
+			if (intEnd == std::string::npos) intEnd = body.size();
+			body = grouped(body.substr(0, intEnd), spec.grouping, 3) + body.substr(intEnd);
+		}
+		if (type == '%') body.push_back('%');
+	}
+
+	size_t len = prefix.size() + utf8Length(body.data(), body.size());
+	size_t fillCount = spec.width > len ? spec.width - len : 0;
+	char align = spec.align ? spec.align : '>';
+	if (align == '=') { out += prefix; pad(out, spec.fill, fillCount); out += body; return; }
+	if (align == '<') { out += prefix; out += body; pad(out, spec.fill, fillCount); return; }
+	if (align == '^') { pad(out, spec.fill, fillCount / 2); out += prefix; out += body; pad(out, spec.fill, fillCount - fillCount / 2); return; }
+	pad(out, spec.fill, fillCount); out += prefix; out += body;
+}
+
+void formatText(std::string& out, const std::string& s, const FormatSpec& spec) {
+	size_t bytes = spec.precision >= 0 ? utf8Prefix(s, static_cast<size_t>(spec.precision)) : s.size();
+	if (spec.width == 0) { out.append(s, 0, bytes); return; }
+	size_t len = utf8Length(s.data(), bytes);
+	size_t fillCount = spec.width > len ? spec.width - len : 0;
+	char align = spec.align ? spec.align : '<';
+	if (align == '=') formatError("'=' alignment is only allowed for numbers");
+	if (align == '>') pad(out, spec.fill, fillCount);
+	else if (align == '^') pad(out, spec.fill, fillCount / 2);
+	out.append(s, 0, bytes);
+	if (align == '<') pad(out, spec.fill, fillCount);
+	else if (align == '^') pad(out, spec.fill, fillCount - fillCount / 2);
+}
+
+void formatValue(std::string& out, const Value& v, const FormatSpec& spec) {
+	if (auto n = std::get_if<double>(&v)) {
+		if (spec.type == 's') formatText(out, toString(v), spec);
+		else formatNumber(out, *n, spec);
+		return;
+	}
+	if (spec.type && spec.type != 's') formatError(std::string("'") + spec.type + "' requires a number, got " + typeName(v));
+	if (spec.sign != '-' || spec.alt || spec.grouping) formatError(std::string("sign, '#' and grouping options require a number, got ") + typeName(v));
+	if (auto s = std::get_if<std::string>(&v)) formatText(out, *s, spec);
+	else formatText(out, toString(v), spec);
+}
+
+Value namedArg(const std::vector<Value>& args, size_t first, const std::string& name) {
+	if (args.size() <= first) formatError("field '" + name + "' needs an object argument");
+	const Value& holder = args.back();
+	if (auto po = std::get_if<std::shared_ptr<Object>>(&holder); po && *po) {
+		auto it = (*po)->find(name);
+		if (it == (*po)->end()) formatError("missing field '" + name + "'");
+		return it->second;
+	}
+	if (auto pins = std::get_if<std::shared_ptr<Instance>>(&holder); pins && *pins) {
+		auto it = (*pins)->fields.find(name);
+		if (it == (*pins)->fields.end()) formatError("missing field '" + name + "'");
+		return it->second;
+	}
+	formatError("field '" + name + "' needs an object as the last argument");
+}
+
+// args[first..] 是格式参数；按名字的字段从最后一个参数 (对象) 中取
+std::string render(const Compiled& c, const std::vector<Value>& args, size_t first) {
+	size_t given = args.size() - first;
+	if (static_cast<size_t>(c.positional) > given) {
+		formatError("format string \"" + c.source + "\" needs " + std::to_string(c.positional) + " argument(s), got " + std::to_string(given));
+	}
+	std::string out;
+	out.reserve(c.text.size() + c.segments.size() * 8);
+	for (auto& seg : c.segments) {
+		out.append(c.text, seg.textOffset, seg.textLength);
+		if (!seg.hasField) continue;
+		const Value& v = seg.argIndex >= 0 ? args[first + static_cast<size_t>(seg.argIndex)] : namedArg(args, first, seg.name);
+		formatValue(out, v, seg.spec);
+	}
+	return out;
+}
+
+// 每个包实例按格式串缓存编译结果
+struct FmtState {
+	std::unordered_map<std::string, CompiledPtr> cache;
+	static constexpr size_t kCacheLimit = 1024;
+
+	CompiledPtr compile(const std::string& src) {
+		auto it = cache.find(src);
+		if (it != cache.end()) return it->second;
+		auto c = compileFormat(src);
+		if (cache.size() >= kCacheLimit) cache.clear();
+		cache.emplace(src, c);
+		return c;
+	}
+};
+
+struct FormatterHandle {
+	CompiledPtr compiled;
+};
+
+using NativeFn = std::function<Value(const std::vector<Value>&, std::shared_ptr<Environment>)>;
+
+std::shared_ptr<Function> builtin(NativeFn fn) {
+	auto f = std::make_shared<Function>();
+	f->isBuiltin = true;
+	f->builtin = std::move(fn);
+	return f;
+}
+
+InstanceExt* thisInstance(const std::shared_ptr<Environment>& clos) {
+	if (!clos) throw std::runtime_error("internal: instance method called without closure");
+	Value tv = clos->get("this");
+	auto pins = std::get_if<std::shared_ptr<Instance>>(&tv);
+	if (!pins || !*pins) throw std::runtime_error("internal: invalid 'this' value");
+	return static_cast<InstanceExt*>(pins->get());
+}
+
+void attachCompiled(InstanceExt* inst, CompiledPtr c) {
+	if (inst->nativeHandle && inst->nativeDestructor) inst->nativeDestructor(inst->nativeHandle);
+	inst->fields["source"] = Value{ c->source };
+	inst->nativeHandle = new FormatterHandle{ std::move(c) };
+	inst->nativeDestructor = [](void* p) { delete static_cast<FormatterHandle*>(p); };
+}
+
+const std::string& formatArg(const std::vector<Value>& args, const char* what) {
+	if (args.empty() || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error(std::string(what) + " expects a format string as the first argument");
+	return std::get<std::string>(args[0]);
+}
+
+} // namespace
+
+void registerStdFmtPackage(Interpreter& interp) {
+	interp.registerLazyPackage("std.fmt", [](std::shared_ptr<Object> pkg) {
+		auto state = std::make_shared<FmtState>();
+
+		// ---- Formatter(format)：预编译的格式串，format(...args) 直接套用 ----
+		auto formatterClass = std::make_shared<ClassInfo>(); formatterClass->name = "Formatter"; formatterClass->isNative = true;
+		formatterClass->methods["constructor"] = builtin([state](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("Formatter expects 1 argument (format string)");
+			attachCompiled(thisInstance(clos), state->compile(formatArg(args, "Formatter")));
+			return Value{ std::monostate{} };
+		});
+		formatterClass->methods["format"] = builtin([](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			auto h = static_cast<FormatterHandle*>(thisInstance(clos)->nativeHandle);
+			if (!h || !h->compiled) throw std::runtime_error("Formatter.format: formatter not initialized");
+			return Value{ render(*h->compiled, args, 0) };
+		});
+
+		// format(fmt, ...args) -> string
+		(*pkg)["format"] = Value{ builtin([state](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			return Value{ render(*state->compile(formatArg(args, "fmt.format")), args, 1) };
+		}) };
+		// compile(fmt) -> Formatter
+		std::weak_ptr<ClassInfo> weakClass = formatterClass;
+		(*pkg)["compile"] = Value{ builtin([state, weakClass](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			if (args.size() != 1) throw std::runtime_error("fmt.compile expects 1 argument (format string)");
+			auto inst = std::make_shared<InstanceExt>();
+			inst->klass = weakClass.lock();
+			attachCompiled(inst.get(), state->compile(formatArg(args, "fmt.compile")));
+			return Value{ std::shared_ptr<Instance>(inst) };
+		}) };
+		(*pkg)["Formatter"] = formatterClass;
+	});
+}
+
+PackageMeta getStdFmtPackageMeta() {
+	PackageMeta pkg;
+	pkg.name = "std.fmt";
+	pkg.exports = { "format", "compile" };
+
+	ClassMeta formatterClass;
+	formatterClass.name = "Formatter";
+	formatterClass.methods = { {"constructor"}, {"format"} };
+	pkg.classes.push_back(formatterClass);
+
+	return pkg;
+}
+
+} // namespace asul
@@ -0,0 +1,16 @@
+#ifndef STD_FMT_H
+#define STD_FMT_H
+
+#include "../../PackageMeta.h"
+
+namespace asul {
+
+class Interpreter;
+
+// Register the std.fmt package ("{:>10.3f}"-style format strings, parsed once and cached) with the interpreter
+void registerStdFmtPackage(Interpreter& interp);
+PackageMeta getStdFmtPackageMeta();
+
+} // namespace asul
+
+#endif // STD_FMT_H
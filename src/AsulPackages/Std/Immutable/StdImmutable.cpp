@@ -0,0 +1,934 @@
+#include "StdImmutable.h"
+#include "../../../AsulInterpreter.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+namespace asul {
+
+namespace {
+
+// ----------- 持久化结构公共部分 -----------
+// 每个节点记录创建它的 transient 令牌 (edit)。persistent 操作使用 edit=0，总是复制路径；
+// transient 持有唯一的非零令牌，只会原地修改自己创建的节点，persistent() 之后令牌作废。
+
+constexpr int kBits = 5;
+constexpr uint32_t kWidth = 1u << kBits;
+constexpr uint32_t kMask = kWidth - 1;
+
+uint64_t nextEditToken() {
+	static std::atomic<uint64_t> counter{0};
+	return ++counter;
+}
+
+template <typename Node>
+std::shared_ptr<Node> editable(const std::shared_ptr<Node>& n, uint64_t edit) {
+	if (edit && n->edit == edit) return n;
+	auto copy = std::make_shared<Node>(*n);
+	copy->edit = edit;
+	return copy;
+}
+
+// ----------- HAMT (CHAMP layout) -----------
+// 位图压缩的 32 路哈希前缀树：entries 存放本层的键值，children 存放子树。
+// 64 位哈希全部相同的键放进 collision 节点线性查找。
+
+struct HamtEntry { Value key; Value value; };
+
+struct HamtNode {
+	uint32_t dataMap{0};
+	uint32_t nodeMap{0};
+	bool collision{false};
+	uint64_t edit{0};
+	std::vector<HamtEntry> entries;
+	std::vector<std::shared_ptr<HamtNode>> children;
+};
+using HamtPtr = std::shared_ptr<HamtNode>;
+
+struct HamtMap {
+	HamtPtr root;
+	size_t count{0};
+};
+
+inline uint64_t hashKey(const Value& key) { return static_cast<uint64_t>(valueHash(key)); }
+inline uint32_t fragment(uint64_t h, int shift) { return static_cast<uint32_t>((h >> shift) & kMask); }
+inline size_t slot(uint32_t bitmap, uint32_t bit) { return static_cast<size_t>(__builtin_popcount(bitmap & (bit - 1))); }
+
+HamtMap emptyHamt() {
+	static const HamtPtr root = std::make_shared<HamtNode>();
+	return HamtMap{ root, 0 };
+}
+
+const HamtEntry* hamtFind(const HamtMap& m, const Value& key) {
+	uint64_t h = hashKey(key);
+	const HamtNode* n = m.root.get();
+	for (int shift = 0;; shift += kBits) {
+		if (n->collision) {
+			for (auto& e : n->entries) if (valueEqual(e.key, key)) return &e;
+			return nullptr;
+		}
+		uint32_t bit = 1u << fragment(h, shift);
+		if (n->dataMap & bit) {
+			auto& e = n->entries[slot(n->dataMap, bit)];
+			return valueEqual(e.key, key) ? &e : nullptr;
+		}
+		if (!(n->nodeMap & bit)) return nullptr;
+		n = n->children[slot(n->nodeMap, bit)].get();
+	}
+}
+
+HamtPtr hamtPair(uint64_t edit, int shift, HamtEntry a, uint64_t ha, HamtEntry b, uint64_t hb) {
+	auto n = std::make_shared<HamtNode>();
+	n->edit = edit;
+	if (shift >= 64) {
+		n->collision = true;
+		n->entries.push_back(std::move(a));
+		n->entries.push_back(std::move(b));
+		return n;
+	}
+	uint32_t fa = fragment(ha, shift), fb = fragment(hb, shift);
+	if (fa == fb) {
+		n->nodeMap = 1u << fa;
+		n->children.push_back(hamtPair(edit, shift + kBits, std::move(a), ha, std::move(b), hb));
+		return n;
+	}
+	n->dataMap = (1u << fa) | (1u << fb);
+	if (fa > fb) std::swap(a, b);
+	n->entries.push_back(std::move(a));
+	n->entries.push_back(std::move(b));
+	return n;
+}
+
+HamtPtr hamtAssoc(const HamtPtr& n, uint64_t edit, uint64_t h, int shift, const Value& key, const Value& value, bool& added) {
+	if (n->collision) {
+		for (size_t i = 0; i < n->entries.size(); ++i) {
+			if (!valueEqual(n->entries[i].key, key)) continue;
+			auto m = editable(n, edit);
+			m->entries[i].value = value;
+			return m;
+		}
+		added = true;
+		auto m = editable(n, edit);
+		m->entries.push_back(HamtEntry{ key, value });
+		return m;
+	}
+	uint32_t bit = 1u << fragment(h, shift);
+	if (n->dataMap & bit) {
+		size_t i = slot(n->dataMap, bit);
+		const HamtEntry& cur = n->entries[i];
+		if (valueEqual(cur.key, key)) {
+			auto m = editable(n, edit);
+			m->entries[i].value = value;
+			return m;
+		}
+		// 同一位置已有别的键：两者一起下沉到新的子节点
+		added = true;
+		auto child = hamtPair(edit, shift + kBits, cur, hashKey(cur.key), HamtEntry{ key, value }, h);
+		auto m = editable(n, edit);
+		m->entries.erase(m->entries.begin() + i);
+		m->dataMap ^= bit;
+		m->nodeMap |= bit;
+		m->children.insert(m->children.begin() + slot(m->nodeMap, bit), std::move(child));
+		return m;
+	}
+	if (n->nodeMap & bit) {
+		size_t j = slot(n->nodeMap, bit);
+		auto child = hamtAssoc(n->children[j], edit, h, shift + kBits, key, value, added);
+		if (child == n->children[j]) return n; // 子节点已原地修改，本节点同属该 transient
+		auto m = editable(n, edit);
+		m->children[j] = std::move(child);
+		return m;
+	}
+	added = true;
+	auto m = editable(n, edit);
+	m->dataMap |= bit;
+	m->entries.insert(m->entries.begin() + slot(m->dataMap, bit), HamtEntry{ key, value });
+	return m;
+}
+
+HamtPtr hamtDissoc(const HamtPtr& n, uint64_t edit, uint64_t h, int shift, const Value& key, bool& removed) {
+	if (n->collision) {
+		for (size_t i = 0; i < n->entries.size(); ++i) {
+			if (!valueEqual(n->entries[i].key, key)) continue;
+			removed = true;
+			auto m = editable(n, edit);
+			m->entries.erase(m->entries.begin() + i);
+			return m;
+		}
+		return n;
+	}
+	uint32_t bit = 1u << fragment(h, shift);
+	if (n->dataMap & bit) {
+		size_t i = slot(n->dataMap, bit);
+		if (!valueEqual(n->entries[i].key, key)) return n;
+		removed = true;
+		auto m = editable(n, edit);
+		m->entries.erase(m->entries.begin() + i);
+		m->dataMap ^= bit;
+		return m;
+	}
+	if (n->nodeMap & bit) {
+		size_t j = slot(n->nodeMap, bit);
+		auto child = hamtDissoc(n->children[j], edit, h, shift + kBits, key, removed);
+		if (!removed) return n;
+		auto m = editable(n, edit);
+		if (child->children.empty() && child->entries.size() <= 1) {
+			// 只剩一个键的子节点上提到本层，保持规范形状 (相同内容的树形状相同)
+			m->children.erase(m->children.begin() + j);
+			m->nodeMap ^= bit;
+			if (!child->entries.empty()) {
+				m->dataMap |= bit;
+				m->entries.insert(m->entries.begin() + slot(m->dataMap, bit), child->entries.front());
+			}
+			return m;
+		}
+		m->children[j] = std::move(child);
+		return m;
+	}
+	return n;
+}
+
+void hamtSet(HamtMap& m, uint64_t edit, const Value& key, const Value& value) {
+	bool added = false;
+	m.root = hamtAssoc(m.root, edit, hashKey(key), 0, key, value, added);
+	if (added) ++m.count;
+}
+
+bool hamtDelete(HamtMap& m, uint64_t edit, const Value& key) {
+	bool removed = false;
+	m.root = hamtDissoc(m.root, edit, hashKey(key), 0, key, removed);
+	if (removed) --m.count;
+	return removed;
+}
+
+template <typename Fn>
+void hamtEach(const HamtNode* n, Fn&& fn) {
+	for (auto& e : n->entries) fn(e);
+	for (auto& c : n->children) hamtEach(c.get(), fn);
+}
+
+bool hamtEquals(const HamtMap& a, const HamtMap& b, bool compareValues) {
+	if (a.count != b.count) return false;
+	if (a.root == b.root) return true;
+	bool same = true;
+	hamtEach(a.root.get(), [&](const HamtEntry& e) {
+		if (!same) return;
+		auto other = hamtFind(b, e.key);
+		same = other && (!compareValues || valueEqual(e.value, other->value));
+	});
+	return same;
+}
+
+// ----------- Persistent vector -----------
+// 32 路前缀树 + 尾部缓冲 (tail)：push/pop 摊还 O(1)，get/set 为 O(log32 n)。
+
+struct VecNode {
+	uint64_t edit{0};
+	std::vector<std::shared_ptr<VecNode>> children;
+	std::vector<Value> values;
+};
+using VecPtr = std::shared_ptr<VecNode>;
+
+struct PVector {
+	size_t count{0};
+	int shift{kBits};
+	VecPtr root;
+	VecPtr tail;
+	size_t tailOffset() const { return count < kWidth ? 0 : ((count - 1) >> kBits) << kBits; }
+};
+
+PVector emptyVector() {
+	static const VecPtr root = std::make_shared<VecNode>();
+	static const VecPtr tail = std::make_shared<VecNode>();
+	PVector v;
+	v.root = root;
+	v.tail = tail;
+	return v;
+}
+
+const VecPtr& vecLeaf(const PVector& v, size_t i) {
+	if (i >= v.tailOffset()) return v.tail;
+	const VecPtr* n = &v.root;
+	for (int level = v.shift; level > 0; level -= kBits) n = &(*n)->children[(i >> level) & kMask];
+	return *n;
+}
+
+const Value& vecGet(const PVector& v, size_t i) { return vecLeaf(v, i)->values[i & kMask]; }
+
+VecPtr vecNewPath(uint64_t edit, int level, VecPtr node) {
+	for (; level > 0; level -= kBits) {
+		auto parent = std::make_shared<VecNode>();
+		parent->edit = edit;
+		parent->children.push_back(std::move(node));
+		node = std::move(parent);
+	}
+	return node;
+}
+
+VecPtr vecPushTail(const PVector& v, uint64_t edit, int level, const VecPtr& parent, VecPtr full) {
+	size_t sub = ((v.count - 1) >> level) & kMask;
+	VecPtr insert;
+	if (level == kBits) insert = std::move(full);
+	else if (sub < parent->children.size()) insert = vecPushTail(v, edit, level - kBits, parent->children[sub], std::move(full));
+	else insert = vecNewPath(edit, level - kBits, std::move(full));
+	auto m = editable(parent, edit);
+	if (sub < m->children.size()) m->children[sub] = std::move(insert);
+	else m->children.push_back(std::move(insert));
+	return m;
+}
+
+void vecPush(PVector& v, uint64_t edit, const Value& x) {
+	if (v.count - v.tailOffset() < kWidth) {
+		v.tail = editable(v.tail, edit);
+		v.tail->values.push_back(x);
+		++v.count;
+		return;
+	}
+	// tail 已满：整块挂进树里，必要时树长高一层
+	if ((v.count >> kBits) > (size_t{1} << v.shift)) {
+		auto root = std::make_shared<VecNode>();
+		root->edit = edit;
+		root->children.push_back(v.root);
+		root->children.push_back(vecNewPath(edit, v.shift, v.tail));
+		v.root = std::move(root);
+		v.shift += kBits;
+	} else {
+		v.root = vecPushTail(v, edit, v.shift, v.root, v.tail);
+	}
+	auto tail = std::make_shared<VecNode>();
+	tail->edit = edit;
+	tail->values.reserve(kWidth);
+	tail->values.push_back(x);
+	v.tail = std::move(tail);
+	++v.count;
+}
+
+VecPtr vecAssoc(uint64_t edit, int level, const VecPtr& node, size_t i, const Value& x) {
+	auto m = editable(node, edit);
+	if (level == 0) {
+		m->values[i & kMask] = x;
+	} else {
+		size_t sub = (i >> level) & kMask;
+		m->children[sub] = vecAssoc(edit, level - kBits, m->children[sub], i, x);
+	}
+	return m;
+}
+
+void vecSet(PVector& v, uint64_t edit, size_t i, const Value& x) {
+	if (i >= v.tailOffset()) {
+		v.tail = editable(v.tail, edit);
+		v.tail->values[i & kMask] = x;
+		return;
+	}
+	v.root = vecAssoc(edit, v.shift, v.root, i, x);
+}
+
+VecPtr vecPopTail(const PVector& v, uint64_t edit, int level, const VecPtr& node) {
+	size_t sub = ((v.count - 2) >> level) & kMask;
+	if (level > kBits) {
+		VecPtr child = vecPopTail(v, edit, level - kBits, node->children[sub]);
+		if (!child && sub == 0) return nullptr;
+		auto m = editable(node, edit);
+		if (child) m->children[sub] = std::move(child);
+		else m->children.pop_back();
+		return m;
+	}
+	if (sub == 0) return nullptr;
+	auto m = editable(node, edit);
+	m->children.pop_back();
+	return m;
+}
+
+void vecPop(PVector& v, uint64_t edit) {
+	if (v.count == 0) return;
+	if (v.count == 1) { v = emptyVector(); return; }
+	if (v.count - v.tailOffset() > 1) {
+		v.tail = editable(v.tail, edit);
+		v.tail->values.pop_back();
+		--v.count;
+		return;
+	}
+	// tail 只剩一个元素：把树里最后一个叶子取回来当 tail
+	VecPtr tail = vecLeaf(v, v.count - 2);
+	VecPtr root = vecPopTail(v, edit, v.shift, v.root);
+	int shift = v.shift;
+	if (!root) { root = std::make_shared<VecNode>(); root->edit = edit; }
+	if (shift > kBits && root->children.size() == 1) {
+		root = root->children[0];
+		shift -= kBits;
+	}
+	v.root = std::move(root);
+	v.tail = std::move(tail);
+	v.shift = shift;
+	--v.count;
+}
+
+template <typename Fn>
+void vecEach(const PVector& v, Fn&& fn) {
+	for (size_t i = 0; i < v.count; i += kWidth) {
+		auto& leaf = vecLeaf(v, i)->values;
+		for (auto& x : leaf) fn(x);
+	}
+}
+
+// ----------- Native handles -----------
+
+struct NativePersistentMap { HamtMap data; };            // Map 与 Set 共用 (Set 的值为 null)
+struct NativeTransientMap { HamtMap data; uint64_t edit{0}; };
+struct NativePersistentVector { PVector data; };
+struct NativeTransientVector { PVector data; uint64_t edit{0}; };
+
+using NativeFn = std::function<Value(const std::vector<Value>&, std::shared_ptr<Environment>)>;
+
+void addMethod(const std::shared_ptr<ClassInfo>& klass, const char* name, NativeFn fn) {
+	auto f = std::make_shared<Function>();
+	f->isBuiltin = true;
+	f->builtin = std::move(fn);
+	klass->methods[name] = f;
+}
+
+std::shared_ptr<Instance> thisInstance(const std::shared_ptr<Environment>& clos) {
+	if (!clos) throw std::runtime_error("internal: instance method called without closure");
+	Value tv = clos->get("this");
+	auto pins = std::get_if<std::shared_ptr<Instance>>(&tv);
+	if (!pins || !*pins) throw std::runtime_error("internal: invalid 'this' value");
+	return *pins;
+}
+
+template <typename T>
+T* handleOf(const std::shared_ptr<Environment>& clos, const char* what) {
+	auto h = static_cast<T*>(static_cast<InstanceExt*>(thisInstance(clos).get())->nativeHandle);
+	if (!h) throw std::runtime_error(std::string(what) + ": native handle missing");
+	return h;
+}
+
+// 参数是指定类的实例时返回其句柄，否则返回 nullptr
+template <typename T>
+T* argHandle(const Value& v, const std::shared_ptr<ClassInfo>& klass) {
+	auto pins = std::get_if<std::shared_ptr<Instance>>(&v);
+	if (!pins || !*pins || (*pins)->klass != klass) return nullptr;
+	return static_cast<T*>(static_cast<InstanceExt*>(pins->get())->nativeHandle);
+}
+
+template <typename T>
+void attach(InstanceExt* inst, T* handle) {
+	inst->nativeHandle = handle;
+	inst->nativeDestructor = [](void* p) { delete static_cast<T*>(p); };
+}
+
+template <typename T>
+Value wrap(const std::shared_ptr<ClassInfo>& klass, T* handle) {
+	auto inst = std::make_shared<InstanceExt>();
+	inst->klass = klass;
+	attach(inst.get(), handle);
+	return Value{ inst };
+}
+
+template <typename T>
+T* liveTransient(const std::shared_ptr<Environment>& clos, const char* what) {
+	auto t = handleOf<T>(clos, what);
+	if (!t->edit) throw std::runtime_error(std::string(what) + ": transient used after persistent()");
+	return t;
+}
+
+size_t indexArg(const Value& v, const char* what) {
+	double d = getNumber(v, what);
+	if (d < 0 || std::floor(d) != d) throw std::runtime_error(std::string(what) + ": index must be a non-negative integer");
+	return static_cast<size_t>(d);
+}
+
+Value arrayOf(const std::vector<Value>& items) {
+	return Value{ std::make_shared<Array>(items) };
+}
+
+// Map 初始化：[[k, v], ...] 或普通对象
+void fillMap(HamtMap& m, uint64_t edit, const Value& init, const char* what) {
+	if (auto arr = std::get_if<std::shared_ptr<Array>>(&init)) {
+		for (auto& item : **arr) {
+			auto pair = std::get_if<std::shared_ptr<Array>>(&item);
+			if (!pair || (*pair)->size() < 2) throw std::runtime_error(std::string(what) + ": entries must be [key, value] arrays");
+			hamtSet(m, edit, (**pair)[0], (**pair)[1]);
+		}
+		return;
+	}
+	if (auto obj = std::get_if<std::shared_ptr<Object>>(&init)) {
+		for (auto& kv : **obj) hamtSet(m, edit, Value{ kv.first }, kv.second);
+		return;
+	}
+	if (std::holds_alternative<std::monostate>(init)) return;
+	throw std::runtime_error(std::string(what) + ": expects an array of entries or an object");
+}
+
+void fillSet(HamtMap& m, uint64_t edit, const Value& init, const char* what) {
+	if (auto arr = std::get_if<std::shared_ptr<Array>>(&init)) {
+		for (auto& item : **arr) hamtSet(m, edit, item, Value{ std::monostate{} });
+		return;
+	}
+	if (std::holds_alternative<std::monostate>(init)) return;
+	throw std::runtime_error(std::string(what) + ": expects an array");
+}
+
+void fillVector(PVector& v, uint64_t edit, const Value& init, const char* what) {
+	if (auto arr = std::get_if<std::shared_ptr<Array>>(&init)) {
+		for (auto& item : **arr) vecPush(v, edit, item);
+		return;
+	}
+	if (std::holds_alternative<std::monostate>(init)) return;
+	throw std::runtime_error(std::string(what) + ": expects an array");
+}
+
+} // namespace
+
+void registerStdImmutablePackage(Interpreter& interp) {
+	Interpreter* interpPtr = &interp;
+	interp.registerLazyPackage("std.immutable", [interpPtr](std::shared_ptr<Object> pkg) {
+		auto mapClass = std::make_shared<ClassInfo>(); mapClass->name = "Map"; mapClass->isNative = true;
+		auto setClass = std::make_shared<ClassInfo>(); setClass->name = "Set"; setClass->isNative = true;
+		auto vectorClass = std::make_shared<ClassInfo>(); vectorClass->name = "Vector"; vectorClass->isNative = true;
+		auto tmapClass = std::make_shared<ClassInfo>(); tmapClass->name = "TransientMap"; tmapClass->isNative = true;
+		auto tsetClass = std::make_shared<ClassInfo>(); tsetClass->name = "TransientSet"; tsetClass->isNative = true;
+		auto tvectorClass = std::make_shared<ClassInfo>(); tvectorClass->name = "TransientVector"; tvectorClass->isNative = true;
+
+		auto newMap = [mapClass](HamtMap data) { return wrap(mapClass, new NativePersistentMap{ std::move(data) }); };
+		auto newSet = [setClass](HamtMap data) { return wrap(setClass, new NativePersistentMap{ std::move(data) }); };
+		auto newVector = [vectorClass](PVector data) { return wrap(vectorClass, new NativePersistentVector{ std::move(data) }); };
+
+		// withMutations(fn)：把 transient 交给 fn 批量修改，返回值由调用方冻结为新的持久版本
+		auto runMutations = [interpPtr](const Value& transient, const std::vector<Value>& args, const char* what) {
+			if (args.size() != 1 || !std::holds_alternative<std::shared_ptr<Function>>(args[0]))
+				throw std::runtime_error(std::string(what) + " expects a function");
+			interpPtr->callValue(args[0], { transient });
+		};
+
+		// ---- Map ----
+		addMethod(mapClass, "constructor", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() > 1) throw std::runtime_error("Map expects at most 1 argument");
+			HamtMap data = emptyHamt();
+			uint64_t edit = nextEditToken();
+			if (!args.empty()) fillMap(data, edit, args[0], "Map");
+			attach(static_cast<InstanceExt*>(thisInstance(clos).get()), new NativePersistentMap{ std::move(data) });
+			return Value{ std::monostate{} };
+		});
+		addMethod(mapClass, "get", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.empty() || args.size() > 2) throw std::runtime_error("map.get expects key [, default]");
+			auto e = hamtFind(handleOf<NativePersistentMap>(clos, "map.get")->data, args[0]);
+			if (e) return e->value;
+			return args.size() == 2 ? args[1] : Value{ std::monostate{} };
+		});
+		addMethod(mapClass, "has", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("map.has expects 1 argument");
+			return Value{ hamtFind(handleOf<NativePersistentMap>(clos, "map.has")->data, args[0]) != nullptr };
+		});
+		addMethod(mapClass, "set", [newMap](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 2) throw std::runtime_error("map.set expects 2 arguments");
+			HamtMap data = handleOf<NativePersistentMap>(clos, "map.set")->data;
+			hamtSet(data, 0, args[0], args[1]);
+			return newMap(std::move(data));
+		});
+		addMethod(mapClass, "delete", [newMap](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("map.delete expects 1 argument");
+			HamtMap data = handleOf<NativePersistentMap>(clos, "map.delete")->data;
+			if (!hamtDelete(data, 0, args[0])) return Value{ thisInstance(clos) };
+			return newMap(std::move(data));
+		});
+		addMethod(mapClass, "update", [newMap, interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 2 || !std::holds_alternative<std::shared_ptr<Function>>(args[1]))
+				throw std::runtime_error("map.update expects key, function");
+			HamtMap data = handleOf<NativePersistentMap>(clos, "map.update")->data;
+			auto e = hamtFind(data, args[0]);
+			Value next = interpPtr->callValue(args[1], { e ? e->value : Value{ std::monostate{} } });
+			hamtSet(data, 0, args[0], next);
+			return newMap(std::move(data));
+		});
+		addMethod(mapClass, "merge", [newMap, mapClass](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("map.merge expects 1 argument");
+			HamtMap data = handleOf<NativePersistentMap>(clos, "map.merge")->data;
+			uint64_t edit = nextEditToken();
+			if (auto other = argHandle<NativePersistentMap>(args[0], mapClass)) {
+				hamtEach(other->data.root.get(), [&](const HamtEntry& e) { hamtSet(data, edit, e.key, e.value); });
+			} else {
+				fillMap(data, edit, args[0], "map.merge");
+			}
+			return newMap(std::move(data));
+		});
+		addMethod(mapClass, "size", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return Value{ static_cast<double>(handleOf<NativePersistentMap>(clos, "map.size")->data.count) };
+		});
+		addMethod(mapClass, "keys", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto out = std::make_shared<Array>();
+			hamtEach(handleOf<NativePersistentMap>(clos, "map.keys")->data.root.get(), [&](const HamtEntry& e) { out->push_back(e.key); });
+			return Value{ out };
+		});
+		addMethod(mapClass, "values", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto out = std::make_shared<Array>();
+			hamtEach(handleOf<NativePersistentMap>(clos, "map.values")->data.root.get(), [&](const HamtEntry& e) { out->push_back(e.value); });
+			return Value{ out };
+		});
+		addMethod(mapClass, "entries", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto out = std::make_shared<Array>();
+			hamtEach(handleOf<NativePersistentMap>(clos, "map.entries")->data.root.get(), [&](const HamtEntry& e) { out->push_back(arrayOf({ e.key, e.value })); });
+			return Value{ out };
+		});
+		addMethod(mapClass, "equals", [mapClass](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("map.equals expects 1 argument");
+			auto other = argHandle<NativePersistentMap>(args[0], mapClass);
+			return Value{ other && hamtEquals(handleOf<NativePersistentMap>(clos, "map.equals")->data, other->data, true) };
+		});
+		addMethod(mapClass, "transient", [tmapClass](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return wrap(tmapClass, new NativeTransientMap{ handleOf<NativePersistentMap>(clos, "map.transient")->data, nextEditToken() });
+		});
+		addMethod(mapClass, "withMutations", [tmapClass, newMap, runMutations](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			auto t = new NativeTransientMap{ handleOf<NativePersistentMap>(clos, "map.withMutations")->data, nextEditToken() };
+			Value holder = wrap(tmapClass, t);
+			runMutations(holder, args, "map.withMutations");
+			t->edit = 0;
+			return newMap(t->data);
+		});
+
+		// ---- TransientMap ----
+		addMethod(tmapClass, "get", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.empty() || args.size() > 2) throw std::runtime_error("transientMap.get expects key [, default]");
+			auto e = hamtFind(liveTransient<NativeTransientMap>(clos, "transientMap.get")->data, args[0]);
+			if (e) return e->value;
+			return args.size() == 2 ? args[1] : Value{ std::monostate{} };
+		});
+		addMethod(tmapClass, "has", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("transientMap.has expects 1 argument");
+			return Value{ hamtFind(liveTransient<NativeTransientMap>(clos, "transientMap.has")->data, args[0]) != nullptr };
+		});
+		addMethod(tmapClass, "set", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 2) throw std::runtime_error("transientMap.set expects 2 arguments");
+			auto t = liveTransient<NativeTransientMap>(clos, "transientMap.set");
+			hamtSet(t->data, t->edit, args[0], args[1]);
+			return Value{ thisInstance(clos) };
+		});
+		addMethod(tmapClass, "delete", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("transientMap.delete expects 1 argument");
+			auto t = liveTransient<NativeTransientMap>(clos, "transientMap.delete");
+			hamtDelete(t->data, t->edit, args[0]);
+			return Value{ thisInstance(clos) };
+		});
+		addMethod(tmapClass, "size", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return Value{ static_cast<double>(liveTransient<NativeTransientMap>(clos, "transientMap.size")->data.count) };
+		});
+		addMethod(tmapClass, "persistent", [newMap](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto t = liveTransient<NativeTransientMap>(clos, "transientMap.persistent");
+			t->edit = 0;
+			return newMap(t->data);
+		});
+
+		// ---- Set ----
+		addMethod(setClass, "constructor", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() > 1) throw std::runtime_error("Set expects at most 1 argument");
+			HamtMap data = emptyHamt();
+			if (!args.empty()) fillSet(data, nextEditToken(), args[0], "Set");
+			attach(static_cast<InstanceExt*>(thisInstance(clos).get()), new NativePersistentMap{ std::move(data) });
+			return Value{ std::monostate{} };
+		});
+		addMethod(setClass, "has", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("set.has expects 1 argument");
+			return Value{ hamtFind(handleOf<NativePersistentMap>(clos, "set.has")->data, args[0]) != nullptr };
+		});
+		addMethod(setClass, "add", [newSet](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("set.add expects 1 argument");
+			HamtMap data = handleOf<NativePersistentMap>(clos, "set.add")->data;
+			if (hamtFind(data, args[0])) return Value{ thisInstance(clos) };
+			hamtSet(data, 0, args[0], Value{ std::monostate{} });
+			return newSet(std::move(data));
+		});
+		addMethod(setClass, "delete", [newSet](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("set.delete expects 1 argument");
+			HamtMap data = handleOf<NativePersistentMap>(clos, "set.delete")->data;
+			if (!hamtDelete(data, 0, args[0])) return Value{ thisInstance(clos) };
+			return newSet(std::move(data));
+		});
+		addMethod(setClass, "size", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return Value{ static_cast<double>(handleOf<NativePersistentMap>(clos, "set.size")->data.count) };
+		});
+		addMethod(setClass, "values", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto out = std::make_shared<Array>();
+			hamtEach(handleOf<NativePersistentMap>(clos, "set.values")->data.root.get(), [&](const HamtEntry& e) { out->push_back(e.key); });
+			return Value{ out };
+		});
+		// 集合运算：参数可以是 Set 或数组
+		auto setOperand = [setClass](const Value& v, const char* what) {
+			if (auto other = argHandle<NativePersistentMap>(v, setClass)) return other->data;
+			HamtMap data = emptyHamt();
+			fillSet(data, nextEditToken(), v, what);
+			return data;
+		};
+		addMethod(setClass, "union", [newSet, setOperand](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("set.union expects 1 argument");
+			HamtMap a = handleOf<NativePersistentMap>(clos, "set.union")->data;
+			HamtMap b = setOperand(args[0], "set.union");
+			if (a.count < b.count) std::swap(a, b);
+			uint64_t edit = nextEditToken();
+			hamtEach(b.root.get(), [&](const HamtEntry& e) { hamtSet(a, edit, e.key, e.value); });
+			return newSet(std::move(a));
+		});
+		addMethod(setClass, "intersection", [newSet, setOperand](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("set.intersection expects 1 argument");
+			HamtMap a = handleOf<NativePersistentMap>(clos, "set.intersection")->data;
+			HamtMap b = setOperand(args[0], "set.intersection");
+			if (a.count > b.count) std::swap(a, b);
+			HamtMap out = emptyHamt();
+			uint64_t edit = nextEditToken();
+			hamtEach(a.root.get(), [&](const HamtEntry& e) { if (hamtFind(b, e.key)) hamtSet(out, edit, e.key, e.value); });
+			return newSet(std::move(out));
+		});
+		addMethod(setClass, "difference", [newSet, setOperand](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("set.difference expects 1 argument");
+			HamtMap a = handleOf<NativePersistentMap>(clos, "set.difference")->data;
+			HamtMap b = setOperand(args[0], "set.difference");
+			uint64_t edit = nextEditToken();
+			hamtEach(b.root.get(), [&](const HamtEntry& e) { hamtDelete(a, edit, e.key); });
+			return newSet(std::move(a));
+		});
+		addMethod(setClass, "equals", [setClass](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("set.equals expects 1 argument");
+			auto other = argHandle<NativePersistentMap>(args[0], setClass);
+			return Value{ other && hamtEquals(handleOf<NativePersistentMap>(clos, "set.equals")->data, other->data, false) };
+		});
+		addMethod(setClass, "transient", [tsetClass](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return wrap(tsetClass, new NativeTransientMap{ handleOf<NativePersistentMap>(clos, "set.transient")->data, nextEditToken() });
+		});
+		addMethod(setClass, "withMutations", [tsetClass, newSet, runMutations](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			auto t = new NativeTransientMap{ handleOf<NativePersistentMap>(clos, "set.withMutations")->data, nextEditToken() };
+			Value holder = wrap(tsetClass, t);
+			runMutations(holder, args, "set.withMutations");
+			t->edit = 0;
+			return newSet(t->data);
+		});
+
+		// ---- TransientSet ----
+		addMethod(tsetClass, "has", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("transientSet.has expects 1 argument");
+			return Value{ hamtFind(liveTransient<NativeTransientMap>(clos, "transientSet.has")->data, args[0]) != nullptr };
+		});
+		addMethod(tsetClass, "add", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("transientSet.add expects 1 argument");
+			auto t = liveTransient<NativeTransientMap>(clos, "transientSet.add");
+			hamtSet(t->data, t->edit, args[0], Value{ std::monostate{} });
+			return Value{ thisInstance(clos) };
+		});
+		addMethod(tsetClass, "delete", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("transientSet.delete expects 1 argument");
+			auto t = liveTransient<NativeTransientMap>(clos, "transientSet.delete");
+			hamtDelete(t->data, t->edit, args[0]);
+			return Value{ thisInstance(clos) };
+		});
+		addMethod(tsetClass, "size", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return Value{ static_cast<double>(liveTransient<NativeTransientMap>(clos, "transientSet.size")->data.count) };
+		});
+		addMethod(tsetClass, "persistent", [newSet](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto t = liveTransient<NativeTransientMap>(clos, "transientSet.persistent");
+			t->edit = 0;
+			return newSet(t->data);
+		});
+
+		// ---- Vector ----
+		addMethod(vectorClass, "constructor", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() > 1) throw std::runtime_error("Vector expects at most 1 argument");
+			PVector data = emptyVector();
+			if (!args.empty()) fillVector(data, nextEditToken(), args[0], "Vector");
+			attach(static_cast<InstanceExt*>(thisInstance(clos).get()), new NativePersistentVector{ std::move(data) });
+			return Value{ std::monostate{} };
+		});
+		addMethod(vectorClass, "get", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.empty() || args.size() > 2) throw std::runtime_error("vector.get expects index [, default]");
+			auto& v = handleOf<NativePersistentVector>(clos, "vector.get")->data;
+			size_t i = indexArg(args[0], "vector.get");
+			if (i < v.count) return vecGet(v, i);
+			return args.size() == 2 ? args[1] : Value{ std::monostate{} };
+		});
+		addMethod(vectorClass, "set", [newVector](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 2) throw std::runtime_error("vector.set expects index, value");
+			PVector v = handleOf<NativePersistentVector>(clos, "vector.set")->data;
+			size_t i = indexArg(args[0], "vector.set");
+			if (i == v.count) vecPush(v, 0, args[1]);
+			else if (i < v.count) vecSet(v, 0, i, args[1]);
+			else throw std::runtime_error("vector.set: index out of range");
+			return newVector(std::move(v));
+		});
+		addMethod(vectorClass, "push", [newVector](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			PVector v = handleOf<NativePersistentVector>(clos, "vector.push")->data;
+			uint64_t edit = args.size() > 1 ? nextEditToken() : 0;
+			for (auto& x : args) vecPush(v, edit, x);
+			return newVector(std::move(v));
+		});
+		addMethod(vectorClass, "pop", [newVector](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			PVector v = handleOf<NativePersistentVector>(clos, "vector.pop")->data;
+			if (v.count == 0) return Value{ thisInstance(clos) };
+			vecPop(v, 0);
+			return newVector(std::move(v));
+		});
+		addMethod(vectorClass, "last", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto& v = handleOf<NativePersistentVector>(clos, "vector.last")->data;
+			return v.count ? vecGet(v, v.count - 1) : Value{ std::monostate{} };
+		});
+		addMethod(vectorClass, "size", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return Value{ static_cast<double>(handleOf<NativePersistentVector>(clos, "vector.size")->data.count) };
+		});
+		addMethod(vectorClass, "slice", [newVector](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.empty() || args.size() > 2) throw std::runtime_error("vector.slice expects start [, end]");
+			auto& v = handleOf<NativePersistentVector>(clos, "vector.slice")->data;
+			size_t start = std::min(indexArg(args[0], "vector.slice"), v.count);
+			size_t end = args.size() == 2 ? std::min(indexArg(args[1], "vector.slice"), v.count) : v.count;
+			if (start == 0 && end == v.count) return Value{ thisInstance(clos) };
+			PVector out = emptyVector();
+			uint64_t edit = nextEditToken();
+			for (size_t i = start; i < end; ++i) vecPush(out, edit, vecGet(v, i));
+			return newVector(std::move(out));
+		});
+		addMethod(vectorClass, "concat", [newVector, vectorClass](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("vector.concat expects 1 argument");
+			PVector v = handleOf<NativePersistentVector>(clos, "vector.concat")->data;
+			uint64_t edit = nextEditToken();
+			if (auto other = argHandle<NativePersistentVector>(args[0], vectorClass)) {
+				PVector rhs = other->data;
+				vecEach(rhs, [&](const Value& x) { vecPush(v, edit, x); });
+			} else {
+				fillVector(v, edit, args[0], "vector.concat");
+			}
+			return newVector(std::move(v));
+		});
+		addMethod(vectorClass, "toArray", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto& v = handleOf<NativePersistentVector>(clos, "vector.toArray")->data;
+			auto out = std::make_shared<Array>();
+			out->reserve(v.count);
+			vecEach(v, [&](const Value& x) { out->push_back(x); });
+			return Value{ out };
+		});
+		addMethod(vectorClass, "equals", [vectorClass](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("vector.equals expects 1 argument");
+			auto other = argHandle<NativePersistentVector>(args[0], vectorClass);
+			auto& a = handleOf<NativePersistentVector>(clos, "vector.equals")->data;
+			if (!other || other->data.count != a.count) return Value{ false };
+			for (size_t i = 0; i < a.count; ++i) {
+				if (!valueEqual(vecGet(a, i), vecGet(other->data, i))) return Value{ false };
+			}
+			return Value{ true };
+		});
+		addMethod(vectorClass, "transient", [tvectorClass](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return wrap(tvectorClass, new NativeTransientVector{ handleOf<NativePersistentVector>(clos, "vector.transient")->data, nextEditToken() });
+		});
+		addMethod(vectorClass, "withMutations", [tvectorClass, newVector, runMutations](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			auto t = new NativeTransientVector{ handleOf<NativePersistentVector>(clos, "vector.withMutations")->data, nextEditToken() };
+			Value holder = wrap(tvectorClass, t);
+			runMutations(holder, args, "vector.withMutations");
+			t->edit = 0;
+			return newVector(t->data);
+		});
+
+		// ---- TransientVector ----
+		addMethod(tvectorClass, "get", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("transientVector.get expects 1 argument");
+			auto& v = liveTransient<NativeTransientVector>(clos, "transientVector.get")->data;
+			size_t i = indexArg(args[0], "transientVector.get");
+			return i < v.count ? vecGet(v, i) : Value{ std::monostate{} };
+		});
+		addMethod(tvectorClass, "set", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 2) throw std::runtime_error("transientVector.set expects index, value");
+			auto t = liveTransient<NativeTransientVector>(clos, "transientVector.set");
+			size_t i = indexArg(args[0], "transientVector.set");
+			if (i == t->data.count) vecPush(t->data, t->edit, args[1]);
+			else if (i < t->data.count) vecSet(t->data, t->edit, i, args[1]);
+			else throw std::runtime_error("transientVector.set: index out of range");
+			return Value{ thisInstance(clos) };
+		});
+		addMethod(tvectorClass, "push", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			auto t = liveTransient<NativeTransientVector>(clos, "transientVector.push");
+			for (auto& x : args) vecPush(t->data, t->edit, x);
+			return Value{ thisInstance(clos) };
+		});
+		addMethod(tvectorClass, "pop", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto t = liveTransient<NativeTransientVector>(clos, "transientVector.pop");
+			if (t->data.count == 0) return Value{ std::monostate{} };
+			Value last = vecGet(t->data, t->data.count - 1);
+			vecPop(t->data, t->edit);
+			return last;
+		});
+		addMethod(tvectorClass, "size", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return Value{ static_cast<double>(liveTransient<NativeTransientVector>(clos, "transientVector.size")->data.count) };
+		});
+		addMethod(tvectorClass, "persistent", [newVector](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto t = liveTransient<NativeTransientVector>(clos, "transientVector.persistent");
+			t->edit = 0;
+			return newVector(t->data);
+		});
+
+		(*pkg)["Map"] = mapClass;
+		(*pkg)["Set"] = setClass;
+		(*pkg)["Vector"] = vectorClass;
+		(*pkg)["TransientMap"] = tmapClass;
+		(*pkg)["TransientSet"] = tsetClass;
+		(*pkg)["TransientVector"] = tvectorClass;
+
+		// 工厂函数：map(init?) / set(init?) / vector(init?)
+		auto mapFn = std::make_shared<Function>(); mapFn->isBuiltin = true;
+		mapFn->builtin = [newMap](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			if (args.size() > 1) throw std::runtime_error("map expects at most 1 argument");
+			HamtMap data = emptyHamt();
+			if (!args.empty()) fillMap(data, nextEditToken(), args[0], "map");
+			return newMap(std::move(data));
+		};
+		(*pkg)["map"] = mapFn;
+		auto setFn = std::make_shared<Function>(); setFn->isBuiltin = true;
+		setFn->builtin = [newSet](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			if (args.size() > 1) throw std::runtime_error("set expects at most 1 argument");
+			HamtMap data = emptyHamt();
+			if (!args.empty()) fillSet(data, nextEditToken(), args[0], "set");
+			return newSet(std::move(data));
+		};
+		(*pkg)["set"] = setFn;
+		auto vectorFn = std::make_shared<Function>(); vectorFn->isBuiltin = true;
+		vectorFn->builtin = [newVector](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			if (args.size() > 1) throw std::runtime_error("vector expects at most 1 argument");
+			PVector data = emptyVector();
+			if (!args.empty()) fillVector(data, nextEditToken(), args[0], "vector");
+			return newVector(std::move(data));
+		};
+		(*pkg)["vector"] = vectorFn;
+	});
+}
+
+PackageMeta getStdImmutablePackageMeta() {
+	PackageMeta pkg;
+	pkg.name = "std.immutable";
+	pkg.exports = { "map", "set", "vector" };
+
+	ClassMeta mapClass;
+	mapClass.name = "Map";
+	mapClass.methods = { {"constructor"}, {"get"}, {"has"}, {"set"}, {"delete"}, {"update"}, {"merge"}, {"size"}, {"keys"}, {"values"}, {"entries"}, {"equals"}, {"transient"}, {"withMutations"} };
+	pkg.classes.push_back(mapClass);
+
+	ClassMeta setClass;
+	setClass.name = "Set";
+	setClass.methods = { {"constructor"}, {"has"}, {"add"}, {"delete"}, {"size"}, {"values"}, {"union"}, {"intersection"}, {"difference"}, {"equals"}, {"transient"}, {"withMutations"} };
+	pkg.classes.push_back(setClass);
+
+	ClassMeta vectorClass;
+	vectorClass.name = "Vector";
+	vectorClass.methods = { {"constructor"}, {"get"}, {"set"}, {"push"}, {"pop"}, {"last"}, {"size"}, {"slice"}, {"concat"}, {"toArray"}, {"equals"}, {"transient"}, {"withMutations"} };
+	pkg.classes.push_back(vectorClass);
+
+	ClassMeta tmapClass;
+	tmapClass.name = "TransientMap";
+	tmapClass.methods = { {"get"}, {"has"}, {"set"}, {"delete"}, {"size"}, {"persistent"} };
+	pkg.classes.push_back(tmapClass);
+
+	ClassMeta tsetClass;
+	tsetClass.name = "TransientSet";
+	tsetClass.methods = { {"has"}, {"add"}, {"delete"}, {"size"}, {"persistent"} };
+	pkg.classes.push_back(tsetClass);
+
+	ClassMeta tvectorClass;
+	tvectorClass.name = "TransientVector";
+	tvectorClass.methods = { {"get"}, {"set"}, {"push"}, {"pop"}, {"size"}, {"persistent"} };
+	pkg.classes.push_back(tvectorClass);
+
+	return pkg;
+}
+
+} // namespace asul
@@ -0,0 +1,16 @@
+#ifndef STD_IMMUTABLE_H
+#define STD_IMMUTABLE_H
+
+#include "../../PackageMeta.h"
+
+namespace asul {
+
+class Interpreter;
+
+// Register the std.immutable package (persistent Map / Set / Vector) with the interpreter
+void registerStdImmutablePackage(Interpreter& interp);
+PackageMeta getStdImmutablePackageMeta();
+
+} // namespace asul
+
+#endif // STD_IMMUTABLE_H
@@ -0,0 +1,1246 @@
+#include "IoStreams.h"
+#include "../../../AsulInterpreter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+
+#ifndef _WIN32
+	#include <poll.h>
+	#include <unistd.h>
+#endif
+#ifdef ASUL_HAS_ZLIB
+	#include <zlib.h>
+#endif
+#ifdef ASUL_HAS_OPENSSL
+	#include <openssl/evp.h>
+#endif
+
+namespace asul {
+
+namespace {
+
+constexpr size_t kChunkSize = 64 * 1024;       // 原生读取与 pipe 转发的块大小
+constexpr size_t kDefaultHighWater = 64 * 1024; // 默认高水位 (字节)
+constexpr int kPollIntervalMs = 100;           // fd 源的单次等待上限，超时后重新排队，避免长期占用工作线程
+
+// ----------- ByteRing -----------
+// 可读端缓冲：容量为 2 的幂的环形字节缓冲，只在容量不足时整体搬移一次；
+// push 追加、read 取出都只复制对应片段，不会像 Stream 的字符串缓冲那样反复拷贝剩余内容。
+class ByteRing {
+public:
+	size_t size() const { return len; }
+	bool empty() const { return len == 0; }
+
+	void append(const char* p, size_t n) {
+		if (n == 0) return;
+		if (len + n > buf.size()) grow(len + n);
+		size_t tail = (head + len) & (buf.size() - 1);
+		size_t first = std::min(n, buf.size() - tail);
+		std::memcpy(buf.data() + tail, p, first);
+		std::memcpy(buf.data(), p + first, n - first);
+		len += n;
+	}
+
+	std::string take(size_t n) {
+		n = std::min(n, len);
+		if (n == 0) return std::string();
+		std::string out(n, '\0');
+		size_t first = std::min(n, buf.size() - head);
+		std::memcpy(&out[0], buf.data() + head, first);
+		std::memcpy(&out[first], buf.data(), n - first);
+		head = (head + n) & (buf.size() - 1);
+		len -= n;
+		if (len == 0) head = 0;
+		return out;
+	}
+
+	// 返回 c 相对可读位置的下标，找不到时为 npos
+	size_t find(char c) const {
+		if (len == 0) return std::string::npos;
+		size_t first = std::min(len, buf.size() - head);
+		if (auto hit = static_cast<const char*>(std::memchr(buf.data() + head, c, first))) return static_cast<size_t>(hit - (buf.data() + head));
+		if (auto hit = static_cast<const char*>(std::memchr(buf.data(), c, len - first))) return first + static_cast<size_t>(hit - buf.data());
+		return std::string::npos;
+	}
+
+	void clear() { head = 0; len = 0; }
+
+private:
+	void grow(size_t need) {
+		size_t cap = std::max<size_t>(buf.size(), 4096);
+		while (cap < need) cap <<= 1;
+		std::vector<char> next(cap);
+		size_t first = std::min(len, buf.size() - head);
+		if (len) {
+			std::memcpy(next.data(), buf.data() + head, first);
+			std::memcpy(next.data() + first, buf.data(), len - first);
+		}
+		buf.swap(next);
+		head = 0;
+	}
+
+	std::vector<char> buf;
+	size_t head{0};
+	size_t len{0};
+};
+
+// 调用脚本回调：结果若是 Promise 则等它完成；异常与 rejection 都以 ok=false 交给 cb。cb 总在事件循环线程上执行。
+void whenSettled(Interpreter* interp, const std::shared_ptr<PromiseState>& p, std::function<void(bool, Value)> cb) {
+	{
+		std::unique_lock<std::mutex> lk(p->mtx);
+		if (!p->settled) {
+			p->waiters.push_back([interp, p, cb]{
+				interp->postTask([p, cb]{
+					bool rejected; Value v;
+					{ std::lock_guard<std::mutex> g(p->mtx); rejected = p->rejected; v = p->result; }
+					cb(!rejected, std::move(v));
+				});
+			});
+			return;
+		}
+	}
+	cb(!p->rejected, p->result);
+}
+
+void callScript(Interpreter* interp, const Value& fn, std::vector<Value> args, std::function<void(bool, Value)> cb) {
+	Value result{std::monostate{}};
+	try {
+		result = interp->callValue(fn, args);
+	} catch (const ExceptionSignal& ex) {
+		cb(false, ex.value); return;
+	} catch (const std::exception& ex) {
+		cb(false, Value{ std::string(ex.what()) }); return;
+	}
+	if (auto p = std::get_if<std::shared_ptr<PromiseState>>(&result)) {
+		if (*p) { whenSettled(interp, *p, std::move(cb)); return; }
+	}
+	cb(true, std::move(result));
+}
+
+// 块参数：字符串原样使用 (二进制安全)，字节数组逐个转换
+std::string chunkArg(const Value& v, const char* what) {
+	if (auto s = std::get_if<std::string>(&v)) return *s;
+	if (auto arr = std::get_if<std::shared_ptr<Array>>(&v)) {
+		std::string out;
+		out.reserve((*arr)->size());
+		for (auto& e : **arr) out.push_back(static_cast<char>(static_cast<int>(getNumber(e, what)) & 0xFF));
+		return out;
+	}
+	throw std::runtime_error(std::string(what) + ": chunk must be a string or byte array");
+}
+
+// ----------- StreamCore -----------
+// 可读端：ByteRing + 读请求队列 + 可选的 pull 源 (缓冲低于高水位时拉取下一块) + 单一 pipe 目标。
+// 可写端：待写块队列 + sink (一次只有一个在途写) + drain/finish 通知。Transform 两端兼有。
+// 所有方法只在事件循环线程上调用。
+class StreamCore : public std::enable_shared_from_this<StreamCore> {
+public:
+	using Done = std::function<void(bool ok, Value err)>;
+	enum class ReadKind { Any, Exact, Line, All };
+
+	StreamCore(Interpreter* interp, bool readable, bool writable) : interp(interp), readable(readable), writable(writable) {}
+
+	Interpreter* interp;
+	const bool readable;
+	const bool writable;
+
+	// ---- 可读端 ----
+	size_t readHighWater{kDefaultHighWater};
+	std::function<void()> pull; // 请求更多数据；数据经 push/end 到达
+
+	bool push(std::string chunk) {
+		if (ended) throw std::runtime_error("Readable.push: stream already ended");
+		pulling = false;
+		if (failed) return false;
+		if (!chunk.empty()) {
+			if (buffer.empty() && pipeDest && !paused && !flowing && !pipeDest->failed) {
+				// 直通：缓冲为空时把块直接交给下游，不经过环形缓冲
+				forward(std::move(chunk));
+			} else if (buffer.empty() && !readers.empty() && readers.front().kind == ReadKind::Any && (readers.front().n == 0 || chunk.size() <= readers.front().n)) {
+				auto p = readers.front().promise;
+				readers.pop_front();
+				interp->resolve(p, Value{ std::move(chunk) });
+			} else {
+				buffer.append(chunk.data(), chunk.size());
+			}
+		}
+		serve();
+		flow();
+		afterConsume();
+		return buffer.size() < readHighWater;
+	}
+
+	void end() {
+		if (ended) return;
+		ended = true;
+		pulling = false;
+		pull = nullptr;
+		serve();
+		flow();
+		afterConsume();
+	}
+
+	std::shared_ptr<PromiseState> read(ReadKind kind, size_t n) {
+		if (pipeDest) throw std::runtime_error("Readable.read: stream is piped");
+		auto p = interp->createPromise();
+		if (failed) { interp->reject(p, error); return p; }
+		readers.push_back(Reader{ p, kind, n });
+		serve();
+		afterConsume();
+		return p;
+	}
+
+	void pipe(const std::shared_ptr<StreamCore>& dest, bool endDest) {
+		if (!dest->writable) throw std::runtime_error("Readable.pipe: destination is not writable");
+		if (dest.get() == this) throw std::runtime_error("Readable.pipe: cannot pipe a stream into itself");
+		if (pipeDest) throw std::runtime_error("Readable.pipe: stream is already piped");
+		if (!readers.empty()) throw std::runtime_error("Readable.pipe: stream has pending reads");
+		pipeDest = dest;
+		pipeEnd = endDest;
+		std::weak_ptr<StreamCore> weak = shared_from_this();
+		// 下游出错时销毁上游，上游出错则经 fail() 传给下游
+		dest->errorListeners.push_back([weak](const Value& err) { if (auto src = weak.lock()) src->fail(err); });
+		if (failed) { dest->fail(error); return; }
+		flow();
+		afterConsume();
+	}
+
+	size_t readableLength() const { return buffer.size(); }
+
+	// ---- 可写端 ----
+	size_t writeHighWater{kDefaultHighWater};
+	std::function<void(std::string, Done)> sink;
+	std::function<void(Done)> finalizer;
+
+	bool write(std::string chunk) {
+		if (failed) throw std::runtime_error("Writable.write: stream has failed");
+		if (ending) throw std::runtime_error("Writable.write: write after end");
+		pendingBytes += chunk.size();
+		pending.push_back(std::move(chunk));
+		kick();
+		bool below = pendingBytes < writeHighWater;
+		if (!below) needDrain = true;
+		return below;
+	}
+
+	std::shared_ptr<PromiseState> endWritable() {
+		auto p = interp->createPromise();
+		if (failed) { interp->reject(p, error); return p; }
+		if (writeFinished) { interp->resolve(p, Value{ std::monostate{} }); return p; }
+		finishPromises.push_back(p);
+		if (!ending) { ending = true; kick(); }
+		return p;
+	}
+
+	std::shared_ptr<PromiseState> drain() {
+		auto p = interp->createPromise();
+		if (failed) interp->reject(p, error);
+		else if (pendingBytes < writeHighWater) interp->resolve(p, Value{ std::monostate{} });
+		else {
+			needDrain = true;
+			drainCallbacks.push_back([this, p](bool ok) { if (ok) interp->resolve(p, Value{ std::monostate{} }); else interp->reject(p, error); });
+		}
+		return p;
+	}
+
+	size_t writableLength() const { return pendingBytes; }
+
+	// Transform：变换结果进入可读端；可读端积压到高水位时推迟确认本次写，从而把背压传回上游
+	void transformed(std::string out, Done done) {
+		if (failed) return;
+		if (!out.empty()) push(std::move(out));
+		if (!hasDemand()) heldWrite = std::move(done);
+		else done(true, Value{ std::monostate{} });
+	}
+
+	// ---- 生命周期 ----
+	// 可写流：数据全部写出并完成 final；纯可读流：数据被读完 (或经 pipe 交给下游)
+	std::shared_ptr<PromiseState> finished() {
+		auto p = interp->createPromise();
+		if (failed) interp->reject(p, error);
+		else if (writable ? writeFinished : consumed) interp->resolve(p, Value{ std::monostate{} });
+		else (writable ? finishPromises : consumedPromises).push_back(p);
+		return p;
+	}
+
+	void fail(const Value& err) {
+		if (failed) return;
+		failed = true;
+		error = err;
+		ended = true;
+		pull = nullptr;
+		buffer.clear();
+		pending.clear();
+		pendingBytes = 0;
+		heldWrite = nullptr;
+		auto rejectAll = [&](std::vector<std::shared_ptr<PromiseState>>& ps) {
+			auto list = std::move(ps); ps.clear();
+			for (auto& p : list) interp->reject(p, err);
+		};
+		auto waiting = std::move(readers); readers.clear();
+		for (auto& r : waiting) interp->reject(r.promise, err);
+		rejectAll(finishPromises);
+		rejectAll(consumedPromises);
+		auto drains = std::move(drainCallbacks); drainCallbacks.clear();
+		for (auto& cb : drains) cb(false);
+		if (pipeDest) pipeDest->fail(err);
+		auto listeners = std::move(errorListeners); errorListeners.clear();
+		for (auto& l : listeners) l(err);
+	}
+
+	bool hasFailed() const { return failed; }
+	bool hasEnded() const { return ended; }
+
+	// 原生源暂时没有数据：只在仍有读请求或 pipe 在消费时继续轮询，没人消费的空闲连接不会让事件循环一直活着
+	void retryPull() {
+		pulling = false;
+		if (!readers.empty() || (pipeDest && !paused)) maybePull();
+	}
+
+private:
+	struct Reader {
+		std::shared_ptr<PromiseState> promise;
+		ReadKind kind;
+		size_t n;
+	};
+
+	// 按顺序满足读请求
+	void serve() {
+		while (!readers.empty() && !failed) {
+			Reader& r = readers.front();
+			Value out{std::monostate{}};
+			bool ready = false;
+			switch (r.kind) {
+			case ReadKind::Any:
+				if (!buffer.empty()) { out = Value{ buffer.take(r.n ? r.n : buffer.size()) }; ready = true; }
+				else if (ended) ready = true;
+				break;
+			case ReadKind::Exact:
+				if (buffer.size() >= r.n) { out = Value{ buffer.take(r.n) }; ready = true; }
+				else if (ended) { if (!buffer.empty()) out = Value{ buffer.take(buffer.size()) }; ready = true; }
+				break;
+			case ReadKind::Line: {
+				size_t nl = buffer.find('\n');
+				if (nl != std::string::npos) {
+					std::string line = buffer.take(nl + 1);
+					line.pop_back();
+					if (!line.empty() && line.back() == '\r') line.pop_back();
+					out = Value{ std::move(line) }; ready = true;
+				} else if (ended) {
+					if (!buffer.empty()) out = Value{ buffer.take(buffer.size()) };
+					ready = true;
+				}
+				break;
+			}
+			case ReadKind::All:
+				if (ended) { out = Value{ buffer.take(buffer.size()) }; ready = true; }
+				break;
+			}
+			if (!ready) break;
+			auto p = r.promise;
+			readers.pop_front();
+			interp->resolve(p, out);
+		}
+	}
+
+	void forward(std::string chunk) {
+		if (!pipeDest->write(std::move(chunk))) {
+			paused = true;
+			// 回调持有上游的强引用：只剩 pipe 连着的流 (脚本不再引用) 也要能继续流动
+			auto self = shared_from_this();
+			pipeDest->onDrain([self](bool ok) {
+				if (!ok) return;
+				self->paused = false;
+				self->flow();
+				self->afterConsume();
+			});
+		}
+	}
+
+	// 把缓冲内容按块转发给 pipe 目标，直到下游要求暂停
+	void flow() {
+		if (!pipeDest || flowing || failed) return;
+		if (pipeDest->failed) return;
+		flowing = true;
+		while (!buffer.empty() && !paused) forward(buffer.take(std::min(buffer.size(), kChunkSize)));
+		flowing = false;
+		if (buffer.empty() && ended && !endForwarded) {
+			endForwarded = true;
+			if (pipeEnd) pipeDest->endWritable();
+		}
+	}
+
+	void afterConsume() {
+		if (heldWrite && hasDemand()) {
+			auto done = std::move(heldWrite); heldWrite = nullptr;
+			done(true, Value{ std::monostate{} });
+		}
+		if (!consumed && ended && !failed && buffer.empty() && (!pipeDest || endForwarded)) {
+			consumed = true;
+			auto list = std::move(consumedPromises); consumedPromises.clear();
+			for (auto& p : list) interp->resolve(p, Value{ std::monostate{} });
+		}
+		maybePull();
+	}
+
+	// 缓冲低于高水位，或仍有读请求在等待 (例如一行超过了高水位、text() 要读到结束)
+	bool hasDemand() const { return buffer.size() < readHighWater || !readers.empty(); }
+
+	void maybePull() {
+		if (inPull) return;
+		inPull = true;
+		while (pull && !pulling && !ended && !failed && !paused && hasDemand()) {
+			pulling = true;
+			auto fn = pull;
+			try { fn(); }
+			catch (...) { pulling = false; inPull = false; throw; }
+		}
+		inPull = false;
+	}
+
+	void onDrain(std::function<void(bool)> cb) {
+		if (pendingBytes < writeHighWater) { cb(true); return; }
+		needDrain = true;
+		drainCallbacks.push_back(std::move(cb));
+	}
+
+	// 依次把待写块交给 sink；同步完成的 sink 在循环里继续，不会递归
+	void kick() {
+		if (kicking) return;
+		kicking = true;
+		while (!writing && !pending.empty() && !failed) {
+			writing = true;
+			std::string chunk = std::move(pending.front());
+			pending.pop_front();
+			size_t n = chunk.size();
+			auto self = shared_from_this();
+			sink(std::move(chunk), [self, n](bool ok, Value err) { self->writeDone(n, ok, err); });
+		}
+		kicking = false;
+		if (!writing && pending.empty() && ending && !finishing && !failed) runFinal();
+	}
+
+	void writeDone(size_t n, bool ok, const Value& err) {
+		writing = false;
+		if (!ok) { fail(err); return; }
+		pendingBytes -= std::min(pendingBytes, n);
+		if (needDrain && pendingBytes < writeHighWater) {
+			needDrain = false;
+			auto cbs = std::move(drainCallbacks); drainCallbacks.clear();
+			for (auto& cb : cbs) cb(true);
+		}
+		kick();
+	}
+
+	void runFinal() {
+		finishing = true;
+		auto self = shared_from_this();
+		Done done = [self](bool ok, Value err) {
+			if (self->failed) return;
+			if (!ok) { self->fail(err); return; }
+			self->writeFinished = true;
+			auto list = std::move(self->finishPromises); self->finishPromises.clear();
+			for (auto& p : list) self->interp->resolve(p, Value{ std::monostate{} });
+		};
+		if (finalizer) finalizer(done);
+		else done(true, Value{ std::monostate{} });
+	}
+
+	ByteRing buffer;
+	std::deque<Reader> readers;
+	bool ended{false}, pulling{false}, inPull{false}, consumed{false};
+	std::shared_ptr<StreamCore> pipeDest;
+	bool pipeEnd{true}, paused{false}, flowing{false}, endForwarded{false};
+	Done heldWrite;
+	std::vector<std::shared_ptr<PromiseState>> consumedPromises;
+
+	std::deque<std::string> pending;
+	size_t pendingBytes{0};
+	bool writing{false}, kicking{false}, needDrain{false}, ending{false}, finishing{false}, writeFinished{false};
+	std::vector<std::function<void(bool)>> drainCallbacks;
+	std::vector<std::shared_ptr<PromiseState>> finishPromises;
+
+	bool failed{false};
+	Value error{std::monostate{}};
+	std::vector<std::function<void(const Value&)>> errorListeners;
+};
+
+struct StreamHandle {
+	std::shared_ptr<StreamCore> core;
+};
+
+
+// ----------- 原生数据源 / 数据汇 -----------
+// readChunk/writeAll 在工作线程上执行，同一个流同时最多只有一个在途调用。
+struct NativeSource {
+	virtual ~NativeSource() = default;
+	// 返回下一块数据；空串表示 EOF；retry=true 表示暂时没有数据，稍后再试
+	virtual std::string readChunk(bool& retry) = 0;
+};
+
+struct NativeSink {
+	virtual ~NativeSink() = default;
+	virtual void writeAll(const char* data, size_t n) = 0;
+	virtual void finish() {}
+};
+
+struct FileSource : NativeSource {
+	FILE* fp;
+	explicit FileSource(FILE* f) : fp(f) {}
+	~FileSource() override { if (fp) std::fclose(fp); }
+	std::string readChunk(bool&) override {
+		std::string out(kChunkSize, '\0');
+		size_t n = std::fread(&out[0], 1, out.size(), fp);
+		if (n == 0 && std::ferror(fp)) throw std::runtime_error(std::string("read failed: ") + std::strerror(errno));
+		out.resize(n);
+		return out;
+	}
+};
+
+struct FileSink : NativeSink {
+	FILE* fp;
+	explicit FileSink(FILE* f) : fp(f) {}
+	~FileSink() override { if (fp) std::fclose(fp); }
+	void writeAll(const char* data, size_t n) override {
+		if (std::fwrite(data, 1, n, fp) != n) throw std::runtime_error(std::string("write failed: ") + std::strerror(errno));
+	}
+	void finish() override {
+		FILE* f = fp; fp = nullptr;
+		if (std::fclose(f) != 0) throw std::runtime_error(std::string("close failed: ") + std::strerror(errno));
+	}
+};
+
+// FileStream (File.open 得到的文件) 的包装器；owner 保持实例存活
+struct WrapperSource : NativeSource {
+	Value owner;
+	StreamWrapper* stream;
+	WrapperSource(Value o, StreamWrapper* s) : owner(std::move(o)), stream(s) {}
+	std::string readChunk(bool&) override {
+		std::string out(kChunkSize, '\0');
+		out.resize(stream->read(&out[0], out.size()));
+		return out;
+	}
+};
+
+struct WrapperSink : NativeSink {
+	Value owner;
+	StreamWrapper* stream;
+	WrapperSink(Value o, StreamWrapper* s) : owner(std::move(o)), stream(s) {}
+	void writeAll(const char* data, size_t n) override { stream->write(data, n); }
+};
+
+#ifndef _WIN32
+// fd 源 (套接字、管道、popen 子进程输出、stdin)：不拥有 fd。每次最多等待 kPollIntervalMs，
+// 没有数据就让出工作线程并重新排队，空闲的连接不会占住共享线程池。
+struct FdSource : NativeSource {
+	Value owner;
+	int fd;
+	FdSource(Value o, int f) : owner(std::move(o)), fd(f) {}
+	std::string readChunk(bool& retry) override {
+		pollfd pfd{ fd, POLLIN, 0 };
+		int r = ::poll(&pfd, 1, kPollIntervalMs);
+		if (r == 0 || (r < 0 && errno == EINTR)) { retry = true; return std::string(); }
+		if (r < 0) throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+		std::string out(kChunkSize, '\0');
+		for (;;) {
+			ssize_t n = ::read(fd, &out[0], out.size());
+			if (n >= 0) { out.resize(static_cast<size_t>(n)); return out; }
+			if (errno == EINTR) continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK) { retry = true; return std::string(); }
+			if (errno == ECONNRESET) return std::string();
+			throw std::runtime_error(std::string("read failed: ") + std::strerror(errno));
+		}
+	}
+};
+
+struct FdSink : NativeSink {
+	Value owner;
+	int fd;
+	FdSink(Value o, int f) : owner(std::move(o)), fd(f) {}
+	void writeAll(const char* data, size_t n) override {
+		while (n > 0) {
+			ssize_t w = ::write(fd, data, n);
+			if (w < 0) {
+				if (errno == EINTR) continue;
+				if (errno == EAGAIN || errno == EWOULDBLOCK) {
+					pollfd pfd{ fd, POLLOUT, 0 };
+					::poll(&pfd, 1, -1);
+					continue;
+				}
+				throw std::runtime_error(std::string("write failed: ") + std::strerror(errno));
+			}
+			data += w; n -= static_cast<size_t>(w);
+		}
+	}
+};
+#endif
+
+// 工作线程上的结果，由 offload 的 finish 在事件循环线程上读取 (一次跳转)
+struct IoResult {
+	std::string data;
+	bool retry{false};
+	std::string error;
+};
+
+void attachSource(Interpreter* interp, const std::shared_ptr<StreamCore>& core, std::shared_ptr<NativeSource> src) {
+	std::weak_ptr<StreamCore> weak = core;
+	core->pull = [interp, weak, src]{
+		// 在途读取持有流的强引用，结果回来之前流不会因脚本丢弃引用而析构
+		auto c = weak.lock();
+		if (!c) return;
+		auto res = std::make_shared<IoResult>();
+		interp->offload([src, res]{
+			try { res->data = src->readChunk(res->retry); }
+			catch (const std::exception& ex) { res->error = ex.what(); }
+			return Value{ std::monostate{} };
+		}, [c, res](Value)->Value {
+			if (c->hasFailed() || c->hasEnded()) return Value{ std::monostate{} };
+			if (!res->error.empty()) c->fail(Value{ res->error });
+			else if (res->retry) c->retryPull();
+			else if (res->data.empty()) c->end();
+			else c->push(std::move(res->data));
+			return Value{ std::monostate{} };
+		});
+	};
+}
+
+void attachSink(Interpreter* interp, const std::shared_ptr<StreamCore>& core, std::shared_ptr<NativeSink> dst) {
+	core->sink = [interp, dst](std::string chunk, StreamCore::Done done) {
+		auto data = std::make_shared<std::string>(std::move(chunk));
+		auto res = std::make_shared<IoResult>();
+		interp->offload([dst, data, res]{
+			try { dst->writeAll(data->data(), data->size()); }
+			catch (const std::exception& ex) { res->error = ex.what(); }
+			return Value{ std::monostate{} };
+		}, [res, done](Value)->Value {
+			done(res->error.empty(), Value{ res->error });
+			return Value{ std::monostate{} };
+		});
+	};
+	core->finalizer = [interp, dst](StreamCore::Done done) {
+		auto res = std::make_shared<IoResult>();
+		interp->offload([dst, res]{
+			try { dst->finish(); }
+			catch (const std::exception& ex) { res->error = ex.what(); }
+			return Value{ std::monostate{} };
+		}, [res, done](Value)->Value {
+			done(res->error.empty(), Value{ res->error });
+			return Value{ std::monostate{} };
+		});
+	};
+}
+
+// 原生 Transform：变换在事件循环线程上同步执行 (每次最多一个输入块)
+using NativeTransformFn = std::function<void(const std::string& in, std::string& out)>;
+using NativeFlushFn = std::function<void(std::string& out)>;
+
+void attachTransform(const std::shared_ptr<StreamCore>& core, NativeTransformFn transform, NativeFlushFn flush) {
+	std::weak_ptr<StreamCore> weak = core;
+	core->sink = [weak, transform](std::string chunk, StreamCore::Done done) {
+		auto c = weak.lock();
+		if (!c) return;
+		std::string out;
+		try { transform(chunk, out); }
+		catch (const std::exception& ex) { done(false, Value{ std::string(ex.what()) }); return; }
+		c->transformed(std::move(out), std::move(done));
+	};
+	core->finalizer = [weak, flush](StreamCore::Done done) {
+		auto c = weak.lock();
+		if (!c) return;
+		std::string out;
+		try { if (flush) flush(out); }
+		catch (const std::exception& ex) { done(false, Value{ std::string(ex.what()) }); return; }
+		if (!out.empty()) c->push(std::move(out));
+		c->end();
+		done(true, Value{ std::monostate{} });
+	};
+}
+
+#ifdef ASUL_HAS_ZLIB
+// gzip 压缩/解压 (windowBits 31 写 gzip 头，47 自动识别 gzip/zlib)
+struct ZlibState {
+	z_stream zs{};
+	bool deflating;
+	bool finished{false};
+	ZlibState(bool deflate, int level) : deflating(deflate) {
+		int rc = deflate ? deflateInit2(&zs, level, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY) : inflateInit2(&zs, 47);
+		if (rc != Z_OK) throw std::runtime_error("zlib initialization failed");
+	}
+	~ZlibState() { if (deflating) deflateEnd(&zs); else inflateEnd(&zs); }
+
+	void run(const std::string& in, int flush, std::string& out) {
+		zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+		zs.avail_in = static_cast<uInt>(in.size());
+		char buf[kChunkSize / 4];
+		for (;;) {
+			zs.next_out = reinterpret_cast<Bytef*>(buf);
+			zs.avail_out = sizeof(buf);
+			int rc = deflating ? deflate(&zs, flush) : inflate(&zs, flush == Z_FINISH ? Z_NO_FLUSH : flush);
+			out.append(buf, sizeof(buf) - zs.avail_out);
+			if (rc == Z_STREAM_END) {
+				finished = true;
+				if (!deflating && zs.avail_in != 0) throw std::runtime_error("gunzip: trailing data after end of stream");
+				return;
+			}
+			if (rc != Z_OK && rc != Z_BUF_ERROR) throw std::runtime_error(std::string(deflating ? "gzip" : "gunzip") + ": " + (zs.msg ? zs.msg : "zlib error"));
+			if (zs.avail_in == 0 && zs.avail_out != 0) {
+				if (flush == Z_FINISH && !deflating && !finished) throw std::runtime_error("gunzip: unexpected end of compressed data");
+				if (flush != Z_FINISH || !deflating) return;
+			}
+			if (rc == Z_BUF_ERROR && zs.avail_in == 0 && zs.avail_out != 0) return;
+		}
+	}
+};
+#endif
+
+#ifdef ASUL_HAS_OPENSSL
+struct DigestState {
+	EVP_MD_CTX* ctx{nullptr};
+	explicit DigestState(const std::string& algorithm) {
+		const EVP_MD* md = EVP_get_digestbyname(algorithm.c_str());
+		if (!md) throw std::runtime_error("createHash: unsupported algorithm '" + algorithm + "'");
+		ctx = EVP_MD_CTX_new();
+		if (!ctx || EVP_DigestInit_ex(ctx, md, nullptr) != 1) {
+			EVP_MD_CTX_free(ctx);
+			throw std::runtime_error("createHash: digest initialization failed");
+		}
+	}
+	~DigestState() { EVP_MD_CTX_free(ctx); }
+};
+#endif
+
+using NativeFn = std::function<Value(const std::vector<Value>&, std::shared_ptr<Environment>)>;
+
+std::shared_ptr<Function> builtin(NativeFn fn) {
+	auto f = std::make_shared<Function>();
+	f->isBuiltin = true;
+	f->builtin = std::move(fn);
+	return f;
+}
+
+InstanceExt* thisInstance(const std::shared_ptr<Environment>& clos) {
+	if (!clos) throw std::runtime_error("internal: instance method called without closure");
+	Value tv = clos->get("this");
+	auto pins = std::get_if<std::shared_ptr<Instance>>(&tv);
+	if (!pins || !*pins) throw std::runtime_error("internal: invalid 'this' value");
+	return static_cast<InstanceExt*>(pins->get());
+}
+
+std::shared_ptr<StreamCore> thisCore(const std::shared_ptr<Environment>& clos, const char* what) {
+	auto h = static_cast<StreamHandle*>(thisInstance(clos)->nativeHandle);
+	if (!h || !h->core) throw std::runtime_error(std::string(what) + ": stream not initialized");
+	return h->core;
+}
+
+void attachCore(InstanceExt* inst, std::shared_ptr<StreamCore> core) {
+	inst->nativeHandle = new StreamHandle{ std::move(core) };
+	inst->nativeDestructor = [](void* p) { delete static_cast<StreamHandle*>(p); };
+}
+
+// 流类对象从 std.io 包中查找 (与 File.open 查找 FileStream 相同)
+std::shared_ptr<ClassInfo> streamClass(Interpreter* interp, const char* name) {
+	auto pkg = interp->ensurePackage("std.io");
+	auto it = pkg->find(name);
+	if (it == pkg->end() || !std::holds_alternative<std::shared_ptr<ClassInfo>>(it->second)) throw std::runtime_error(std::string(name) + " class not found");
+	return std::get<std::shared_ptr<ClassInfo>>(it->second);
+}
+
+bool isStreamClass(const std::shared_ptr<ClassInfo>& k, const std::shared_ptr<ClassInfo>& r, const std::shared_ptr<ClassInfo>& w) {
+	if (!k) return false;
+	if (k == r || k == w) return true;
+	for (auto& s : k->supers) if (isStreamClass(s, r, w)) return true;
+	return false;
+}
+
+std::shared_ptr<StreamCore> coreOf(Interpreter* interp, const Value& v, const char* what) {
+	auto pins = std::get_if<std::shared_ptr<Instance>>(&v);
+	if (!pins || !*pins || !isStreamClass((*pins)->klass, streamClass(interp, "Readable"), streamClass(interp, "Writable"))) throw std::runtime_error(std::string(what) + ": expected a Readable, Writable or Transform stream");
+	auto h = static_cast<StreamHandle*>(static_cast<InstanceExt*>(pins->get())->nativeHandle);
+	if (!h || !h->core) throw std::runtime_error(std::string(what) + ": stream not initialized");
+	return h->core;
+}
+
+Value newStream(Interpreter* interp, const char* className, bool readable, bool writable, std::shared_ptr<StreamCore>& core) {
+	auto inst = std::make_shared<InstanceExt>();
+	inst->klass = streamClass(interp, className);
+	core = std::make_shared<StreamCore>(interp, readable, writable);
+	attachCore(inst.get(), core);
+	return Value{ std::shared_ptr<Instance>(inst) };
+}
+
+std::shared_ptr<Object> optionsArg(const std::vector<Value>& args, size_t idx, const char* what) {
+	if (args.size() <= idx || std::holds_alternative<std::monostate>(args[idx])) return nullptr;
+	auto opts = std::get_if<std::shared_ptr<Object>>(&args[idx]);
+	if (!opts || !*opts) throw std::runtime_error(std::string(what) + " options must be an object");
+	return *opts;
+}
+
+size_t highWaterOption(const Value& v, const char* what) {
+	double d = getNumber(v, what);
+	if (!(d >= 1 && d <= 1073741824.0) || std::floor(d) != d) throw std::runtime_error(std::string(what) + " must be an integer in 1..1073741824");
+	return static_cast<size_t>(d);
+}
+
+Value functionOption(const Value& v, const char* what) {
+	if (!std::holds_alternative<std::shared_ptr<Function>>(v)) throw std::runtime_error(std::string(what) + " must be a function");
+	return v;
+}
+
+// 文件路径参数：字符串或带 path 字段的 File 实例
+std::string pathArg(const Value& v, const char* what) {
+	if (auto s = std::get_if<std::string>(&v)) return *s;
+	if (auto pins = std::get_if<std::shared_ptr<Instance>>(&v)) {
+		if (*pins) {
+			auto it = (*pins)->fields.find("path");
+			if (it != (*pins)->fields.end() && std::holds_alternative<std::string>(it->second)) return std::get<std::string>(it->second);
+		}
+	}
+	throw std::runtime_error(std::string(what) + " expects a path string or File");
+}
+
+#ifndef _WIN32
+// fd 参数：数字，或带 fileno() 方法的对象 (Socket) 的结果
+int fdArg(const Value& v, const char* what) {
+	Value fdv = v;
+	if (auto pins = std::get_if<std::shared_ptr<Instance>>(&v)) {
+		std::shared_ptr<Function> fileno;
+		if (*pins && (*pins)->klass) {
+			auto it = (*pins)->klass->methods.find("fileno");
+			if (it != (*pins)->klass->methods.end() && it->second->isBuiltin) fileno = it->second;
+		}
+		if (!fileno) throw std::runtime_error(std::string(what) + " expects a file descriptor or a native object with fileno()");
+		auto env = std::make_shared<Environment>(fileno->closure);
+		env->define("this", v);
+		fdv = fileno->builtin({}, env);
+	}
+	double d = getNumber(fdv, what);
+	if (d < 0 || std::floor(d) != d) throw std::runtime_error(std::string(what) + ": invalid file descriptor");
+	return static_cast<int>(d);
+}
+
+// FileStream 实例的底层 fd：popen 管道与标准流可以按 fd 轮询，普通文件返回 -1
+int streamFd(StreamWrapper* w) {
+	if (auto fp = dynamic_cast<FilePtrWrapper*>(w)) return fp->fp ? fileno(fp->fp) : -1;
+	if (dynamic_cast<StdinWrapper*>(w)) return 0;
+	if (dynamic_cast<StdoutWrapper*>(w)) return 1;
+	if (dynamic_cast<StderrWrapper*>(w)) return 2;
+	return -1;
+}
+#endif
+
+StreamWrapper* fileStreamArg(const Value& v, const char* what) {
+	auto pins = std::get_if<std::shared_ptr<Instance>>(&v);
+	if (!pins || !*pins || !(*pins)->klass || (*pins)->klass->name != "FileStream") throw std::runtime_error(std::string(what) + " expects a FileStream");
+	auto w = static_cast<StreamWrapper*>(static_cast<InstanceExt*>(pins->get())->nativeHandle);
+	if (!w) throw std::runtime_error(std::string(what) + ": FileStream is closed");
+	return w;
+}
+
+StreamCore::ReadKind readKindOf(size_t n) { return n ? StreamCore::ReadKind::Exact : StreamCore::ReadKind::Any; }
+
+} // namespace
+
+void registerIoStreams(Interpreter& interp, const std::shared_ptr<Object>& ioPkg) {
+	Interpreter* interpPtr = &interp;
+	auto readable = std::make_shared<ClassInfo>(); readable->name = "Readable"; readable->isNative = true;
+	auto writable = std::make_shared<ClassInfo>(); writable->name = "Writable"; writable->isNative = true;
+	auto transform = std::make_shared<ClassInfo>(); transform->name = "Transform"; transform->isNative = true;
+	transform->supers = { readable, writable };
+
+	// ---- Readable([{highWaterMark, read}]) ----
+	readable->methods["constructor"] = builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		auto core = std::make_shared<StreamCore>(interpPtr, true, false);
+		if (auto opts = optionsArg(args, 0, "Readable")) {
+			for (auto& kv : *opts) {
+				if (kv.first == "highWaterMark") core->readHighWater = highWaterOption(kv.second, "Readable highWaterMark");
+				else if (kv.first == "read") {
+					// 脚本拉取回调：缓冲低于高水位时调用，回调里用 push()/end() 提供数据
+					Value fn = functionOption(kv.second, "Readable read");
+					core->pull = [interpPtr, fn]{ interpPtr->callValue(fn, {}); };
+				}
+				else throw std::runtime_error("Readable: unknown option '" + kv.first + "'");
+			}
+		}
+		attachCore(thisInstance(clos), core);
+		return Value{ std::monostate{} };
+	});
+	// push(chunk) -> bool：缓冲仍低于高水位时为 true
+	readable->methods["push"] = builtin([](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		if (args.size() != 1) throw std::runtime_error("Readable.push expects 1 argument (chunk)");
+		auto core = thisCore(clos, "Readable.push");
+		if (std::holds_alternative<std::monostate>(args[0])) { core->end(); return Value{ false }; }
+		return Value{ core->push(chunkArg(args[0], "Readable.push")) };
+	});
+	readable->methods["end"] = builtin([](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+		thisCore(clos, "Readable.end")->end();
+		return Value{ std::monostate{} };
+	});
+	// read([n]) -> Promise<string|null>：无参数时取出当前可用的数据，n 指定时凑满 n 字节 (结束时可能更短)；EOF 为 null
+	readable->methods["read"] = builtin([](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		size_t n = 0;
+		if (!args.empty() && !std::holds_alternative<std::monostate>(args[0])) {
+			double d = getNumber(args[0], "Readable.read n");
+			if (!(d >= 1) || std::floor(d) != d) throw std::runtime_error("Readable.read n must be a positive integer");
+			n = static_cast<size_t>(d);
+		}
+		return Value{ thisCore(clos, "Readable.read")->read(readKindOf(n), n) };
+	});
+	// readLine() -> Promise<string|null>：不含行尾的 \n / \r\n
+	readable->methods["readLine"] = builtin([](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+		return Value{ thisCore(clos, "Readable.readLine")->read(StreamCore::ReadKind::Line, 0) };
+	});
+	// text() -> Promise<string>：读到结束的全部剩余数据
+	readable->methods["text"] = builtin([](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+		return Value{ thisCore(clos, "Readable.text")->read(StreamCore::ReadKind::All, 0) };
+	});
+	// pipe(dest[, {end}]) -> dest：按下游的 write() 返回值暂停，drain 后继续
+	readable->methods["pipe"] = builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		if (args.empty() || args.size() > 2) throw std::runtime_error("Readable.pipe expects (dest[, options])");
+		auto dest = coreOf(interpPtr, args[0], "Readable.pipe");
+		bool endDest = true;
+		if (auto opts = optionsArg(args, 1, "Readable.pipe")) {
+			for (auto& kv : *opts) {
+				if (kv.first == "end") endDest = isTruthy(kv.second);
+				else throw std::runtime_error("Readable.pipe: unknown option '" + kv.first + "'");
+			}
+		}
+		thisCore(clos, "Readable.pipe")->pipe(dest, endDest);
+		return args[0];
+	});
+	readable->methods["readableLength"] = builtin([](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+		return Value{ static_cast<double>(thisCore(clos, "Readable.readableLength")->readableLength()) };
+	});
+	auto finishedFn = builtin([](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+		return Value{ thisCore(clos, "stream.finished")->finished() };
+	});
+	// destroy([err])：丢弃缓冲，挂起的读写以 err (默认 "stream destroyed") 失败
+	auto destroyFn = builtin([](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		Value err = (!args.empty() && !std::holds_alternative<std::monostate>(args[0])) ? args[0] : Value{ std::string("stream destroyed") };
+		thisCore(clos, "stream.destroy")->fail(err);
+		return Value{ std::monostate{} };
+	});
+	readable->methods["finished"] = finishedFn;
+	readable->methods["destroy"] = destroyFn;
+	// Readable.from(string | array of chunks)
+	readable->staticMethods["from"] = builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+		if (args.size() != 1) throw std::runtime_error("Readable.from expects 1 argument (string or array of chunks)");
+		std::shared_ptr<StreamCore> core;
+		Value out = newStream(interpPtr, "Readable", true, false, core);
+		if (auto arr = std::get_if<std::shared_ptr<Array>>(&args[0])) {
+			for (auto& v : **arr) core->push(chunkArg(v, "Readable.from"));
+		} else {
+			core->push(chunkArg(args[0], "Readable.from"));
+		}
+		core->end();
+		return out;
+	});
+
+	// ---- Writable({write, final, highWaterMark}) ----
+	writable->methods["constructor"] = builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		auto core = std::make_shared<StreamCore>(interpPtr, false, true);
+		auto opts = optionsArg(args, 0, "Writable");
+		if (!opts) throw std::runtime_error("Writable expects options with a write(chunk) function");
+		for (auto& kv : *opts) {
+			if (kv.first == "highWaterMark") core->writeHighWater = highWaterOption(kv.second, "Writable highWaterMark");
+			else if (kv.first == "write") {
+				// write(chunk) 可返回 Promise；它完成之前不会交付下一块
+				Value fn = functionOption(kv.second, "Writable write");
+				core->sink = [interpPtr, fn](std::string chunk, StreamCore::Done done) {
+					callScript(interpPtr, fn, { Value{ std::move(chunk) } }, done);
+				};
+			}
+			else if (kv.first == "final") {
+				Value fn = functionOption(kv.second, "Writable final");
+				core->finalizer = [interpPtr, fn](StreamCore::Done done) { callScript(interpPtr, fn, {}, done); };
+			}
+			else throw std::runtime_error("Writable: unknown option '" + kv.first + "'");
+		}
+		if (!core->sink) throw std::runtime_error("Writable expects options with a write(chunk) function");
+		attachCore(thisInstance(clos), core);
+		return Value{ std::monostate{} };
+	});
+	// write(chunk) -> bool：待写字节低于高水位时为 true；为 false 时应等待 drain()
+	writable->methods["write"] = builtin([](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		if (args.size() != 1) throw std::runtime_error("Writable.write expects 1 argument (chunk)");
+		auto core = thisCore(clos, "Writable.write");
+		return Value{ core->write(chunkArg(args[0], "Writable.write")) };
+	});
+	writable->methods["drain"] = builtin([](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+		return Value{ thisCore(clos, "Writable.drain")->drain() };
+	});
+	// end([chunk]) -> Promise：全部写出并完成 final 后 resolve
+	writable->methods["end"] = builtin([](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		auto core = thisCore(clos, "Writable.end");
+		if (!args.empty() && !std::holds_alternative<std::monostate>(args[0])) core->write(chunkArg(args[0], "Writable.end"));
+		return Value{ core->endWritable() };
+	});
+	writable->methods["writableLength"] = builtin([](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+		return Value{ static_cast<double>(thisCore(clos, "Writable.writableLength")->writableLength()) };
+	});
+	writable->methods["finished"] = finishedFn;
+	writable->methods["destroy"] = destroyFn;
+
+	// ---- Transform({transform, flush, highWaterMark}) ----
+	transform->methods["constructor"] = builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+		auto core = std::make_shared<StreamCore>(interpPtr, true, true);
+		Value transformFn{std::monostate{}}, flushFn{std::monostate{}};
+		if (auto opts = optionsArg(args, 0, "Transform")) {
+			for (auto& kv : *opts) {
+				if (kv.first == "highWaterMark") core->readHighWater = core->writeHighWater = highWaterOption(kv.second, "Transform highWaterMark");
+				else if (kv.first == "transform") transformFn = functionOption(kv.second, "Transform transform");
+				else if (kv.first == "flush") flushFn = functionOption(kv.second, "Transform flush");
+				else throw std::runtime_error("Transform: unknown option '" + kv.first + "'");
+			}
+		}
+		// transform(chunk) 返回输出块 (字符串/字节数组，null 表示不输出) 或其 Promise；未提供时原样透传
+		std::weak_ptr<StreamCore> weak = core;
+		auto emit = [weak](StreamCore::Done done) {
+			return [weak, done](bool ok, Value out) {
+				auto c = weak.lock();
+				if (!c) return;
+				if (!ok) { done(false, out); return; }
+				std::string bytes;
+				try { if (!std::holds_alternative<std::monostate>(out)) bytes = chunkArg(out, "Transform output"); }
+				catch (const std::exception& ex) { done(false, Value{ std::string(ex.what()) }); return; }
+				c->transformed(std::move(bytes), done);
+			};
+		};
+		core->sink = [interpPtr, transformFn, emit](std::string chunk, StreamCore::Done done) {
+			if (std::holds_alternative<std::monostate>(transformFn)) { emit(done)(true, Value{ std::move(chunk) }); return; }
+			callScript(interpPtr, transformFn, { Value{ std::move(chunk) } }, emit(done));
+		};
+		core->finalizer = [interpPtr, weak, flushFn](StreamCore::Done done) {
+			auto finish = [weak, done](bool ok, Value out) {
+				auto c = weak.lock();
+				if (!c) return;
+				if (!ok) { done(false, out); return; }
+				try { if (!std::holds_alternative<std::monostate>(out)) c->push(chunkArg(out, "Transform flush output")); }
+				catch (const std::exception& ex) { done(false, Value{ std::string(ex.what()) }); return; }
+				c->end();
+				done(true, Value{ std::monostate{} });
+			};
+			if (std::holds_alternative<std::monostate>(flushFn)) finish(true, Value{ std::monostate{} });
+			else callScript(interpPtr, flushFn, {}, finish);
+		};
+		attachCore(thisInstance(clos), core);
+		return Value{ std::monostate{} };
+	});
+	// end 同时存在于两个父类中，Transform 取可写端的语义
+	transform->methods["end"] = writable->methods["end"];
+	transform->methods["finished"] = finishedFn;
+	transform->methods["destroy"] = destroyFn;
+
+	(*ioPkg)["Readable"] = Value{ readable };
+	(*ioPkg)["Writable"] = Value{ writable };
+	(*ioPkg)["Transform"] = Value{ transform };
+
+	// ---- 文件适配器 ----
+	// createReadStream(path|File[, {highWaterMark, start}])
+	(*ioPkg)["createReadStream"] = Value{ builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+		if (args.empty() || args.size() > 2) throw std::runtime_error("createReadStream expects (path[, options])");
+		std::string path = pathArg(args[0], "createReadStream");
+		std::shared_ptr<StreamCore> core;
+		Value out = newStream(interpPtr, "Readable", true, false, core);
+		long start = 0;
+		if (auto opts = optionsArg(args, 1, "createReadStream")) {
+			for (auto& kv : *opts) {
+				if (kv.first == "highWaterMark") core->readHighWater = highWaterOption(kv.second, "createReadStream highWaterMark");
+				else if (kv.first == "start") {
+					double d = getNumber(kv.second, "createReadStream start");
+					if (d < 0 || std::floor(d) != d) throw std::runtime_error("createReadStream start must be a non-negative integer");
+					start = static_cast<long>(d);
+				}
+				else throw std::runtime_error("createReadStream: unknown option '" + kv.first + "'");
+			}
+		}
+		FILE* fp = std::fopen(path.c_str(), "rb");
+		if (!fp) throw std::runtime_error("createReadStream cannot open: " + path);
+		if (start > 0 && std::fseek(fp, start, SEEK_SET) != 0) { std::fclose(fp); throw std::runtime_error("createReadStream cannot seek: " + path); }
+		attachSource(interpPtr, core, std::make_shared<FileSource>(fp));
+		return out;
+	}) };
+	// createWriteStream(path|File[, {append, highWaterMark}])
+	(*ioPkg)["createWriteStream"] = Value{ builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+		if (args.empty() || args.size() > 2) throw std::runtime_error("createWriteStream expects (path[, options])");
+		std::string path = pathArg(args[0], "createWriteStream");
+		std::shared_ptr<StreamCore> core;
+		Value out = newStream(interpPtr, "Writable", false, true, core);
+		bool append = false;
+		if (auto opts = optionsArg(args, 1, "createWriteStream")) {
+			for (auto& kv : *opts) {
+				if (kv.first == "append") append = isTruthy(kv.second);
+				else if (kv.first == "highWaterMark") core->writeHighWater = highWaterOption(kv.second, "createWriteStream highWaterMark");
+				else throw std::runtime_error("createWriteStream: unknown option '" + kv.first + "'");
+			}
+		}
+		FILE* fp = std::fopen(path.c_str(), append ? "ab" : "wb");
+		if (!fp) throw std::runtime_error("createWriteStream cannot open: " + path);
+		attachSink(interpPtr, core, std::make_shared<FileSink>(fp));
+		return out;
+	}) };
+
+	// ---- fd / FileStream 适配器 ----
+	// Readable.fromFd(fd|socket) / Writable.fromFd(fd|socket)：不接管 fd，关闭仍由原对象负责
+	readable->staticMethods["fromFd"] = builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+#ifdef _WIN32
+		throw std::runtime_error("Readable.fromFd is not supported on this platform");
+#else
+		if (args.size() != 1) throw std::runtime_error("Readable.fromFd expects 1 argument (fd or socket)");
+		int fd = fdArg(args[0], "Readable.fromFd");
+		std::shared_ptr<StreamCore> core;
+		Value out = newStream(interpPtr, "Readable", true, false, core);
+		attachSource(interpPtr, core, std::make_shared<FdSource>(args[0], fd));
+		return out;
+#endif
+	});
+	writable->staticMethods["fromFd"] = builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+#ifdef _WIN32
+		throw std::runtime_error("Writable.fromFd is not supported on this platform");
+#else
+		if (args.size() != 1) throw std::runtime_error("Writable.fromFd expects 1 argument (fd or socket)");
+		int fd = fdArg(args[0], "Writable.fromFd");
+		std::shared_ptr<StreamCore> core;
+		Value out = newStream(interpPtr, "Writable", false, true, core);
+		attachSink(interpPtr, core, std::make_shared<FdSink>(args[0], fd));
+		return out;
+#endif
+	});
+	// Readable.fromFileStream(fs) / Writable.fromFileStream(fs)：File.open、os.popen 与 stdin/stdout/stderr 得到的 FileStream。
+	// 管道与标准流按 fd 读取 (有多少交付多少)，普通文件经 FileStream 自身读写。
+	readable->staticMethods["fromFileStream"] = builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+		if (args.size() != 1) throw std::runtime_error("Readable.fromFileStream expects 1 argument (FileStream)");
+		StreamWrapper* w = fileStreamArg(args[0], "Readable.fromFileStream");
+		std::shared_ptr<StreamCore> core;
+		Value out = newStream(interpPtr, "Readable", true, false, core);
+#ifndef _WIN32
+		int fd = streamFd(w);
+		if (fd >= 0) { attachSource(interpPtr, core, std::make_shared<FdSource>(args[0], fd)); return out; }
+#endif
+		attachSource(interpPtr, core, std::make_shared<WrapperSource>(args[0], w));
+		return out;
+	});
+	writable->staticMethods["fromFileStream"] = builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+		if (args.size() != 1) throw std::runtime_error("Writable.fromFileStream expects 1 argument (FileStream)");
+		StreamWrapper* w = fileStreamArg(args[0], "Writable.fromFileStream");
+		std::shared_ptr<StreamCore> core;
+		Value out = newStream(interpPtr, "Writable", false, true, core);
+		attachSink(interpPtr, core, std::make_shared<WrapperSink>(args[0], w));
+		return out;
+	});
+
+	// ---- 压缩与哈希 ----
+	// createGzip([{level}]) / createGunzip()
+	(*ioPkg)["createGzip"] = Value{ builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+#ifdef ASUL_HAS_ZLIB
+		int level = Z_DEFAULT_COMPRESSION;
+		if (auto opts = optionsArg(args, 0, "createGzip")) {
+			for (auto& kv : *opts) {
+				if (kv.first == "level") {
+					double d = getNumber(kv.second, "createGzip level");
+					if (d < 0 || d > 9 || std::floor(d) != d) throw std::runtime_error("createGzip level must be 0..9");
+					level = static_cast<int>(d);
+				}
+				else throw std::runtime_error("createGzip: unknown option '" + kv.first + "'");
+			}
+		}
+		std::shared_ptr<StreamCore> core;
+		Value out = newStream(interpPtr, "Transform", true, true, core);
+		auto z = std::make_shared<ZlibState>(true, level);
+		attachTransform(core, [z](const std::string& in, std::string& o) { z->run(in, Z_NO_FLUSH, o); },
+			[z](std::string& o) { z->run(std::string(), Z_FINISH, o); });
+		return out;
+#else
+		(void)args; (void)interpPtr;
+		throw std::runtime_error("createGzip requires zlib support");
+#endif
+	}) };
+	(*ioPkg)["createGunzip"] = Value{ builtin([interpPtr](const std::vector<Value>&, std::shared_ptr<Environment>)->Value {
+#ifdef ASUL_HAS_ZLIB
+		std::shared_ptr<StreamCore> core;
+		Value out = newStream(interpPtr, "Transform", true, true, core);
+		auto z = std::make_shared<ZlibState>(false, 0);
+		attachTransform(core, [z](const std::string& in, std::string& o) { z->run(in, Z_NO_FLUSH, o); },
+			[z](std::string& o) { z->run(std::string(), Z_FINISH, o); });
+		return out;
+#else
+		(void)interpPtr;
+		throw std::runtime_error("createGunzip requires zlib support");
+#endif
+	}) };
+	// createHash(algorithm)：吞下全部输入，结束时输出小写十六进制摘要
+	(*ioPkg)["createHash"] = Value{ builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+		if (args.size() != 1 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("createHash expects 1 argument (algorithm name)");
+#ifdef ASUL_HAS_OPENSSL
+		auto digest = std::make_shared<DigestState>(std::get<std::string>(args[0]));
+		std::shared_ptr<StreamCore> core;
+		Value out = newStream(interpPtr, "Transform", true, true, core);
+		attachTransform(core, [digest](const std::string& in, std::string&) {
+			if (EVP_DigestUpdate(digest->ctx, in.data(), in.size()) != 1) throw std::runtime_error("createHash: digest update failed");
+		}, [digest](std::string& o) {
+			unsigned char md[EVP_MAX_MD_SIZE]; unsigned int mdLen = 0;
+			if (EVP_DigestFinal_ex(digest->ctx, md, &mdLen) != 1) throw std::runtime_error("createHash: digest finalization failed");
+			static const char* hex = "0123456789abcdef";
+			for (unsigned int i = 0; i < mdLen; ++i) { o.push_back(hex[md[i] >> 4]); o.push_back(hex[md[i] & 15]); }
+		});
+		return out;
+#else
+		(void)interpPtr;
+		throw std::runtime_error("createHash requires OpenSSL support");
+#endif
+	}) };
+
+	// pipeline(s1, s2, ...) -> Promise：依次 pipe；最后一段可读时 resolve 为它的全部输出，否则在它写完后 resolve。任一段出错都会 reject
+	(*ioPkg)["pipeline"] = Value{ builtin([interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+		if (args.size() < 2) throw std::runtime_error("pipeline expects at least 2 streams");
+		std::vector<std::shared_ptr<StreamCore>> cores;
+		for (size_t i = 0; i < args.size(); ++i) {
+			auto c = coreOf(interpPtr, args[i], "pipeline");
+			if (i + 1 < args.size() && !c->readable) throw std::runtime_error("pipeline: stream " + std::to_string(i) + " is not readable");
+			if (i > 0 && !c->writable) throw std::runtime_error("pipeline: stream " + std::to_string(i) + " is not writable");
+			cores.push_back(std::move(c));
+		}
+		for (size_t i = 0; i + 1 < cores.size(); ++i) cores[i]->pipe(cores[i + 1], true);
+		auto& last = cores.back();
+		return Value{ last->readable ? last->read(StreamCore::ReadKind::All, 0) : last->finished() };
+	}) };
+
+	// for await (chunk in source)：可读流、FileStream (文件/子进程/标准流) 与带 fileno() 的原生对象 (Socket) 按块交付，
+	// 每块一次 Promise。后两者在内部建一个 Readable 核心；提前退出循环时销毁核心，但不关闭底层对象
+	interp.registerAsyncIterable([interpPtr](const Value& v, Interpreter::AsyncIterator& it) {
+		auto pins = std::get_if<std::shared_ptr<Instance>>(&v);
+		if (!pins || !*pins || !(*pins)->klass) return false;
+		auto klass = (*pins)->klass;
+		std::shared_ptr<StreamCore> core;
+		if (isStreamClass(klass, streamClass(interpPtr, "Readable"), streamClass(interpPtr, "Writable"))) {
+			core = coreOf(interpPtr, v, "for await");
+			if (!core->readable) throw std::runtime_error("for await: a Writable stream is not iterable");
+		} else if (klass->name == "FileStream") {
+			StreamWrapper* w = fileStreamArg(v, "for await");
+			core = std::make_shared<StreamCore>(interpPtr, true, false);
+			std::shared_ptr<NativeSource> src;
+#ifndef _WIN32
+			int fd = streamFd(w);
+			if (fd >= 0) src = std::make_shared<FdSource>(v, fd);
+#endif
+			if (!src) src = std::make_shared<WrapperSource>(v, w);
+			attachSource(interpPtr, core, src);
+		} else {
+#ifdef _WIN32
+			return false;
+#else
+			auto fileno = klass->methods.find("fileno");
+			if (fileno == klass->methods.end() || !fileno->second->isBuiltin) return false;
+			core = std::make_shared<StreamCore>(interpPtr, true, false);
+			attachSource(interpPtr, core, std::make_shared<FdSource>(v, fdArg(v, "for await")));
+#endif
+		}
+		it.next = [core]() { return Value{ core->read(StreamCore::ReadKind::Any, 0) }; };
+		it.close = [core]() { if (!core->hasEnded() && !core->hasFailed()) core->fail(Value{ std::string("stream destroyed") }); };
+		return true;
+	});
+}
+
+} // namespace asul
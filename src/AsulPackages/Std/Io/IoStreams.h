@@ -0,0 +1,16 @@
+#ifndef STD_IO_STREAMS_H
+#define STD_IO_STREAMS_H
+
+#include "../../../AsulRuntime.h"
+
+namespace asul {
+
+class Interpreter;
+
+// Readable / Writable / Transform 原生流，以及文件、fd (套接字/管道)、FileStream (子进程 stdio)、gzip、哈希适配器。
+// 注册到 std.io 包 (ioPkg) 中；所有流状态只在事件循环线程上修改，阻塞 I/O 经 offload 放到工作线程池。
+void registerIoStreams(Interpreter& interp, const std::shared_ptr<Object>& ioPkg);
+
+} // namespace asul
+
+#endif // STD_IO_STREAMS_H
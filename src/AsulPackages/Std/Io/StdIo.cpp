@@ -1,4 +1,5 @@
 #include "StdIo.h"
+#include "IoStreams.h"
 #include "../../../AsulInterpreter.h"
 #include <sstream>
 #include <fstream>
@@ -6,6 +7,13 @@
 
 namespace asul {
 
+// Stream 的缓冲区按引用读写：readLine/readToken 只复制读出的片段，而不是整个缓冲区
+static std::string& streamBuffer(const std::shared_ptr<Instance>& inst) {
+    auto& buf = inst->fields["buffer"];
+    if (!std::holds_alternative<std::string>(buf)) buf = Value{ toString(buf) };
+    return std::get<std::string>(buf);
+}
+
 static std::shared_ptr<ClassInfo> makeStreamClass(std::shared_ptr<Environment> env) {
     auto klass = std::make_shared<ClassInfo>();
     klass->name = "Stream";
@@ -31,9 +39,9 @@ static std::shared_ptr<ClassInfo> makeStreamClass(std::shared_ptr<Environment> e
         auto fn = std::make_shared<Function>(); fn->isBuiltin = true; fn->closure = env; fn->params = { "value" };
         fn->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
             auto thisV = clos->get("this"); auto inst = std::get<std::shared_ptr<Instance>>(thisV);
-            std::string cur = std::get<std::string>(inst->fields["buffer"]);
+            // 原地追加，避免每次写入都复制整个缓冲区
+            auto& cur = streamBuffer(inst);
             cur += toString(args.empty()? Value{std::monostate{}} : args[0]);
-            inst->fields["buffer"] = Value{ cur };
             return thisV;
         };
         klass->methods["write"] = fn;
@@ -44,7 +52,7 @@ static std::shared_ptr<ClassInfo> makeStreamClass(std::shared_ptr<Environment> e
         auto fn = std::make_shared<Function>(); fn->isBuiltin = true; fn->closure = env;
         fn->builtin = [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
             auto thisV = clos->get("this"); auto inst = std::get<std::shared_ptr<Instance>>(thisV);
-            std::string cur = std::get<std::string>(inst->fields["buffer"]);
+            const auto& cur = streamBuffer(inst);
             size_t pos = static_cast<size_t>(Interpreter::getNumber(inst->fields["pos"], "pos"));
             while (pos < cur.size() && std::isspace(static_cast<unsigned char>(cur[pos]))) pos++;
             size_t start = pos;
@@ -61,7 +69,7 @@ static std::shared_ptr<ClassInfo> makeStreamClass(std::shared_ptr<Environment> e
         auto fn = std::make_shared<Function>(); fn->isBuiltin = true; fn->closure = env;
         fn->builtin = [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
             auto thisV = clos->get("this"); auto inst = std::get<std::shared_ptr<Instance>>(thisV);
-            std::string cur = std::get<std::string>(inst->fields["buffer"]);
+            const auto& cur = streamBuffer(inst);
             size_t pos = static_cast<size_t>(Interpreter::getNumber(inst->fields["pos"], "pos"));
             size_t start = pos;
             while (pos < cur.size() && cur[pos] != '\n') pos++;
@@ -78,9 +86,9 @@ static std::shared_ptr<ClassInfo> makeStreamClass(std::shared_ptr<Environment> e
         auto fn = std::make_shared<Function>(); fn->isBuiltin = true; fn->closure = env; fn->params = { "value" };
         fn->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
             auto thisV = clos->get("this"); auto inst = std::get<std::shared_ptr<Instance>>(thisV);
-            std::string cur = std::get<std::string>(inst->fields["buffer"]);
+            // 原地追加，避免每次写入都复制整个缓冲区
+            auto& cur = streamBuffer(inst);
             cur += toString(args.empty()? Value{std::monostate{}} : args[0]);
-            inst->fields["buffer"] = Value{ cur };
             return thisV;
         };
         klass->methods["__shl__"] = fn;
@@ -91,7 +99,7 @@ static std::shared_ptr<ClassInfo> makeStreamClass(std::shared_ptr<Environment> e
         auto fn = std::make_shared<Function>(); fn->isBuiltin = true; fn->closure = env; fn->params = { "target" };
         fn->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
             auto thisV = clos->get("this"); auto inst = std::get<std::shared_ptr<Instance>>(thisV);
-            std::string cur = std::get<std::string>(inst->fields["buffer"]);
+            const auto& cur = streamBuffer(inst);
             size_t pos = static_cast<size_t>(Interpreter::getNumber(inst->fields["pos"], "pos"));
             while (pos < cur.size() && std::isspace(static_cast<unsigned char>(cur[pos]))) pos++;
             size_t start = pos;
@@ -132,6 +140,8 @@ void registerStdIoPackage(Interpreter& interp) {
 		// Expose Stream class
 		auto klass = makeStreamClass(interp.globalsEnv());
 		(*ioPkg)["Stream"] = Value{ klass };
+		// Readable / Writable / Transform 原生流与适配器
+		registerIoStreams(interp, ioPkg);
 		
 		// Add I/O functions and File/Dir/FileStream classes
 		auto fsPkg = interp.ensurePackage("std.io.fileSystem");
@@ -675,7 +685,8 @@ void registerStdIoPackage(Interpreter& interp) {
 PackageMeta getStdIoPackageMeta() {
     PackageMeta pkg;
     pkg.name = "std.io";
-    pkg.exports = { "stdin", "stdout", "stderr", "mkdir", "rmdir", "stat", "copy", "move", "chmod", "walk", "writeFile", "appendFile", "readFile" };
+    pkg.exports = { "stdin", "stdout", "stderr", "mkdir", "rmdir", "stat", "copy", "move", "chmod", "walk", "writeFile", "appendFile", "readFile",
+        "createReadStream", "createWriteStream", "createGzip", "createGunzip", "createHash", "pipeline" };
 
     ClassMeta fileStreamClass;
     fileStreamClass.name = "FileStream";
@@ -692,6 +703,21 @@ PackageMeta getStdIoPackageMeta() {
     dirClass.methods = { {"list"}, {"exists"}, {"create"}, {"delete"}, {"rename"}, {"walk"} };
     pkg.classes.push_back(dirClass);
 
+    ClassMeta readableClass;
+    readableClass.name = "Readable";
+    readableClass.methods = { {"constructor"}, {"push"}, {"end"}, {"read"}, {"readLine"}, {"text"}, {"pipe"}, {"readableLength"}, {"finished"}, {"destroy"}, {"from"}, {"fromFd"}, {"fromFileStream"} };
+    pkg.classes.push_back(readableClass);
+
+    ClassMeta writableClass;
+    writableClass.name = "Writable";
+    writableClass.methods = { {"constructor"}, {"write"}, {"drain"}, {"end"}, {"writableLength"}, {"finished"}, {"destroy"}, {"fromFd"}, {"fromFileStream"} };
+    pkg.classes.push_back(writableClass);
+
+    ClassMeta transformClass;
+    transformClass.name = "Transform";
+    transformClass.methods = { {"constructor"}, {"push"}, {"read"}, {"readLine"}, {"text"}, {"pipe"}, {"write"}, {"drain"}, {"end"}, {"finished"}, {"destroy"} };
+    pkg.classes.push_back(transformClass);
+
     return pkg;
 }
 
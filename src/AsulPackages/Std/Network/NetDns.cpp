@@ -0,0 +1,294 @@
+#include "NetDns.h"
+#include "../../../AsulAsync.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+	#define ASUL_CLOSE_SOCKET closesocket
+#else
+	#include <sys/types.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+	#include <netdb.h>
+	#include <unistd.h>
+	#define ASUL_CLOSE_SOCKET ::close
+#endif
+
+namespace asul {
+
+static std::string cacheKey(const std::string& host, int family) {
+	std::string key = std::to_string(family) + "|";
+	for (char c : host) key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+	return key;
+}
+
+// 调用 getaddrinfo；numericOnly 时只接受数字地址 (不会发起网络查询)
+static bool lookupAddrs(const std::string& host, int family, bool numericOnly, std::vector<DnsAddress>& out) {
+	struct addrinfo hints;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = family;
+	hints.ai_socktype = SOCK_STREAM; // 每个地址只返回一项
+	if (numericOnly) hints.ai_flags = AI_NUMERICHOST;
+	struct addrinfo* res = nullptr;
+	if (getaddrinfo(host.c_str(), nullptr, &hints, &res) != 0 || !res) return false;
+	for (auto ai = res; ai; ai = ai->ai_next) {
+		DnsAddress a;
+		std::memset(&a.addr, 0, sizeof(a.addr));
+		std::memcpy(&a.addr, ai->ai_addr, ai->ai_addrlen);
+		a.len = static_cast<socklen_t>(ai->ai_addrlen);
+		out.push_back(a);
+	}
+	freeaddrinfo(res);
+	return !out.empty();
+}
+
+DnsCache& DnsCache::shared() {
+	// 与 WorkerPool::shared 一样不析构，退出时不等待卡住的解析
+	static DnsCache* cache = new DnsCache();
+	return *cache;
+}
+
+DnsCache::DnsCache() : pool(4) {}
+
+void DnsCache::resolveAsync(const std::string& host, int family, Callback done) {
+	std::vector<DnsAddress> addrs;
+	if (lookupAddrs(host, family, true, addrs)) { done(addrs, ""); return; }
+
+	std::string key = cacheKey(host, family);
+	{
+		std::unique_lock<std::mutex> lk(m);
+		auto it = entries.find(key);
+		if (it != entries.end()) {
+			if (it->second.expires > std::chrono::steady_clock::now()) {
+				lru.splice(lru.begin(), lru, it->second.lruPos);
+				if (it->second.error.empty()) counters.hits++; else counters.negativeHits++;
+				addrs = it->second.addrs;
+				std::string error = it->second.error;
+				lk.unlock();
+				done(addrs, error);
+				return;
+			}
+			lru.erase(it->second.lruPos);
+			entries.erase(it);
+		}
+		counters.misses++;
+		auto pending = inflight.find(key);
+		if (pending != inflight.end()) {
+			counters.coalesced++;
+			pending->second.push_back(std::move(done));
+			return;
+		}
+		inflight[key].push_back(std::move(done));
+	}
+	pool.submit([this, host, family, key] {
+		std::vector<DnsAddress> result;
+		std::string error;
+		if (!lookupAddrs(host, family, false, result)) error = "cannot resolve host '" + host + "'";
+		std::vector<Callback> waiters;
+		{
+			std::lock_guard<std::mutex> lk(m);
+			counters.resolutions++;
+			if (!error.empty()) counters.failures++;
+			store(key, result, error);
+			auto it = inflight.find(key);
+			if (it != inflight.end()) {
+				waiters = std::move(it->second);
+				inflight.erase(it);
+			}
+		}
+		for (auto& w : waiters) w(result, error);
+	});
+}
+
+void DnsCache::store(const std::string& key, const std::vector<DnsAddress>& addrs, const std::string& error) {
+	auto ttl = error.empty() ? ttlMs : negativeTtlMs;
+	if (ttl.count() <= 0 || capacity == 0) return;
+	while (entries.size() >= capacity && !lru.empty()) {
+		entries.erase(lru.back());
+		lru.pop_back();
+		counters.evictions++;
+	}
+	lru.push_front(key);
+	Entry& e = entries[key];
+	e.addrs = addrs;
+	e.error = error;
+	e.expires = std::chrono::steady_clock::now() + ttl;
+	e.lruPos = lru.begin();
+}
+
+std::vector<DnsAddress> DnsCache::resolve(const std::string& host, int family) {
+	std::mutex doneMutex;
+	std::condition_variable doneCv;
+	bool finished = false;
+	std::vector<DnsAddress> result;
+	std::string failure;
+	resolveAsync(host, family, [&](const std::vector<DnsAddress>& addrs, const std::string& error) {
+		std::lock_guard<std::mutex> lk(doneMutex);
+		result = addrs;
+		failure = error;
+		finished = true;
+		doneCv.notify_one();
+	});
+	std::unique_lock<std::mutex> lk(doneMutex);
+	doneCv.wait(lk, [&] { return finished; });
+	if (!failure.empty()) throw std::runtime_error(failure);
+	return result;
+}
+
+void DnsCache::configure(std::chrono::milliseconds ttl, std::chrono::milliseconds negativeTtl, size_t maxEntries) {
+	std::lock_guard<std::mutex> lk(m);
+	ttlMs = ttl;
+	negativeTtlMs = negativeTtl;
+	capacity = maxEntries;
+	while (entries.size() > capacity && !lru.empty()) {
+		entries.erase(lru.back());
+		lru.pop_back();
+		counters.evictions++;
+	}
+}
+
+void DnsCache::clear() {
+	std::lock_guard<std::mutex> lk(m);
+	entries.clear();
+	lru.clear();
+}
+
+DnsCache::Stats DnsCache::stats() const { std::lock_guard<std::mutex> lk(m); return counters; }
+size_t DnsCache::size() const { std::lock_guard<std::mutex> lk(m); return entries.size(); }
+std::chrono::milliseconds DnsCache::ttl() const { std::lock_guard<std::mutex> lk(m); return ttlMs; }
+std::chrono::milliseconds DnsCache::negativeTtl() const { std::lock_guard<std::mutex> lk(m); return negativeTtlMs; }
+size_t DnsCache::maxEntries() const { std::lock_guard<std::mutex> lk(m); return capacity; }
+
+int connectTcp(const std::string& host, int port, std::string& error) {
+	std::vector<DnsAddress> addrs;
+	try {
+		addrs = DnsCache::shared().resolve(host, AF_UNSPEC);
+	} catch (const std::exception&) {
+		error = "No such host: " + host;
+		return -1;
+	}
+	for (auto& a : addrs) {
+		struct sockaddr_storage addr = a.addr;
+		if (addr.ss_family == AF_INET6) reinterpret_cast<struct sockaddr_in6*>(&addr)->sin6_port = htons(static_cast<uint16_t>(port));
+		else reinterpret_cast<struct sockaddr_in*>(&addr)->sin_port = htons(static_cast<uint16_t>(port));
+		int fd = static_cast<int>(socket(addr.ss_family, SOCK_STREAM, 0));
+		if (fd < 0) continue;
+		if (::connect(fd, reinterpret_cast<struct sockaddr*>(&addr), a.len) == 0) return fd;
+		ASUL_CLOSE_SOCKET(fd);
+	}
+	error = "connect failed: " + host + ":" + std::to_string(port);
+	return -1;
+}
+
+static std::string addressString(const DnsAddress& a) {
+	char buf[INET6_ADDRSTRLEN] = {0};
+	if (a.addr.ss_family == AF_INET6) inet_ntop(AF_INET6, &reinterpret_cast<const struct sockaddr_in6*>(&a.addr)->sin6_addr, buf, sizeof(buf));
+	else inet_ntop(AF_INET, &reinterpret_cast<const struct sockaddr_in*>(&a.addr)->sin_addr, buf, sizeof(buf));
+	return buf;
+}
+
+static int familyArg(const std::vector<Value>& args, size_t idx, const std::string& what) {
+	if (args.size() <= idx || std::holds_alternative<std::monostate>(args[idx])) return AF_UNSPEC;
+	std::string f = toString(args[idx]);
+	if (f == "inet") return AF_INET;
+	if (f == "inet6") return AF_INET6;
+	if (f == "any") return AF_UNSPEC;
+	throw std::runtime_error(what + ": family must be \"inet\", \"inet6\" or \"any\"");
+}
+
+Value makeDnsObject(AsulAsync* async) {
+	auto dns = std::make_shared<Object>();
+	auto fn = [&](const std::string& name, std::function<Value(const std::vector<Value>&)> body) {
+		auto f = std::make_shared<Function>();
+		f->isBuiltin = true;
+		f->builtin = [body = std::move(body)](const std::vector<Value>& args, std::shared_ptr<Environment>) -> Value { return body(args); };
+		(*dns)[name] = Value{f};
+	};
+
+	// lookup(host[, family]) -> Promise<[address]>
+	fn("lookup", [async](const std::vector<Value>& args) -> Value {
+		if (args.empty()) throw std::runtime_error("dns.lookup expects a host name");
+		std::string host = toString(args[0]);
+		int family = familyArg(args, 1, "dns.lookup");
+		auto p = async->createPromise();
+		DnsCache::shared().resolveAsync(host, family, [async, p](const std::vector<DnsAddress>& addrs, const std::string& error) {
+			if (!error.empty()) { async->reject(p, Value{error}); return; }
+			auto arr = std::make_shared<Array>();
+			for (auto& a : addrs) {
+				std::string s = addressString(a);
+				bool seen = false;
+				for (auto& v : *arr) if (std::get<std::string>(v) == s) { seen = true; break; }
+				if (!seen) arr->push_back(Value{s});
+			}
+			async->resolve(p, Value{arr});
+		});
+		return Value{p};
+	});
+
+	// warm(names[, family]) -> Promise<number>：并行预解析，结果为成功解析的个数
+	fn("warm", [async](const std::vector<Value>& args) -> Value {
+		if (args.empty() || !std::holds_alternative<std::shared_ptr<Array>>(args[0])) throw std::runtime_error("dns.warm expects an array of host names");
+		auto names = std::get<std::shared_ptr<Array>>(args[0]);
+		int family = familyArg(args, 1, "dns.warm");
+		auto p = async->createPromise();
+		if (names->empty()) { async->resolve(p, Value{0.0}); return Value{p}; }
+		auto remaining = std::make_shared<std::atomic<size_t>>(names->size());
+		auto ok = std::make_shared<std::atomic<size_t>>(0);
+		for (auto& n : *names) {
+			DnsCache::shared().resolveAsync(toString(n), family, [async, p, remaining, ok](const std::vector<DnsAddress>&, const std::string& error) {
+				if (error.empty()) ok->fetch_add(1);
+				if (remaining->fetch_sub(1) == 1) async->resolve(p, Value{static_cast<double>(ok->load())});
+			});
+		}
+		return Value{p};
+	});
+
+	// stats() -> {hits, negativeHits, misses, coalesced, resolutions, failures, evictions, size, maxEntries, ttl, negativeTtl}
+	fn("stats", [](const std::vector<Value>&) -> Value {
+		auto& cache = DnsCache::shared();
+		DnsCache::Stats s = cache.stats();
+		auto o = std::make_shared<Object>();
+		(*o)["hits"] = Value{static_cast<double>(s.hits)};
+		(*o)["negativeHits"] = Value{static_cast<double>(s.negativeHits)};
+		(*o)["misses"] = Value{static_cast<double>(s.misses)};
+		(*o)["coalesced"] = Value{static_cast<double>(s.coalesced)};
+		(*o)["resolutions"] = Value{static_cast<double>(s.resolutions)};
+		(*o)["failures"] = Value{static_cast<double>(s.failures)};
+		(*o)["evictions"] = Value{static_cast<double>(s.evictions)};
+		(*o)["size"] = Value{static_cast<double>(cache.size())};
+		(*o)["maxEntries"] = Value{static_cast<double>(cache.maxEntries())};
+		(*o)["ttl"] = Value{static_cast<double>(cache.ttl().count())};
+		(*o)["negativeTtl"] = Value{static_cast<double>(cache.negativeTtl().count())};
+		return Value{o};
+	});
+
+	fn("clear", [](const std::vector<Value>&) -> Value { DnsCache::shared().clear(); return Value{std::monostate{}}; });
+
+	// configure({ttl, negativeTtl, maxEntries})：时间单位为毫秒，0 表示不缓存
+	fn("configure", [](const std::vector<Value>& args) -> Value {
+		if (args.empty() || !std::holds_alternative<std::shared_ptr<Object>>(args[0])) throw std::runtime_error("dns.configure expects an options object");
+		auto opts = std::get<std::shared_ptr<Object>>(args[0]);
+		auto& cache = DnsCache::shared();
+		auto ttl = cache.ttl();
+		auto negativeTtl = cache.negativeTtl();
+		size_t maxEntries = cache.maxEntries();
+		for (auto& kv : *opts) {
+			double v = getNumber(kv.second, "dns.configure option");
+			if (v < 0) throw std::runtime_error("dns.configure: " + kv.first + " must not be negative");
+			if (kv.first == "ttl") ttl = std::chrono::milliseconds(static_cast<long long>(v));
+			else if (kv.first == "negativeTtl") negativeTtl = std::chrono::milliseconds(static_cast<long long>(v));
+			else if (kv.first == "maxEntries") maxEntries = static_cast<size_t>(v);
+			else throw std::runtime_error("dns.configure: unknown option '" + kv.first + "'");
+		}
+		cache.configure(ttl, negativeTtl, maxEntries);
+		return Value{std::monostate{}};
+	});
+	return Value{dns};
+}
+
+} // namespace asul
@@ -0,0 +1,93 @@
+#ifndef ASUL_NET_DNS_H
+#define ASUL_NET_DNS_H
+
+#include "../../../AsulRuntime.h"
+#include "../../../AsulWorkerPool.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+#else
+	#include <sys/socket.h>
+#endif
+
+namespace asul {
+
+class AsulAsync;
+
+struct DnsAddress {
+	struct sockaddr_storage addr;
+	socklen_t len;
+};
+
+// ----------- 进程内 DNS 缓存 -----------
+// 解析在独立的解析线程池上执行 (getaddrinfo 会阻塞，不能占用 offload 用的计算池)；
+// 同一名字的并发查询合并为一次解析。成功结果按 ttl 缓存，失败按 negativeTtl 缓存，
+// 条目数超过 maxEntries 时按 LRU 淘汰。数字地址不经过缓存。
+// getaddrinfo 不提供记录的 TTL，因此 TTL 为统一的可配置值。
+class DnsCache {
+public:
+	using Callback = std::function<void(const std::vector<DnsAddress>& addrs, const std::string& error)>;
+
+	struct Stats {
+		uint64_t hits{0}, negativeHits{0}, misses{0}, coalesced{0};
+		uint64_t resolutions{0}, failures{0}, evictions{0};
+	};
+
+	static DnsCache& shared();
+
+	// 阻塞直到得到结果 (命中时立即返回)；失败时抛出 std::runtime_error("cannot resolve host '...'")
+	std::vector<DnsAddress> resolve(const std::string& host, int family);
+	// 命中时在当前线程上立即回调，否则在解析线程上回调
+	void resolveAsync(const std::string& host, int family, Callback done);
+
+	void configure(std::chrono::milliseconds ttl, std::chrono::milliseconds negativeTtl, size_t maxEntries);
+	void clear();
+	Stats stats() const;
+	size_t size() const;
+	std::chrono::milliseconds ttl() const;
+	std::chrono::milliseconds negativeTtl() const;
+	size_t maxEntries() const;
+
+private:
+	DnsCache();
+
+	struct Entry {
+		std::vector<DnsAddress> addrs;
+		std::string error;
+		std::chrono::steady_clock::time_point expires;
+		std::list<std::string>::iterator lruPos;
+	};
+
+	void store(const std::string& key, const std::vector<DnsAddress>& addrs, const std::string& error);
+
+	mutable std::mutex m;
+	std::unordered_map<std::string, Entry> entries;
+	std::list<std::string> lru; // 前端为最近使用
+	std::unordered_map<std::string, std::vector<Callback>> inflight;
+	std::chrono::milliseconds ttlMs{60000};
+	std::chrono::milliseconds negativeTtlMs{5000};
+	size_t capacity{1024};
+	Stats counters;
+	WorkerPool pool;
+};
+
+// 通过缓存解析 host 并依次尝试每个地址建立 TCP 连接；成功返回 fd，失败返回 -1 并设置 error
+int connectTcp(const std::string& host, int port, std::string& error);
+
+// net.dns = {lookup, warm, stats, clear, configure}
+Value makeDnsObject(AsulAsync* async);
+
+} // namespace asul
+
+#endif // ASUL_NET_DNS_H
@@ -0,0 +1,354 @@
+#include "NetFetchBody.h"
+#include "../../../AsulAsync.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+namespace asul {
+
+static std::string lowerAscii(std::string s) {
+	for (auto& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	return s;
+}
+
+std::shared_ptr<FetchBody> FetchBody::forResponse(std::shared_ptr<NetStream> conn, const std::string& method, int status,
+	const std::string& headers, AsulAsync* async) {
+	std::string transferEncoding, contentLength;
+	std::istringstream in(headers);
+	std::string line;
+	std::getline(in, line); // 状态行
+	while (std::getline(in, line)) {
+		size_t colon = line.find(':');
+		if (colon == std::string::npos) continue;
+		std::string name = lowerAscii(line.substr(0, colon));
+		size_t b = line.find_first_not_of(" \t", colon + 1);
+		size_t e = line.find_last_not_of(" \t\r");
+		std::string value = (b == std::string::npos || e < b) ? std::string() : line.substr(b, e - b + 1);
+		if (name == "transfer-encoding") transferEncoding = lowerAscii(value);
+		else if (name == "content-length") contentLength = value;
+	}
+	if (method == "HEAD" || (status >= 100 && status < 200) || status == 204 || status == 304)
+		return std::make_shared<FetchBody>(std::move(conn), Framing::None, 0, async);
+	if (transferEncoding.find("chunked") != std::string::npos)
+		return std::make_shared<FetchBody>(std::move(conn), Framing::Chunked, 0, async);
+	if (!contentLength.empty()) {
+		char* end = nullptr;
+		unsigned long long len = std::strtoull(contentLength.c_str(), &end, 10);
+		if (end != contentLength.c_str()) return std::make_shared<FetchBody>(std::move(conn), Framing::Length, len, async);
+	}
+	return std::make_shared<FetchBody>(std::move(conn), Framing::UntilClose, 0, async);
+}
+
+bool FetchBody::deliver(std::string chunk) {
+	if (chunk.empty()) return true;
+	std::unique_lock<std::mutex> lk(m);
+	received += chunk.size();
+	if (cancelled) return false;
+	if (mode == Mode::Pipe) {
+		file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+		if (!file) { error = "write to " + filePath + " failed"; return false; }
+		written += chunk.size();
+		return true;
+	}
+	if (mode == Mode::Collect) {
+		collected += chunk;
+		return true;
+	}
+	if (waiter) {
+		auto w = std::move(waiter);
+		waiter.reset();
+		lk.unlock();
+		async->resolve(w, Value{std::move(chunk)});
+		return true;
+	}
+	if (abandoned) {
+		// 已没有脚本能再读取这些数据
+		cancelled = true;
+		chunks.clear();
+		queuedBytes = 0;
+		return false;
+	}
+	queuedBytes += chunk.size();
+	chunks.push_back(std::move(chunk));
+	// 背压：队列满时等待消费者 (或切换到 collect / pipe)
+	cv.wait(lk, [&] { return queuedBytes < kMaxQueued || cancelled || abandoned || mode != Mode::Queue; });
+	if (abandoned && mode == Mode::Queue && !waiter) { cancelled = true; chunks.clear(); queuedBytes = 0; }
+	return !cancelled;
+}
+
+void FetchBody::finish(const std::string& err) {
+	std::shared_ptr<PromiseState> w, pipe;
+	std::function<void(const std::string&, const std::string&)> collectedCb;
+	std::string data, failure;
+	uint64_t bytes;
+	{
+		std::lock_guard<std::mutex> lk(m);
+		if (error.empty()) error = cancelled ? "Body stream cancelled" : err;
+		done = true;
+		failure = error;
+		conn->disconnect(); // 持锁关闭，cancel() 不会对已关闭的 fd 调用 interrupt
+		w = std::move(waiter);
+		waiter.reset();
+		if (mode == Mode::Pipe) {
+			file.close();
+			pipe = pipePromise;
+		}
+		if (mode == Mode::Collect) {
+			collectedCb = std::move(onCollected);
+			onCollected = nullptr;
+			data = std::move(collected);
+			collected.clear();
+		}
+		bytes = written;
+	}
+	cv.notify_all();
+	if (w) {
+		// 正常结束或被取消时 read() 得到 null；传输错误则 reject
+		if (failure.empty() || cancelled) async->resolve(w, Value{std::monostate{}});
+		else async->reject(w, Value{failure});
+	}
+	if (pipe) {
+		if (failure.empty()) async->resolve(pipe, Value{static_cast<double>(bytes)});
+		else async->reject(pipe, Value{failure});
+	}
+	if (collectedCb) {
+		async->postTask([collectedCb, data = std::move(data), failure] { collectedCb(data, failure); });
+	}
+}
+
+void FetchBody::produce(std::string buf) {
+	auto self = shared_from_this(); // 生产期间保持存活
+	char tmp[65536];
+	// 读更多数据到 buf；返回 false 表示连接已结束 (出错时设置 readError)
+	std::string readError;
+	auto fill = [&]() -> bool {
+		long n = conn->receive(tmp, sizeof(tmp));
+		if (n > 0) { buf.append(tmp, static_cast<size_t>(n)); return true; }
+		if (n < 0) readError = conn->lastError();
+		return false;
+	};
+	auto truncated = [&](const char* what) {
+		std::lock_guard<std::mutex> lk(m);
+		if (cancelled) return std::string();
+		return std::string(what) + (readError.empty() ? "" : ": " + readError);
+	};
+
+	std::string err;
+	switch (framing) {
+	case Framing::None:
+		break;
+	case Framing::Length: {
+		uint64_t remaining = length;
+		while (remaining > 0) {
+			if (buf.empty() && !fill()) { err = truncated("connection closed before the body was complete"); break; }
+			size_t n = static_cast<size_t>(std::min<uint64_t>(remaining, buf.size()));
+			remaining -= n;
+			std::string piece;
+			if (n == buf.size()) piece.swap(buf);
+			else { piece = buf.substr(0, n); buf.erase(0, n); }
+			if (!deliver(std::move(piece))) break;
+		}
+		break;
+	}
+	case Framing::Chunked: {
+		bool ok = true;
+		for (;;) {
+			size_t eol;
+			while ((eol = buf.find("\r\n")) == std::string::npos) {
+				if (!fill()) { ok = false; break; }
+			}
+			if (!ok) { err = truncated("truncated chunked body"); break; }
+			std::string sizeLine = buf.substr(0, eol);
+			buf.erase(0, eol + 2);
+			char* end = nullptr;
+			unsigned long long size = std::strtoull(sizeLine.c_str(), &end, 16);
+			if (end == sizeLine.c_str()) { err = "invalid chunk size '" + sizeLine + "'"; break; }
+			if (size == 0) {
+				// 跳过 trailer，直到空行
+				for (;;) {
+					while ((eol = buf.find("\r\n")) == std::string::npos) {
+						if (!fill()) { ok = false; break; }
+					}
+					if (!ok || eol == 0) break;
+					buf.erase(0, eol + 2);
+				}
+				break;
+			}
+			uint64_t remaining = size;
+			while (remaining > 0 && ok) {
+				if (buf.empty() && !fill()) { ok = false; break; }
+				size_t n = static_cast<size_t>(std::min<uint64_t>(remaining, buf.size()));
+				remaining -= n;
+				std::string piece = buf.substr(0, n);
+				buf.erase(0, n);
+				if (!deliver(std::move(piece))) { ok = false; break; }
+			}
+			if (!ok) { err = truncated("truncated chunked body"); break; }
+			while (buf.size() < 2) {
+				if (!fill()) { ok = false; break; }
+			}
+			if (!ok) { err = truncated("truncated chunked body"); break; }
+			buf.erase(0, 2); // 块后的 CRLF
+		}
+		break;
+	}
+	case Framing::UntilClose: {
+		if (!deliver(std::move(buf))) break;
+		for (;;) {
+			long n = conn->receive(tmp, sizeof(tmp));
+			if (n == 0) break;
+			if (n < 0) { readError = conn->lastError(); err = truncated("read failed"); break; }
+			if (!deliver(std::string(tmp, static_cast<size_t>(n)))) break;
+		}
+		break;
+	}
+	}
+	finish(err);
+}
+
+std::shared_ptr<PromiseState> FetchBody::read() {
+	auto p = async->createPromise();
+	std::unique_lock<std::mutex> lk(m);
+	if (mode != Mode::Queue) throw std::runtime_error("body.read: the body is already being consumed by text(), json() or pipeTo()");
+	if (waiter) throw std::runtime_error("body.read: a previous read() is still pending");
+	if (!chunks.empty()) {
+		std::string chunk = std::move(chunks.front());
+		chunks.pop_front();
+		queuedBytes -= chunk.size();
+		lk.unlock();
+		cv.notify_all();
+		async->resolve(p, Value{std::move(chunk)});
+	} else if (done) {
+		std::string failure = cancelled ? std::string() : error;
+		lk.unlock();
+		if (failure.empty()) async->resolve(p, Value{std::monostate{}});
+		else async->reject(p, Value{failure});
+	} else {
+		waiter = p;
+	}
+	return p;
+}
+
+void FetchBody::collect(std::function<void(const std::string& data, const std::string& error)> cb) {
+	std::string data, failure;
+	{
+		std::lock_guard<std::mutex> lk(m);
+		if (mode != Mode::Queue || waiter) throw std::runtime_error("body is already being consumed");
+		for (auto& c : chunks) collected += c;
+		chunks.clear();
+		queuedBytes = 0;
+		if (!done) {
+			mode = Mode::Collect;
+			onCollected = std::move(cb);
+			cv.notify_all();
+			return;
+		}
+		data = std::move(collected);
+		collected.clear();
+		failure = cancelled ? "Body stream cancelled" : error;
+		mode = Mode::Collect;
+	}
+	// 已经读完：在下一轮事件循环中回调，保持异步语义
+	async->postTask([cb = std::move(cb), data = std::move(data), failure] { cb(data, failure); });
+}
+
+std::shared_ptr<PromiseState> FetchBody::pipeTo(const std::string& path) {
+	auto p = async->createPromise();
+	std::unique_lock<std::mutex> lk(m);
+	if (mode != Mode::Queue || waiter) throw std::runtime_error("body.pipeTo: the body is already being consumed");
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file) throw std::runtime_error("body.pipeTo: cannot open " + path);
+	filePath = path;
+	// 先写已排队的数据，保证顺序
+	for (auto& c : chunks) { file.write(c.data(), static_cast<std::streamsize>(c.size())); written += c.size(); }
+	chunks.clear();
+	queuedBytes = 0;
+	mode = Mode::Pipe;
+	if (done) {
+		file.close();
+		std::string failure = cancelled ? "Body stream cancelled" : error;
+		uint64_t bytes = written;
+		lk.unlock();
+		if (failure.empty()) async->resolve(p, Value{static_cast<double>(bytes)});
+		else async->reject(p, Value{failure});
+		return p;
+	}
+	pipePromise = p;
+	lk.unlock();
+	cv.notify_all();
+	return p;
+}
+
+void FetchBody::cancel() {
+	std::lock_guard<std::mutex> lk(m);
+	if (done || cancelled) return;
+	cancelled = true;
+	chunks.clear();
+	queuedBytes = 0;
+	conn->interrupt(); // 让阻塞在 recv 上的 fetch 线程立即返回
+	cv.notify_all();
+}
+
+void FetchBody::abandon() {
+	std::lock_guard<std::mutex> lk(m);
+	abandoned = true;
+	if (done || cancelled) return;
+	if (mode == Mode::Queue && !waiter) {
+		cancelled = true;
+		chunks.clear();
+		queuedBytes = 0;
+		conn->interrupt();
+	}
+	cv.notify_all();
+}
+
+std::shared_ptr<FetchBody::ScriptHandle> FetchBody::scriptHandle() {
+	std::lock_guard<std::mutex> lk(m);
+	auto h = handle.lock();
+	if (!h) {
+		h = std::make_shared<ScriptHandle>(shared_from_this());
+		handle = h;
+	}
+	return h;
+}
+
+uint64_t FetchBody::bytesRead() const {
+	std::lock_guard<std::mutex> lk(m);
+	return received;
+}
+
+Value FetchBody::makeObject() {
+	auto owner = scriptHandle();
+	FetchBody* self = this; // 经由 owner 保持存活
+	auto obj = std::make_shared<Object>();
+	auto fn = [&](const std::string& name, std::function<Value(const std::vector<Value>&)> body) {
+		auto f = std::make_shared<Function>();
+		f->isBuiltin = true;
+		f->builtin = [body = std::move(body)](const std::vector<Value>& args, std::shared_ptr<Environment>) -> Value { return body(args); };
+		(*obj)[name] = Value{f};
+	};
+	// read() -> Promise<string|null>：下一块数据，结束时为 null
+	fn("read", [owner, self](const std::vector<Value>&) -> Value { return Value{self->read()}; });
+	// pipeTo(path | io.File) -> Promise<number>
+	fn("pipeTo", [owner, self](const std::vector<Value>& args) -> Value {
+		if (args.empty()) throw std::runtime_error("body.pipeTo expects a path or a File");
+		std::string path;
+		if (auto inst = std::get_if<std::shared_ptr<Instance>>(&args[0])) {
+			auto it = (*inst)->fields.find("path");
+			if (it == (*inst)->fields.end()) throw std::runtime_error("body.pipeTo expects a path or a File");
+			path = toString(it->second);
+		} else {
+			path = toString(args[0]);
+		}
+		return Value{self->pipeTo(path)};
+	});
+	// cancel()：停止下载并关闭连接
+	fn("cancel", [owner, self](const std::vector<Value>&) -> Value { self->cancel(); return Value{std::monostate{}}; });
+	fn("bytesRead", [owner, self](const std::vector<Value>&) -> Value { return Value{static_cast<double>(self->bytesRead())}; });
+	return Value{obj};
+}
+
+} // namespace asul
@@ -0,0 +1,96 @@
+#ifndef ASUL_NET_FETCH_BODY_H
+#define ASUL_NET_FETCH_BODY_H
+
+#include "../../../AsulRuntime.h"
+#include "NetTls.h"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace asul {
+
+class AsulAsync;
+
+// ----------- fetch 响应体流 -----------
+// fetch 线程在收到响应头后即 resolve，然后继续在同一线程上按 Content-Length / chunked / 读到关闭
+// 解码响应体。消费方式三选一：
+//   read()        逐块读取，队列有上限 (背压：消费慢时生产方阻塞，不再读 socket)
+//   text()/json() 收集剩余内容
+//   pipeTo(path)  在 fetch 线程上直接写文件，内存占用与响应大小无关
+class FetchBody : public std::enable_shared_from_this<FetchBody> {
+public:
+	enum class Framing { None, Length, Chunked, UntilClose };
+
+	FetchBody(std::shared_ptr<NetStream> conn, Framing framing, uint64_t length, AsulAsync* async)
+		: conn(std::move(conn)), framing(framing), length(length), async(async) {}
+
+	// 按 RFC 7230 3.3.3 由方法、状态码和响应头 (含状态行) 决定分帧方式
+	static std::shared_ptr<FetchBody> forResponse(std::shared_ptr<NetStream> conn, const std::string& method, int status,
+		const std::string& headers, AsulAsync* async);
+
+	// fetch 线程：解码并交付响应体，直到结束、出错或 cancel()
+	void produce(std::string leftover);
+
+	// ---- 事件循环线程 ----
+	std::shared_ptr<PromiseState> read();                   // Promise<string|null>
+	// 收集剩余内容；done 在事件循环线程上调用 (error 为空表示成功)
+	void collect(std::function<void(const std::string& data, const std::string& error)> done);
+	std::shared_ptr<PromiseState> pipeTo(const std::string& path); // Promise<number> (写入的字节数)
+	void cancel();
+	uint64_t bytesRead() const;
+
+	// 脚本侧持有的句柄：response.body 与 text()/json() 共用同一个；最后一个引用释放时调用 abandon()，
+	// 这样脚本丢弃未读完的响应时 fetch 线程不会一直阻塞在背压上、占着连接
+	struct ScriptHandle {
+		std::shared_ptr<FetchBody> body;
+		explicit ScriptHandle(std::shared_ptr<FetchBody> b) : body(std::move(b)) {}
+		~ScriptHandle() { body->abandon(); }
+	};
+	std::shared_ptr<ScriptHandle> scriptHandle();
+
+	// {read, pipeTo, cancel, bytesRead}
+	Value makeObject();
+
+private:
+	enum class Mode { Queue, Collect, Pipe };
+	static constexpr size_t kMaxQueued = 1 << 20;
+
+	bool deliver(std::string chunk);   // fetch 线程；返回 false 表示应停止
+	// 脚本已不再持有响应体：还没有人消费 (排队模式且没有挂起的 read) 时直接取消；
+	// text()/json()/pipeTo() 进行中或 read() 挂起时继续，之后若要排队等待消费则停止
+	void abandon();
+	void finish(const std::string& error);
+
+	std::shared_ptr<NetStream> conn;
+	Framing framing;
+	uint64_t length;
+	AsulAsync* async;
+
+	mutable std::mutex m;
+	std::condition_variable cv;
+	Mode mode{Mode::Queue};
+	std::deque<std::string> chunks;
+	size_t queuedBytes{0};
+	uint64_t received{0};
+	bool done{false};
+	bool cancelled{false};
+	bool abandoned{false};
+	std::weak_ptr<ScriptHandle> handle;
+	std::string error;
+	std::shared_ptr<PromiseState> waiter;   // 挂起的 read()
+	std::string collected;
+	std::function<void(const std::string&, const std::string&)> onCollected;
+	std::ofstream file;
+	std::string filePath;
+	uint64_t written{0};
+	std::shared_ptr<PromiseState> pipePromise;
+};
+
+} // namespace asul
+
+#endif // ASUL_NET_FETCH_BODY_H
@@ -0,0 +1,593 @@
+#include "NetTls.h"
+
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #define ASUL_CLOSE_SOCKET closesocket
+    #define ASUL_POLL WSAPoll
+#else
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #define ASUL_CLOSE_SOCKET ::close
+    #define ASUL_POLL ::poll
+#endif
+
+#ifdef ASUL_HAS_OPENSSL
+#include <openssl/ssl.h>
+#include <openssl/ec.h>
+#include <openssl/err.h>
+#include <openssl/pem.h>
+#include <openssl/rand.h>
+#include <openssl/x509v3.h>
+#endif
+
+namespace asul {
+
+TlsOptions tlsOptionsFromValue(const Value& v, const std::string& what) {
+	TlsOptions opts;
+	if (std::holds_alternative<std::monostate>(v)) return opts;
+	auto po = std::get_if<std::shared_ptr<Object>>(&v);
+	if (!po || !*po) throw std::runtime_error(what + ": tls options must be an object");
+	for (auto& kv : **po) {
+		const std::string& k = kv.first;
+		const Value& val = kv.second;
+		if (k == "cert") opts.cert = toString(val);
+		else if (k == "key") opts.key = toString(val);
+		else if (k == "ca") opts.ca = toString(val);
+		else if (k == "servername") opts.servername = toString(val);
+		else if (k == "rejectUnauthorized") opts.rejectUnauthorized = isTruthy(val);
+		else if (k == "requestCert") opts.requestCert = isTruthy(val);
+		else if (k == "handshakeTimeout") {
+			auto n = std::get_if<double>(&val);
+			if (!n || !(*n > 0)) throw std::runtime_error(what + ": tls.handshakeTimeout must be a positive number of milliseconds");
+			opts.handshakeTimeoutMs = static_cast<int>(*n);
+		} else if (k == "alpn") {
+			if (auto s = std::get_if<std::string>(&val)) opts.alpn.push_back(*s);
+			else if (auto arr = std::get_if<std::shared_ptr<Array>>(&val)) { for (auto& p : **arr) opts.alpn.push_back(toString(p)); }
+			else throw std::runtime_error(what + ": tls.alpn must be a string or an array of strings");
+			for (auto& p : opts.alpn) if (p.empty() || p.size() > 255) throw std::runtime_error(what + ": ALPN protocol names must be 1..255 bytes");
+		} else {
+			throw std::runtime_error(what + ": unknown tls option '" + k + "'");
+		}
+	}
+	return opts;
+}
+
+static void setFdNonBlocking(int fd, bool on) {
+#ifdef _WIN32
+	u_long mode = on ? 1 : 0;
+	ioctlsocket(fd, FIONBIO, &mode);
+#else
+	int flags = fcntl(fd, F_GETFL, 0);
+	if (flags < 0) return;
+	fcntl(fd, F_SETFL, on ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+#endif
+}
+
+static bool wouldBlockErrno() {
+#ifdef _WIN32
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+	return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+void NetStream::setNonBlocking(bool on) { if (sock >= 0) setFdNonBlocking(sock, on); }
+
+void NetStream::interrupt() {
+	if (sock < 0) return;
+	interrupted = true;
+#ifdef _WIN32
+	::shutdown(sock, SD_BOTH);
+#else
+	::shutdown(sock, SHUT_RDWR);
+#endif
+}
+
+#ifdef ASUL_HAS_OPENSSL
+
+bool tlsAvailable() { return true; }
+
+static std::string sslErrors(const std::string& what) {
+	std::string out = what;
+	unsigned long e;
+	bool first = true;
+	while ((e = ERR_get_error()) != 0) {
+		char buf[256];
+		ERR_error_string_n(e, buf, sizeof(buf));
+		out += first ? ": " : "; ";
+		out += buf;
+		first = false;
+	}
+	if (first && errno != 0) out += std::string(": ") + std::strerror(errno); // 底层 socket 错误 (如对端已断开)
+	return out;
+}
+
+static bool isPemText(const std::string& s) { return s.find("-----BEGIN") != std::string::npos; }
+
+class TlsContext {
+public:
+	SSL_CTX* ctx{nullptr};
+	bool server{false};
+	std::string alpnWire; // 长度前缀格式
+	int handshakeTimeoutMs{10000};
+	bool rejectUnauthorized{true};
+	~TlsContext() { if (ctx) SSL_CTX_free(ctx); }
+};
+
+static void loadCertificate(SSL_CTX* ctx, const std::string& cert) {
+	if (!isPemText(cert)) {
+		if (SSL_CTX_use_certificate_chain_file(ctx, cert.c_str()) != 1) throw std::runtime_error(sslErrors("tls: cannot load certificate '" + cert + "'"));
+		return;
+	}
+	BIO* bio = BIO_new_mem_buf(cert.data(), static_cast<int>(cert.size()));
+	X509* leaf = PEM_read_bio_X509(bio, nullptr, nullptr, nullptr);
+	bool ok = leaf && SSL_CTX_use_certificate(ctx, leaf) == 1;
+	if (leaf) X509_free(leaf);
+	while (ok) {
+		X509* extra = PEM_read_bio_X509(bio, nullptr, nullptr, nullptr);
+		if (!extra) { ERR_clear_error(); break; } // 链结束
+		if (SSL_CTX_add_extra_chain_cert(ctx, extra) != 1) { X509_free(extra); ok = false; }
+	}
+	BIO_free(bio);
+	if (!ok) throw std::runtime_error(sslErrors("tls: invalid certificate"));
+}
+
+static void loadPrivateKey(SSL_CTX* ctx, const std::string& key) {
+	if (!isPemText(key)) {
+		if (SSL_CTX_use_PrivateKey_file(ctx, key.c_str(), SSL_FILETYPE_PEM) != 1) throw std::runtime_error(sslErrors("tls: cannot load private key '" + key + "'"));
+	} else {
+		BIO* bio = BIO_new_mem_buf(key.data(), static_cast<int>(key.size()));
+		EVP_PKEY* pkey = PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr);
+		BIO_free(bio);
+		bool ok = pkey && SSL_CTX_use_PrivateKey(ctx, pkey) == 1;
+		if (pkey) EVP_PKEY_free(pkey);
+		if (!ok) throw std::runtime_error(sslErrors("tls: invalid private key"));
+	}
+	if (SSL_CTX_check_private_key(ctx) != 1) throw std::runtime_error(sslErrors("tls: private key does not match the certificate"));
+}
+
+static void loadTrust(SSL_CTX* ctx, const std::string& ca) {
+	if (!isPemText(ca)) {
+		if (SSL_CTX_load_verify_locations(ctx, ca.c_str(), nullptr) != 1) throw std::runtime_error(sslErrors("tls: cannot load CA '" + ca + "'"));
+		return;
+	}
+	X509_STORE* store = SSL_CTX_get_cert_store(ctx);
+	BIO* bio = BIO_new_mem_buf(ca.data(), static_cast<int>(ca.size()));
+	int added = 0;
+	while (X509* x = PEM_read_bio_X509(bio, nullptr, nullptr, nullptr)) {
+		X509_STORE_add_cert(store, x);
+		X509_free(x);
+		++added;
+	}
+	ERR_clear_error();
+	BIO_free(bio);
+	if (added == 0) throw std::runtime_error("tls: no certificates found in ca");
+	// 服务器要求客户端证书时，把这些 CA 作为可接受的签发者告知客户端
+	if (SSL_CTX_get_verify_mode(ctx) & SSL_VERIFY_PEER) {
+		BIO* names = BIO_new_mem_buf(ca.data(), static_cast<int>(ca.size()));
+		STACK_OF(X509_NAME)* list = sk_X509_NAME_new_null();
+		while (X509* x = PEM_read_bio_X509(names, nullptr, nullptr, nullptr)) {
+			sk_X509_NAME_push(list, X509_NAME_dup(X509_get_subject_name(x)));
+			X509_free(x);
+		}
+		ERR_clear_error();
+		BIO_free(names);
+		SSL_CTX_set_client_CA_list(ctx, list);
+	}
+}
+
+static std::string alpnWireFormat(const std::vector<std::string>& protos) {
+	std::string wire;
+	for (auto& p : protos) { wire.push_back(static_cast<char>(p.size())); wire += p; }
+	return wire;
+}
+
+static int selectAlpn(SSL*, const unsigned char** out, unsigned char* outlen, const unsigned char* in, unsigned int inlen, void* arg) {
+	auto* tc = static_cast<TlsContext*>(arg);
+	unsigned char* selected = nullptr;
+	// 以服务器的优先级为准
+	if (SSL_select_next_proto(&selected, outlen,
+			reinterpret_cast<const unsigned char*>(tc->alpnWire.data()), static_cast<unsigned int>(tc->alpnWire.size()),
+			in, inlen) != OPENSSL_NPN_NEGOTIATED) {
+		return SSL_TLSEXT_ERR_NOACK;
+	}
+	*out = selected;
+	return SSL_TLSEXT_ERR_OK;
+}
+
+static SSL_CTX* newContext(bool server) {
+	SSL_CTX* ctx = SSL_CTX_new(server ? TLS_server_method() : TLS_client_method());
+	if (!ctx) throw std::runtime_error(sslErrors("tls: SSL_CTX_new failed"));
+	SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+	// 对端不发 close_notify 直接断开时按 EOF 处理 (HTTP 以 Connection: close 结束响应)
+	SSL_CTX_set_options(ctx, SSL_OP_IGNORE_UNEXPECTED_EOF);
+#endif
+	return ctx;
+}
+
+std::shared_ptr<TlsContext> createServerTlsContext(const TlsOptions& opts) {
+	if (opts.cert.empty() || opts.key.empty()) throw std::runtime_error("tls: server requires cert and key");
+	auto tc = std::make_shared<TlsContext>();
+	tc->server = true;
+	tc->ctx = newContext(true);
+	tc->handshakeTimeoutMs = opts.handshakeTimeoutMs;
+	tc->rejectUnauthorized = opts.rejectUnauthorized;
+	loadCertificate(tc->ctx, opts.cert);
+	loadPrivateKey(tc->ctx, opts.key);
+	if (opts.requestCert) {
+		if (opts.rejectUnauthorized) SSL_CTX_set_verify(tc->ctx, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, nullptr);
+		else SSL_CTX_set_verify(tc->ctx, SSL_VERIFY_PEER, [](int, X509_STORE_CTX*) { return 1; }); // 只记录校验结果 (tls.authorized)
+	}
+	if (!opts.ca.empty()) loadTrust(tc->ctx, opts.ca);
+	// 会话恢复：服务器端会话缓存 + 默认开启的 session ticket (密钥随上下文随机生成)
+	SSL_CTX_set_session_cache_mode(tc->ctx, SSL_SESS_CACHE_SERVER);
+	static const unsigned char sidCtx[] = "asul-http";
+	SSL_CTX_set_session_id_context(tc->ctx, sidCtx, sizeof(sidCtx) - 1);
+	SSL_CTX_sess_set_cache_size(tc->ctx, 20000);
+	if (!opts.alpn.empty()) {
+		tc->alpnWire = alpnWireFormat(opts.alpn);
+		SSL_CTX_set_alpn_select_cb(tc->ctx, selectAlpn, tc.get());
+	}
+	return tc;
+}
+
+// ---- 客户端上下文与会话缓存 ----
+namespace {
+std::mutex clientMutex;
+std::map<std::string, std::shared_ptr<TlsContext>> clientContexts; // 选项指纹 -> 上下文 (进程内常驻，会话缓存依附于它)
+std::map<std::string, SSL_SESSION*> clientSessions;               // 上下文 + host:port -> 会话
+constexpr size_t kMaxClientSessions = 1024;
+}
+
+std::shared_ptr<TlsContext> clientTlsContext(const TlsOptions& opts) {
+	std::string fingerprint = opts.cert + '\x1f' + opts.key + '\x1f' + opts.ca + '\x1f' + alpnWireFormat(opts.alpn)
+		+ '\x1f' + (opts.rejectUnauthorized ? "1" : "0") + '\x1f' + std::to_string(opts.handshakeTimeoutMs);
+	std::lock_guard<std::mutex> lk(clientMutex);
+	auto it = clientContexts.find(fingerprint);
+	if (it != clientContexts.end()) return it->second;
+	auto tc = std::make_shared<TlsContext>();
+	tc->ctx = newContext(false);
+	tc->handshakeTimeoutMs = opts.handshakeTimeoutMs;
+	tc->rejectUnauthorized = opts.rejectUnauthorized;
+	if (opts.ca.empty()) SSL_CTX_set_default_verify_paths(tc->ctx);
+	else loadTrust(tc->ctx, opts.ca);
+	if (!opts.cert.empty()) loadCertificate(tc->ctx, opts.cert);
+	if (!opts.key.empty()) loadPrivateKey(tc->ctx, opts.key);
+	SSL_CTX_set_verify(tc->ctx, opts.rejectUnauthorized ? SSL_VERIFY_PEER : SSL_VERIFY_NONE, nullptr);
+	SSL_CTX_set_session_cache_mode(tc->ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+	if (!opts.alpn.empty()) {
+		tc->alpnWire = alpnWireFormat(opts.alpn);
+		SSL_CTX_set_alpn_protos(tc->ctx, reinterpret_cast<const unsigned char*>(tc->alpnWire.data()), static_cast<unsigned int>(tc->alpnWire.size()));
+	}
+	clientContexts[fingerprint] = tc;
+	return tc;
+}
+
+// 握手：fd 切到非阻塞，按 SSL_ERROR_WANT_READ / WANT_WRITE 等待 fd 就绪，超时则失败
+static void driveHandshake(SSL* ssl, int fd, bool server, int timeoutMs) {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+	setFdNonBlocking(fd, true);
+	for (;;) {
+		ERR_clear_error();
+		errno = 0;
+		int r = server ? SSL_accept(ssl) : SSL_connect(ssl);
+		if (r == 1) break;
+		int err = SSL_get_error(ssl, r);
+		short events;
+		if (err == SSL_ERROR_WANT_READ) events = POLLIN;
+		else if (err == SSL_ERROR_WANT_WRITE) events = POLLOUT;
+		else {
+			long vr = SSL_get_verify_result(ssl);
+			if (vr != X509_V_OK) throw std::runtime_error(std::string("TLS handshake failed: certificate verify failed: ") + X509_verify_cert_error_string(vr));
+			throw std::runtime_error(sslErrors("TLS handshake failed"));
+		}
+		auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+		if (left <= 0) throw std::runtime_error("TLS handshake timed out");
+		struct pollfd pfd;
+		pfd.fd = fd; pfd.events = events; pfd.revents = 0;
+		int pr = ASUL_POLL(&pfd, 1, static_cast<int>(left));
+		if (pr == 0) throw std::runtime_error("TLS handshake timed out");
+#ifndef _WIN32
+		if (pr < 0 && errno != EINTR) throw std::runtime_error("TLS handshake failed: poll error");
+#endif
+	}
+	setFdNonBlocking(fd, false);
+}
+
+std::shared_ptr<NetStream> NetStream::acceptTls(const std::shared_ptr<TlsContext>& ctx, int fd) {
+	auto stream = std::make_shared<NetStream>(fd);
+	SSL* ssl = SSL_new(ctx->ctx);
+	if (!ssl) throw std::runtime_error(sslErrors("tls: SSL_new failed"));
+	stream->ssl = ssl;
+	stream->ctx = ctx;
+	SSL_set_fd(ssl, fd);
+	driveHandshake(ssl, fd, true, ctx->handshakeTimeoutMs);
+	return stream;
+}
+
+std::shared_ptr<NetStream> NetStream::connectTls(const std::shared_ptr<TlsContext>& ctx, int fd, const std::string& host, int port) {
+	auto stream = std::make_shared<NetStream>(fd);
+	SSL* ssl = SSL_new(ctx->ctx);
+	if (!ssl) throw std::runtime_error(sslErrors("tls: SSL_new failed"));
+	stream->ssl = ssl;
+	stream->ctx = ctx;
+	SSL_set_fd(ssl, fd);
+	unsigned char ipBuf[16];
+	bool isIp = inet_pton(AF_INET, host.c_str(), ipBuf) == 1 || inet_pton(AF_INET6, host.c_str(), ipBuf) == 1;
+	if (!isIp) SSL_set_tlsext_host_name(ssl, host.c_str());
+	if (ctx->rejectUnauthorized) {
+		X509_VERIFY_PARAM* param = SSL_get0_param(ssl);
+		if (isIp) X509_VERIFY_PARAM_set1_ip_asc(param, host.c_str());
+		else X509_VERIFY_PARAM_set1_host(param, host.c_str(), 0);
+	}
+	stream->sessionKey = std::to_string(reinterpret_cast<uintptr_t>(ctx.get())) + "|" + host + ":" + std::to_string(port);
+	{
+		std::lock_guard<std::mutex> lk(clientMutex);
+		auto it = clientSessions.find(stream->sessionKey);
+		if (it != clientSessions.end()) SSL_set_session(ssl, it->second);
+	}
+	driveHandshake(ssl, fd, false, ctx->handshakeTimeoutMs);
+	return stream;
+}
+
+NetStream::~NetStream() { disconnect(); }
+
+long NetStream::receive(char* buf, size_t len) {
+	if (sock < 0) return -1;
+	if (!ssl) {
+		long n = static_cast<long>(::recv(sock, buf, static_cast<int>(len), 0));
+		if (n < 0) {
+			if (wouldBlockErrno()) return kWouldBlock;
+			error = std::strerror(errno);
+		}
+		return n;
+	}
+	ERR_clear_error();
+	errno = 0;
+	int n = SSL_read(static_cast<SSL*>(ssl), buf, static_cast<int>(len));
+	if (n > 0) return n;
+	int err = SSL_get_error(static_cast<SSL*>(ssl), n);
+	if (err == SSL_ERROR_ZERO_RETURN) return 0;
+	if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) return kWouldBlock;
+	error = sslErrors("TLS read failed");
+	return -1;
+}
+
+long NetStream::sendSome(const char* data, size_t len) {
+	if (sock < 0) return -1;
+	if (!ssl) {
+		long n = static_cast<long>(::send(sock, data, static_cast<int>(len), 0));
+		if (n < 0) {
+			if (wouldBlockErrno()) return kWouldBlock;
+			error = std::strerror(errno);
+		}
+		return n;
+	}
+	ERR_clear_error();
+	errno = 0;
+	int n = SSL_write(static_cast<SSL*>(ssl), data, static_cast<int>(len));
+	if (n > 0) return n;
+	int err = SSL_get_error(static_cast<SSL*>(ssl), n);
+	if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) return kWouldBlock;
+	error = sslErrors("TLS write failed");
+	return -1;
+}
+
+bool NetStream::writeAll(const char* data, size_t len) {
+	if (sock < 0) return false;
+	size_t off = 0;
+	while (off < len) {
+		long n;
+		if (ssl) { ERR_clear_error(); errno = 0; n = SSL_write(static_cast<SSL*>(ssl), data + off, static_cast<int>(len - off)); }
+		else n = static_cast<long>(::send(sock, data + off, static_cast<int>(len - off), 0));
+		if (n <= 0) { error = ssl ? sslErrors("TLS write failed") : std::string(std::strerror(errno)); return false; }
+		off += static_cast<size_t>(n);
+	}
+	return true;
+}
+
+void NetStream::disconnect() {
+	if (ssl) {
+		SSL* s = static_cast<SSL*>(ssl);
+		// 客户端：保存 (TLS 1.3 下握手后才收到的) 会话以便下次恢复
+		if (!sessionKey.empty()) {
+			SSL_SESSION* sess = SSL_get1_session(s);
+			if (sess && SSL_SESSION_is_resumable(sess)) {
+				std::lock_guard<std::mutex> lk(clientMutex);
+				if (clientSessions.size() >= kMaxClientSessions && !clientSessions.count(sessionKey)) {
+					for (auto& kv : clientSessions) SSL_SESSION_free(kv.second);
+					clientSessions.clear();
+				}
+				auto& slot = clientSessions[sessionKey];
+				if (slot) SSL_SESSION_free(slot);
+				slot = sess;
+			} else if (sess) {
+				SSL_SESSION_free(sess);
+			}
+		}
+		if (!interrupted) SSL_shutdown(s); // 已 shutdown 的 socket 上不能再发 close_notify
+		SSL_free(s);
+		ssl = nullptr;
+	}
+	if (sock >= 0) {
+		ASUL_CLOSE_SOCKET(sock);
+		sock = -1;
+	}
+}
+
+Value NetStream::tlsInfo() const {
+	if (!ssl) return Value{std::monostate{}};
+	SSL* s = static_cast<SSL*>(ssl);
+	auto o = std::make_shared<Object>();
+	(*o)["protocol"] = Value{std::string(SSL_get_version(s))};
+	(*o)["cipher"] = Value{std::string(SSL_get_cipher_name(s))};
+	const unsigned char* proto = nullptr; unsigned int protoLen = 0;
+	SSL_get0_alpn_selected(s, &proto, &protoLen);
+	(*o)["alpn"] = protoLen ? Value{std::string(reinterpret_cast<const char*>(proto), protoLen)} : Value{std::monostate{}};
+	(*o)["sessionReused"] = Value{SSL_session_reused(s) == 1};
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	X509* peer = SSL_get1_peer_certificate(s);
+#else
+	X509* peer = SSL_get_peer_certificate(s); // 1.1.x 的旧名字，同样增加引用计数
+#endif
+	if (peer) {
+		char name[512];
+		X509_NAME_oneline(X509_get_subject_name(peer), name, sizeof(name));
+		(*o)["peerCertificate"] = Value{std::string(name)};
+		X509_free(peer);
+	} else {
+		(*o)["peerCertificate"] = Value{std::monostate{}};
+	}
+	(*o)["authorized"] = Value{peer != nullptr && SSL_get_verify_result(s) == X509_V_OK};
+	return Value{o};
+}
+
+namespace {
+
+// P-256 密钥；EVP_EC_gen 只在 OpenSSL 3.0+ 提供，1.1.x 走 EVP_PKEY_keygen
+EVP_PKEY* generateP256Key() {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	return EVP_EC_gen("P-256");
+#else
+	EVP_PKEY* pkey = nullptr;
+	EVP_PKEY_CTX* kctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+	if (kctx && EVP_PKEY_keygen_init(kctx) > 0 && EVP_PKEY_CTX_set_ec_paramgen_curve_nid(kctx, NID_X9_62_prime256v1) > 0
+		&& EVP_PKEY_CTX_set_ec_param_enc(kctx, OPENSSL_EC_NAMED_CURVE) > 0) {
+		if (EVP_PKEY_keygen(kctx, &pkey) <= 0) pkey = nullptr;
+	}
+	if (kctx) EVP_PKEY_CTX_free(kctx);
+	return pkey;
+#endif
+}
+}
+
+void createSelfSignedCertificate(const std::string& commonName, int days, std::string& certPem, std::string& keyPem) {
+	EVP_PKEY* pkey = generateP256Key();
+	if (!pkey) throw std::runtime_error(sslErrors("tls: key generation failed"));
+	X509* x = X509_new();
+	bool ok = x != nullptr;
+	if (ok) {
+		X509_set_version(x, 2);
+		unsigned char serial[16];
+		RAND_bytes(serial, sizeof(serial));
+		serial[0] &= 0x7f;
+		BIGNUM* bn = BN_bin2bn(serial, sizeof(serial), nullptr);
+		BN_to_ASN1_INTEGER(bn, X509_get_serialNumber(x));
+		BN_free(bn);
+		X509_gmtime_adj(X509_getm_notBefore(x), -60);
+		X509_gmtime_adj(X509_getm_notAfter(x), static_cast<long>(days) * 24 * 3600);
+		X509_set_pubkey(x, pkey);
+		X509_NAME* name = X509_get_subject_name(x);
+		X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_UTF8, reinterpret_cast<const unsigned char*>(commonName.c_str()), -1, -1, 0);
+		X509_set_issuer_name(x, name);
+		X509V3_CTX v3;
+		X509V3_set_ctx_nodb(&v3);
+		X509V3_set_ctx(&v3, x, x, nullptr, nullptr, 0);
+		std::string san = "DNS:localhost,IP:127.0.0.1,IP:::1";
+		unsigned char ipBuf[16];
+		if (commonName != "localhost") {
+			bool isIp = inet_pton(AF_INET, commonName.c_str(), ipBuf) == 1 || inet_pton(AF_INET6, commonName.c_str(), ipBuf) == 1;
+			san = (isIp ? "IP:" : "DNS:") + commonName + "," + san;
+		}
+		const std::pair<int, std::string> exts[] = {
+			{NID_basic_constraints, "critical,CA:TRUE"},
+			{NID_key_usage, "critical,digitalSignature,keyCertSign"},
+			{NID_ext_key_usage, "serverAuth,clientAuth"},
+			{NID_subject_alt_name, san},
+		};
+		for (auto& e : exts) {
+			X509_EXTENSION* ext = X509V3_EXT_conf_nid(nullptr, &v3, e.first, e.second.c_str());
+			if (!ext) { ok = false; break; }
+			X509_add_ext(x, ext, -1);
+			X509_EXTENSION_free(ext);
+		}
+		ok = ok && X509_sign(x, pkey, EVP_sha256()) > 0;
+	}
+	if (ok) {
+		BIO* cb = BIO_new(BIO_s_mem());
+		BIO* kb = BIO_new(BIO_s_mem());
+		PEM_write_bio_X509(cb, x);
+		PEM_write_bio_PrivateKey(kb, pkey, nullptr, nullptr, 0, nullptr, nullptr);
+		BUF_MEM* mem;
+		BIO_get_mem_ptr(cb, &mem); certPem.assign(mem->data, mem->length);
+		BIO_get_mem_ptr(kb, &mem); keyPem.assign(mem->data, mem->length);
+		BIO_free(cb);
+		BIO_free(kb);
+	}
+	if (x) X509_free(x);
+	EVP_PKEY_free(pkey);
+	if (!ok) throw std::runtime_error(sslErrors("tls: cannot create self-signed certificate"));
+}
+
+#else // !ASUL_HAS_OPENSSL
+
+bool tlsAvailable() { return false; }
+
+class TlsContext {};
+
+static std::runtime_error noTls() { return std::runtime_error("TLS support requires building with OpenSSL"); }
+
+std::shared_ptr<TlsContext> createServerTlsContext(const TlsOptions&) { throw noTls(); }
+std::shared_ptr<TlsContext> clientTlsContext(const TlsOptions&) { throw noTls(); }
+void createSelfSignedCertificate(const std::string&, int, std::string&, std::string&) { throw noTls(); }
+std::shared_ptr<NetStream> NetStream::acceptTls(const std::shared_ptr<TlsContext>&, int) { throw noTls(); }
+std::shared_ptr<NetStream> NetStream::connectTls(const std::shared_ptr<TlsContext>&, int, const std::string&, int) { throw noTls(); }
+
+NetStream::~NetStream() { disconnect(); }
+
+long NetStream::receive(char* buf, size_t len) {
+	if (sock < 0) return -1;
+	long n = static_cast<long>(::recv(sock, buf, static_cast<int>(len), 0));
+	if (n < 0) {
+		if (wouldBlockErrno()) return kWouldBlock;
+		error = std::strerror(errno);
+	}
+	return n;
+}
+
+long NetStream::sendSome(const char* data, size_t len) {
+	if (sock < 0) return -1;
+	long n = static_cast<long>(::send(sock, data, static_cast<int>(len), 0));
+	if (n < 0) {
+		if (wouldBlockErrno()) return kWouldBlock;
+		error = std::strerror(errno);
+	}
+	return n;
+}
+
+bool NetStream::writeAll(const char* data, size_t len) {
+	if (sock < 0) return false;
+	size_t off = 0;
+	while (off < len) {
+		long n = static_cast<long>(::send(sock, data + off, static_cast<int>(len - off), 0));
+		if (n <= 0) { error = std::strerror(errno); return false; }
+		off += static_cast<size_t>(n);
+	}
+	return true;
+}
+
+void NetStream::disconnect() {
+	if (sock >= 0) {
+		ASUL_CLOSE_SOCKET(sock);
+		sock = -1;
+	}
+}
+
+Value NetStream::tlsInfo() const { return Value{std::monostate{}}; }
+
+#endif
+
+} // namespace asul
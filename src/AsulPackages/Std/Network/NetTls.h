@@ -0,0 +1,80 @@
+#ifndef ASUL_NET_TLS_H
+#define ASUL_NET_TLS_H
+
+#include "../../../AsulRuntime.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace asul {
+
+// ----------- TLS for std.network -----------
+// http.Server 与 fetch 共用的连接层：明文 socket 或 OpenSSL 上的 TLS。
+// 握手在非阻塞 fd 上用 poll 驱动并带超时，完成后切回阻塞模式，读写接口与 recv/send 相同。
+// 未启用 OpenSSL (ASUL_HAS_OPENSSL) 时创建 TLS 上下文会抛出异常，明文连接不受影响。
+
+struct TlsOptions {
+	std::string cert;                // PEM 文本或文件路径 (可含证书链)
+	std::string key;                 // PEM 文本或文件路径
+	std::string ca;                  // 信任的 CA (PEM 文本或文件路径)；客户端为空时使用系统默认
+	std::vector<std::string> alpn;   // 按优先级排列的协议名，如 ["h2", "http/1.1"]
+	bool rejectUnauthorized{true};   // 客户端：校验服务器证书；服务器：requestCert 时校验客户端证书
+	bool requestCert{false};         // 服务器：要求客户端提供证书
+	std::string servername;          // 客户端：SNI 与主机名校验使用的名字 (默认取 URL 主机)
+	int handshakeTimeoutMs{10000};
+};
+
+// {cert, key, ca, alpn, rejectUnauthorized, requestCert, servername, handshakeTimeout}
+TlsOptions tlsOptionsFromValue(const Value& v, const std::string& what);
+
+bool tlsAvailable();
+
+class TlsContext; // 包装 SSL_CTX；服务器上下文带会话缓存与 ticket 密钥
+
+std::shared_ptr<TlsContext> createServerTlsContext(const TlsOptions& opts);
+// 相同选项的客户端上下文在进程内复用，会话按 host:port 缓存以便恢复
+std::shared_ptr<TlsContext> clientTlsContext(const TlsOptions& opts);
+
+// 生成自签名证书 (EC P-256)，SAN 包含 commonName、localhost 与 127.0.0.1
+void createSelfSignedCertificate(const std::string& commonName, int days, std::string& certPem, std::string& keyPem);
+
+class NetStream {
+public:
+	explicit NetStream(int fd) : sock(fd) {}
+	~NetStream();
+	NetStream(const NetStream&) = delete;
+	NetStream& operator=(const NetStream&) = delete;
+
+	// 在已连接的 fd 上完成 TLS 握手；失败时关闭 fd 并抛出 std::runtime_error
+	static std::shared_ptr<NetStream> acceptTls(const std::shared_ptr<TlsContext>& ctx, int fd);
+	static std::shared_ptr<NetStream> connectTls(const std::shared_ptr<TlsContext>& ctx, int fd, const std::string& host, int port);
+
+	static constexpr long kWouldBlock = -2;
+	long receive(char* buf, size_t len); // 返回 0 表示对端关闭，-1 表示出错；非阻塞模式下无数据时返回 kWouldBlock
+	long sendSome(const char* data, size_t len); // 非阻塞写：返回写出的字节数、-1 或 kWouldBlock
+	bool writeAll(const char* data, size_t len);
+	void setNonBlocking(bool on);
+	bool writeAll(const std::string& data) { return writeAll(data.data(), data.size()); }
+	void disconnect(); // 不叫 close/read：StdNetwork.cpp 在 Windows 上把它们定义成宏
+	// 从其他线程唤醒阻塞中的 receive()：shutdown 但不关闭 fd，仍由拥有者调用 disconnect()
+	void interrupt();
+
+	int fd() const { return sock; }
+	bool secure() const { return ssl != nullptr; }
+	const std::string& lastError() const { return error; } // receive / writeAll 失败的原因
+	// {protocol, cipher, alpn, sessionReused, authorized, peerCertificate}；明文连接返回 null
+	Value tlsInfo() const;
+
+private:
+	int sock;
+	void* ssl{nullptr}; // SSL*
+	std::shared_ptr<TlsContext> ctx;
+	std::string sessionKey; // 客户端：会话缓存键
+	std::string error;
+	bool interrupted{false};
+};
+
+} // namespace asul
+
+#endif // ASUL_NET_TLS_H
@@ -0,0 +1,1104 @@
+#include "NetWebSocket.h"
+#include "NetDns.h"
+#include "../../../AsulInterpreter.h"
+#include "../../../AsulAsync.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+	#include <sys/types.h>
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <netinet/tcp.h>
+	#include <netdb.h>
+	#include <fcntl.h>
+	#include <poll.h>
+	#include <unistd.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+	#define ASUL_WS_SSE2 1
+#endif
+#ifdef ASUL_HAS_ZLIB
+	#include <zlib.h>
+#endif
+
+namespace asul {
+
+namespace {
+
+constexpr const char* kWsGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+constexpr size_t kFragmentSize = 256 * 1024;  // 大消息按此大小分片，控制帧可以插在分片之间
+constexpr size_t kDeflateThreshold = 64;      // 更短的消息不压缩
+constexpr int kCloseTimeoutMs = 5000;         // 发出 close 帧后等待对端回应的时间
+
+std::string sha1(const std::string& msg) {
+	uint32_t h[5] = {0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u};
+	std::string m = msg;
+	uint64_t bitLen = static_cast<uint64_t>(msg.size()) * 8;
+	m.push_back(static_cast<char>(0x80));
+	while (m.size() % 64 != 56) m.push_back('\0');
+	for (int i = 7; i >= 0; --i) m.push_back(static_cast<char>((bitLen >> (i * 8)) & 0xff));
+	auto rol = [](uint32_t x, int n) { return (x << n) | (x >> (32 - n)); };
+	for (size_t chunk = 0; chunk < m.size(); chunk += 64) {
+		uint32_t w[80];
+		for (int i = 0; i < 16; ++i) {
+			const unsigned char* p = reinterpret_cast<const unsigned char*>(m.data() + chunk + i * 4);
+			w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+		}
+		for (int i = 16; i < 80; ++i) w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+		uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+		for (int i = 0; i < 80; ++i) {
+			uint32_t f, k;
+			if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999u; }
+			else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1u; }
+			else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDCu; }
+			else { f = b ^ c ^ d; k = 0xCA62C1D6u; }
+			uint32_t t = rol(a, 5) + f + e + k + w[i];
+			e = d; d = c; c = rol(b, 30); b = a; a = t;
+		}
+		h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+	}
+	std::string out;
+	for (uint32_t v : h) for (int i = 3; i >= 0; --i) out.push_back(static_cast<char>((v >> (i * 8)) & 0xff));
+	return out;
+}
+
+std::string base64(const std::string& in) {
+	static const char* tbl = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	std::string out;
+	size_t i = 0;
+	for (; i + 2 < in.size(); i += 3) {
+		uint32_t n = (uint32_t(uint8_t(in[i])) << 16) | (uint32_t(uint8_t(in[i + 1])) << 8) | uint8_t(in[i + 2]);
+		out += tbl[(n >> 18) & 63]; out += tbl[(n >> 12) & 63]; out += tbl[(n >> 6) & 63]; out += tbl[n & 63];
+	}
+	if (i + 1 == in.size()) {
+		uint32_t n = uint32_t(uint8_t(in[i])) << 16;
+		out += tbl[(n >> 18) & 63]; out += tbl[(n >> 12) & 63]; out += "==";
+	} else if (i + 2 == in.size()) {
+		uint32_t n = (uint32_t(uint8_t(in[i])) << 16) | (uint32_t(uint8_t(in[i + 1])) << 8);
+		out += tbl[(n >> 18) & 63]; out += tbl[(n >> 12) & 63]; out += tbl[(n >> 6) & 63]; out += '=';
+	}
+	return out;
+}
+
+std::string acceptKey(const std::string& key) { return base64(sha1(key + kWsGuid)); }
+
+std::string lower(std::string s) {
+	std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return s;
+}
+
+std::string trim(const std::string& s) {
+	size_t b = s.find_first_not_of(" \t\r\n");
+	if (b == std::string::npos) return "";
+	size_t e = s.find_last_not_of(" \t\r\n");
+	return s.substr(b, e - b + 1);
+}
+
+// 请求/响应头中按名字 (不区分大小写) 查找，多个同名头以 ", " 连接
+std::string headerValue(const std::string& headers, const std::string& name) {
+	std::string want = lower(name);
+	std::string result;
+	std::istringstream in(headers);
+	std::string line;
+	std::getline(in, line); // 起始行
+	while (std::getline(in, line)) {
+		size_t colon = line.find(':');
+		if (colon == std::string::npos) continue;
+		if (lower(trim(line.substr(0, colon))) != want) continue;
+		if (!result.empty()) result += ", ";
+		result += trim(line.substr(colon + 1));
+	}
+	return result;
+}
+
+std::vector<std::string> splitTokens(const std::string& s, char sep) {
+	std::vector<std::string> out;
+	std::string cur;
+	std::istringstream in(s);
+	while (std::getline(in, cur, sep)) {
+		cur = trim(cur);
+		if (!cur.empty()) out.push_back(cur);
+	}
+	return out;
+}
+
+bool hasToken(const std::string& list, const std::string& token) {
+	for (auto& t : splitTokens(list, ',')) if (lower(t) == lower(token)) return true;
+	return false;
+}
+
+// permessage-deflate 是否出现在 Sec-WebSocket-Extensions 中 (忽略参数)
+bool offersDeflate(const std::string& extensions) {
+	for (auto& ext : splitTokens(extensions, ',')) {
+		auto parts = splitTokens(ext, ';');
+		if (!parts.empty() && lower(parts[0]) == "permessage-deflate") return true;
+	}
+	return false;
+}
+
+bool validUtf8(const std::string& s) {
+	const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+	size_t n = s.size(), i = 0;
+	while (i < n) {
+		// ASCII 快速路径：一次检查 8 字节
+		if (i + 8 <= n) {
+			uint64_t v;
+			std::memcpy(&v, p + i, 8);
+			if ((v & 0x8080808080808080ull) == 0) { i += 8; continue; }
+		}
+		unsigned char c = p[i];
+		if (c < 0x80) { ++i; continue; }
+		size_t len; uint32_t cp;
+		if ((c & 0xE0) == 0xC0) { len = 2; cp = c & 0x1F; }
+		else if ((c & 0xF0) == 0xE0) { len = 3; cp = c & 0x0F; }
+		else if ((c & 0xF8) == 0xF0) { len = 4; cp = c & 0x07; }
+		else return false;
+		if (i + len > n) return false;
+		for (size_t k = 1; k < len; ++k) {
+			if ((p[i + k] & 0xC0) != 0x80) return false;
+			cp = (cp << 6) | (p[i + k] & 0x3F);
+		}
+		if ((len == 2 && cp < 0x80) || (len == 3 && cp < 0x800) || (len == 4 && (cp < 0x10000 || cp > 0x10FFFF))) return false;
+		if (cp >= 0xD800 && cp <= 0xDFFF) return false;
+		i += len;
+	}
+	return true;
+}
+
+void setNoDelay(int fd) {
+#ifndef _WIN32
+	int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#else
+	(void)fd;
+#endif
+}
+
+#ifdef ASUL_HAS_ZLIB
+// permessage-deflate：本端每条消息重置压缩器 (no_context_takeover)；解压器一直保留上下文，
+// 因此无论对端是否复用上下文都能正确解码
+class WsDeflate {
+public:
+	~WsDeflate() {
+		if (defInit) deflateEnd(&def);
+		if (infInit) inflateEnd(&inf);
+	}
+	bool compress(const std::string& in, std::string& out) {
+		if (!defInit) {
+			std::memset(&def, 0, sizeof(def));
+			if (deflateInit2(&def, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+			defInit = true;
+		} else {
+			deflateReset(&def);
+		}
+		out.clear();
+		def.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+		def.avail_in = static_cast<uInt>(in.size());
+		char chunk[16384];
+		do {
+			def.next_out = reinterpret_cast<Bytef*>(chunk);
+			def.avail_out = sizeof(chunk);
+			if (deflate(&def, Z_SYNC_FLUSH) == Z_STREAM_ERROR) return false;
+			out.append(chunk, sizeof(chunk) - def.avail_out);
+		} while (def.avail_out == 0);
+		// 去掉同步刷新产生的 00 00 ff ff 尾部 (RFC 7692 7.2.1)
+		if (out.size() >= 4 && out.compare(out.size() - 4, 4, std::string("\x00\x00\xff\xff", 4)) == 0) out.resize(out.size() - 4);
+		return true;
+	}
+	bool decompress(std::string in, std::string& out, size_t limit) {
+		if (!infInit) {
+			std::memset(&inf, 0, sizeof(inf));
+			if (inflateInit2(&inf, -15) != Z_OK) return false;
+			infInit = true;
+		}
+		in.append("\x00\x00\xff\xff", 4);
+		out.clear();
+		inf.next_in = reinterpret_cast<Bytef*>(&in[0]);
+		inf.avail_in = static_cast<uInt>(in.size());
+		char chunk[16384];
+		while (inf.avail_in > 0) {
+			inf.next_out = reinterpret_cast<Bytef*>(chunk);
+			inf.avail_out = sizeof(chunk);
+			int r = inflate(&inf, Z_SYNC_FLUSH);
+			if (r != Z_OK && r != Z_BUF_ERROR && r != Z_STREAM_END) return false;
+			out.append(chunk, sizeof(chunk) - inf.avail_out);
+			if (out.size() > limit) return false;
+			if (r == Z_BUF_ERROR && inf.avail_out != 0) break;
+		}
+		return true;
+	}
+private:
+	z_stream def, inf;
+	bool defInit{false}, infInit{false};
+};
+#endif
+
+struct WsOutgoing {
+	int opcode;
+	std::string payload;
+	std::shared_ptr<PromiseState> promise;
+};
+
+std::string describeError(const Value& v) {
+	if (auto o = std::get_if<std::shared_ptr<Object>>(&v)) {
+		if (*o) {
+			auto it = (*o)->find("message");
+			if (it != (*o)->end()) return toString(it->second);
+		}
+	}
+	return toString(v);
+}
+
+} // namespace
+
+void wsMask(unsigned char* data, size_t len, const unsigned char key[4], size_t offset) {
+	unsigned char k[4];
+	for (int j = 0; j < 4; ++j) k[j] = key[(offset + j) & 3];
+	size_t i = 0;
+#ifdef ASUL_WS_SSE2
+	if (len >= 16) {
+		unsigned char pattern[16];
+		for (int j = 0; j < 16; ++j) pattern[j] = k[j & 3];
+		__m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern));
+		for (; i + 16 <= len; i += 16) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm_xor_si128(v, m));
+		}
+	}
+#endif
+	unsigned char pattern8[8];
+	for (int j = 0; j < 8; ++j) pattern8[j] = k[j & 3];
+	uint64_t m64;
+	std::memcpy(&m64, pattern8, 8);
+	for (; i + 8 <= len; i += 8) {
+		uint64_t v;
+		std::memcpy(&v, data + i, 8);
+		v ^= m64;
+		std::memcpy(data + i, &v, 8);
+	}
+	for (; i < len; ++i) data[i] ^= k[i & 3];
+}
+
+WsOptions wsOptionsFromValue(const Value& v, const std::string& what) {
+	WsOptions opts;
+	if (std::holds_alternative<std::monostate>(v)) return opts;
+	auto po = std::get_if<std::shared_ptr<Object>>(&v);
+	if (!po || !*po) throw std::runtime_error(what + ": options must be an object");
+	for (auto& kv : **po) {
+		if (kv.first == "protocols") {
+			if (auto s = std::get_if<std::string>(&kv.second)) opts.protocols.push_back(*s);
+			else if (auto arr = std::get_if<std::shared_ptr<Array>>(&kv.second)) { for (auto& p : **arr) opts.protocols.push_back(toString(p)); }
+			else throw std::runtime_error(what + ": protocols must be a string or an array of strings");
+		} else if (kv.first == "deflate") {
+			opts.deflate = isTruthy(kv.second);
+		} else if (kv.first == "maxMessageSize") {
+			auto n = std::get_if<double>(&kv.second);
+			if (!n || !(*n >= 1)) throw std::runtime_error(what + ": maxMessageSize must be a positive number");
+			opts.maxMessageSize = static_cast<size_t>(*n);
+		}
+		// 其他键 (tls、headers) 由调用方处理
+	}
+	return opts;
+}
+
+bool isWebSocketUpgrade(const std::string& headers) {
+	return hasToken(headerValue(headers, "Upgrade"), "websocket") && hasToken(headerValue(headers, "Connection"), "upgrade");
+}
+
+// ---- 连接 ----
+class WsConnection : public std::enable_shared_from_this<WsConnection> {
+public:
+	enum State { kOpen = 0, kClosing = 1, kClosed = 2 };
+
+	WsConnection(std::shared_ptr<NetStream> s, bool client, bool deflate, size_t maxMessage, Interpreter* interp, AsulAsync* async)
+		: stream(std::move(s)), isClient(client), useDeflate(deflate), maxMessageSize(maxMessage), interp(interp), async(async),
+		  rng(std::random_device{}()) {
+#ifndef _WIN32
+		int fds[2];
+		if (pipe(fds) == 0) {
+			wakeRead = fds[0]; wakeWrite = fds[1];
+			fcntl(wakeRead, F_SETFL, fcntl(wakeRead, F_GETFL, 0) | O_NONBLOCK);
+			fcntl(wakeWrite, F_SETFL, fcntl(wakeWrite, F_GETFL, 0) | O_NONBLOCK);
+		}
+#endif
+	}
+	~WsConnection() {
+#ifndef _WIN32
+		if (wakeRead >= 0) ::close(wakeRead);
+		if (wakeWrite >= 0) ::close(wakeWrite);
+#endif
+	}
+
+	// ---- 事件循环线程 ----
+	Value self{std::monostate{}}; // 连接打开期间保持脚本对象存活
+	std::string url;
+
+	std::shared_ptr<PromiseState> send(std::string data, int opcode) {
+		if (state.load() != kOpen) throw std::runtime_error("WebSocket.send: connection is not open");
+		auto p = async->createPromise();
+		size_t n = data.size();
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			dataQueue.push_back(WsOutgoing{opcode, std::move(data), p});
+		}
+		buffered += n;
+		wake();
+		return p;
+	}
+
+	void ping(const std::string& data) {
+		if (data.size() > 125) throw std::runtime_error("WebSocket.ping: payload must be at most 125 bytes");
+		if (state.load() != kOpen) throw std::runtime_error("WebSocket.ping: connection is not open");
+		std::string frame;
+		appendFrame(frame, 0x9, data.data(), data.size(), true, false);
+		{
+			std::lock_guard<std::mutex> lk(mtx);
+			controlQueue.push_back(std::move(frame));
+		}
+		wake();
+	}
+
+	std::shared_ptr<PromiseState> close(int code, const std::string& reason) {
+		if (!closePromise) {
+			closePromise = async->createPromise();
+			if (finished) async->resolve(closePromise, closeInfo());
+		}
+		if (finished) return closePromise;
+		int expected = kOpen;
+		if (state.compare_exchange_strong(expected, kClosing)) {
+			std::lock_guard<std::mutex> lk(mtx);
+			closeRequested = true;
+			localCode = code;
+			localReason = reason;
+		}
+		wake();
+		return closePromise;
+	}
+
+	std::shared_ptr<PromiseState> receive() {
+		auto p = async->createPromise();
+		if (!inbox.empty()) {
+			async->resolve(p, Value{inbox.front()});
+			inbox.pop_front();
+		} else if (finished) {
+			async->resolve(p, Value{std::monostate{}});
+		} else {
+			receivers.push_back(p);
+		}
+		return p;
+	}
+
+	void on(const std::string& event, const Value& fn) {
+		if (event != "message" && event != "close" && event != "pong" && event != "error")
+			throw std::runtime_error("WebSocket.on: unknown event '" + event + "' (expected message, close, pong or error)");
+		handlers[event].push_back(fn);
+		if (event == "message" && !inbox.empty()) {
+			// 已到达但尚未被取走的消息交给新处理函数 (异步，保持调用顺序一致)
+			auto self = shared_from_this();
+			async->postTask([self]{
+				while (!self->inbox.empty() && self->hasHandlers("message")) {
+					std::string data = std::move(self->inbox.front());
+					bool binary = self->inboxBinary.front();
+					self->inbox.pop_front();
+					self->inboxBinary.pop_front();
+					self->emit("message", {Value{data}, Value{binary}});
+				}
+			});
+		}
+	}
+
+	size_t bufferedAmount() const { return buffered.load(); }
+	int readyState() const { return state.load(); }
+
+	// ---- I/O 线程 ----
+	void run(std::string inbuf);
+
+private:
+	std::shared_ptr<NetStream> stream;
+	bool isClient;
+	bool useDeflate;
+	size_t maxMessageSize;
+	Interpreter* interp;
+	AsulAsync* async;
+	std::mt19937 rng;
+#ifdef ASUL_HAS_ZLIB
+	WsDeflate zlib;
+#endif
+
+	std::mutex mtx; // 保护下面的发送队列与关闭请求
+	std::deque<WsOutgoing> dataQueue;
+	std::deque<std::string> controlQueue; // 已编码的控制帧
+	bool closeRequested{false};
+	int localCode{1000};
+	std::string localReason;
+	std::atomic<size_t> buffered{0};
+	std::atomic<int> state{kOpen};
+	int wakeRead{-1}, wakeWrite{-1};
+
+	// 仅事件循环线程
+	std::map<std::string, std::vector<Value>> handlers;
+	std::deque<std::string> inbox;
+	std::deque<bool> inboxBinary;
+	std::deque<std::shared_ptr<PromiseState>> receivers;
+	std::shared_ptr<PromiseState> closePromise;
+	bool finished{false};
+	int finalCode{1006};
+	std::string finalReason;
+
+	Value closeInfo() const {
+		auto info = std::make_shared<Object>();
+		(*info)["code"] = Value{static_cast<double>(finalCode)};
+		(*info)["reason"] = Value{finalReason};
+		return Value{info};
+	}
+
+	void wake() {
+#ifndef _WIN32
+		if (wakeWrite >= 0) { char c = 1; ssize_t r = ::write(wakeWrite, &c, 1); (void)r; }
+#endif
+	}
+
+	void appendFrame(std::string& out, int opcode, const char* payload, size_t len, bool fin, bool rsv1) {
+		out.push_back(static_cast<char>((fin ? 0x80 : 0) | (rsv1 ? 0x40 : 0) | opcode));
+		unsigned char maskBit = isClient ? 0x80 : 0;
+		if (len < 126) {
+			out.push_back(static_cast<char>(maskBit | len));
+		} else if (len <= 0xffff) {
+			out.push_back(static_cast<char>(maskBit | 126));
+			out.push_back(static_cast<char>((len >> 8) & 0xff));
+			out.push_back(static_cast<char>(len & 0xff));
+		} else {
+			out.push_back(static_cast<char>(maskBit | 127));
+			for (int i = 7; i >= 0; --i) out.push_back(static_cast<char>((static_cast<uint64_t>(len) >> (i * 8)) & 0xff));
+		}
+		if (!isClient) { out.append(payload, len); return; }
+		// 客户端发出的帧必须掩码 (RFC 6455 5.3)
+		unsigned char key[4];
+		uint32_t r = rng();
+		std::memcpy(key, &r, 4);
+		out.append(reinterpret_cast<char*>(key), 4);
+		size_t start = out.size();
+		out.append(payload, len);
+		wsMask(reinterpret_cast<unsigned char*>(&out[start]), len, key);
+	}
+
+	std::string closePayload(int code, const std::string& reason) {
+		std::string p;
+		p.push_back(static_cast<char>((code >> 8) & 0xff));
+		p.push_back(static_cast<char>(code & 0xff));
+		p += reason;
+		return p;
+	}
+
+	bool hasHandlers(const std::string& event) {
+		auto it = handlers.find(event);
+		return it != handlers.end() && !it->second.empty();
+	}
+
+	void emit(const std::string& event, const std::vector<Value>& args) {
+		auto it = handlers.find(event);
+		if (it == handlers.end()) return;
+		auto list = it->second; // 处理函数中可能继续注册
+		for (auto& fn : list) {
+			try {
+				interp->callValue(fn, args);
+			} catch (const ExceptionSignal& ex) {
+				std::cerr << "WebSocket " << event << " handler error: " << describeError(ex.value) << std::endl;
+			} catch (const std::exception& ex) {
+				std::cerr << "WebSocket " << event << " handler error: " << ex.what() << std::endl;
+			}
+		}
+	}
+
+	// I/O 线程 -> 事件循环
+	void postMessage(std::string data, bool binary) {
+		auto self = shared_from_this();
+		async->postTask([self, data = std::move(data), binary]() mutable {
+			if (self->hasHandlers("message")) {
+				self->emit("message", {Value{data}, Value{binary}});
+			} else if (!self->receivers.empty()) {
+				auto p = self->receivers.front();
+				self->receivers.pop_front();
+				self->async->resolve(p, Value{std::move(data)});
+			} else {
+				self->inbox.push_back(std::move(data));
+				self->inboxBinary.push_back(binary);
+			}
+		});
+	}
+
+	void postPong(std::string data) {
+		auto self = shared_from_this();
+		async->postTask([self, data = std::move(data)] { self->emit("pong", {Value{data}}); });
+	}
+
+	void postFinished(int code, std::string reason, std::string error) {
+		auto self = shared_from_this();
+		async->postTask([self, code, reason = std::move(reason), error = std::move(error)] {
+			self->finished = true;
+			self->finalCode = code;
+			self->finalReason = reason;
+			if (!error.empty()) self->emit("error", {Value{error}});
+			for (auto& p : self->receivers) self->async->resolve(p, Value{std::monostate{}});
+			self->receivers.clear();
+			self->emit("close", {Value{static_cast<double>(code)}, Value{reason}});
+			if (self->closePromise) self->async->resolve(self->closePromise, self->closeInfo());
+			self->handlers.clear();
+			self->self = Value{std::monostate{}};
+		});
+	}
+};
+
+void WsConnection::run(std::string inbuf) {
+#ifdef _WIN32
+	(void)inbuf;
+	state = kClosed;
+	postFinished(1006, "", "WebSocket is not supported on Windows yet");
+#else
+	stream->setNonBlocking(true);
+	setNoDelay(stream->fd());
+
+	std::string out;           // 待写出的已编码字节
+	size_t outOff = 0;
+	std::vector<std::pair<std::shared_ptr<PromiseState>, size_t>> flushing; // out 写完后 resolve
+	bool haveCurrent = false;  // 正在分片发送的消息
+	WsOutgoing current{0, "", nullptr};
+	std::string currentWire;   // 压缩后的负载
+	size_t currentOff = 0;
+	bool currentCompressed = false;
+
+	bool sentClose = false, gotClose = false, failing = false;
+	int peerCode = 1005;
+	std::string peerReason, errorText;
+	bool abnormal = false;
+	std::chrono::steady_clock::time_point closeDeadline;
+
+	// 入站分片重组
+	bool fragmenting = false;
+	int messageOpcode = 0;
+	bool messageCompressed = false;
+	std::string message;
+
+	auto fail = [&](int code, const std::string& reason) {
+		// 协议错误：发出 close 帧后不再处理入站数据，写完即断开
+		failing = true;
+		gotClose = true;
+		peerCode = code;
+		peerReason = reason;
+		std::lock_guard<std::mutex> lk(mtx);
+		if (!sentClose) {
+			std::string frame;
+			std::string payload = closePayload(code, reason);
+			appendFrame(frame, 0x8, payload.data(), payload.size(), true, false);
+			controlQueue.push_back(std::move(frame));
+			sentClose = true;
+		}
+	};
+
+	auto handleFrame = [&](bool fin, bool rsv1, int opcode, const char* payload, size_t len) {
+		if (opcode >= 0x8) {
+			if (!fin || len > 125 || rsv1) { fail(1002, "invalid control frame"); return; }
+			if (opcode == 0x8) {
+				if (len == 1) { fail(1002, "invalid close payload"); return; }
+				gotClose = true;
+				int code = 1005;
+				std::string reason;
+				if (len >= 2) {
+					code = (static_cast<unsigned char>(payload[0]) << 8) | static_cast<unsigned char>(payload[1]);
+					reason.assign(payload + 2, len - 2);
+				}
+				peerCode = code;
+				peerReason = reason;
+				std::lock_guard<std::mutex> lk(mtx);
+				if (!sentClose) {
+					// 回应 close：回显状态码
+					std::string frame;
+					std::string echo = len >= 2 ? closePayload(code, "") : std::string();
+					appendFrame(frame, 0x8, echo.data(), echo.size(), true, false);
+					controlQueue.push_back(std::move(frame));
+					sentClose = true;
+				}
+				state = kClosing;
+			} else if (opcode == 0x9) {
+				std::string frame;
+				appendFrame(frame, 0xA, payload, len, true, false);
+				std::lock_guard<std::mutex> lk(mtx);
+				controlQueue.push_back(std::move(frame));
+			} else if (opcode == 0xA) {
+				postPong(std::string(payload, len));
+			} else {
+				fail(1002, "unknown opcode");
+			}
+			return;
+		}
+		if (gotClose) return; // close 之后的数据帧忽略
+		if (opcode == 0x1 || opcode == 0x2) {
+			if (fragmenting) { fail(1002, "expected continuation frame"); return; }
+			if (rsv1 && !useDeflate) { fail(1002, "compressed frame without permessage-deflate"); return; }
+			fragmenting = true;
+			messageOpcode = opcode;
+			messageCompressed = rsv1;
+			message.assign(payload, len);
+		} else if (opcode == 0x0) {
+			if (!fragmenting) { fail(1002, "unexpected continuation frame"); return; }
+			if (rsv1) { fail(1002, "RSV1 set on continuation frame"); return; }
+			message.append(payload, len);
+		} else {
+			fail(1002, "unknown opcode");
+			return;
+		}
+		if (message.size() > maxMessageSize) { fail(1009, "message too big"); return; }
+		if (!fin) return;
+		fragmenting = false;
+		if (messageCompressed) {
+#ifdef ASUL_HAS_ZLIB
+			std::string plain;
+			if (!zlib.decompress(std::move(message), plain, maxMessageSize)) { fail(1009, "invalid or oversized compressed message"); return; }
+			message = std::move(plain);
+#endif
+		}
+		if (messageOpcode == 0x1 && !validUtf8(message)) { fail(1007, "invalid UTF-8 in text message"); return; }
+		postMessage(std::move(message), messageOpcode == 0x2);
+		message.clear();
+	};
+
+	// 解析缓冲区中所有完整的帧
+	auto parseFrames = [&]() {
+		size_t pos = 0;
+		while (!failing) {
+			size_t avail = inbuf.size() - pos;
+			if (avail < 2) break;
+			const unsigned char* h = reinterpret_cast<const unsigned char*>(inbuf.data() + pos);
+			bool fin = (h[0] & 0x80) != 0;
+			bool rsv1 = (h[0] & 0x40) != 0;
+			if (h[0] & 0x30) { fail(1002, "reserved bits set"); break; }
+			int opcode = h[0] & 0x0f;
+			bool masked = (h[1] & 0x80) != 0;
+			uint64_t len = h[1] & 0x7f;
+			size_t hdr = 2;
+			if (len == 126) {
+				if (avail < 4) break;
+				len = (uint64_t(h[2]) << 8) | h[3];
+				hdr = 4;
+			} else if (len == 127) {
+				if (avail < 10) break;
+				len = 0;
+				for (int i = 0; i < 8; ++i) len = (len << 8) | h[2 + i];
+				hdr = 10;
+			}
+			if (masked == isClient) { fail(1002, isClient ? "server frames must not be masked" : "client frames must be masked"); break; }
+			if (len > maxMessageSize) { fail(1009, "message too big"); break; }
+			size_t maskAt = hdr;
+			if (masked) hdr += 4;
+			if (avail < hdr + len) break;
+			char* payload = &inbuf[pos + hdr];
+			if (masked) wsMask(reinterpret_cast<unsigned char*>(payload), static_cast<size_t>(len), h + maskAt);
+			handleFrame(fin, rsv1, opcode, payload, static_cast<size_t>(len));
+			pos += hdr + static_cast<size_t>(len);
+		}
+		inbuf.erase(0, pos);
+	};
+
+	// 取下一批要写出的字节：控制帧优先，其次是当前消息的下一个分片，最后是本端的 close 帧
+	auto refill = [&]() {
+		std::lock_guard<std::mutex> lk(mtx);
+		while (!controlQueue.empty()) { out += controlQueue.front(); controlQueue.pop_front(); }
+		if (sentClose && gotClose) return;
+		if (!haveCurrent && !dataQueue.empty() && !sentClose) {
+			current = std::move(dataQueue.front());
+			dataQueue.pop_front();
+			haveCurrent = true;
+			currentOff = 0;
+			currentCompressed = false;
+#ifdef ASUL_HAS_ZLIB
+			if (useDeflate && current.payload.size() >= kDeflateThreshold) {
+				std::string packed;
+				if (zlib.compress(current.payload, packed) && packed.size() < current.payload.size()) {
+					currentWire = std::move(packed);
+					currentCompressed = true;
+				}
+			}
+#endif
+			if (!currentCompressed) currentWire = current.payload;
+		}
+		if (haveCurrent) {
+			size_t n = std::min(kFragmentSize, currentWire.size() - currentOff);
+			bool first = currentOff == 0;
+			bool fin = currentOff + n == currentWire.size();
+			appendFrame(out, first ? current.opcode : 0x0, currentWire.data() + currentOff, n, fin, first && currentCompressed);
+			currentOff += n;
+			if (fin) {
+				flushing.emplace_back(current.promise, current.payload.size());
+				haveCurrent = false;
+				currentWire.clear();
+			}
+			return;
+		}
+		if (closeRequested && !sentClose) {
+			std::string payload = closePayload(localCode, localReason);
+			appendFrame(out, 0x8, payload.data(), payload.size(), true, false);
+			sentClose = true;
+			closeDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kCloseTimeoutMs);
+		}
+	};
+
+	char buf[65536];
+	bool peerEof = false;
+	if (!inbuf.empty()) parseFrames();
+	for (;;) {
+		if (outOff == out.size()) {
+			out.clear();
+			outOff = 0;
+			for (auto& f : flushing) {
+				buffered -= f.second;
+				async->resolve(f.first, Value{static_cast<double>(f.second)});
+			}
+			flushing.clear();
+			refill();
+		}
+		bool idle = outOff == out.size();
+		if (idle && sentClose && (gotClose || failing)) break; // 关闭握手完成
+		if (peerEof) { if (!gotClose) abnormal = true; break; }
+		if (sentClose && !gotClose && std::chrono::steady_clock::now() >= closeDeadline) { abnormal = true; break; }
+
+		struct pollfd fds[2];
+		fds[0].fd = stream->fd();
+		fds[0].events = static_cast<short>(POLLIN | (idle ? 0 : POLLOUT));
+		fds[0].revents = 0;
+		fds[1].fd = wakeRead;
+		fds[1].events = POLLIN;
+		fds[1].revents = 0;
+		int timeout = sentClose && !gotClose ? 100 : 1000;
+		int pr = ::poll(fds, wakeRead >= 0 ? 2 : 1, timeout);
+		if (pr < 0) {
+			if (errno == EINTR) continue;
+			errorText = "poll failed";
+			abnormal = true;
+			break;
+		}
+		if (wakeRead >= 0 && (fds[1].revents & POLLIN)) {
+			char drain[64];
+			while (::read(wakeRead, drain, sizeof(drain)) > 0) {}
+		}
+		if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+			for (;;) {
+				long n = stream->receive(buf, sizeof(buf));
+				if (n > 0) { if (!failing) inbuf.append(buf, static_cast<size_t>(n)); continue; }
+				if (n == NetStream::kWouldBlock) break;
+				if (n < 0) errorText = stream->lastError();
+				peerEof = true;
+				break;
+			}
+			if (!failing) parseFrames();
+		}
+		if (outOff < out.size()) {
+			while (outOff < out.size()) {
+				long n = stream->sendSome(out.data() + outOff, out.size() - outOff);
+				if (n > 0) { outOff += static_cast<size_t>(n); continue; }
+				if (n == NetStream::kWouldBlock) break;
+				errorText = stream->lastError();
+				peerEof = true;
+				break;
+			}
+		}
+	}
+
+	state = kClosed;
+	stream->disconnect();
+	// 未发出的消息以错误结束
+	std::vector<std::shared_ptr<PromiseState>> dropped;
+	{
+		std::lock_guard<std::mutex> lk(mtx);
+		for (auto& o : dataQueue) dropped.push_back(o.promise);
+		dataQueue.clear();
+		controlQueue.clear();
+	}
+	if (haveCurrent) dropped.push_back(current.promise);
+	for (auto& f : flushing) dropped.push_back(f.first);
+	buffered = 0;
+	for (auto& p : dropped) async->reject(p, Value{std::string("WebSocket closed before the message was sent")});
+
+	int code = abnormal ? 1006 : peerCode;
+	std::string reason = abnormal ? std::string() : peerReason;
+	if (abnormal && errorText.empty() && sentClose && !gotClose) errorText = "close handshake timed out";
+	postFinished(code, reason, abnormal ? errorText : std::string());
+#endif
+}
+
+// ---- 脚本对象 ----
+static std::shared_ptr<WsConnection> thisConnection(const std::shared_ptr<Environment>& closure, const char* method) {
+	Value thisVal = closure->get("this");
+	auto inst = std::get_if<std::shared_ptr<Instance>>(&thisVal);
+	auto ext = inst ? std::dynamic_pointer_cast<InstanceExt>(*inst) : nullptr;
+	if (!ext || !ext->nativeHandle) throw std::runtime_error(std::string("WebSocket.") + method + ": not a connected WebSocket");
+	return *static_cast<std::shared_ptr<WsConnection>*>(ext->nativeHandle);
+}
+
+// 在事件循环线程上为连接创建脚本对象
+static Value makeInstance(const std::shared_ptr<ClassInfo>& klass, const std::shared_ptr<WsConnection>& conn,
+	const std::string& url, const std::string& protocol, const std::string& extensions) {
+	auto inst = std::make_shared<InstanceExt>();
+	inst->klass = klass;
+	inst->nativeHandle = new std::shared_ptr<WsConnection>(conn);
+	inst->nativeDestructor = [](void* p) { delete static_cast<std::shared_ptr<WsConnection>*>(p); };
+	inst->fields["url"] = Value{url};
+	inst->fields["protocol"] = Value{protocol};
+	inst->fields["extensions"] = Value{extensions};
+	Value v{std::shared_ptr<Instance>(inst)};
+	conn->self = v;
+	conn->url = url;
+	return v;
+}
+
+std::shared_ptr<ClassInfo> makeWebSocketClass(Interpreter* interp, AsulAsync* async) {
+	auto klass = std::make_shared<ClassInfo>();
+	klass->name = "WebSocket";
+	klass->isNative = true;
+	std::weak_ptr<ClassInfo> weakClass = klass;
+
+	auto method = [&](const std::string& name, std::function<Value(const std::vector<Value>&, std::shared_ptr<Environment>)> body) {
+		auto fn = std::make_shared<Function>();
+		fn->isBuiltin = true;
+		fn->builtin = std::move(body);
+		klass->methods[name] = fn;
+	};
+
+	auto ctor = std::make_shared<Function>();
+	ctor->isBuiltin = true;
+	ctor->builtin = [](const std::vector<Value>&, std::shared_ptr<Environment>) -> Value {
+		throw std::runtime_error("WebSocket cannot be constructed directly; use net.WebSocket.connect(url) or http.Server.onWebSocket");
+	};
+	klass->methods["constructor"] = ctor;
+
+	// send(data) -> Promise<number>，数据写入 socket 后 resolve；await 它即可按对端速度发送
+	method("send", [](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+		if (args.empty()) throw std::runtime_error("WebSocket.send expects data");
+		auto conn = thisConnection(closure, "send");
+		std::string data = toString(args[0]);
+		if (!validUtf8(data)) throw std::runtime_error("WebSocket.send: text messages must be valid UTF-8 (use sendBinary)");
+		return Value{conn->send(std::move(data), 0x1)};
+	});
+	method("sendBinary", [](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+		if (args.empty()) throw std::runtime_error("WebSocket.sendBinary expects data");
+		return Value{thisConnection(closure, "sendBinary")->send(toString(args[0]), 0x2)};
+	});
+	// receive() -> Promise<string|null>，连接关闭且没有剩余消息时为 null
+	method("receive", [](const std::vector<Value>&, std::shared_ptr<Environment> closure) -> Value {
+		return Value{thisConnection(closure, "receive")->receive()};
+	});
+	method("ping", [](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+		thisConnection(closure, "ping")->ping(args.empty() ? std::string() : toString(args[0]));
+		return Value{std::monostate{}};
+	});
+	// close([code = 1000[, reason]]) -> Promise<{code, reason}>
+	method("close", [](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+		int code = args.size() >= 1 ? static_cast<int>(getNumber(args[0], "code")) : 1000;
+		std::string reason = args.size() >= 2 ? toString(args[1]) : std::string();
+		if (code != 1000 && (code < 3000 || code > 4999)) throw std::runtime_error("WebSocket.close: code must be 1000 or in 3000..4999");
+		if (reason.size() > 123) throw std::runtime_error("WebSocket.close: reason must be at most 123 bytes");
+		return Value{thisConnection(closure, "close")->close(code, reason)};
+	});
+	// on(event, fn)：message(data, isBinary) / close(code, reason) / pong(data) / error(message)
+	method("on", [](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+		if (args.size() < 2 || !std::holds_alternative<std::shared_ptr<Function>>(args[1]))
+			throw std::runtime_error("WebSocket.on expects (event, function)");
+		thisConnection(closure, "on")->on(toString(args[0]), args[1]);
+		return Value{std::monostate{}};
+	});
+	method("bufferedAmount", [](const std::vector<Value>&, std::shared_ptr<Environment> closure) -> Value {
+		return Value{static_cast<double>(thisConnection(closure, "bufferedAmount")->bufferedAmount())};
+	});
+	method("readyState", [](const std::vector<Value>&, std::shared_ptr<Environment> closure) -> Value {
+		static const char* names[] = {"open", "closing", "closed"};
+		return Value{std::string(names[thisConnection(closure, "readyState")->readyState()])};
+	});
+
+	// WebSocket.connect(url[, {protocols, headers, deflate, maxMessageSize, tls}]) -> Promise<WebSocket>
+	auto connectFn = std::make_shared<Function>();
+	connectFn->isBuiltin = true;
+	connectFn->builtin = [interp, async, weakClass](const std::vector<Value>& args, std::shared_ptr<Environment>) -> Value {
+		if (args.empty()) throw std::runtime_error("WebSocket.connect expects a url");
+		std::string url = toString(args[0]);
+		Value optVal = args.size() >= 2 ? args[1] : Value{std::monostate{}};
+		WsOptions opts = wsOptionsFromValue(optVal, "WebSocket.connect");
+		TlsOptions tlsOpts;
+		std::vector<std::pair<std::string, std::string>> extraHeaders;
+		if (auto po = std::get_if<std::shared_ptr<Object>>(&optVal)) {
+			auto itT = (*po)->find("tls");
+			if (itT != (*po)->end()) tlsOpts = tlsOptionsFromValue(itT->second, "WebSocket.connect");
+			auto itH = (*po)->find("headers");
+			if (itH != (*po)->end()) {
+				auto ho = std::get_if<std::shared_ptr<Object>>(&itH->second);
+				if (!ho || !*ho) throw std::runtime_error("WebSocket.connect: headers must be an object");
+				for (auto& kv : **ho) extraHeaders.emplace_back(kv.first, toString(kv.second));
+			}
+		}
+		size_t schemeEnd = url.find("://");
+		std::string scheme = schemeEnd == std::string::npos ? "" : lower(url.substr(0, schemeEnd));
+		if (scheme != "ws" && scheme != "wss") throw std::runtime_error("WebSocket.connect: url must start with ws:// or wss://");
+		bool secure = scheme == "wss";
+		size_t hostStart = schemeEnd + 3;
+		size_t pathStart = url.find_first_of("/?", hostStart);
+		std::string hostPort = url.substr(hostStart, pathStart == std::string::npos ? std::string::npos : pathStart - hostStart);
+		std::string path = pathStart == std::string::npos ? "/" : url.substr(pathStart);
+		if (!path.empty() && path[0] == '?') path = "/" + path;
+		std::string host = hostPort;
+		int defaultPort = secure ? 443 : 80;
+		int port = defaultPort;
+		size_t colon = hostPort.rfind(':');
+		size_t bracket = hostPort.find(']');
+		// [v6]:port 或 host:port；不带方括号的 IPv6 地址没有端口
+		if (colon != std::string::npos && (bracket == std::string::npos ? hostPort.find(':') == colon : colon > bracket)) {
+			host = hostPort.substr(0, colon);
+			try { port = std::stoi(hostPort.substr(colon + 1)); } catch (...) { throw std::runtime_error("WebSocket.connect: invalid port in " + url); }
+		}
+		if (host.size() >= 2 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.size() - 2);
+		if (host.empty()) throw std::runtime_error("WebSocket.connect: missing host in " + url);
+
+		auto p = async->createPromise();
+		auto worker = [=]() {
+#ifdef _WIN32
+			async->reject(p, Value{std::string("WebSocket is not supported on Windows yet")});
+#else
+			try {
+				std::string connectError;
+				int fd = connectTcp(host, port, connectError);
+				if (fd < 0) { async->reject(p, Value{connectError}); return; }
+				std::shared_ptr<NetStream> stream = secure
+					? NetStream::connectTls(clientTlsContext(tlsOpts), fd, tlsOpts.servername.empty() ? host : tlsOpts.servername, port)
+					: std::make_shared<NetStream>(fd);
+
+				std::mt19937 keyRng(std::random_device{}());
+				std::string nonce;
+				for (int i = 0; i < 16; ++i) nonce.push_back(static_cast<char>(keyRng() & 0xff));
+				std::string key = base64(nonce);
+				std::ostringstream req;
+				req << "GET " << path << " HTTP/1.1\r\n";
+				req << "Host: " << (hostPort.empty() ? host : hostPort) << "\r\n";
+				req << "Upgrade: websocket\r\nConnection: Upgrade\r\n";
+				req << "Sec-WebSocket-Key: " << key << "\r\nSec-WebSocket-Version: 13\r\n";
+				if (!opts.protocols.empty()) {
+					req << "Sec-WebSocket-Protocol: ";
+					for (size_t i = 0; i < opts.protocols.size(); ++i) req << (i ? ", " : "") << opts.protocols[i];
+					req << "\r\n";
+				}
+#ifdef ASUL_HAS_ZLIB
+				if (opts.deflate) req << "Sec-WebSocket-Extensions: permessage-deflate; client_no_context_takeover\r\n";
+#endif
+				req << "User-Agent: ALang/1.0\r\n";
+				for (auto& h : extraHeaders) req << h.first << ": " << h.second << "\r\n";
+				req << "\r\n";
+				if (!stream->writeAll(req.str())) { async->reject(p, Value{std::string("WebSocket handshake write failed: ") + stream->lastError()}); return; }
+
+				std::string response;
+				char buf[4096];
+				size_t headerEnd;
+				while ((headerEnd = response.find("\r\n\r\n")) == std::string::npos) {
+					if (response.size() > 65536) { async->reject(p, Value{std::string("WebSocket handshake: response headers too large")}); return; }
+					long n = stream->receive(buf, sizeof(buf));
+					if (n <= 0) { async->reject(p, Value{std::string("WebSocket handshake: connection closed")}); return; }
+					response.append(buf, static_cast<size_t>(n));
+				}
+				std::string headers = response.substr(0, headerEnd);
+				std::string leftover = response.substr(headerEnd + 4);
+				std::string statusLine = headers.substr(0, headers.find("\r\n"));
+				if (statusLine.find(" 101") == std::string::npos) {
+					async->reject(p, Value{std::string("WebSocket handshake failed: ") + statusLine});
+					return;
+				}
+				if (headerValue(headers, "Sec-WebSocket-Accept") != acceptKey(key) || !hasToken(headerValue(headers, "Upgrade"), "websocket")) {
+					async->reject(p, Value{std::string("WebSocket handshake failed: invalid Sec-WebSocket-Accept")});
+					return;
+				}
+				std::string protocol = headerValue(headers, "Sec-WebSocket-Protocol");
+				if (!protocol.empty() && std::find(opts.protocols.begin(), opts.protocols.end(), protocol) == opts.protocols.end()) {
+					async->reject(p, Value{std::string("WebSocket handshake failed: server selected unrequested protocol ") + protocol});
+					return;
+				}
+				std::string extensions = headerValue(headers, "Sec-WebSocket-Extensions");
+				bool deflate = false;
+#ifdef ASUL_HAS_ZLIB
+				deflate = opts.deflate && offersDeflate(extensions);
+#endif
+				if (!deflate && !extensions.empty()) {
+					async->reject(p, Value{std::string("WebSocket handshake failed: unsupported extensions ") + extensions});
+					return;
+				}
+				auto conn = std::make_shared<WsConnection>(stream, true, deflate, opts.maxMessageSize, interp, async);
+				async->postTask([weakClass, conn, url, protocol, extensions, async, p] {
+					auto klass = weakClass.lock();
+					if (!klass) return;
+					async->resolve(p, makeInstance(klass, conn, url, protocol, extensions));
+				});
+				conn->run(std::move(leftover));
+			} catch (const std::exception& ex) {
+				async->reject(p, Value{std::string(ex.what())});
+			}
+#endif
+		};
+		std::thread(std::move(worker)).detach();
+		return Value{p};
+	};
+	klass->staticMethods["connect"] = connectFn;
+	return klass;
+}
+
+void serveWebSocket(std::shared_ptr<NetStream> conn, const std::string& headers, const std::string& leftover,
+	const WsOptions& opts, const std::shared_ptr<ClassInfo>& wsClass, const Value& handler, const Value& request,
+	Interpreter* interp, AsulAsync* async) {
+	std::string key = headerValue(headers, "Sec-WebSocket-Key");
+	if (key.empty() || headerValue(headers, "Sec-WebSocket-Version") != "13") {
+		conn->writeAll(std::string("HTTP/1.1 426 Upgrade Required\r\nSec-WebSocket-Version: 13\r\nContent-Length: 0\r\nConnection: close\r\n\r\n"));
+		conn->disconnect();
+		return;
+	}
+	// 子协议：按客户端给出的顺序选第一个服务器支持的
+	std::string protocol;
+	for (auto& p : splitTokens(headerValue(headers, "Sec-WebSocket-Protocol"), ',')) {
+		if (std::find(opts.protocols.begin(), opts.protocols.end(), p) != opts.protocols.end()) { protocol = p; break; }
+	}
+	bool deflate = false;
+#ifdef ASUL_HAS_ZLIB
+	deflate = opts.deflate && offersDeflate(headerValue(headers, "Sec-WebSocket-Extensions"));
+#endif
+	std::string extensions = deflate ? "permessage-deflate; server_no_context_takeover" : "";
+	std::ostringstream resp;
+	resp << "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n";
+	resp << "Sec-WebSocket-Accept: " << acceptKey(key) << "\r\n";
+	if (!protocol.empty()) resp << "Sec-WebSocket-Protocol: " << protocol << "\r\n";
+	if (deflate) resp << "Sec-WebSocket-Extensions: " << extensions << "\r\n";
+	resp << "\r\n";
+	if (!conn->writeAll(resp.str())) { conn->disconnect(); return; }
+
+	std::string url;
+	if (auto ro = std::get_if<std::shared_ptr<Object>>(&request)) {
+		auto it = (*ro)->find("url");
+		if (it != (*ro)->end()) url = toString(it->second);
+	}
+	auto ws = std::make_shared<WsConnection>(conn, false, deflate, opts.maxMessageSize, interp, async);
+	async->postTask([wsClass, ws, url, protocol, extensions, handler, request, interp] {
+		Value inst = makeInstance(wsClass, ws, url, protocol, extensions);
+		try {
+			interp->callValue(handler, {inst, request});
+		} catch (const ExceptionSignal& ex) {
+			std::cerr << "WebSocket handler error: " << describeError(ex.value) << std::endl;
+		} catch (const std::exception& ex) {
+			std::cerr << "WebSocket handler error: " << ex.what() << std::endl;
+		}
+	});
+	ws->run(leftover);
+}
+
+} // namespace asul
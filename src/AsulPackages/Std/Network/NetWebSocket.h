@@ -0,0 +1,44 @@
+#ifndef ASUL_NET_WEBSOCKET_H
+#define ASUL_NET_WEBSOCKET_H
+
+#include "../../../AsulRuntime.h"
+#include "NetTls.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace asul {
+
+class Interpreter;
+class AsulAsync;
+
+// ----------- WebSocket (RFC 6455) for std.network -----------
+// 每个连接一个 I/O 线程：非阻塞 socket + poll，负责分帧、掩码、分片重组、ping/pong 与 permessage-deflate；
+// 完整的消息和事件通过 postTask 交给事件循环，脚本侧的状态只在事件循环线程上访问。
+
+struct WsOptions {
+	std::vector<std::string> protocols;    // 客户端：请求的子协议；服务器：支持的子协议
+	bool deflate{true};                    // 协商 permessage-deflate (需要 zlib)
+	size_t maxMessageSize{16 * 1024 * 1024};
+};
+
+// {protocols, deflate, maxMessageSize}
+WsOptions wsOptionsFromValue(const Value& v, const std::string& what);
+
+// 用 SIMD (SSE2) / 64 位字异或掩码或解掩码；offset 为 data[0] 在整个负载中的位置
+void wsMask(unsigned char* data, size_t len, const unsigned char key[4], size_t offset = 0);
+
+// net.WebSocket：静态 connect(url[, options]) -> Promise<WebSocket>
+std::shared_ptr<ClassInfo> makeWebSocketClass(Interpreter* interp, AsulAsync* async);
+
+// http.Server 用：请求头是否为 WebSocket 升级请求
+bool isWebSocketUpgrade(const std::string& headers);
+// 在 http.Server 的连接线程上完成握手，把连接交给 handler(ws, req)，然后在当前线程运行 I/O 直到连接关闭
+void serveWebSocket(std::shared_ptr<NetStream> conn, const std::string& headers, const std::string& leftover,
+	const WsOptions& opts, const std::shared_ptr<ClassInfo>& wsClass, const Value& handler, const Value& request,
+	Interpreter* interp, AsulAsync* async);
+
+} // namespace asul
+
+#endif // ASUL_NET_WEBSOCKET_H
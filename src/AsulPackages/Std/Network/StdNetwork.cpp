@@ -1,6 +1,10 @@
 #include "StdNetwork.h"
 #include "../../../AsulInterpreter.h"
 #include "../../../AsulAsync.h"
+#include "NetTls.h"
+#include "NetWebSocket.h"
+#include "NetFetchBody.h"
+#include "NetDns.h"
 #include <cstring>
 
 #ifdef _WIN32
@@ -40,7 +44,11 @@
     #include <arpa/inet.h>
     #include <unistd.h>
     #include <netdb.h>
+    #include <sys/un.h>
+    #include <sys/uio.h>
 #endif
+#include <algorithm>
+#include <cstddef>
 #include <thread>
 #include <sstream>
 #include <iostream>
@@ -87,6 +95,232 @@ static std::string getHttpStatusText(int statusCode) {
 	}
 }
 
+// ---- Socket helpers ----
+// Socket 实例的 nativeHandle 是 int* (fd)；关闭后为 nullptr
+static int thisSocketFd(const std::shared_ptr<Environment>& closure) {
+	Value thisVal = closure->get("this");
+	auto inst = std::get<std::shared_ptr<Instance>>(thisVal);
+	auto ext = std::dynamic_pointer_cast<InstanceExt>(inst);
+	if (!ext || !ext->nativeHandle) throw std::runtime_error("Socket not initialized");
+	return *static_cast<int*>(ext->nativeHandle);
+}
+
+static int socketFamily(int fd) {
+	struct sockaddr_storage ss;
+	socklen_t len = sizeof(ss);
+	std::memset(&ss, 0, sizeof(ss));
+	if (getsockname(fd, (struct sockaddr*)&ss, &len) < 0) return AF_INET;
+	return ss.ss_family;
+}
+
+static std::string socketError(const std::string& what) {
+	return what + ": " + std::strerror(errno);
+}
+
+// 按地址族把 args[idx..] 转换为 sockaddr：inet/inet6 为 (host, port)，unix 为 (path)。
+// Linux 上以 '@' 开头的路径表示抽象命名空间。
+static socklen_t buildSockAddr(int family, const std::vector<Value>& args, size_t idx, struct sockaddr_storage& out, const std::string& what) {
+	std::memset(&out, 0, sizeof(out));
+#ifndef _WIN32
+	if (family == AF_UNIX) {
+		if (args.size() <= idx) throw std::runtime_error(what + " expects a socket path");
+		std::string path = toString(args[idx]);
+		auto* un = reinterpret_cast<struct sockaddr_un*>(&out);
+		if (path.empty() || path.size() >= sizeof(un->sun_path)) {
+			throw std::runtime_error(what + ": unix socket path must be 1.." + std::to_string(sizeof(un->sun_path) - 1) + " bytes");
+		}
+		un->sun_family = AF_UNIX;
+		std::memcpy(un->sun_path, path.data(), path.size());
+#ifdef __linux__
+		if (path[0] == '@') {
+			un->sun_path[0] = '\0';
+			return static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.size());
+		}
+#endif
+		return static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.size() + 1);
+	}
+#endif
+	if (args.size() <= idx + 1) throw std::runtime_error(what + " expects host and port");
+	std::string host = toString(args[idx]);
+	double portNum = getNumber(args[idx + 1], "port");
+	if (!(portNum >= 0 && portNum <= 65535)) throw std::runtime_error(what + ": port must be 0..65535");
+	std::vector<DnsAddress> addrs;
+	try {
+		addrs = DnsCache::shared().resolve(host, family);
+	} catch (const std::exception& ex) {
+		throw std::runtime_error(what + ": " + ex.what());
+	}
+	socklen_t len = addrs.front().len;
+	std::memcpy(&out, &addrs.front().addr, len);
+	uint16_t port = htons(static_cast<uint16_t>(portNum));
+	if (out.ss_family == AF_INET6) reinterpret_cast<struct sockaddr_in6*>(&out)->sin6_port = port;
+	else reinterpret_cast<struct sockaddr_in*>(&out)->sin_port = port;
+	return len;
+}
+
+// sockaddr -> {family, host, port} 或 {family: "unix", path}
+static void describeAddress(Object& o, const struct sockaddr_storage& ss, socklen_t len) {
+	if (ss.ss_family == AF_INET) {
+		auto* in = reinterpret_cast<const struct sockaddr_in*>(&ss);
+		char buf[INET_ADDRSTRLEN] = {0};
+		inet_ntop(AF_INET, &in->sin_addr, buf, sizeof(buf));
+		o["family"] = Value{std::string("inet")};
+		o["host"] = Value{std::string(buf)};
+		o["port"] = Value{static_cast<double>(ntohs(in->sin_port))};
+	} else if (ss.ss_family == AF_INET6) {
+		auto* in6 = reinterpret_cast<const struct sockaddr_in6*>(&ss);
+		char buf[INET6_ADDRSTRLEN] = {0};
+		inet_ntop(AF_INET6, &in6->sin6_addr, buf, sizeof(buf));
+		o["family"] = Value{std::string("inet6")};
+		o["host"] = Value{std::string(buf)};
+		o["port"] = Value{static_cast<double>(ntohs(in6->sin6_port))};
+	}
+#ifndef _WIN32
+	else if (ss.ss_family == AF_UNIX) {
+		auto* un = reinterpret_cast<const struct sockaddr_un*>(&ss);
+		size_t off = offsetof(struct sockaddr_un, sun_path);
+		std::string path;
+		if (len > off) {
+			path.assign(un->sun_path, len - off);
+			if (!path.empty() && path[0] == '\0') path[0] = '@'; // 抽象命名空间
+			else path = path.c_str(); // 去掉结尾的 NUL
+		}
+		o["family"] = Value{std::string("unix")};
+		o["path"] = Value{path};
+	}
+#endif
+}
+
+#ifndef _WIN32
+// ---- Datagram batches ----
+// 一次收取/发送多个数据报：Linux 上使用 recvmmsg / sendmmsg，其他平台逐个 recvmsg / sendmsg。
+// 数据报内容以二进制安全的字符串交给脚本。
+struct DatagramBatch {
+	int family; // 接收方 socket 的地址族；对端未命名 (如 socketpair) 时用于描述地址
+	size_t slotSize;
+	std::vector<char> storage;
+	std::vector<struct sockaddr_storage> addrs;
+	std::vector<struct iovec> iovs;
+#ifdef __linux__
+	std::vector<struct mmsghdr> msgs;
+#else
+	std::vector<struct msghdr> msgs;
+	std::vector<size_t> lengths;
+#endif
+
+	DatagramBatch(int family, size_t count, size_t size)
+		: family(family), slotSize(size), storage(count * size), addrs(count), iovs(count), msgs(count)
+#ifndef __linux__
+		, lengths(count)
+#endif
+	{
+		for (size_t i = 0; i < count; ++i) {
+			iovs[i].iov_base = storage.data() + i * size;
+			iovs[i].iov_len = size;
+			std::memset(&msgs[i], 0, sizeof(msgs[i]));
+			header(i).msg_iov = &iovs[i];
+			header(i).msg_iovlen = 1;
+		}
+	}
+
+#ifdef __linux__
+	struct msghdr& header(size_t i) { return msgs[i].msg_hdr; }
+	size_t length(size_t i) const { return msgs[i].msg_len; }
+#else
+	struct msghdr& header(size_t i) { return msgs[i]; }
+	size_t length(size_t i) const { return lengths[i]; }
+#endif
+
+	// 返回收到的数据报个数，出错返回 -1 (errno 有效)。blocking 时至少等到一个数据报
+	int receive(int fd, bool blocking) {
+		for (size_t i = 0; i < msgs.size(); ++i) {
+			header(i).msg_name = &addrs[i];
+			header(i).msg_namelen = sizeof(addrs[i]);
+			header(i).msg_flags = 0;
+		}
+#ifdef __linux__
+		return recvmmsg(fd, msgs.data(), static_cast<unsigned int>(msgs.size()), blocking ? MSG_WAITFORONE : MSG_DONTWAIT, nullptr);
+#else
+		int got = 0;
+		for (size_t i = 0; i < msgs.size(); ++i) {
+			ssize_t n = recvmsg(fd, &msgs[i], (blocking && got == 0) ? 0 : MSG_DONTWAIT);
+			if (n < 0) {
+				if (got > 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+				return got > 0 ? got : -1;
+			}
+			lengths[i] = static_cast<size_t>(n);
+			++got;
+		}
+		return got;
+#endif
+	}
+
+	// 第 i 个数据报 -> {data, truncated, 以及发送方地址字段}
+	Value message(size_t i) {
+		auto o = std::make_shared<Object>();
+		size_t n = std::min(length(i), slotSize);
+		(*o)["data"] = Value{std::string(storage.data() + i * slotSize, n)};
+		(*o)["truncated"] = Value{(header(i).msg_flags & MSG_TRUNC) != 0};
+		if (header(i).msg_namelen == 0) {
+			std::memset(&addrs[i], 0, sizeof(addrs[i]));
+			addrs[i].ss_family = static_cast<sa_family_t>(family);
+		}
+		describeAddress(*o, addrs[i], header(i).msg_namelen);
+		return Value{o};
+	}
+
+	Value messages(int n) {
+		auto arr = std::make_shared<Array>();
+		arr->reserve(static_cast<size_t>(n));
+		for (int i = 0; i < n; ++i) arr->push_back(message(static_cast<size_t>(i)));
+		return Value{arr};
+	}
+};
+
+// 待发送的数据报；addrLen 为 0 表示使用 connect 过的默认地址
+struct OutgoingDatagram {
+	std::string data;
+	struct sockaddr_storage addr;
+	socklen_t addrLen{0};
+};
+
+// 从 from 开始尽量发送；返回成功发送后的下一个下标，出错时返回值 < 0 且 errno 有效
+static long sendDatagrams(int fd, std::vector<OutgoingDatagram>& out, size_t from, bool blocking) {
+	int flags = blocking ? 0 : MSG_DONTWAIT;
+#ifdef __linux__
+	constexpr size_t kChunk = 256;
+	std::vector<struct mmsghdr> msgs;
+	std::vector<struct iovec> iovs;
+	while (from < out.size()) {
+		size_t n = std::min(kChunk, out.size() - from);
+		msgs.assign(n, mmsghdr{});
+		iovs.resize(n);
+		for (size_t i = 0; i < n; ++i) {
+			auto& d = out[from + i];
+			iovs[i].iov_base = const_cast<char*>(d.data.data());
+			iovs[i].iov_len = d.data.size();
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			if (d.addrLen) { msgs[i].msg_hdr.msg_name = &d.addr; msgs[i].msg_hdr.msg_namelen = d.addrLen; }
+		}
+		int sent = sendmmsg(fd, msgs.data(), static_cast<unsigned int>(n), flags);
+		if (sent < 0) return (errno == EAGAIN || errno == EWOULDBLOCK) ? static_cast<long>(from) : -1;
+		from += static_cast<size_t>(sent);
+		if (static_cast<size_t>(sent) < n && !blocking) break;
+	}
+	return static_cast<long>(from);
+#else
+	for (; from < out.size(); ++from) {
+		auto& d = out[from];
+		ssize_t n = d.addrLen ? sendto(fd, d.data.data(), d.data.size(), flags, (struct sockaddr*)&d.addr, d.addrLen)
+		                      : send(fd, d.data.data(), d.data.size(), flags);
+		if (n < 0) return (errno == EAGAIN || errno == EWOULDBLOCK) ? static_cast<long>(from) : -1;
+	}
+	return static_cast<long>(from);
+#endif
+}
+#endif
+
 void registerStdNetworkPackage(Interpreter& interp) {
 	// Get pointer to async interface (Interpreter implements AsulAsync)
 	// The Interpreter outlives all packages and threads
@@ -102,6 +336,7 @@ void registerStdNetworkPackage(Interpreter& interp) {
 		(*netPkg)["Socket"] = Value{socketClass};
 
 		// constructor(domain, type)
+		// domain: "inet" | "inet6" | "unix"；type: "tcp" / "stream" | "udp" / "dgram"
 		auto ctor = std::make_shared<Function>();
 		ctor->isBuiltin = true;
 		ctor->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
@@ -110,10 +345,13 @@ void registerStdNetworkPackage(Interpreter& interp) {
 			if (args.size() >= 1) {
 				std::string d = toString(args[0]);
 				if (d == "inet6") domain = AF_INET6;
+#ifndef _WIN32
+				else if (d == "unix" || d == "local") domain = AF_UNIX;
+#endif
 			}
 			if (args.size() >= 2) {
 				std::string t = toString(args[1]);
-				if (t == "udp") type = SOCK_DGRAM;
+				if (t == "udp" || t == "dgram") type = SOCK_DGRAM;
 			}
 			
 			int fd = socket(domain, type, 0);
@@ -144,30 +382,15 @@ void registerStdNetworkPackage(Interpreter& interp) {
 		};
 		socketClass->methods["constructor"] = ctor;
 
-		// bind(host, port)
+		// bind(host, port) / bind(path) (unix)
 		auto bindFn = std::make_shared<Function>();
 		bindFn->isBuiltin = true;
 		bindFn->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
-			if (args.size() != 2) throw std::runtime_error("bind expects host and port");
-			std::string host = toString(args[0]);
-			int port = static_cast<int>(getNumber(args[1], "port"));
-			
-			Value thisVal = closure->get("this");
-			auto inst = std::get<std::shared_ptr<Instance>>(thisVal);
-			auto ext = std::dynamic_pointer_cast<InstanceExt>(inst);
-			if (!ext || !ext->nativeHandle) throw std::runtime_error("Socket not initialized");
-			int fd = *static_cast<int*>(ext->nativeHandle);
-
-			struct sockaddr_in addr;
-			std::memset(&addr, 0, sizeof(addr));
-			addr.sin_family = AF_INET;
-			addr.sin_port = htons(port);
-			if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) <= 0) {
-				throw std::runtime_error("Invalid address");
-			}
-			
-			if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-				throw std::runtime_error("bind failed");
+			int fd = thisSocketFd(closure);
+			struct sockaddr_storage addr;
+			socklen_t len = buildSockAddr(socketFamily(fd), args, 0, addr, "bind");
+			if (bind(fd, (struct sockaddr*)&addr, len) < 0) {
+				throw std::runtime_error(socketError("bind failed"));
 			}
 			return Value{true};
 		};
@@ -190,36 +413,31 @@ void registerStdNetworkPackage(Interpreter& interp) {
 		};
 		socketClass->methods["listen"] = listenFn;
 
-		// connect(host, port) -> Promise
+		// connect(host, port) / connect(path) (unix) -> Promise
 		auto connectFn = std::make_shared<Function>();
 		connectFn->isBuiltin = true;
 		connectFn->builtin = [asyncPtr](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
-			if (args.size() != 2) throw std::runtime_error("connect expects host and port");
-			std::string host = toString(args[0]);
-			int port = static_cast<int>(getNumber(args[1], "port"));
-			
-			Value thisVal = closure->get("this");
-			auto inst = std::get<std::shared_ptr<Instance>>(thisVal);
-			auto ext = std::dynamic_pointer_cast<InstanceExt>(inst);
-			int fd = *static_cast<int*>(ext->nativeHandle);
+			int fd = thisSocketFd(closure);
+			int family = socketFamily(fd);
+			if (args.size() != (family == AF_INET || family == AF_INET6 ? 2u : 1u)) {
+				throw std::runtime_error(family == AF_INET || family == AF_INET6 ? "connect expects host and port" : "connect expects a socket path");
+			}
+			std::vector<Value> target = args;
 
 			auto p = asyncPtr->createPromise();
 			
-			std::thread([p, asyncPtr, fd, host, port]{
+			std::thread([p, asyncPtr, fd, family, target]{
 				try {
-					struct sockaddr_in addr;
-					std::memset(&addr, 0, sizeof(addr));
-					addr.sin_family = AF_INET;
-					addr.sin_port = htons(port);
-					
-					struct hostent* server = gethostbyname(host.c_str());
-					if (server == NULL) {
-						asyncPtr->reject(p, Value{std::string("Host resolution failed")});
+					struct sockaddr_storage addr;
+					socklen_t len = 0;
+					try {
+						len = buildSockAddr(family, target, 0, addr, "connect");
+					} catch (const std::exception& ex) {
+						asyncPtr->reject(p, Value{std::string(ex.what())});
 						return;
 					}
-					std::memcpy(&addr.sin_addr.s_addr, server->h_addr, server->h_length);
 
-					if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+					if (connect(fd, (struct sockaddr*)&addr, len) < 0) {
 						asyncPtr->reject(p, Value{std::string("Connection failed")});
 					} else {
 						asyncPtr->resolve(p, Value{true});
@@ -248,7 +466,7 @@ void registerStdNetworkPackage(Interpreter& interp) {
 
 			std::thread([p, asyncPtr, fd, socketClass]{
 				try {
-					struct sockaddr_in cli_addr;
+					struct sockaddr_storage cli_addr;
 					socklen_t clilen = sizeof(cli_addr);
 					int newsockfd = accept(fd, (struct sockaddr*)&cli_addr, &clilen);
 					if (newsockfd < 0) {
@@ -355,6 +573,10 @@ void registerStdNetworkPackage(Interpreter& interp) {
 			auto ext = std::dynamic_pointer_cast<InstanceExt>(inst);
 			if (ext && ext->nativeHandle) {
 				int* fdp = static_cast<int*>(ext->nativeHandle);
+#ifndef _WIN32
+				// 唤醒仍阻塞在 read / recvBatch 等调用上的后台线程
+				shutdown(*fdp, SHUT_RDWR);
+#endif
 				close(*fdp);
 				delete fdp;
 				ext->nativeHandle = nullptr;
@@ -363,6 +585,293 @@ void registerStdNetworkPackage(Interpreter& interp) {
 		};
 		socketClass->methods["close"] = closeFn;
 
+#ifndef _WIN32
+		// ---- Unix 域 socket / 数据报 ----
+		auto wrapSocket = [socketClass](int fd) -> Value {
+			auto inst = std::make_shared<InstanceExt>();
+			inst->klass = socketClass;
+			inst->nativeHandle = new int(fd);
+			inst->nativeDestructor = [](void* p) {
+				int* fdp = static_cast<int*>(p);
+				close(*fdp);
+				delete fdp;
+			};
+			return Value{std::shared_ptr<Instance>(inst)};
+		};
+		auto sizeArg = [](const std::vector<Value>& args, size_t idx, double def, double max, const char* what) -> size_t {
+			if (args.size() <= idx || std::holds_alternative<std::monostate>(args[idx])) return static_cast<size_t>(def);
+			double n = getNumber(args[idx], what);
+			if (!(n >= 1 && n <= max)) throw std::runtime_error(std::string(what) + " must be 1.." + std::to_string(static_cast<long long>(max)));
+			return static_cast<size_t>(n);
+		};
+
+		// fileno() -> number
+		auto filenoFn = std::make_shared<Function>();
+		filenoFn->isBuiltin = true;
+		filenoFn->builtin = [](const std::vector<Value>&, std::shared_ptr<Environment> closure) -> Value {
+			return Value{static_cast<double>(thisSocketFd(closure))};
+		};
+		socketClass->methods["fileno"] = filenoFn;
+
+		// localAddress() -> {family, host, port} | {family: "unix", path}
+		auto localAddressFn = std::make_shared<Function>();
+		localAddressFn->isBuiltin = true;
+		localAddressFn->builtin = [](const std::vector<Value>&, std::shared_ptr<Environment> closure) -> Value {
+			int fd = thisSocketFd(closure);
+			struct sockaddr_storage ss;
+			socklen_t len = sizeof(ss);
+			std::memset(&ss, 0, sizeof(ss));
+			if (getsockname(fd, (struct sockaddr*)&ss, &len) < 0) throw std::runtime_error(socketError("getsockname failed"));
+			auto o = std::make_shared<Object>();
+			describeAddress(*o, ss, len);
+			return Value{o};
+		};
+		socketClass->methods["localAddress"] = localAddressFn;
+
+		// setOption(name, value): rcvbuf / sndbuf (字节数)，broadcast / reuseaddr / reuseport (bool)
+		auto setOptionFn = std::make_shared<Function>();
+		setOptionFn->isBuiltin = true;
+		setOptionFn->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+			if (args.size() != 2) throw std::runtime_error("setOption expects (name, value)");
+			int fd = thisSocketFd(closure);
+			std::string name = toString(args[0]);
+			int opt = 0;
+			int value = std::holds_alternative<bool>(args[1]) ? (std::get<bool>(args[1]) ? 1 : 0) : static_cast<int>(getNumber(args[1], "option value"));
+			if (name == "rcvbuf") opt = SO_RCVBUF;
+			else if (name == "sndbuf") opt = SO_SNDBUF;
+			else if (name == "broadcast") opt = SO_BROADCAST;
+			else if (name == "reuseaddr") opt = SO_REUSEADDR;
+#ifdef SO_REUSEPORT
+			else if (name == "reuseport") opt = SO_REUSEPORT;
+#endif
+			else throw std::runtime_error("setOption: unknown option '" + name + "'");
+			if (setsockopt(fd, SOL_SOCKET, opt, &value, sizeof(value)) < 0) throw std::runtime_error(socketError("setOption " + name + " failed"));
+			return Value{true};
+		};
+		socketClass->methods["setOption"] = setOptionFn;
+
+		// 数据报列表 -> OutgoingDatagram：字符串 (发往 connect 的地址) 或 {data, host, port} / {data, path}
+		auto toDatagram = [](int family, const Value& v, const std::string& what) -> OutgoingDatagram {
+			OutgoingDatagram d;
+			if (auto s = std::get_if<std::string>(&v)) { d.data = *s; return d; }
+			auto po = std::get_if<std::shared_ptr<Object>>(&v);
+			if (!po || !*po) throw std::runtime_error(what + " expects strings or {data, host, port} / {data, path} objects");
+			auto field = [&](const char* key) -> Value { auto it = (*po)->find(key); return it == (*po)->end() ? Value{std::monostate{}} : it->second; };
+			d.data = toString(field("data"));
+			Value host = field("host"), path = field("path");
+			if (!std::holds_alternative<std::monostate>(path)) d.addrLen = buildSockAddr(family, {path}, 0, d.addr, what);
+			else if (!std::holds_alternative<std::monostate>(host)) d.addrLen = buildSockAddr(family, {host, field("port")}, 0, d.addr, what);
+			return d;
+		};
+		// 先以非阻塞方式尝试发送；内核缓冲区满时剩余部分在后台线程里阻塞发送
+		auto sendDatagramsAsync = [asyncPtr](int fd, std::shared_ptr<std::vector<OutgoingDatagram>> out, Value result, const std::string& what) -> Value {
+			auto p = asyncPtr->createPromise();
+			long next = sendDatagrams(fd, *out, 0, false);
+			if (next < 0) {
+				asyncPtr->reject(p, Value{socketError(what + " failed")});
+			} else if (static_cast<size_t>(next) == out->size()) {
+				asyncPtr->resolve(p, result);
+			} else {
+				std::thread([p, asyncPtr, fd, out, next, result, what]{
+					long done = sendDatagrams(fd, *out, static_cast<size_t>(next), true);
+					if (done < 0) asyncPtr->reject(p, Value{socketError(what + " failed")});
+					else asyncPtr->resolve(p, result);
+				}).detach();
+			}
+			return Value{p};
+		};
+
+		// sendTo(data, host, port) / sendTo(data, path) -> Promise<number> (发送的字节数)
+		auto sendToFn = std::make_shared<Function>();
+		sendToFn->isBuiltin = true;
+		sendToFn->builtin = [sendDatagramsAsync](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+			if (args.size() < 2) throw std::runtime_error("sendTo expects (data, host, port) or (data, path)");
+			int fd = thisSocketFd(closure);
+			auto out = std::make_shared<std::vector<OutgoingDatagram>>(1);
+			(*out)[0].data = toString(args[0]);
+			(*out)[0].addrLen = buildSockAddr(socketFamily(fd), args, 1, (*out)[0].addr, "sendTo");
+			return sendDatagramsAsync(fd, out, Value{static_cast<double>((*out)[0].data.size())}, "sendTo");
+		};
+		socketClass->methods["sendTo"] = sendToFn;
+
+		// sendBatch(messages) -> Promise<number> (发送的数据报个数)；Linux 上每次 sendmmsg 最多提交 256 个
+		auto sendBatchFn = std::make_shared<Function>();
+		sendBatchFn->isBuiltin = true;
+		sendBatchFn->builtin = [sendDatagramsAsync, toDatagram](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+			if (args.size() != 1 || !std::holds_alternative<std::shared_ptr<Array>>(args[0])) throw std::runtime_error("sendBatch expects an array of messages");
+			int fd = thisSocketFd(closure);
+			int family = socketFamily(fd);
+			auto& msgs = *std::get<std::shared_ptr<Array>>(args[0]);
+			auto out = std::make_shared<std::vector<OutgoingDatagram>>();
+			out->reserve(msgs.size());
+			for (auto& m : msgs) out->push_back(toDatagram(family, m, "sendBatch"));
+			return sendDatagramsAsync(fd, out, Value{static_cast<double>(out->size())}, "sendBatch");
+		};
+		socketClass->methods["sendBatch"] = sendBatchFn;
+
+		// 已有数据报时直接在当前线程取走 (不阻塞)；否则由后台线程等待至少一个数据报
+		auto receiveAsync = [asyncPtr](int fd, size_t count, size_t size, bool single, const std::string& what) -> Value {
+			auto p = asyncPtr->createPromise();
+			auto batch = std::make_shared<DatagramBatch>(socketFamily(fd), count, size);
+			auto settle = [asyncPtr, p, batch, single, what](int n) {
+				if (n < 0) asyncPtr->reject(p, Value{socketError(what + " failed")});
+				else if (single) asyncPtr->resolve(p, n > 0 ? batch->message(0) : Value{std::monostate{}});
+				else asyncPtr->resolve(p, batch->messages(n));
+			};
+			int n = batch->receive(fd, false);
+			if (n > 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+				settle(n);
+			} else {
+				std::thread([fd, batch, settle]{ settle(batch->receive(fd, true)); }).detach();
+			}
+			return Value{p};
+		};
+
+		// recvFrom([maxSize = 65536]) -> Promise<{data, truncated, host, port} | {data, truncated, path}>
+		auto recvFromFn = std::make_shared<Function>();
+		recvFromFn->isBuiltin = true;
+		recvFromFn->builtin = [receiveAsync, sizeArg](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+			int fd = thisSocketFd(closure);
+			return receiveAsync(fd, 1, sizeArg(args, 0, 65536, 16 * 1024 * 1024, "recvFrom maxSize"), true, "recvFrom");
+		};
+		socketClass->methods["recvFrom"] = recvFromFn;
+
+		// recvBatch([maxMessages = 64 [, maxSize = 65536]]) -> Promise<Array<message>>
+		// Linux 上一次 recvmmsg 取走所有已到达的数据报 (最多 maxMessages 个)
+		auto recvBatchFn = std::make_shared<Function>();
+		recvBatchFn->isBuiltin = true;
+		recvBatchFn->builtin = [receiveAsync, sizeArg](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+			int fd = thisSocketFd(closure);
+			size_t count = sizeArg(args, 0, 64, 1024, "recvBatch maxMessages");
+			size_t size = sizeArg(args, 1, 65536, 16 * 1024 * 1024, "recvBatch maxSize");
+			if (count * size > 64u * 1024 * 1024) throw std::runtime_error("recvBatch: maxMessages * maxSize must not exceed 64 MiB");
+			return receiveAsync(fd, count, size, false, "recvBatch");
+		};
+		socketClass->methods["recvBatch"] = recvBatchFn;
+
+		// sendFd(socketOrFd [, data]) -> Promise<number>：通过 SCM_RIGHTS 传递文件描述符 (仅 unix 域 socket)。
+		// stream socket 至少要发送 1 字节才能携带控制消息，data 为空时发送一个 "\0"
+		auto sendFdFn = std::make_shared<Function>();
+		sendFdFn->isBuiltin = true;
+		sendFdFn->builtin = [asyncPtr](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+			if (args.empty() || args.size() > 2) throw std::runtime_error("sendFd expects (socketOrFd [, data])");
+			int fd = thisSocketFd(closure);
+			if (socketFamily(fd) != AF_UNIX) throw std::runtime_error("sendFd requires a unix domain socket");
+			int passFd = -1;
+			if (auto pinst = std::get_if<std::shared_ptr<Instance>>(&args[0])) {
+				auto ext = std::dynamic_pointer_cast<InstanceExt>(*pinst);
+				if (!ext || !ext->nativeHandle) throw std::runtime_error("sendFd: socket is closed");
+				passFd = *static_cast<int*>(ext->nativeHandle);
+			} else {
+				passFd = static_cast<int>(getNumber(args[0], "sendFd fd"));
+			}
+			if (passFd < 0) throw std::runtime_error("sendFd: invalid file descriptor");
+			std::string payload = args.size() == 2 ? toString(args[1]) : std::string();
+			if (payload.empty()) payload.assign(1, '\0');
+
+			auto p = asyncPtr->createPromise();
+			std::thread([p, asyncPtr, fd, passFd, payload]{
+				struct iovec iov;
+				iov.iov_base = const_cast<char*>(payload.data());
+				iov.iov_len = payload.size();
+				union { char buf[CMSG_SPACE(sizeof(int))]; struct cmsghdr align; } ctrl;
+				std::memset(&ctrl, 0, sizeof(ctrl));
+				struct msghdr msg;
+				std::memset(&msg, 0, sizeof(msg));
+				msg.msg_iov = &iov;
+				msg.msg_iovlen = 1;
+				msg.msg_control = ctrl.buf;
+				msg.msg_controllen = sizeof(ctrl.buf);
+				struct cmsghdr* c = CMSG_FIRSTHDR(&msg);
+				c->cmsg_level = SOL_SOCKET;
+				c->cmsg_type = SCM_RIGHTS;
+				c->cmsg_len = CMSG_LEN(sizeof(int));
+				std::memcpy(CMSG_DATA(c), &passFd, sizeof(int));
+				ssize_t n = sendmsg(fd, &msg, 0);
+				if (n < 0) asyncPtr->reject(p, Value{socketError("sendFd failed")});
+				else asyncPtr->resolve(p, Value{static_cast<double>(n)});
+			}).detach();
+			return Value{p};
+		};
+		socketClass->methods["sendFd"] = sendFdFn;
+
+		// recvFd([maxSize = 4096]) -> Promise<{fd, data}>：fd 为收到的描述符 (没有则为 null)，可交给 Socket.fromFd
+		auto recvFdFn = std::make_shared<Function>();
+		recvFdFn->isBuiltin = true;
+		recvFdFn->builtin = [asyncPtr, sizeArg](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+			int fd = thisSocketFd(closure);
+			if (socketFamily(fd) != AF_UNIX) throw std::runtime_error("recvFd requires a unix domain socket");
+			size_t size = sizeArg(args, 0, 4096, 16 * 1024 * 1024, "recvFd maxSize");
+			auto p = asyncPtr->createPromise();
+			std::thread([p, asyncPtr, fd, size]{
+				std::vector<char> buf(size);
+				struct iovec iov;
+				iov.iov_base = buf.data();
+				iov.iov_len = buf.size();
+				union { char buf[CMSG_SPACE(sizeof(int) * 8)]; struct cmsghdr align; } ctrl;
+				std::memset(&ctrl, 0, sizeof(ctrl));
+				struct msghdr msg;
+				std::memset(&msg, 0, sizeof(msg));
+				msg.msg_iov = &iov;
+				msg.msg_iovlen = 1;
+				msg.msg_control = ctrl.buf;
+				msg.msg_controllen = sizeof(ctrl.buf);
+#ifdef MSG_CMSG_CLOEXEC
+				ssize_t n = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+#else
+				ssize_t n = recvmsg(fd, &msg, 0);
+#endif
+				if (n < 0) { asyncPtr->reject(p, Value{socketError("recvFd failed")}); return; }
+				int received = -1;
+				for (struct cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+					if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+					size_t count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+					for (size_t i = 0; i < count; ++i) {
+						int got;
+						std::memcpy(&got, CMSG_DATA(c) + i * sizeof(int), sizeof(int));
+						if (received < 0) received = got; else close(got); // 只保留第一个
+					}
+				}
+				auto o = std::make_shared<Object>();
+				(*o)["fd"] = received >= 0 ? Value{static_cast<double>(received)} : Value{std::monostate{}};
+				(*o)["data"] = Value{std::string(buf.data(), static_cast<size_t>(n))};
+				asyncPtr->resolve(p, Value{o});
+			}).detach();
+			return Value{p};
+		};
+		socketClass->methods["recvFd"] = recvFdFn;
+
+		// Socket.fromFd(fd) -> Socket：接管一个已打开的 socket 描述符
+		auto fromFdFn = std::make_shared<Function>();
+		fromFdFn->isBuiltin = true;
+		fromFdFn->builtin = [wrapSocket](const std::vector<Value>& args, std::shared_ptr<Environment>) -> Value {
+			if (args.size() != 1) throw std::runtime_error("Socket.fromFd expects (fd)");
+			int fd = static_cast<int>(getNumber(args[0], "fd"));
+			if (fd < 0) throw std::runtime_error("Socket.fromFd: invalid file descriptor");
+			return wrapSocket(fd);
+		};
+		socketClass->staticMethods["fromFd"] = fromFdFn;
+
+		// Socket.pair(type = "stream") -> [Socket, Socket]：一对相连的 unix 域 socket
+		auto pairFn = std::make_shared<Function>();
+		pairFn->isBuiltin = true;
+		pairFn->builtin = [wrapSocket](const std::vector<Value>& args, std::shared_ptr<Environment>) -> Value {
+			int type = SOCK_STREAM;
+			if (!args.empty()) {
+				std::string t = toString(args[0]);
+				if (t == "dgram" || t == "udp") type = SOCK_DGRAM;
+				else if (t != "stream" && t != "tcp") throw std::runtime_error("Socket.pair: type must be \"stream\" or \"dgram\"");
+			}
+			int sv[2];
+			if (socketpair(AF_UNIX, type, 0, sv) < 0) throw std::runtime_error(socketError("socketpair failed"));
+			auto arr = std::make_shared<Array>();
+			arr->push_back(wrapSocket(sv[0]));
+			arr->push_back(wrapSocket(sv[1]));
+			return Value{arr};
+		};
+		socketClass->staticMethods["pair"] = pairFn;
+#endif
+
 		// URL class: new URL(str) -> fields: protocol, host, port, path, query
 		{
 			auto urlClass = std::make_shared<ClassInfo>();
@@ -498,6 +1007,7 @@ void registerStdNetworkPackage(Interpreter& interp) {
 				std::string body;
 				bool followRedirects = true;
 				int maxRedirects = 5;
+				TlsOptions tlsOpts;
 				
 				if (args.size() >= 2) {
 					if (!std::holds_alternative<std::shared_ptr<Object>>(args[1])) throw std::runtime_error("fetch options must be object");
@@ -514,20 +1024,23 @@ void registerStdNetworkPackage(Interpreter& interp) {
 					if (itMR != opt->end() && std::holds_alternative<double>(itMR->second)) {
 						maxRedirects = static_cast<int>(std::get<double>(itMR->second));
 					}
+					auto itT = opt->find("tls"); if (itT != opt->end()) tlsOpts = tlsOptionsFromValue(itT->second, "fetch");
 				}
 				
 				// Promise
 				auto p = asyncPtr->createPromise();
-				std::thread([interpPtr, asyncPtr, p, initialUrl, method, hdrObj, body, followRedirects, maxRedirects]{
+				std::thread([interpPtr, asyncPtr, p, initialUrl, method, hdrObj, body, followRedirects, maxRedirects, tlsOpts]() mutable {
 					try {
 						std::string currentUrl = initialUrl;
 						int redirectCount = 0;
-						std::string finalHeaders, finalBody;
+						std::string finalHeaders, finalLeftover;
 						double finalStatus = 0.0;
+						Value finalTls{std::monostate{}};
+						std::shared_ptr<FetchBody> bodyStream;
 						
 						while (true) {
 							// Parse URL
-							std::string proto = "http"; std::string host; int port = 80; std::string path = "/";
+							std::string proto = "http"; std::string host; int port = -1; std::string path = "/";
 							size_t schemePos = currentUrl.find("://"); 
 							if (schemePos != std::string::npos) proto = currentUrl.substr(0, schemePos);
 							size_t hostStart = (schemePos == std::string::npos) ? 0 : (schemePos + 3);
@@ -541,30 +1054,30 @@ void registerStdNetworkPackage(Interpreter& interp) {
 								host = currentUrl.substr(hostStart, pathStart - hostStart); 
 							}
 							if (pathStart < currentUrl.size()) path = currentUrl.substr(pathStart);
-							if (proto == "https") { asyncPtr->reject(p, Value{ std::string("HTTPS not supported") }); return; }
-							
-							// DNS
-							struct hostent* server = gethostbyname(host.c_str());
-							if (server == NULL) { asyncPtr->reject(p, Value{ std::string("No such host: ") + host }); return; }
-							
-							int sockfd = socket(AF_INET, SOCK_STREAM, 0); 
-							if (sockfd < 0) { asyncPtr->reject(p, Value{ std::string("socket failed") }); return; }
+							if (proto != "http" && proto != "https") { asyncPtr->reject(p, Value{ std::string("Unsupported protocol: ") + proto }); return; }
+							bool secure = proto == "https";
+							int defaultPort = secure ? 443 : 80;
+							if (port < 0) port = defaultPort;
 							
-							struct sockaddr_in serv_addr; 
-							std::memset(&serv_addr, 0, sizeof(serv_addr));
-							serv_addr.sin_family = AF_INET; 
-							std::memcpy(&serv_addr.sin_addr.s_addr, server->h_addr, server->h_length); 
-							serv_addr.sin_port = htons(port);
-							
-							if (connect(sockfd, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0) { 
-								close(sockfd); 
-								asyncPtr->reject(p, Value{ std::string("connect failed") }); 
-								return; 
+							// DNS (进程内缓存) + connect
+							std::string connectError;
+							int sockfd = connectTcp(host, port, connectError);
+							if (sockfd < 0) { asyncPtr->reject(p, Value{ connectError }); return; }
+							std::shared_ptr<NetStream> conn;
+							if (secure) {
+								try {
+									conn = NetStream::connectTls(clientTlsContext(tlsOpts), sockfd, tlsOpts.servername.empty() ? host : tlsOpts.servername, port);
+								} catch (const std::exception& ex) {
+									asyncPtr->reject(p, Value{ std::string(ex.what()) });
+									return;
+								}
+							} else {
+								conn = std::make_shared<NetStream>(sockfd);
 							}
 							
 							std::ostringstream req;
 							req << method << " " << path << " HTTP/1.1\r\n";
-							req << "Host: " << host << "\r\n";
+							req << "Host: " << host << (port != defaultPort ? ":" + std::to_string(port) : "") << "\r\n";
 							req << "Connection: close\r\n";
 							req << "User-Agent: ALang/1.0\r\n";
 							if (hdrObj) { for (auto& kv : *hdrObj) { req << kv.first << ": " << toString(kv.second) << "\r\n"; } }
@@ -573,25 +1086,33 @@ void registerStdNetworkPackage(Interpreter& interp) {
 							if (!body.empty()) req << body;
 							
 							std::string rs = req.str(); 
-							if (write(sockfd, rs.c_str(), rs.size()) < 0) { 
-								close(sockfd); 
-								asyncPtr->reject(p, Value{ std::string("write failed") }); 
+							if (!conn->writeAll(rs)) { 
+								asyncPtr->reject(p, Value{ std::string("write failed: ") + conn->lastError() }); 
 								return; 
 							}
 							
-							std::string response; 
-							char buf[4096]; 
-							int n; 
-							while ((n = read(sockfd, buf, sizeof(buf))) > 0) response.append(buf, n); 
-							close(sockfd);
+							// 只读到响应头结束；响应体由 FetchBody 在本线程上流式解码
+							std::string response;
+							char buf[4096];
+							size_t headerEnd = std::string::npos;
+							long n = 0;
+							while ((headerEnd = response.find("\r\n\r\n")) == std::string::npos) {
+								n = conn->receive(buf, sizeof(buf));
+								if (n <= 0) break;
+								response.append(buf, static_cast<size_t>(n));
+							}
+							if (headerEnd == std::string::npos) {
+								std::string reason = n < 0 ? "read failed: " + conn->lastError() : std::string("connection closed before the response headers were complete");
+								conn->disconnect();
+								asyncPtr->reject(p, Value{ reason });
+								return;
+							}
 							
 							// Parse response
-							size_t headerEnd = response.find("\r\n\r\n"); 
-							std::string headers, bodyStr; 
+							std::string headers = response.substr(0, headerEnd);
+							std::string leftover = response.substr(headerEnd + 4);
 							double status = 0.0;
-							if (headerEnd != std::string::npos) { 
-								headers = response.substr(0, headerEnd); 
-								bodyStr = response.substr(headerEnd + 4);
+							{
 								size_t sp1 = headers.find(' '); 
 								size_t sp2 = headers.find(' ', sp1 + 1);
 								if (sp1 != std::string::npos && sp2 != std::string::npos) { 
@@ -603,6 +1124,7 @@ void registerStdNetworkPackage(Interpreter& interp) {
 							
 							// Check for redirect
 							if (followRedirects && status >= 300 && status < 400) {
+								conn->disconnect();
 								if (redirectCount >= maxRedirects) {
 									asyncPtr->reject(p, Value{ std::string("Too many redirects") });
 									return;
@@ -636,12 +1158,12 @@ void registerStdNetworkPackage(Interpreter& interp) {
 								
 								// Handle relative URLs
 								if (location[0] == '/') {
-									currentUrl = proto + "://" + host + (port != 80 ? ":" + std::to_string(port) : "") + location;
+									currentUrl = proto + "://" + host + (port != defaultPort ? ":" + std::to_string(port) : "") + location;
 								} else if (location.find("://") == std::string::npos) {
 									// Relative path
 									size_t lastSlash = path.find_last_of('/');
 									std::string basePath = (lastSlash != std::string::npos) ? path.substr(0, lastSlash + 1) : "/";
-									currentUrl = proto + "://" + host + (port != 80 ? ":" + std::to_string(port) : "") + basePath + location;
+									currentUrl = proto + "://" + host + (port != defaultPort ? ":" + std::to_string(port) : "") + basePath + location;
 								} else {
 									currentUrl = location;
 								}
@@ -652,8 +1174,10 @@ void registerStdNetworkPackage(Interpreter& interp) {
 							
 							// No redirect or reached final destination
 							finalHeaders = headers;
-							finalBody = bodyStr;
 							finalStatus = status;
+							finalTls = conn->tlsInfo();
+							finalLeftover = std::move(leftover);
+							bodyStream = FetchBody::forResponse(conn, method, static_cast<int>(status), headers, asyncPtr);
 							break;
 						}
 						
@@ -662,27 +1186,36 @@ void registerStdNetworkPackage(Interpreter& interp) {
 						(*respObj)["headers"] = Value{ finalHeaders };
 						(*respObj)["redirected"] = Value{ redirectCount > 0 };
 						(*respObj)["url"] = Value{ currentUrl };
+						(*respObj)["tls"] = finalTls;
 						
-						// text(): Promise<string>
+						// body: 流式读取 {read, pipeTo, cancel, bytesRead}
+						(*respObj)["body"] = bodyStream->makeObject();
+						auto bodyHandle = bodyStream->scriptHandle();
+						// text(): Promise<string>，收集尚未读取的部分
 						{
 							auto textFn = std::make_shared<Function>(); textFn->isBuiltin = true;
-							std::string copy = finalBody;
-							textFn->builtin = [asyncPtr, copy](const std::vector<Value>&, std::shared_ptr<Environment>)->Value {
-								auto tp = asyncPtr->createPromise(); asyncPtr->resolve(tp, Value{ copy }); return Value{ tp };
+							textFn->builtin = [asyncPtr, bodyHandle](const std::vector<Value>&, std::shared_ptr<Environment>)->Value {
+								auto tp = asyncPtr->createPromise();
+								bodyHandle->body->collect([asyncPtr, tp](const std::string& data, const std::string& error) {
+									if (error.empty()) asyncPtr->resolve(tp, Value{ data }); else asyncPtr->reject(tp, Value{ error });
+								});
+								return Value{ tp };
 							};
 							(*respObj)["text"] = Value{ textFn };
 						}
 						// json(): Promise<any>
 						{
-							auto jsonFn = std::make_shared<Function>(); jsonFn->isBuiltin = true; std::string copy = finalBody;
-							jsonFn->builtin = [interpPtr, asyncPtr, copy](const std::vector<Value>&, std::shared_ptr<Environment>)->Value {
+							auto jsonFn = std::make_shared<Function>(); jsonFn->isBuiltin = true;
+							jsonFn->builtin = [interpPtr, asyncPtr, bodyHandle](const std::vector<Value>&, std::shared_ptr<Environment>)->Value {
 								auto tp = asyncPtr->createPromise();
-								asyncPtr->postTask([interpPtr, asyncPtr, tp, copy]{
+								bodyHandle->body->collect([interpPtr, asyncPtr, tp](const std::string& data, const std::string& error) {
+									if (!error.empty()) { asyncPtr->reject(tp, Value{ error }); return; }
 									try {
+										interpPtr->loadLazyPackage("json");
 										auto jsonPkg = interpPtr->ensurePackage("json");
 										Value parseV = (*jsonPkg)["parse"]; if (!std::holds_alternative<std::shared_ptr<Function>>(parseV)) { asyncPtr->reject(tp, Value{ std::string("json.parse not found") }); return; }
 										auto parseFn = std::get<std::shared_ptr<Function>>(parseV);
-										Value res = parseFn->builtin({ Value{ copy } }, parseFn->closure);
+										Value res = parseFn->builtin({ Value{ data } }, parseFn->closure);
 										asyncPtr->resolve(tp, res);
 									} catch (const std::exception& ex) {
 										asyncPtr->reject(tp, Value{ std::string(ex.what()) });
@@ -693,10 +1226,16 @@ void registerStdNetworkPackage(Interpreter& interp) {
 							(*respObj)["json"] = Value{ jsonFn };
 						}
 						asyncPtr->resolve(p, Value{ respObj });
+						// 本线程不再持有脚本侧引用，响应对象被丢弃时 FetchBody 能感知到并停止
+						respObj.reset();
+						bodyHandle.reset();
+						p.reset(); // 已 settle 的 Promise 仍持有响应对象
+						// 响应已交给脚本；在本线程上继续读取响应体 (背压由 FetchBody 的有界队列控制)
+						bodyStream->produce(std::move(finalLeftover));
 					} catch (const std::exception& ex) {
-						asyncPtr->reject(p, Value{ std::string("Fetch exception: ") + ex.what() });
+						if (p) asyncPtr->reject(p, Value{ std::string("Fetch exception: ") + ex.what() });
 					} catch (...) {
-						asyncPtr->reject(p, Value{ std::string("Fetch unknown exception") });
+						if (p) asyncPtr->reject(p, Value{ std::string("Fetch unknown exception") });
 					}
 				}).detach();
 				return Value{ p };
@@ -735,25 +1274,10 @@ void registerStdNetworkPackage(Interpreter& interp) {
 				path = url.substr(pathStart);
 			}
 
-			// 2. Resolve Host
-			struct hostent* server = gethostbyname(host.c_str());
-			if (server == NULL) throw std::runtime_error("No such host: " + host);
-
-			// 3. Create Socket
-			int sockfd = socket(AF_INET, SOCK_STREAM, 0);
-			if (sockfd < 0) throw std::runtime_error("Error opening socket");
-
-			struct sockaddr_in serv_addr;
-			std::memset(&serv_addr, 0, sizeof(serv_addr));
-			serv_addr.sin_family = AF_INET;
-			std::memcpy(&serv_addr.sin_addr.s_addr, server->h_addr, server->h_length);
-			serv_addr.sin_port = htons(port);
-
-			// 4. Connect
-			if (connect(sockfd, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0) {
-				close(sockfd);
-				throw std::runtime_error("Error connecting to " + host);
-			}
+			// 2. Resolve Host + Connect
+			std::string connectError;
+			int sockfd = connectTcp(host, port, connectError);
+			if (sockfd < 0) throw std::runtime_error(connectError);
 
 			// 5. Send Request
 			std::ostringstream req;
@@ -881,6 +1405,10 @@ void registerStdNetworkPackage(Interpreter& interp) {
 		};
 		(*netPkg)["request"] = Value{requestFn};
 
+		// WebSocket class: WebSocket.connect(url[, options]) -> Promise<WebSocket>
+		auto wsClass = makeWebSocketClass(interpPtr, asyncPtr);
+		(*netPkg)["WebSocket"] = Value{wsClass};
+
 		// http sub-package with Server class
 		{
 			auto httpPkg = std::make_shared<Object>();
@@ -890,7 +1418,7 @@ void registerStdNetworkPackage(Interpreter& interp) {
 			serverClass->name = "Server";
 			serverClass->isNative = true;
 
-			// constructor()
+			// constructor([options]) - options.tls = {cert, key, ca, alpn, requestCert, rejectUnauthorized, handshakeTimeout}
 			auto serverCtor = std::make_shared<Function>();
 			serverCtor->isBuiltin = true;
 			serverCtor->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
@@ -900,6 +1428,15 @@ void registerStdNetworkPackage(Interpreter& interp) {
 				if (ext) {
 					ext->nativeHandle = nullptr; // Will be set in listen()
 				}
+				if (!args.empty() && !std::holds_alternative<std::monostate>(args[0])) {
+					auto opt = std::get_if<std::shared_ptr<Object>>(&args[0]);
+					if (!opt || !*opt) throw std::runtime_error("http.Server options must be an object");
+					auto itT = (*opt)->find("tls");
+					if (itT != (*opt)->end() && !std::holds_alternative<std::monostate>(itT->second)) {
+						tlsOptionsFromValue(itT->second, "http.Server"); // 尽早报告无效选项
+						inst->fields["_tls"] = itT->second;
+					}
+				}
 				return Value{std::monostate{}};
 			};
 			serverClass->methods["constructor"] = serverCtor;
@@ -907,7 +1444,7 @@ void registerStdNetworkPackage(Interpreter& interp) {
 			// listen(port, callback) - starts HTTP server
 			auto listenFn = std::make_shared<Function>();
 			listenFn->isBuiltin = true;
-			listenFn->builtin = [asyncPtr, interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+			listenFn->builtin = [asyncPtr, interpPtr, wsClass](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
 				if (args.size() < 2) throw std::runtime_error("Server.listen expects port and callback");
 				int port = static_cast<int>(getNumber(args[0], "port"));
 				if (!std::holds_alternative<std::shared_ptr<Function>>(args[1])) {
@@ -918,6 +1455,16 @@ void registerStdNetworkPackage(Interpreter& interp) {
 				Value thisVal = closure->get("this");
 				auto inst = std::get<std::shared_ptr<Instance>>(thisVal);
 				auto ext = std::dynamic_pointer_cast<InstanceExt>(inst);
+				std::shared_ptr<TlsContext> tlsCtx;
+				auto itTls = inst->fields.find("_tls");
+				if (itTls != inst->fields.end()) tlsCtx = createServerTlsContext(tlsOptionsFromValue(itTls->second, "http.Server"));
+				Value wsHandler{std::monostate{}};
+				WsOptions wsOpts;
+				auto itWs = inst->fields.find("_wsHandler");
+				if (itWs != inst->fields.end()) {
+					wsHandler = itWs->second;
+					wsOpts = wsOptionsFromValue(inst->fields["_wsOptions"], "http.Server.onWebSocket");
+				}
 
 				// Create server socket
 				int serverFd = socket(AF_INET, SOCK_STREAM, 0);
@@ -948,6 +1495,9 @@ void registerStdNetworkPackage(Interpreter& interp) {
 					close(serverFd);
 					throw std::runtime_error("Failed to listen on server socket");
 				}
+				// 端口 0 时由系统分配，回写实际端口
+				socklen_t addrLen = sizeof(addr);
+				if (getsockname(serverFd, (struct sockaddr*)&addr, &addrLen) == 0) inst->fields["port"] = Value{static_cast<double>(ntohs(addr.sin_port))};
 
 				if (ext) {
 					ext->nativeHandle = new int(serverFd);
@@ -959,7 +1509,7 @@ void registerStdNetworkPackage(Interpreter& interp) {
 				}
 
 				// Start accepting connections in background thread
-				std::thread([serverFd, callback, asyncPtr, interpPtr]() {
+				std::thread([serverFd, callback, asyncPtr, interpPtr, tlsCtx, wsHandler, wsOpts, wsClass]() {
 					try {
 						while (true) {
 							struct sockaddr_in clientAddr;
@@ -968,12 +1518,19 @@ void registerStdNetworkPackage(Interpreter& interp) {
 							if (clientFd < 0) break; // Server closed
 
 							// Handle each connection in its own thread
-							std::thread([clientFd, callback, asyncPtr, interpPtr]() {
+							std::thread([clientFd, callback, asyncPtr, interpPtr, tlsCtx, wsHandler, wsOpts, wsClass]() {
+								std::shared_ptr<NetStream> conn;
 								try {
+									if (tlsCtx) {
+										// 握手失败 (证书被拒、超时、明文客户端) 只关闭该连接
+										try { conn = NetStream::acceptTls(tlsCtx, clientFd); } catch (const std::exception&) { return; }
+									} else {
+										conn = std::make_shared<NetStream>(clientFd);
+									}
 									// Read HTTP request
 									std::string requestData;
 									char buf[4096];
-									ssize_t n = read(clientFd, buf, sizeof(buf) - 1);
+									long n = conn->receive(buf, sizeof(buf) - 1);
 									if (n > 0) {
 										buf[n] = '\0';
 										requestData = std::string(buf, n);
@@ -1004,10 +1561,17 @@ void registerStdNetworkPackage(Interpreter& interp) {
 									(*reqObj)["version"] = Value{version};
 									(*reqObj)["headers"] = Value{headersSection};
 									(*reqObj)["body"] = Value{body};
+									(*reqObj)["secure"] = Value{conn->secure()};
+									(*reqObj)["tls"] = conn->tlsInfo();
+
+									// WebSocket 升级：握手后由该线程继续负责这条连接的 I/O
+									if (!std::holds_alternative<std::monostate>(wsHandler) && isWebSocketUpgrade(headersSection)) {
+										serveWebSocket(conn, headersSection, body, wsOpts, wsClass, wsHandler, Value{reqObj}, interpPtr, asyncPtr);
+										return;
+									}
 
 									// Create response object
 									auto resObj = std::make_shared<Object>();
-									int* clientFdPtr = new int(clientFd);
 
 							// res.writeHead(statusCode, headers)
 							auto writeHeadFn = std::make_shared<Function>();
@@ -1033,7 +1597,7 @@ void registerStdNetworkPackage(Interpreter& interp) {
 							// res.end(body) - send response
 							auto endFn = std::make_shared<Function>();
 							endFn->isBuiltin = true;
-							endFn->builtin = [clientFdPtr, statusCodePtr, headersStrPtr](const std::vector<Value>& args, std::shared_ptr<Environment>) -> Value {
+							endFn->builtin = [conn, statusCodePtr, headersStrPtr](const std::vector<Value>& args, std::shared_ptr<Environment>) -> Value {
 								std::string body;
 								if (!args.empty()) {
 									body = toString(args[0]);
@@ -1051,11 +1615,10 @@ void registerStdNetworkPackage(Interpreter& interp) {
 								response << body;
 
 								std::string respStr = response.str();
-								ssize_t written = write(*clientFdPtr, respStr.c_str(), respStr.size());
-								close(*clientFdPtr);
-								delete clientFdPtr;
+								bool written = conn->writeAll(respStr);
+								conn->disconnect();
 
-								if (written < 0) {
+								if (!written) {
 									auto errObj = std::make_shared<Object>();
 									(*errObj)["message"] = Value{std::string("Failed to send response")};
 									return Value{errObj};
@@ -1084,10 +1647,10 @@ void registerStdNetworkPackage(Interpreter& interp) {
 							});
 						} catch (const std::exception& ex) {
 							std::cerr << "HTTP Server connection handler exception: " << ex.what() << std::endl;
-							close(clientFd);
+							if (conn) conn->disconnect(); else close(clientFd);
 						} catch (...) {
 							std::cerr << "HTTP Server connection handler unknown exception" << std::endl;
-							close(clientFd);
+							if (conn) conn->disconnect(); else close(clientFd);
 						}
 					}).detach();
 				}
@@ -1102,6 +1665,22 @@ void registerStdNetworkPackage(Interpreter& interp) {
 			};
 			serverClass->methods["listen"] = listenFn;
 
+			// onWebSocket(handler(ws, req)[, {protocols, deflate, maxMessageSize}]) - must be called before listen()
+			auto onWebSocketFn = std::make_shared<Function>();
+			onWebSocketFn->isBuiltin = true;
+			onWebSocketFn->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment> closure) -> Value {
+				if (args.empty() || !std::holds_alternative<std::shared_ptr<Function>>(args[0])) {
+					throw std::runtime_error("Server.onWebSocket expects a handler function");
+				}
+				Value optVal = args.size() >= 2 ? args[1] : Value{std::monostate{}};
+				wsOptionsFromValue(optVal, "http.Server.onWebSocket");
+				auto inst = std::get<std::shared_ptr<Instance>>(closure->get("this"));
+				inst->fields["_wsHandler"] = args[0];
+				inst->fields["_wsOptions"] = optVal;
+				return Value{std::monostate{}};
+			};
+			serverClass->methods["onWebSocket"] = onWebSocketFn;
+
 			// close() - stop the server
 			auto closeFn = std::make_shared<Function>();
 			closeFn->isBuiltin = true;
@@ -1169,17 +1748,43 @@ void registerStdNetworkPackage(Interpreter& interp) {
 
 			(*netPkg)["http"] = Value{httpPkg};
 		}
+
+		// tls sub-package: available, createSelfSignedCertificate(commonName = "localhost", days = 30) -> {cert, key}
+		{
+			auto tlsPkg = std::make_shared<Object>();
+			(*tlsPkg)["available"] = Value{tlsAvailable()};
+			auto selfSignedFn = std::make_shared<Function>();
+			selfSignedFn->isBuiltin = true;
+			selfSignedFn->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment>) -> Value {
+				std::string commonName = args.size() >= 1 ? toString(args[0]) : std::string("localhost");
+				int days = args.size() >= 2 ? static_cast<int>(getNumber(args[1], "days")) : 30;
+				if (commonName.empty()) throw std::runtime_error("createSelfSignedCertificate: commonName must not be empty");
+				if (days <= 0) throw std::runtime_error("createSelfSignedCertificate: days must be positive");
+				std::string cert, key;
+				createSelfSignedCertificate(commonName, days, cert, key);
+				auto out = std::make_shared<Object>();
+				(*out)["cert"] = Value{cert};
+				(*out)["key"] = Value{key};
+				return Value{out};
+			};
+			(*tlsPkg)["createSelfSignedCertificate"] = Value{selfSignedFn};
+			(*netPkg)["tls"] = Value{tlsPkg};
+		}
+
+		// dns: 进程内解析缓存 {lookup, warm, stats, clear, configure}
+		(*netPkg)["dns"] = makeDnsObject(asyncPtr);
 	});
 }
 
 PackageMeta getStdNetworkPackageMeta() {
     PackageMeta pkg;
     pkg.name = "std.network";
-    pkg.exports = { "parseHeaders", "fetch", "get", "post", "put", "delete", "patch", "head", "request", "http" };
+    pkg.exports = { "parseHeaders", "fetch", "get", "post", "put", "delete", "patch", "head", "request", "http", "tls", "dns", "WebSocket" };
     
     ClassMeta socketClass;
     socketClass.name = "Socket";
-    socketClass.methods = { {"constructor"}, {"bind"}, {"listen"}, {"connect"}, {"accept"}, {"read"}, {"write"}, {"close"} };
+    socketClass.methods = { {"constructor"}, {"bind"}, {"listen"}, {"connect"}, {"accept"}, {"read"}, {"write"}, {"close"},
+        {"fileno"}, {"localAddress"}, {"setOption"}, {"sendTo"}, {"sendBatch"}, {"recvFrom"}, {"recvBatch"}, {"sendFd"}, {"recvFd"}, {"fromFd"}, {"pair"} };
     pkg.classes.push_back(socketClass);
 
     ClassMeta urlClass;
@@ -1187,6 +1792,11 @@ PackageMeta getStdNetworkPackageMeta() {
     urlClass.methods = { {"constructor"}, {"parseQuery"} };
     pkg.classes.push_back(urlClass);
 
+    ClassMeta wsClass;
+    wsClass.name = "WebSocket";
+    wsClass.methods = { {"connect"}, {"send"}, {"sendBinary"}, {"receive"}, {"ping"}, {"close"}, {"on"}, {"bufferedAmount"}, {"readyState"} };
+    pkg.classes.push_back(wsClass);
+
     return pkg;
 }
 
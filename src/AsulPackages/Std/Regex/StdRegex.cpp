@@ -7,7 +7,8 @@ namespace asul {
 void registerStdRegexPackage(Interpreter& interp) {
 	auto stdRoot = interp.ensurePackage("std");
 	
-	interp.registerLazyPackage("std.regex", [stdRoot](std::shared_ptr<Object> regexPkg) {
+	Interpreter* interpPtr = &interp;
+	interp.registerLazyPackage("std.regex", [stdRoot, interpPtr](std::shared_ptr<Object> regexPkg) {
 		auto regexClass = std::make_shared<ClassInfo>();
 		regexClass->name = "Regex";
 		
@@ -142,6 +143,44 @@ void registerStdRegexPackage(Interpreter& interp) {
 		};
 		regexClass->methods["replace"] = replaceFn;
 
+		// replaceAsync(str, replacement) -> Promise<string>
+		// 参数与 pattern 在调用时读取，编译与替换在工作线程上进行
+		auto replaceAsyncFn = std::make_shared<Function>(); replaceAsyncFn->isBuiltin = true;
+		replaceAsyncFn->builtin = [interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() < 2) throw ExceptionSignal{ Value{ std::string("Regex.replaceAsync expects string and replacement") } };
+			std::string text;
+			if (auto p = std::get_if<std::string>(&args[0])) text = *p;
+			else throw ExceptionSignal{ Value{ std::string("Regex.replaceAsync first argument must be string") } };
+
+			std::string replacement;
+			if (auto p = std::get_if<std::string>(&args[1])) replacement = *p;
+			else throw ExceptionSignal{ Value{ std::string("Regex.replaceAsync second argument must be string") } };
+
+			std::string pattern;
+			if (clos) {
+				Value tv = clos->get("this");
+				if (auto pins = std::get_if<std::shared_ptr<Instance>>(&tv)) {
+					if (*pins) {
+						auto it = (*pins)->fields.find("_pattern");
+						if (it != (*pins)->fields.end() && std::holds_alternative<std::string>(it->second)) {
+							pattern = std::get<std::string>(it->second);
+						}
+					}
+				}
+			}
+			if (pattern.empty()) throw ExceptionSignal{ Value{ std::string("Regex instance has no pattern") } };
+
+			return Value{ interpPtr->offload([pattern, text, replacement]()->Value {
+				try {
+					std::regex re(pattern);
+					return Value{ std::regex_replace(text, re, replacement) };
+				} catch (const std::exception& e) {
+					throw ExceptionSignal{ Value{ std::string("Regex error: ") + e.what() } };
+				}
+			}) };
+		};
+		regexClass->methods["replaceAsync"] = replaceAsyncFn;
+
 		(*regexPkg)["Regex"] = Value{regexClass};
 		(*stdRoot)["regex"] = Value{regexClass};
 	});
@@ -154,7 +193,7 @@ PackageMeta getStdRegexPackageMeta() {
 
     ClassMeta regexClass;
     regexClass.name = "Regex";
-    regexClass.methods = { {"constructor"}, {"match"}, {"test"}, {"replace"} };
+    regexClass.methods = { {"constructor"}, {"match"}, {"test"}, {"replace"}, {"replaceAsync"} };
     pkg.classes.push_back(regexClass);
 
     return pkg;
@@ -0,0 +1,529 @@
+#include "StdShm.h"
+#include "../../../AsulInterpreter.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifndef _WIN32
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#ifdef __linux__
+		#include <linux/futex.h>
+		#include <sys/syscall.h>
+	#endif
+#endif
+
+namespace asul {
+
+namespace {
+
+// ----------- 共享内存布局 -----------
+// 命名区域由 shm_open 创建；创建者写完布局后才以 release 语义发布 magic，打开者等到 magic 出现再使用。
+// Ring 是 Vyukov 式有界 MPMC 队列：每个槽有序号 seq，生产者/消费者各自用 CAS 推进 enqueuePos/dequeuePos，
+// 槽内是长度前缀的消息 (最多 slotSize 字节)。单生产者单消费者时同样适用。
+// 阻塞等待用 futex (跨进程，非 PRIVATE)：dataSeq/spaceSeq 每次 push/pop 递增，只有存在等待者时才发起 wake 系统调用。
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free && std::atomic<int64_t>::is_always_lock_free,
+	"std.shm needs address-free lock-free atomics");
+
+constexpr uint32_t kRingMagic = 0x414c5247;    // "ALRG"
+constexpr uint32_t kCounterMagic = 0x414c4354; // "ALCT"
+constexpr uint32_t kLayoutVersion = 1;
+
+struct RingHeader {
+	std::atomic<uint32_t> magic;
+	uint32_t version;
+	uint32_t slots;
+	uint32_t slotSize;
+	uint32_t slotStride;
+	alignas(64) std::atomic<uint64_t> enqueuePos;
+	alignas(64) std::atomic<uint64_t> dequeuePos;
+	alignas(64) std::atomic<uint32_t> dataSeq;
+	std::atomic<uint32_t> dataWaiters;
+	alignas(64) std::atomic<uint32_t> spaceSeq;
+	std::atomic<uint32_t> spaceWaiters;
+};
+
+struct SlotHeader {
+	std::atomic<uint64_t> seq;
+	uint32_t len;
+	uint32_t reserved;
+};
+
+struct CounterHeader {
+	std::atomic<uint32_t> magic;
+	uint32_t version;
+	std::atomic<int64_t> value;
+};
+
+constexpr size_t kRingDataOffset = (sizeof(RingHeader) + 63) & ~size_t(63);
+
+std::string regionName(const std::string& name, const char* what) {
+	std::string n = name;
+	if (!n.empty() && n[0] == '/') n = n.substr(1);
+	if (n.empty() || n.size() > 200 || n.find('/') != std::string::npos) {
+		throw std::runtime_error(std::string(what) + ": name must be a non-empty string without '/'");
+	}
+	return "/" + n;
+}
+
+struct Mapping {
+	void* base{nullptr};
+	size_t size{0};
+	~Mapping() {
+#ifndef _WIN32
+		if (base) munmap(base, size);
+#endif
+	}
+};
+
+#ifndef _WIN32
+// 创建 (create 且不存在时) 或打开命名区域。init 在发布 magic 之前初始化布局。
+std::shared_ptr<Mapping> openRegion(const std::string& name, bool create, size_t createSize, uint32_t magic,
+	const std::function<void(void*)>& init, const char* what) {
+	auto map = std::make_shared<Mapping>();
+	int fd = -1;
+	if (create) fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd >= 0) {
+		if (ftruncate(fd, static_cast<off_t>(createSize)) != 0) {
+			int err = errno;
+			::close(fd);
+			shm_unlink(name.c_str());
+			throw std::runtime_error(std::string(what) + ": cannot size region: " + std::strerror(err));
+		}
+		map->base = mmap(nullptr, createSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (map->base == MAP_FAILED) { map->base = nullptr; throw std::runtime_error(std::string(what) + ": mmap failed: " + std::strerror(errno)); }
+		map->size = createSize;
+		init(map->base);
+		static_cast<std::atomic<uint32_t>*>(map->base)->store(magic, std::memory_order_release);
+		return map;
+	}
+	if (create && errno != EEXIST) throw std::runtime_error(std::string(what) + ": shm_open failed: " + std::strerror(errno));
+	fd = shm_open(name.c_str(), O_RDWR, 0600);
+	if (fd < 0) throw std::runtime_error(std::string(what) + ": cannot open shared memory '" + name.substr(1) + "': " + std::strerror(errno));
+	// 创建者可能还在 ftruncate / 初始化：最多等 1 秒
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+	struct stat st;
+	while (fstat(fd, &st) == 0 && st.st_size < static_cast<off_t>(sizeof(std::atomic<uint32_t>) * 2)) {
+		if (std::chrono::steady_clock::now() > deadline) { ::close(fd); throw std::runtime_error(std::string(what) + ": shared memory '" + name.substr(1) + "' was never initialised"); }
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	map->base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (map->base == MAP_FAILED) { map->base = nullptr; throw std::runtime_error(std::string(what) + ": mmap failed: " + std::strerror(errno)); }
+	map->size = static_cast<size_t>(st.st_size);
+	auto* m = static_cast<std::atomic<uint32_t>*>(map->base);
+	while (m->load(std::memory_order_acquire) != magic) {
+		if (std::chrono::steady_clock::now() > deadline) throw std::runtime_error(std::string(what) + ": '" + name.substr(1) + "' is not a compatible shared region");
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	if (static_cast<const uint32_t*>(map->base)[1] != kLayoutVersion) throw std::runtime_error(std::string(what) + ": '" + name.substr(1) + "' has an incompatible layout version");
+	return map;
+}
+#endif // !_WIN32
+
+// timeoutMs < 0 表示无限等待；返回时不保证条件已满足，调用方需重新检查
+void futexWait(std::atomic<uint32_t>* addr, uint32_t expected, long timeoutMs) {
+#ifdef __linux__
+	struct timespec ts;
+	struct timespec* tsp = nullptr;
+	if (timeoutMs >= 0) {
+		ts.tv_sec = timeoutMs / 1000;
+		ts.tv_nsec = (timeoutMs % 1000) * 1000000L;
+		tsp = &ts;
+	}
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, expected, tsp, nullptr, 0);
+#else
+	// 无 futex 的平台退化为短间隔轮询
+	(void)expected;
+	long ms = timeoutMs < 0 ? 1 : std::min<long>(timeoutMs, 1);
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+#endif
+}
+
+void futexWake(std::atomic<uint32_t>* addr) {
+#ifdef __linux__
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+	(void)addr;
+#endif
+}
+
+struct ShmRing {
+	std::shared_ptr<Mapping> map;
+	RingHeader* hdr{nullptr};
+	char* data{nullptr};
+	uint64_t mask{0};
+
+	SlotHeader* slot(uint64_t pos) const { return reinterpret_cast<SlotHeader*>(data + (pos & mask) * hdr->slotStride); }
+
+	bool tryPush(const char* bytes, size_t len) {
+		uint64_t pos = hdr->enqueuePos.load(std::memory_order_relaxed);
+		SlotHeader* s;
+		for (;;) {
+			s = slot(pos);
+			uint64_t seq = s->seq.load(std::memory_order_acquire);
+			int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+			if (diff == 0) {
+				if (hdr->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+			} else if (diff < 0) {
+				return false; // 满
+			} else {
+				pos = hdr->enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		s->len = static_cast<uint32_t>(len);
+		std::memcpy(reinterpret_cast<char*>(s) + sizeof(SlotHeader), bytes, len);
+		s->seq.store(pos + 1, std::memory_order_release);
+		hdr->dataSeq.fetch_add(1);
+		if (hdr->dataWaiters.load() != 0) futexWake(&hdr->dataSeq);
+		return true;
+	}
+
+	bool tryPop(std::string& out) {
+		uint64_t pos = hdr->dequeuePos.load(std::memory_order_relaxed);
+		SlotHeader* s;
+		for (;;) {
+			s = slot(pos);
+			uint64_t seq = s->seq.load(std::memory_order_acquire);
+			int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1);
+			if (diff == 0) {
+				if (hdr->dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+			} else if (diff < 0) {
+				return false; // 空
+			} else {
+				pos = hdr->dequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+		out.assign(reinterpret_cast<const char*>(s) + sizeof(SlotHeader), s->len);
+		s->seq.store(pos + mask + 1, std::memory_order_release);
+		hdr->spaceSeq.fetch_add(1);
+		if (hdr->spaceWaiters.load() != 0) futexWake(&hdr->spaceSeq);
+		return true;
+	}
+
+	size_t size() const {
+		uint64_t deq = hdr->dequeuePos.load();
+		uint64_t enq = hdr->enqueuePos.load();
+		return enq > deq ? static_cast<size_t>(std::min<uint64_t>(enq - deq, mask + 1)) : 0;
+	}
+
+	// 在 seq 上等待直到 attempt() 成功或超时 (timeoutMs < 0 为无限)
+	static bool waitUntil(std::atomic<uint32_t>& seq, std::atomic<uint32_t>& waiters, long timeoutMs, const std::function<bool()>& attempt) {
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs < 0 ? 0 : timeoutMs);
+		for (;;) {
+			waiters.fetch_add(1);
+			uint32_t observed = seq.load();
+			if (attempt()) { waiters.fetch_sub(1); return true; }
+			long left = -1;
+			if (timeoutMs >= 0) {
+				left = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count());
+				if (left <= 0) { waiters.fetch_sub(1); return false; }
+			}
+			futexWait(&seq, observed, left);
+			waiters.fetch_sub(1);
+		}
+	}
+};
+
+struct RingHandle {
+	std::shared_ptr<ShmRing> ring; // close() 后为空；等待中的线程各自持有引用，映射在它们结束后才解除
+};
+
+struct CounterHandle {
+	std::shared_ptr<Mapping> map;
+	CounterHeader* hdr{nullptr};
+};
+
+using NativeFn = std::function<Value(const std::vector<Value>&, std::shared_ptr<Environment>)>;
+
+void addMethod(const std::shared_ptr<ClassInfo>& klass, const char* name, NativeFn fn) {
+	auto f = std::make_shared<Function>();
+	f->isBuiltin = true;
+	f->builtin = std::move(fn);
+	klass->methods[name] = f;
+}
+
+InstanceExt* thisInstance(const std::shared_ptr<Environment>& clos) {
+	if (!clos) throw std::runtime_error("internal: instance method called without closure");
+	Value tv = clos->get("this");
+	auto pins = std::get_if<std::shared_ptr<Instance>>(&tv);
+	if (!pins || !*pins) throw std::runtime_error("internal: invalid 'this' value");
+	return static_cast<InstanceExt*>(pins->get());
+}
+
+template <typename T>
+T* handleOf(const std::shared_ptr<Environment>& clos, const char* what) {
+	auto h = static_cast<T*>(thisInstance(clos)->nativeHandle);
+	if (!h) throw std::runtime_error(std::string(what) + ": native handle missing");
+	return h;
+}
+
+template <typename T>
+void attach(InstanceExt* inst, T* handle) {
+	inst->nativeHandle = handle;
+	inst->nativeDestructor = [](void* p) { delete static_cast<T*>(p); };
+}
+
+std::shared_ptr<ShmRing> ringOf(const std::shared_ptr<Environment>& clos, const char* what) {
+	auto h = handleOf<RingHandle>(clos, what);
+	if (!h->ring) throw std::runtime_error(std::string(what) + ": ring is closed");
+	return h->ring;
+}
+
+CounterHandle* counterOf(const std::shared_ptr<Environment>& clos, const char* what) {
+	auto h = handleOf<CounterHandle>(clos, what);
+	if (!h->hdr) throw std::runtime_error(std::string(what) + ": counter is closed");
+	return h;
+}
+
+int64_t integerArg(const Value& v, const char* what) {
+	double d = getNumber(v, what);
+	if (std::floor(d) != d || std::fabs(d) > 9007199254740991.0) throw std::runtime_error(std::string(what) + ": expected an integer");
+	return static_cast<int64_t>(d);
+}
+
+const std::string& messageArg(const std::vector<Value>& args, const ShmRing& ring, const char* what) {
+	if (args.empty() || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error(std::string(what) + " expects a string message");
+	const std::string& msg = std::get<std::string>(args[0]);
+	if (msg.size() > ring.hdr->slotSize) {
+		throw std::runtime_error(std::string(what) + ": message of " + std::to_string(msg.size()) + " bytes exceeds slotSize " + std::to_string(ring.hdr->slotSize));
+	}
+	return msg;
+}
+
+long timeoutArg(const std::vector<Value>& args, size_t idx, const char* what) {
+	if (args.size() <= idx || std::holds_alternative<std::monostate>(args[idx])) return -1;
+	double ms = getNumber(args[idx], what);
+	if (ms < 0) throw std::runtime_error(std::string(what) + " must be >= 0");
+	return static_cast<long>(ms);
+}
+
+} // namespace
+
+void registerStdShmPackage(Interpreter& interp) {
+	Interpreter* interpPtr = &interp;
+	interp.registerLazyPackage("std.shm", [interpPtr](std::shared_ptr<Object> pkg) {
+		// ---- Ring(name[, {slots, slotSize, create}]) ----
+		auto ringClass = std::make_shared<ClassInfo>(); ringClass->name = "Ring"; ringClass->isNative = true;
+		addMethod(ringClass, "constructor", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+#ifdef _WIN32
+			throw std::runtime_error("std.shm is not supported on this platform");
+#else
+			if (args.empty() || args.size() > 2) throw std::runtime_error("Ring expects (name[, options])");
+			std::string name = regionName(toString(args[0]), "Ring");
+			uint64_t slots = 1024, slotSize = 4096;
+			bool create = true, explicitGeometry = false;
+			if (args.size() == 2) {
+				auto opts = std::get_if<std::shared_ptr<Object>>(&args[1]);
+				if (!opts || !*opts) throw std::runtime_error("Ring options must be an object");
+				for (auto& kv : **opts) {
+					if (kv.first == "slots") { slots = static_cast<uint64_t>(integerArg(kv.second, "Ring slots")); explicitGeometry = true; }
+					else if (kv.first == "slotSize") { slotSize = static_cast<uint64_t>(integerArg(kv.second, "Ring slotSize")); explicitGeometry = true; }
+					else if (kv.first == "create") create = isTruthy(kv.second);
+					else throw std::runtime_error("Ring: unknown option '" + kv.first + "'");
+				}
+			}
+			if (slots < 2 || slots > (1u << 24)) throw std::runtime_error("Ring: slots must be 2..16777216");
+			if (slotSize < 1 || slotSize > (64u << 20)) throw std::runtime_error("Ring: slotSize must be 1..67108864");
+			uint64_t pow2 = 2;
+			while (pow2 < slots) pow2 <<= 1;
+			slots = pow2;
+			uint32_t stride = static_cast<uint32_t>((sizeof(SlotHeader) + slotSize + 63) & ~uint64_t(63));
+			size_t total = kRingDataOffset + static_cast<size_t>(slots) * stride;
+
+			auto map = openRegion(name, create, total, kRingMagic, [&](void* base) {
+				auto* h = new (base) RingHeader();
+				h->version = kLayoutVersion;
+				h->slots = static_cast<uint32_t>(slots);
+				h->slotSize = static_cast<uint32_t>(slotSize);
+				h->slotStride = stride;
+				char* data = static_cast<char*>(base) + kRingDataOffset;
+				for (uint64_t i = 0; i < slots; ++i) {
+					auto* s = new (data + i * stride) SlotHeader();
+					s->seq.store(i, std::memory_order_relaxed);
+				}
+			}, "Ring");
+			auto ring = std::make_shared<ShmRing>();
+			ring->map = map;
+			ring->hdr = static_cast<RingHeader*>(map->base);
+			ring->data = static_cast<char*>(map->base) + kRingDataOffset;
+			ring->mask = ring->hdr->slots - 1;
+			if (map->size < kRingDataOffset + static_cast<size_t>(ring->hdr->slots) * ring->hdr->slotStride) {
+				throw std::runtime_error("Ring: shared memory '" + name.substr(1) + "' is truncated");
+			}
+			if (explicitGeometry && (ring->hdr->slots != slots || ring->hdr->slotSize != slotSize)) {
+				throw std::runtime_error("Ring: '" + name.substr(1) + "' already exists with " + std::to_string(ring->hdr->slots) +
+					" slots of " + std::to_string(ring->hdr->slotSize) + " bytes");
+			}
+			auto inst = thisInstance(clos);
+			inst->fields["name"] = Value{ name.substr(1) };
+			inst->fields["slots"] = Value{ static_cast<double>(ring->hdr->slots) };
+			inst->fields["slotSize"] = Value{ static_cast<double>(ring->hdr->slotSize) };
+			attach(inst, new RingHandle{ ring });
+			return Value{ std::monostate{} };
+#endif
+		});
+#ifndef _WIN32
+		// push(msg) -> bool：非阻塞，满时返回 false
+		addMethod(ringClass, "push", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			auto ring = ringOf(clos, "ring.push");
+			const std::string& msg = messageArg(args, *ring, "ring.push");
+			return Value{ ring->tryPush(msg.data(), msg.size()) };
+		});
+		// pop() -> string|null：非阻塞
+		addMethod(ringClass, "pop", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto ring = ringOf(clos, "ring.pop");
+			std::string out;
+			if (!ring->tryPop(out)) return Value{ std::monostate{} };
+			return Value{ std::move(out) };
+		});
+		// send(msg[, timeoutMs]) -> Promise<bool>：满时在后台线程上等待空位
+		addMethod(ringClass, "send", [interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			auto ring = ringOf(clos, "ring.send");
+			std::string msg = messageArg(args, *ring, "ring.send");
+			long timeout = timeoutArg(args, 1, "ring.send timeout");
+			auto p = interpPtr->createPromise();
+			if (ring->tryPush(msg.data(), msg.size())) { interpPtr->resolve(p, Value{ true }); return Value{ p }; }
+			if (timeout == 0) { interpPtr->resolve(p, Value{ false }); return Value{ p }; }
+			std::thread([interpPtr, p, ring, msg, timeout]{
+				bool ok = ShmRing::waitUntil(ring->hdr->spaceSeq, ring->hdr->spaceWaiters, timeout, [&]{ return ring->tryPush(msg.data(), msg.size()); });
+				interpPtr->resolve(p, Value{ ok });
+			}).detach();
+			return Value{ p };
+		});
+		// receive([timeoutMs]) -> Promise<string|null>：空时在后台线程上等待，超时得到 null
+		addMethod(ringClass, "receive", [interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			auto ring = ringOf(clos, "ring.receive");
+			long timeout = timeoutArg(args, 0, "ring.receive timeout");
+			auto p = interpPtr->createPromise();
+			std::string out;
+			if (ring->tryPop(out)) { interpPtr->resolve(p, Value{ std::move(out) }); return Value{ p }; }
+			if (timeout == 0) { interpPtr->resolve(p, Value{ std::monostate{} }); return Value{ p }; }
+			std::thread([interpPtr, p, ring, timeout]{
+				std::string msg;
+				bool ok = ShmRing::waitUntil(ring->hdr->dataSeq, ring->hdr->dataWaiters, timeout, [&]{ return ring->tryPop(msg); });
+				interpPtr->resolve(p, ok ? Value{ std::move(msg) } : Value{ std::monostate{} });
+			}).detach();
+			return Value{ p };
+		});
+		addMethod(ringClass, "size", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return Value{ static_cast<double>(ringOf(clos, "ring.size")->size()) };
+		});
+		// close()：解除本进程的映射 (区域本身保留，直到 shm.unlink)
+		addMethod(ringClass, "close", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			handleOf<RingHandle>(clos, "ring.close")->ring.reset();
+			return Value{ std::monostate{} };
+		});
+#endif
+
+		// ---- Counter(name[, initial]) ----
+		auto counterClass = std::make_shared<ClassInfo>(); counterClass->name = "Counter"; counterClass->isNative = true;
+		addMethod(counterClass, "constructor", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+#ifdef _WIN32
+			throw std::runtime_error("std.shm is not supported on this platform");
+#else
+			if (args.empty() || args.size() > 2) throw std::runtime_error("Counter expects (name[, initial])");
+			std::string name = regionName(toString(args[0]), "Counter");
+			int64_t initial = args.size() == 2 ? integerArg(args[1], "Counter initial") : 0;
+			auto map = openRegion(name, true, sizeof(CounterHeader), kCounterMagic, [&](void* base) {
+				auto* h = new (base) CounterHeader();
+				h->version = kLayoutVersion;
+				h->value.store(initial, std::memory_order_relaxed);
+			}, "Counter");
+			auto inst = thisInstance(clos);
+			inst->fields["name"] = Value{ name.substr(1) };
+			attach(inst, new CounterHandle{ map, static_cast<CounterHeader*>(map->base) });
+			return Value{ std::monostate{} };
+#endif
+		});
+		auto num = [](int64_t v) { return Value{ static_cast<double>(v) }; };
+		addMethod(counterClass, "get", [num](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return num(counterOf(clos, "counter.get")->hdr->value.load());
+		});
+		addMethod(counterClass, "set", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("counter.set expects (value)");
+			counterOf(clos, "counter.set")->hdr->value.store(integerArg(args[0], "counter.set"));
+			return Value{ std::monostate{} };
+		});
+		// add/increment/decrement 返回更新后的值
+		addMethod(counterClass, "add", [num](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("counter.add expects (delta)");
+			int64_t d = integerArg(args[0], "counter.add");
+			return num(counterOf(clos, "counter.add")->hdr->value.fetch_add(d) + d);
+		});
+		addMethod(counterClass, "increment", [num](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return num(counterOf(clos, "counter.increment")->hdr->value.fetch_add(1) + 1);
+		});
+		addMethod(counterClass, "decrement", [num](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return num(counterOf(clos, "counter.decrement")->hdr->value.fetch_sub(1) - 1);
+		});
+		addMethod(counterClass, "exchange", [num](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("counter.exchange expects (value)");
+			return num(counterOf(clos, "counter.exchange")->hdr->value.exchange(integerArg(args[0], "counter.exchange")));
+		});
+		addMethod(counterClass, "compareAndSet", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 2) throw std::runtime_error("counter.compareAndSet expects (expected, value)");
+			int64_t expected = integerArg(args[0], "counter.compareAndSet expected");
+			int64_t desired = integerArg(args[1], "counter.compareAndSet value");
+			return Value{ counterOf(clos, "counter.compareAndSet")->hdr->value.compare_exchange_strong(expected, desired) };
+		});
+		addMethod(counterClass, "close", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto h = handleOf<CounterHandle>(clos, "counter.close");
+			h->hdr = nullptr;
+			h->map.reset();
+			return Value{ std::monostate{} };
+		});
+
+		// unlink(name) -> bool：删除命名区域；已映射的进程仍可继续使用直到关闭
+		auto unlinkFn = std::make_shared<Function>();
+		unlinkFn->isBuiltin = true;
+		unlinkFn->builtin = [](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			if (args.size() != 1) throw std::runtime_error("shm.unlink expects (name)");
+#ifdef _WIN32
+			return Value{ false };
+#else
+			return Value{ shm_unlink(regionName(toString(args[0]), "shm.unlink").c_str()) == 0 };
+#endif
+		};
+
+		(*pkg)["Ring"] = ringClass;
+		(*pkg)["Counter"] = counterClass;
+		(*pkg)["unlink"] = Value{ unlinkFn };
+#ifdef _WIN32
+		(*pkg)["available"] = Value{ false };
+#else
+		(*pkg)["available"] = Value{ true };
+#endif
+	});
+}
+
+PackageMeta getStdShmPackageMeta() {
+	PackageMeta pkg;
+	pkg.name = "std.shm";
+	pkg.exports = { "unlink", "available" };
+
+	ClassMeta ringClass;
+	ringClass.name = "Ring";
+	ringClass.methods = { {"constructor"}, {"push"}, {"pop"}, {"send"}, {"receive"}, {"size"}, {"close"} };
+	pkg.classes.push_back(ringClass);
+
+	ClassMeta counterClass;
+	counterClass.name = "Counter";
+	counterClass.methods = { {"constructor"}, {"get"}, {"set"}, {"add"}, {"increment"}, {"decrement"}, {"exchange"}, {"compareAndSet"}, {"close"} };
+	pkg.classes.push_back(counterClass);
+
+	return pkg;
+}
+
+} // namespace asul
@@ -0,0 +1,16 @@
+#ifndef STD_SHM_H
+#define STD_SHM_H
+
+#include "../../PackageMeta.h"
+
+namespace asul {
+
+class Interpreter;
+
+// Register the std.shm package (named shared-memory Ring / Counter for inter-process messaging) with the interpreter
+void registerStdShmPackage(Interpreter& interp);
+PackageMeta getStdShmPackageMeta();
+
+} // namespace asul
+
+#endif // STD_SHM_H
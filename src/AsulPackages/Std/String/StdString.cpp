@@ -15,9 +15,7 @@ void registerStdStringPackage(Interpreter& interp) {
 			if (args.size() != 1 || !std::holds_alternative<std::string>(args[0])) {
 				throw std::runtime_error("toUpperCase 需要 1 个字符串参数");
 			}
-			std::string input = std::get<std::string>(args[0]);
-			std::transform(input.begin(), input.end(), input.begin(), ::toupper);
-			return Value{input};
+			return Value{strops::toUpperAscii(std::get<std::string>(args[0]))};
 		};
 		(*stringPkg)["toUpperCase"] = Value{toUpperCaseFn};
 
@@ -28,9 +26,7 @@ void registerStdStringPackage(Interpreter& interp) {
 			if (args.size() != 1 || !std::holds_alternative<std::string>(args[0])) {
 				throw std::runtime_error("toLowerCase 需要 1 个字符串参数");
 			}
-			std::string input = std::get<std::string>(args[0]);
-			std::transform(input.begin(), input.end(), input.begin(), ::tolower);
-			return Value{input};
+			return Value{strops::toLowerAscii(std::get<std::string>(args[0]))};
 		};
 		(*stringPkg)["toLowerCase"] = Value{toLowerCaseFn};
 
@@ -41,13 +37,13 @@ void registerStdStringPackage(Interpreter& interp) {
 			if (args.size() != 1 || !std::holds_alternative<std::string>(args[0])) {
 				throw std::runtime_error("trim 需要 1 个字符串参数");
 			}
-			std::string input = std::get<std::string>(args[0]);
-			auto start = input.find_first_not_of(" \t\n\r");
-			auto end = input.find_last_not_of(" \t\n\r");
-			if (start == std::string::npos || end == std::string::npos) {
+			const std::string& input = std::get<std::string>(args[0]);
+			size_t start = strops::skipSpaceForward(input);
+			size_t end = strops::skipSpaceBackward(input, input.size());
+			if (end <= start) {
 				return Value{std::string("")};
 			}
-			return Value{input.substr(start, end - start + 1)};
+			return Value{input.substr(start, end - start)};
 		};
 		(*stringPkg)["trim"] = Value{trimFn};
 
@@ -59,24 +55,7 @@ void registerStdStringPackage(Interpreter& interp) {
 			    !std::holds_alternative<std::string>(args[1]) || !std::holds_alternative<std::string>(args[2])) {
 				throw std::runtime_error("replaceAll 需要 3 个字符串参数 (str, search, replacement)");
 			}
-			std::string str = std::get<std::string>(args[0]);
-			std::string search = std::get<std::string>(args[1]);
-			std::string replacement = std::get<std::string>(args[2]);
-			
-			if (search.empty()) {
-				return Value{str};
-			}
-			
-			std::string result;
-			size_t pos = 0;
-			size_t lastPos = 0;
-			while ((pos = str.find(search, lastPos)) != std::string::npos) {
-				result.append(str, lastPos, pos - lastPos);
-				result.append(replacement);
-				lastPos = pos + search.length();
-			}
-			result.append(str, lastPos, str.length() - lastPos);
-			return Value{result};
+			return Value{strops::replaceAll(std::get<std::string>(args[0]), std::get<std::string>(args[1]), std::get<std::string>(args[2]))};
 		};
 		(*stringPkg)["replaceAll"] = Value{replaceAllFn};
 
@@ -0,0 +1,523 @@
+#include "StdSync.h"
+#include "../../../AsulInterpreter.h"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+
+namespace asul {
+
+namespace {
+
+// ----------- 等待队列 -----------
+// 获取不到时把 grant 回调排队，释放方按 FIFO 直接把所有权交给队首，不会出现插队饥饿。
+// grant 通常只是 resolve 一个 Promise：await 它的协程由事件循环恢复，线程本身从不阻塞。
+
+using Grant = std::function<void()>;
+
+struct NativeMutex {
+	std::mutex m;
+	bool locked{false};
+	std::deque<Grant> waiters;
+
+	bool tryAcquire() {
+		std::lock_guard<std::mutex> lk(m);
+		if (locked) return false;
+		locked = true;
+		return true;
+	}
+	void acquire(Grant g) {
+		{
+			std::lock_guard<std::mutex> lk(m);
+			if (locked) { waiters.push_back(std::move(g)); return; }
+			locked = true;
+		}
+		g();
+	}
+	void release() {
+		Grant next;
+		{
+			std::lock_guard<std::mutex> lk(m);
+			if (!locked) throw std::runtime_error("mutex.unlock: mutex is not locked");
+			if (waiters.empty()) { locked = false; return; }
+			next = std::move(waiters.front());
+			waiters.pop_front();
+		}
+		next();
+	}
+};
+
+struct NativeSemaphore {
+	std::mutex m;
+	int64_t permits{0};
+	std::deque<Grant> waiters;
+
+	bool tryAcquire() {
+		std::lock_guard<std::mutex> lk(m);
+		if (permits <= 0) return false;
+		--permits;
+		return true;
+	}
+	void acquire(Grant g) {
+		{
+			std::lock_guard<std::mutex> lk(m);
+			if (permits <= 0 || !waiters.empty()) { waiters.push_back(std::move(g)); return; }
+			--permits;
+		}
+		g();
+	}
+	void release() {
+		Grant next;
+		{
+			std::lock_guard<std::mutex> lk(m);
+			if (waiters.empty()) { ++permits; return; }
+			next = std::move(waiters.front());
+			waiters.pop_front();
+		}
+		next();
+	}
+};
+
+// 读者可并发，写者独占；队首是写者时后来的读者也排队，避免写者饿死
+struct NativeRWLock {
+	std::mutex m;
+	int64_t readers{0};
+	bool writer{false};
+	std::deque<std::pair<bool, Grant>> waiters; // first: 是否写者
+
+	bool tryRead() {
+		std::lock_guard<std::mutex> lk(m);
+		if (writer || !waiters.empty()) return false;
+		++readers;
+		return true;
+	}
+	bool tryWrite() {
+		std::lock_guard<std::mutex> lk(m);
+		if (writer || readers || !waiters.empty()) return false;
+		writer = true;
+		return true;
+	}
+	void acquire(bool write, Grant g) {
+		{
+			std::lock_guard<std::mutex> lk(m);
+			bool free = write ? (!writer && readers == 0 && waiters.empty()) : (!writer && waiters.empty());
+			if (!free) { waiters.emplace_back(write, std::move(g)); return; }
+			if (write) writer = true; else ++readers;
+		}
+		g();
+	}
+	void release(bool write) {
+		std::vector<Grant> ready;
+		{
+			std::lock_guard<std::mutex> lk(m);
+			if (write) {
+				if (!writer) throw std::runtime_error("rwlock.writeUnlock: not write-locked");
+				writer = false;
+			} else {
+				if (readers == 0) throw std::runtime_error("rwlock.readUnlock: not read-locked");
+				--readers;
+			}
+			while (!waiters.empty() && !writer) {
+				auto& front = waiters.front();
+				if (front.first) {
+					if (readers) break;
+					writer = true;
+				} else {
+					++readers;
+				}
+				ready.push_back(std::move(front.second));
+				waiters.pop_front();
+			}
+		}
+		for (auto& g : ready) g();
+	}
+};
+
+struct NativeWaitGroup {
+	std::mutex m;
+	int64_t counter{0};
+	std::vector<Grant> waiters;
+
+	void add(int64_t delta) {
+		std::vector<Grant> ready;
+		{
+			std::lock_guard<std::mutex> lk(m);
+			if (counter + delta < 0) throw std::runtime_error("waitGroup: counter would become negative");
+			counter += delta;
+			if (counter == 0) ready.swap(waiters);
+		}
+		for (auto& g : ready) g();
+	}
+	void wait(Grant g) {
+		{
+			std::lock_guard<std::mutex> lk(m);
+			if (counter != 0) { waiters.push_back(std::move(g)); return; }
+		}
+		g();
+	}
+};
+
+struct NativeOnce {
+	std::mutex m;
+	bool done{false};
+	Value result{std::monostate{}};
+};
+
+struct NativeAtomicInt {
+	std::atomic<int64_t> value{0};
+};
+
+using NativeFn = std::function<Value(const std::vector<Value>&, std::shared_ptr<Environment>)>;
+
+void addMethod(const std::shared_ptr<ClassInfo>& klass, const char* name, NativeFn fn) {
+	auto f = std::make_shared<Function>();
+	f->isBuiltin = true;
+	f->builtin = std::move(fn);
+	klass->methods[name] = f;
+}
+
+InstanceExt* thisInstance(const std::shared_ptr<Environment>& clos) {
+	if (!clos) throw std::runtime_error("internal: instance method called without closure");
+	Value tv = clos->get("this");
+	auto pins = std::get_if<std::shared_ptr<Instance>>(&tv);
+	if (!pins || !*pins) throw std::runtime_error("internal: invalid 'this' value");
+	return static_cast<InstanceExt*>(pins->get());
+}
+
+template <typename T>
+T* handleOf(const std::shared_ptr<Environment>& clos, const char* what) {
+	auto h = static_cast<T*>(thisInstance(clos)->nativeHandle);
+	if (!h) throw std::runtime_error(std::string(what) + ": native handle missing");
+	return h;
+}
+
+template <typename T>
+void attach(InstanceExt* inst, T* handle) {
+	inst->nativeHandle = handle;
+	inst->nativeDestructor = [](void* p) { delete static_cast<T*>(p); };
+}
+
+int64_t integerArg(const Value& v, const char* what) {
+	double d = getNumber(v, what);
+	if (std::floor(d) != d || std::fabs(d) > 9007199254740991.0) throw std::runtime_error(std::string(what) + ": expected an integer");
+	return static_cast<int64_t>(d);
+}
+
+const Value& functionArg(const std::vector<Value>& args, const char* what) {
+	if (args.size() != 1 || !std::holds_alternative<std::shared_ptr<Function>>(args[0])) throw std::runtime_error(std::string(what) + " expects a function");
+	return args[0];
+}
+
+// p 完成后在事件循环上执行 fn（p 可能由其他线程 settle）
+void whenSettled(Interpreter* interp, const std::shared_ptr<PromiseState>& p, Grant fn) {
+	{
+		std::lock_guard<std::mutex> lk(p->mtx);
+		if (!p->settled) {
+			p->waiters.push_back([interp, fn]{ interp->postTask(fn); });
+			return;
+		}
+	}
+	interp->postTask(std::move(fn));
+}
+
+// 返回一个在获得许可时 resolve 的 Promise
+Value acquirePromise(Interpreter* interp, const std::function<void(Grant)>& acquire) {
+	auto p = interp->createPromise();
+	acquire([interp, p]{ interp->resolve(p, Value{std::monostate{}}); });
+	return Value{p};
+}
+
+// 获得许可后执行 fn；fn 返回 Promise 时等它完成再释放。结果（或异常）经返回的 Promise 传出
+Value runGuarded(Interpreter* interp, const Value& fn, const std::function<void(Grant)>& acquire, Grant release) {
+	auto result = interp->createPromise();
+	acquire([interp, fn, release, result]{
+		interp->postTask([interp, fn, release, result]{
+			Value r;
+			try {
+				r = interp->callValue(fn, {});
+			} catch (const ExceptionSignal& ex) {
+				release();
+				interp->reject(result, ex.value);
+				return;
+			} catch (const std::exception& ex) {
+				release();
+				interp->reject(result, Value{ std::string(ex.what()) });
+				return;
+			}
+			auto inner = std::get_if<std::shared_ptr<PromiseState>>(&r);
+			if (inner && *inner) {
+				auto q = *inner;
+				whenSettled(interp, q, [interp, q, release, result]{
+					release();
+					interp->settlePromise(result, q->rejected, q->result);
+				});
+				return;
+			}
+			release();
+			interp->resolve(result, r);
+		});
+	});
+	return Value{result};
+}
+
+} // namespace
+
+void registerStdSyncPackage(Interpreter& interp) {
+	Interpreter* interpPtr = &interp;
+	interp.registerLazyPackage("std.sync", [interpPtr](std::shared_ptr<Object> pkg) {
+		// ---- Mutex ----
+		auto mutexClass = std::make_shared<ClassInfo>(); mutexClass->name = "Mutex"; mutexClass->isNative = true;
+		addMethod(mutexClass, "constructor", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			attach(thisInstance(clos), new NativeMutex());
+			return Value{ std::monostate{} };
+		});
+		addMethod(mutexClass, "lock", [interpPtr](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto mu = handleOf<NativeMutex>(clos, "mutex.lock");
+			return acquirePromise(interpPtr, [mu](Grant g){ mu->acquire(std::move(g)); });
+		});
+		addMethod(mutexClass, "tryLock", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return Value{ handleOf<NativeMutex>(clos, "mutex.tryLock")->tryAcquire() };
+		});
+		addMethod(mutexClass, "unlock", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			handleOf<NativeMutex>(clos, "mutex.unlock")->release();
+			return Value{ std::monostate{} };
+		});
+		addMethod(mutexClass, "isLocked", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto mu = handleOf<NativeMutex>(clos, "mutex.isLocked");
+			std::lock_guard<std::mutex> lk(mu->m);
+			return Value{ mu->locked };
+		});
+		addMethod(mutexClass, "withLock", [interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			const Value& fn = functionArg(args, "mutex.withLock");
+			auto self = std::get<std::shared_ptr<Instance>>(clos->get("this")); // 保持实例存活直到释放
+			auto mu = handleOf<NativeMutex>(clos, "mutex.withLock");
+			return runGuarded(interpPtr, fn, [mu](Grant g){ mu->acquire(std::move(g)); }, [self, mu]{ mu->release(); });
+		});
+
+		// ---- RWLock ----
+		auto rwClass = std::make_shared<ClassInfo>(); rwClass->name = "RWLock"; rwClass->isNative = true;
+		addMethod(rwClass, "constructor", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			attach(thisInstance(clos), new NativeRWLock());
+			return Value{ std::monostate{} };
+		});
+		addMethod(rwClass, "readLock", [interpPtr](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto rw = handleOf<NativeRWLock>(clos, "rwlock.readLock");
+			return acquirePromise(interpPtr, [rw](Grant g){ rw->acquire(false, std::move(g)); });
+		});
+		addMethod(rwClass, "writeLock", [interpPtr](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto rw = handleOf<NativeRWLock>(clos, "rwlock.writeLock");
+			return acquirePromise(interpPtr, [rw](Grant g){ rw->acquire(true, std::move(g)); });
+		});
+		addMethod(rwClass, "tryReadLock", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return Value{ handleOf<NativeRWLock>(clos, "rwlock.tryReadLock")->tryRead() };
+		});
+		addMethod(rwClass, "tryWriteLock", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return Value{ handleOf<NativeRWLock>(clos, "rwlock.tryWriteLock")->tryWrite() };
+		});
+		addMethod(rwClass, "readUnlock", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			handleOf<NativeRWLock>(clos, "rwlock.readUnlock")->release(false);
+			return Value{ std::monostate{} };
+		});
+		addMethod(rwClass, "writeUnlock", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			handleOf<NativeRWLock>(clos, "rwlock.writeUnlock")->release(true);
+			return Value{ std::monostate{} };
+		});
+		addMethod(rwClass, "withRead", [interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			const Value& fn = functionArg(args, "rwlock.withRead");
+			auto self = std::get<std::shared_ptr<Instance>>(clos->get("this"));
+			auto rw = handleOf<NativeRWLock>(clos, "rwlock.withRead");
+			return runGuarded(interpPtr, fn, [rw](Grant g){ rw->acquire(false, std::move(g)); }, [self, rw]{ rw->release(false); });
+		});
+		addMethod(rwClass, "withWrite", [interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			const Value& fn = functionArg(args, "rwlock.withWrite");
+			auto self = std::get<std::shared_ptr<Instance>>(clos->get("this"));
+			auto rw = handleOf<NativeRWLock>(clos, "rwlock.withWrite");
+			return runGuarded(interpPtr, fn, [rw](Grant g){ rw->acquire(true, std::move(g)); }, [self, rw]{ rw->release(true); });
+		});
+
+		// ---- Semaphore(permits) ----
+		auto semClass = std::make_shared<ClassInfo>(); semClass->name = "Semaphore"; semClass->isNative = true;
+		addMethod(semClass, "constructor", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("Semaphore expects (permits)");
+			int64_t n = integerArg(args[0], "Semaphore permits");
+			if (n < 0) throw std::runtime_error("Semaphore: permits must be >= 0");
+			auto sem = new NativeSemaphore();
+			sem->permits = n;
+			attach(thisInstance(clos), sem);
+			return Value{ std::monostate{} };
+		});
+		addMethod(semClass, "acquire", [interpPtr](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto sem = handleOf<NativeSemaphore>(clos, "semaphore.acquire");
+			return acquirePromise(interpPtr, [sem](Grant g){ sem->acquire(std::move(g)); });
+		});
+		addMethod(semClass, "tryAcquire", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return Value{ handleOf<NativeSemaphore>(clos, "semaphore.tryAcquire")->tryAcquire() };
+		});
+		addMethod(semClass, "release", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			handleOf<NativeSemaphore>(clos, "semaphore.release")->release();
+			return Value{ std::monostate{} };
+		});
+		addMethod(semClass, "available", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto sem = handleOf<NativeSemaphore>(clos, "semaphore.available");
+			std::lock_guard<std::mutex> lk(sem->m);
+			return Value{ static_cast<double>(sem->permits) };
+		});
+		addMethod(semClass, "waiting", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto sem = handleOf<NativeSemaphore>(clos, "semaphore.waiting");
+			std::lock_guard<std::mutex> lk(sem->m);
+			return Value{ static_cast<double>(sem->waiters.size()) };
+		});
+		// run(fn)：限流执行，最多 permits 个 fn 同时在途
+		addMethod(semClass, "run", [interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			const Value& fn = functionArg(args, "semaphore.run");
+			auto self = std::get<std::shared_ptr<Instance>>(clos->get("this"));
+			auto sem = handleOf<NativeSemaphore>(clos, "semaphore.run");
+			return runGuarded(interpPtr, fn, [sem](Grant g){ sem->acquire(std::move(g)); }, [self, sem]{ sem->release(); });
+		});
+
+		// ---- WaitGroup ----
+		auto wgClass = std::make_shared<ClassInfo>(); wgClass->name = "WaitGroup"; wgClass->isNative = true;
+		addMethod(wgClass, "constructor", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			attach(thisInstance(clos), new NativeWaitGroup());
+			return Value{ std::monostate{} };
+		});
+		addMethod(wgClass, "add", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() > 1) throw std::runtime_error("waitGroup.add expects ([delta])");
+			handleOf<NativeWaitGroup>(clos, "waitGroup.add")->add(args.empty() ? 1 : integerArg(args[0], "waitGroup.add delta"));
+			return Value{ std::monostate{} };
+		});
+		addMethod(wgClass, "done", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			handleOf<NativeWaitGroup>(clos, "waitGroup.done")->add(-1);
+			return Value{ std::monostate{} };
+		});
+		addMethod(wgClass, "wait", [interpPtr](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto wg = handleOf<NativeWaitGroup>(clos, "waitGroup.wait");
+			return acquirePromise(interpPtr, [wg](Grant g){ wg->wait(std::move(g)); });
+		});
+		addMethod(wgClass, "count", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto wg = handleOf<NativeWaitGroup>(clos, "waitGroup.count");
+			std::lock_guard<std::mutex> lk(wg->m);
+			return Value{ static_cast<double>(wg->counter) };
+		});
+
+		// ---- Once ----
+		auto onceClass = std::make_shared<ClassInfo>(); onceClass->name = "Once"; onceClass->isNative = true;
+		addMethod(onceClass, "constructor", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			attach(thisInstance(clos), new NativeOnce());
+			return Value{ std::monostate{} };
+		});
+		// run(fn)：只有第一次调用执行 fn，之后都返回第一次的结果（async fn 返回的是同一个 Promise）
+		addMethod(onceClass, "run", [interpPtr](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			const Value& fn = functionArg(args, "once.run");
+			auto once = handleOf<NativeOnce>(clos, "once.run");
+			{
+				std::lock_guard<std::mutex> lk(once->m);
+				if (once->done) return once->result;
+				once->done = true;
+			}
+			Value r = interpPtr->callValue(fn, {});
+			std::lock_guard<std::mutex> lk(once->m);
+			once->result = r;
+			return r;
+		});
+		addMethod(onceClass, "isDone", [](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			auto once = handleOf<NativeOnce>(clos, "once.isDone");
+			std::lock_guard<std::mutex> lk(once->m);
+			return Value{ once->done };
+		});
+
+		// ---- AtomicInt ----
+		auto atomicClass = std::make_shared<ClassInfo>(); atomicClass->name = "AtomicInt"; atomicClass->isNative = true;
+		addMethod(atomicClass, "constructor", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() > 1) throw std::runtime_error("AtomicInt expects ([initial])");
+			auto a = new NativeAtomicInt();
+			if (!args.empty()) {
+				try { a->value = integerArg(args[0], "AtomicInt initial"); } catch (...) { delete a; throw; }
+			}
+			attach(thisInstance(clos), a);
+			return Value{ std::monostate{} };
+		});
+		auto num = [](int64_t v) { return Value{ static_cast<double>(v) }; };
+		addMethod(atomicClass, "get", [num](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return num(handleOf<NativeAtomicInt>(clos, "atomicInt.get")->value.load());
+		});
+		addMethod(atomicClass, "set", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("atomicInt.set expects (value)");
+			handleOf<NativeAtomicInt>(clos, "atomicInt.set")->value.store(integerArg(args[0], "atomicInt.set"));
+			return Value{ std::monostate{} };
+		});
+		// add/sub/increment/decrement 返回更新后的值
+		addMethod(atomicClass, "add", [num](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("atomicInt.add expects (delta)");
+			int64_t d = integerArg(args[0], "atomicInt.add");
+			return num(handleOf<NativeAtomicInt>(clos, "atomicInt.add")->value.fetch_add(d) + d);
+		});
+		addMethod(atomicClass, "sub", [num](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("atomicInt.sub expects (delta)");
+			int64_t d = integerArg(args[0], "atomicInt.sub");
+			return num(handleOf<NativeAtomicInt>(clos, "atomicInt.sub")->value.fetch_sub(d) - d);
+		});
+		addMethod(atomicClass, "increment", [num](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return num(handleOf<NativeAtomicInt>(clos, "atomicInt.increment")->value.fetch_add(1) + 1);
+		});
+		addMethod(atomicClass, "decrement", [num](const std::vector<Value>&, std::shared_ptr<Environment> clos)->Value {
+			return num(handleOf<NativeAtomicInt>(clos, "atomicInt.decrement")->value.fetch_sub(1) - 1);
+		});
+		addMethod(atomicClass, "exchange", [num](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 1) throw std::runtime_error("atomicInt.exchange expects (value)");
+			return num(handleOf<NativeAtomicInt>(clos, "atomicInt.exchange")->value.exchange(integerArg(args[0], "atomicInt.exchange")));
+		});
+		addMethod(atomicClass, "compareAndSet", [](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			if (args.size() != 2) throw std::runtime_error("atomicInt.compareAndSet expects (expected, value)");
+			int64_t expected = integerArg(args[0], "atomicInt.compareAndSet expected");
+			int64_t desired = integerArg(args[1], "atomicInt.compareAndSet value");
+			return Value{ handleOf<NativeAtomicInt>(clos, "atomicInt.compareAndSet")->value.compare_exchange_strong(expected, desired) };
+		});
+
+		(*pkg)["Mutex"] = mutexClass;
+		(*pkg)["RWLock"] = rwClass;
+		(*pkg)["Semaphore"] = semClass;
+		(*pkg)["WaitGroup"] = wgClass;
+		(*pkg)["Once"] = onceClass;
+		(*pkg)["AtomicInt"] = atomicClass;
+	});
+}
+
+PackageMeta getStdSyncPackageMeta() {
+	PackageMeta pkg;
+	pkg.name = "std.sync";
+
+	ClassMeta mutexClass;
+	mutexClass.name = "Mutex";
+	mutexClass.methods = { {"constructor"}, {"lock"}, {"tryLock"}, {"unlock"}, {"isLocked"}, {"withLock"} };
+	pkg.classes.push_back(mutexClass);
+
+	ClassMeta rwClass;
+	rwClass.name = "RWLock";
+	rwClass.methods = { {"constructor"}, {"readLock"}, {"writeLock"}, {"tryReadLock"}, {"tryWriteLock"}, {"readUnlock"}, {"writeUnlock"}, {"withRead"}, {"withWrite"} };
+	pkg.classes.push_back(rwClass);
+
+	ClassMeta semClass;
+	semClass.name = "Semaphore";
+	semClass.methods = { {"constructor"}, {"acquire"}, {"tryAcquire"}, {"release"}, {"available"}, {"waiting"}, {"run"} };
+	pkg.classes.push_back(semClass);
+
+	ClassMeta wgClass;
+	wgClass.name = "WaitGroup";
+	wgClass.methods = { {"constructor"}, {"add"}, {"done"}, {"wait"}, {"count"} };
+	pkg.classes.push_back(wgClass);
+
+	ClassMeta onceClass;
+	onceClass.name = "Once";
+	onceClass.methods = { {"constructor"}, {"run"}, {"isDone"} };
+	pkg.classes.push_back(onceClass);
+
+	ClassMeta atomicClass;
+	atomicClass.name = "AtomicInt";
+	atomicClass.methods = { {"constructor"}, {"get"}, {"set"}, {"add"}, {"sub"}, {"increment"}, {"decrement"}, {"exchange"}, {"compareAndSet"} };
+	pkg.classes.push_back(atomicClass);
+
+	return pkg;
+}
+
+} // namespace asul
@@ -0,0 +1,16 @@
+#ifndef STD_SYNC_H
+#define STD_SYNC_H
+
+#include "../../PackageMeta.h"
+
+namespace asul {
+
+class Interpreter;
+
+// Register the std.sync package (Mutex / RWLock / Semaphore / WaitGroup / Once / AtomicInt) with the interpreter
+void registerStdSyncPackage(Interpreter& interp);
+PackageMeta getStdSyncPackageMeta();
+
+} // namespace asul
+
+#endif // STD_SYNC_H
@@ -0,0 +1,567 @@
+#include "StdTemplate.h"
+#include "../../../AsulInterpreter.h"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace asul {
+
+namespace {
+
+// ----------- 编译结果 -----------
+// 模板源码只解析一次，得到扁平的指令表：字面文本全部拼进 text，变量路径预先按 '.' 切好。
+// 区块 (#/^) 与对应的 End 互相记录下标，渲染时循环靠跳转完成，不再重新扫描源码。
+struct Instr {
+	enum Op : uint8_t { Text, Var, Raw, Section, Inverted, End, Partial };
+	Op op;
+	uint32_t a{0}; // Text: text 偏移；Var/Raw/Section/Inverted: 路径下标；End: 起始指令下标；Partial: 名字下标
+	uint32_t b{0}; // Text: 长度；Section/Inverted: 对应 End 的下标
+};
+
+struct Program {
+	std::string source;
+	std::string text;
+	std::vector<std::vector<std::string>> paths; // 空路径表示 {{.}}
+	std::vector<std::string> names; // partial 名
+	std::vector<Instr> code;
+	bool escape{true};
+	std::shared_ptr<Object> partials; // compile 时给出的 partials
+};
+
+using ProgramPtr = std::shared_ptr<const Program>;
+
+bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+std::string trimmed(const std::string& s, size_t from, size_t to) {
+	while (from < to && std::isspace(static_cast<unsigned char>(s[from]))) ++from;
+	while (to > from && std::isspace(static_cast<unsigned char>(s[to - 1]))) --to;
+	return s.substr(from, to - from);
+}
+
+int lineOf(const std::string& s, size_t pos) {
+	return 1 + static_cast<int>(std::count(s.begin(), s.begin() + static_cast<std::ptrdiff_t>(pos), '\n'));
+}
+
+ProgramPtr compileProgram(const std::string& src, bool escape) {
+	auto prog = std::make_shared<Program>();
+	prog->source = src;
+	prog->escape = escape;
+	struct OpenSection { uint32_t index; size_t at; std::string name; };
+	std::vector<OpenSection> open;
+	auto emitText = [&](size_t from, size_t to) {
+		if (to <= from) return;
+		auto& last = prog->code;
+		// 相邻文本合并为一条指令
+		if (!last.empty() && last.back().op == Instr::Text && last.back().a + last.back().b == prog->text.size()) {
+			last.back().b += static_cast<uint32_t>(to - from);
+		} else {
+			last.push_back({ Instr::Text, static_cast<uint32_t>(prog->text.size()), static_cast<uint32_t>(to - from) });
+		}
+		prog->text.append(src, from, to - from);
+	};
+	auto pathIndex = [&](const std::string& name, size_t at) -> uint32_t {
+		if (name.empty()) throw std::runtime_error("template: empty tag at line " + std::to_string(lineOf(src, at)));
+		std::vector<std::string> parts;
+		if (name != ".") {
+			size_t start = 0;
+			for (;;) {
+				size_t dot = name.find('.', start);
+				parts.push_back(name.substr(start, dot == std::string::npos ? std::string::npos : dot - start));
+				if (parts.back().empty()) throw std::runtime_error("template: invalid name '" + name + "' at line " + std::to_string(lineOf(src, at)));
+				if (dot == std::string::npos) break;
+				start = dot + 1;
+			}
+		}
+		prog->paths.push_back(std::move(parts));
+		return static_cast<uint32_t>(prog->paths.size() - 1);
+	};
+
+	size_t pos = 0;     // 尚未输出的文本起点
+	size_t scan = 0;
+	for (;;) {
+		size_t tag = src.find("{{", scan);
+		if (tag == std::string::npos) break;
+		bool triple = tag + 2 < src.size() && src[tag + 2] == '{';
+		size_t close = src.find(triple ? "}}}" : "}}", tag + (triple ? 3 : 2));
+		if (close == std::string::npos) throw std::runtime_error("template: unclosed tag at line " + std::to_string(lineOf(src, tag)));
+		size_t tagEnd = close + (triple ? 3 : 2);
+		char kind = triple ? '{' : src[tag + 2];
+		bool sigil = triple || (kind != '\0' && std::strchr("&#^/!>", kind));
+		if (!sigil) kind = 0;
+		std::string body = trimmed(src, tag + 2 + (sigil ? 1 : 0), close);
+
+		// 独占一行的区块/注释/partial 标签连同该行的缩进与换行一起去掉
+		size_t textEnd = tag, next = tagEnd;
+		if (kind == '#' || kind == '^' || kind == '/' || kind == '!' || kind == '>') {
+			size_t lineStart = tag;
+			while (lineStart > pos && isBlank(src[lineStart - 1])) --lineStart;
+			bool atLineStart = lineStart == 0 || src[lineStart - 1] == '\n';
+			size_t after = tagEnd;
+			while (after < src.size() && isBlank(src[after])) ++after;
+			bool atLineEnd = after == src.size() || src[after] == '\n' || (src[after] == '\r' && after + 1 < src.size() && src[after + 1] == '\n');
+			if (atLineStart && atLineEnd) {
+				textEnd = lineStart;
+				next = after == src.size() ? after : after + (src[after] == '\r' ? 2 : 1);
+			}
+		}
+		emitText(pos, textEnd);
+		pos = scan = next;
+
+		switch (kind) {
+		case '!': break;
+		case '#': case '^': {
+			uint32_t idx = static_cast<uint32_t>(prog->code.size());
+			prog->code.push_back({ kind == '#' ? Instr::Section : Instr::Inverted, pathIndex(body, tag), 0 });
+			open.push_back({ idx, tag, body });
+			break;
+		}
+		case '/': {
+			if (open.empty()) throw std::runtime_error("template: unexpected closing tag '" + body + "' at line " + std::to_string(lineOf(src, tag)));
+			OpenSection sec = std::move(open.back());
+			open.pop_back();
+			if (sec.name != body) throw std::runtime_error("template: section '" + sec.name + "' closed by '" + body + "' at line " + std::to_string(lineOf(src, tag)));
+			prog->code[sec.index].b = static_cast<uint32_t>(prog->code.size());
+			prog->code.push_back({ Instr::End, sec.index, 0 });
+			break;
+		}
+		case '>': {
+			if (body.empty()) throw std::runtime_error("template: empty partial name at line " + std::to_string(lineOf(src, tag)));
+			prog->names.push_back(body);
+			prog->code.push_back({ Instr::Partial, static_cast<uint32_t>(prog->names.size() - 1), 0 });
+			break;
+		}
+		case '{': case '&':
+			prog->code.push_back({ Instr::Raw, pathIndex(body, tag), 0 });
+			break;
+		default:
+			prog->code.push_back({ escape ? Instr::Var : Instr::Raw, pathIndex(body, tag), 0 });
+			break;
+		}
+	}
+	if (!open.empty()) {
+		throw std::runtime_error("template: unclosed section '" + open.back().name + "' opened at line " + std::to_string(lineOf(src, open.back().at)));
+	}
+	emitText(pos, src.size());
+	return prog;
+}
+
+// ----------- 包级状态 -----------
+// 按源码 (及转义模式) 缓存编译结果；registerPartial 注册的全局 partial
+struct TemplateState {
+	std::unordered_map<std::string, ProgramPtr> cache;
+	std::unordered_map<std::string, ProgramPtr> partials;
+	std::weak_ptr<ClassInfo> templateClass;
+
+	static constexpr size_t kCacheLimit = 512;
+
+	ProgramPtr compile(const std::string& src, bool escape) {
+		std::string key;
+		key.reserve(src.size() + 1);
+		key.push_back(escape ? 'h' : 'n');
+		key += src;
+		auto it = cache.find(key);
+		if (it != cache.end()) return it->second;
+		auto prog = compileProgram(src, escape);
+		if (cache.size() >= kCacheLimit) cache.clear();
+		cache.emplace(std::move(key), prog);
+		return prog;
+	}
+};
+
+struct TemplateHandle {
+	ProgramPtr program;
+};
+
+void appendEscaped(std::string& out, const std::string& s) {
+	size_t start = 0;
+	for (size_t i = 0; i < s.size(); ++i) {
+		const char* rep;
+		switch (s[i]) {
+		case '&': rep = "&amp;"; break;
+		case '<': rep = "&lt;"; break;
+		case '>': rep = "&gt;"; break;
+		case '"': rep = "&quot;"; break;
+		case '\'': rep = "&#39;"; break;
+		default: continue;
+		}
+		out.append(s, start, i - start);
+		out.append(rep);
+		start = i + 1;
+	}
+	out.append(s, start, std::string::npos);
+}
+
+// ----------- 渲染 -----------
+class Renderer {
+public:
+	Renderer(Interpreter* interp, TemplateState& state, std::shared_ptr<Object> partials, std::string& out, std::function<void(std::string&)> flush)
+		: interp(interp), state(state), renderPartials(std::move(partials)), out(out), flush(std::move(flush)) {}
+
+	void run(const Program& prog, const Value& data) {
+		stack.push_back(data);
+		exec(prog);
+		stack.pop_back();
+	}
+
+private:
+	struct Frame {
+		std::shared_ptr<Array> items; // 为空表示非循环区块
+		size_t index{0};
+		bool pushed{false};
+	};
+
+	static constexpr size_t kFlushAt = 64 * 1024;
+	static constexpr int kMaxPartialDepth = 64;
+
+	Interpreter* interp;
+	TemplateState& state;
+	std::shared_ptr<Object> renderPartials;
+	std::string& out;
+	std::function<void(std::string&)> flush;
+	std::vector<Value> stack;
+	std::vector<Frame> frames;
+	int depth{0};
+
+	void exec(const Program& prog) {
+		const auto& code = prog.code;
+		for (size_t pc = 0; pc < code.size();) {
+			const Instr& in = code[pc];
+			switch (in.op) {
+			case Instr::Text:
+				out.append(prog.text, in.a, in.b);
+				if (flush && out.size() >= kFlushAt) flush(out);
+				++pc;
+				break;
+			case Instr::Var:
+			case Instr::Raw: {
+				Value v = resolve(prog.paths[in.a]);
+				appendValue(v, in.op == Instr::Var);
+				if (flush && out.size() >= kFlushAt) flush(out);
+				++pc;
+				break;
+			}
+			case Instr::Section: {
+				Value v = resolve(prog.paths[in.a]);
+				if (auto arr = std::get_if<std::shared_ptr<Array>>(&v)) {
+					if (!*arr || (*arr)->empty()) { pc = in.b + 1; break; }
+					frames.push_back({ *arr, 0, true });
+					stack.push_back((**arr)[0]);
+				} else if (isTruthy(v)) {
+					frames.push_back({ nullptr, 0, true });
+					stack.push_back(v);
+				} else {
+					pc = in.b + 1;
+					break;
+				}
+				++pc;
+				break;
+			}
+			case Instr::Inverted: {
+				Value v = resolve(prog.paths[in.a]);
+				auto arr = std::get_if<std::shared_ptr<Array>>(&v);
+				bool empty = arr ? (!*arr || (*arr)->empty()) : !isTruthy(v);
+				if (!empty) { pc = in.b + 1; break; }
+				frames.push_back({ nullptr, 0, false });
+				++pc;
+				break;
+			}
+			case Instr::End: {
+				Frame& f = frames.back();
+				if (f.items && ++f.index < f.items->size()) {
+					stack.back() = (*f.items)[f.index];
+					pc = in.a + 1;
+					break;
+				}
+				if (f.pushed) stack.pop_back();
+				frames.pop_back();
+				++pc;
+				break;
+			}
+			case Instr::Partial: {
+				auto partial = findPartial(prog, prog.names[in.a]);
+				if (partial) {
+					if (++depth > kMaxPartialDepth) throw std::runtime_error("template: partials nested too deeply (recursive partial '" + prog.names[in.a] + "'?)");
+					exec(*partial);
+					--depth;
+				}
+				++pc;
+				break;
+			}
+			}
+		}
+	}
+
+	// 依次查 render 时的 partials、compile 时的 partials、registerPartial；都没有时输出为空 (与 Mustache 一致)
+	ProgramPtr findPartial(const Program& prog, const std::string& name) {
+		for (auto* table : { renderPartials.get(), prog.partials.get() }) {
+			if (!table) continue;
+			auto it = table->find(name);
+			if (it != table->end()) return partialProgram(it->second, prog.escape, name);
+		}
+		auto it = state.partials.find(name);
+		return it == state.partials.end() ? nullptr : it->second;
+	}
+
+	ProgramPtr partialProgram(const Value& v, bool escape, const std::string& name) {
+		if (auto s = std::get_if<std::string>(&v)) return state.compile(*s, escape);
+		if (auto pins = std::get_if<std::shared_ptr<Instance>>(&v)) {
+			if (*pins && (*pins)->klass == state.templateClass.lock()) {
+				auto h = static_cast<TemplateHandle*>(static_cast<InstanceExt*>(pins->get())->nativeHandle);
+				if (h && h->program) return h->program;
+			}
+		}
+		throw std::runtime_error("template: partial '" + name + "' must be a template source string or a Template");
+	}
+
+	bool lookupIn(const Value& ctx, const std::string& name, Value& result) {
+		if (auto po = std::get_if<std::shared_ptr<Object>>(&ctx)) {
+			if (!*po) return false;
+			auto it = (*po)->find(name);
+			if (it == (*po)->end()) return false;
+			result = it->second;
+			return true;
+		}
+		if (auto pins = std::get_if<std::shared_ptr<Instance>>(&ctx)) {
+			if (!*pins) return false;
+			auto fit = (*pins)->fields.find(name);
+			if (fit != (*pins)->fields.end()) { result = fit->second; return true; }
+			if (!(*pins)->klass || !interp->findMethod((*pins)->klass, name)) return false;
+			result = interp->getProperty(ctx, name);
+			return true;
+		}
+		if (auto parr = std::get_if<std::shared_ptr<Array>>(&ctx)) {
+			if (!*parr) return false;
+			if (name == "length" || name == "len") { result = Value{ static_cast<double>((*parr)->size()) }; return true; }
+			size_t idx = 0;
+			auto [end, ec] = std::from_chars(name.data(), name.data() + name.size(), idx);
+			if (ec != std::errc() || end != name.data() + name.size() || idx >= (*parr)->size()) return false;
+			result = (**parr)[idx];
+			return true;
+		}
+		return false;
+	}
+
+	// 方法与函数值按无参调用取结果 (例如实例上的 fullName())
+	Value unwrap(Value v) {
+		if (std::holds_alternative<std::shared_ptr<Function>>(v)) return interp->callValue(v, {});
+		return v;
+	}
+
+	Value resolve(const std::vector<std::string>& path) {
+		if (path.empty()) return stack.back();
+		const std::string& head = path[0];
+		Value cur{ std::monostate{} };
+		if (head[0] == '@') {
+			// 最近一层循环的 @index / @first / @last
+			for (auto f = frames.rbegin(); f != frames.rend(); ++f) {
+				if (!f->items) continue;
+				if (head == "@index") return Value{ static_cast<double>(f->index) };
+				if (head == "@first") return Value{ f->index == 0 };
+				if (head == "@last") return Value{ f->index + 1 == f->items->size() };
+				break;
+			}
+			return cur;
+		}
+		// 首段沿上下文栈由内向外查找，其余各段在结果上逐级取值
+		bool found = false;
+		for (auto it = stack.rbegin(); it != stack.rend() && !found; ++it) found = lookupIn(*it, head, cur);
+		if (!found) return Value{ std::monostate{} };
+		for (size_t i = 1; i < path.size(); ++i) {
+			Value ctx = unwrap(cur);
+			if (!lookupIn(ctx, path[i], cur)) return Value{ std::monostate{} };
+		}
+		return unwrap(cur);
+	}
+
+	void appendValue(const Value& v, bool escape) {
+		if (std::holds_alternative<std::monostate>(v)) return;
+		if (auto s = std::get_if<std::string>(&v)) {
+			if (escape) appendEscaped(out, *s); else out += *s;
+			return;
+		}
+		if (auto n = std::get_if<double>(&v)) {
+			// 常见的小整数直接格式化；其余交给 toString 以保持与字符串拼接相同的输出
+			if (std::floor(*n) == *n && std::fabs(*n) < 1e6) {
+				char buf[16];
+				auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), static_cast<int64_t>(*n));
+				if (ec == std::errc()) { out.append(buf, end); return; }
+			}
+		}
+		std::string s = toString(v);
+		if (escape) appendEscaped(out, s); else out += s;
+	}
+};
+
+std::shared_ptr<Object> optionalObject(const std::vector<Value>& args, size_t idx, const char* what) {
+	if (args.size() <= idx || std::holds_alternative<std::monostate>(args[idx])) return nullptr;
+	auto po = std::get_if<std::shared_ptr<Object>>(&args[idx]);
+	if (!po || !*po) throw std::runtime_error(std::string(what) + " must be an object");
+	return *po;
+}
+
+// 编译选项：{escape: "html" | "none", partials: {name: source | Template}}
+void parseOptions(const std::shared_ptr<Object>& opts, bool& escape, std::shared_ptr<Object>& partials, const char* what) {
+	if (!opts) return;
+	for (auto& kv : *opts) {
+		if (kv.first == "escape") {
+			std::string mode = toString(kv.second);
+			if (mode == "html") escape = true;
+			else if (mode == "none") escape = false;
+			else throw std::runtime_error(std::string(what) + ": escape must be \"html\" or \"none\"");
+		} else if (kv.first == "partials") {
+			auto po = std::get_if<std::shared_ptr<Object>>(&kv.second);
+			if (!po || !*po) throw std::runtime_error(std::string(what) + ": partials must be an object");
+			partials = *po;
+		} else {
+			throw std::runtime_error(std::string(what) + ": unknown option '" + kv.first + "'");
+		}
+	}
+}
+
+ProgramPtr compileWithOptions(TemplateState& state, const std::vector<Value>& args, const char* what) {
+	if (args.empty() || args.size() > 2 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error(std::string(what) + " expects (source[, options])");
+	bool escape = true;
+	std::shared_ptr<Object> partials;
+	parseOptions(optionalObject(args, 1, what), escape, partials, what);
+	auto prog = state.compile(std::get<std::string>(args[0]), escape);
+	if (!partials) return prog;
+	// partials 属于这个模板实例，不进入共享缓存
+	auto own = std::make_shared<Program>(*prog);
+	own->partials = partials;
+	return own;
+}
+
+using NativeFn = std::function<Value(const std::vector<Value>&, std::shared_ptr<Environment>)>;
+
+std::shared_ptr<Function> builtin(NativeFn fn) {
+	auto f = std::make_shared<Function>();
+	f->isBuiltin = true;
+	f->builtin = std::move(fn);
+	return f;
+}
+
+TemplateHandle* handleOf(const std::shared_ptr<Environment>& clos, const char* what) {
+	if (!clos) throw std::runtime_error("internal: instance method called without closure");
+	Value tv = clos->get("this");
+	auto pins = std::get_if<std::shared_ptr<Instance>>(&tv);
+	if (!pins || !*pins) throw std::runtime_error("internal: invalid 'this' value");
+	auto h = static_cast<TemplateHandle*>(static_cast<InstanceExt*>(pins->get())->nativeHandle);
+	if (!h || !h->program) throw std::runtime_error(std::string(what) + ": template not initialized");
+	return h;
+}
+
+void attachProgram(InstanceExt* inst, ProgramPtr prog) {
+	if (inst->nativeHandle && inst->nativeDestructor) inst->nativeDestructor(inst->nativeHandle);
+	inst->fields["source"] = Value{ prog->source };
+	inst->nativeHandle = new TemplateHandle{ std::move(prog) };
+	inst->nativeDestructor = [](void* p) { delete static_cast<TemplateHandle*>(p); };
+}
+
+std::string renderToString(Interpreter* interp, TemplateState& state, const Program& prog, const Value& data, std::shared_ptr<Object> partials) {
+	std::string out;
+	out.reserve(prog.text.size() + prog.text.size() / 2);
+	Renderer(interp, state, std::move(partials), out, nullptr).run(prog, data);
+	return out;
+}
+
+} // namespace
+
+void registerStdTemplatePackage(Interpreter& interp) {
+	Interpreter* interpPtr = &interp;
+	interp.registerLazyPackage("std.template", [interpPtr](std::shared_ptr<Object> pkg) {
+		auto state = std::make_shared<TemplateState>();
+
+		// ---- Template(source[, {escape, partials}]) ----
+		auto templateClass = std::make_shared<ClassInfo>(); templateClass->name = "Template"; templateClass->isNative = true;
+		state->templateClass = templateClass;
+		templateClass->methods["constructor"] = builtin([state](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			Value tv = clos->get("this");
+			auto pins = std::get_if<std::shared_ptr<Instance>>(&tv);
+			if (!pins || !*pins) throw std::runtime_error("internal: invalid 'this' value");
+			attachProgram(static_cast<InstanceExt*>(pins->get()), compileWithOptions(*state, args, "Template"));
+			return Value{ std::monostate{} };
+		});
+		// render(data[, partials]) -> string
+		templateClass->methods["render"] = builtin([interpPtr, state](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			auto h = handleOf(clos, "Template.render");
+			if (args.size() > 2) throw std::runtime_error("Template.render expects (data[, partials])");
+			Value data = args.empty() ? Value{ std::monostate{} } : args[0];
+			return Value{ renderToString(interpPtr, *state, *h->program, data, optionalObject(args, 1, "Template.render partials")) };
+		});
+		// renderTo(dest, data[, partials]) -> number：边渲染边按 64KB 块调用 dest.write(chunk)
+		// (io.Writable、FileStream 等任何带 write 方法的对象)，返回写出的字节数
+		templateClass->methods["renderTo"] = builtin([interpPtr, state](const std::vector<Value>& args, std::shared_ptr<Environment> clos)->Value {
+			auto h = handleOf(clos, "Template.renderTo");
+			if (args.empty() || args.size() > 3) throw std::runtime_error("Template.renderTo expects (dest, data[, partials])");
+			Value write = interpPtr->getProperty(args[0], "write");
+			if (!std::holds_alternative<std::shared_ptr<Function>>(write)) throw std::runtime_error("Template.renderTo: dest must have a write(chunk) method");
+			double total = 0;
+			auto flush = [interpPtr, &write, &total](std::string& buf) {
+				if (buf.empty()) return;
+				total += static_cast<double>(buf.size());
+				interpPtr->callValue(write, { Value{ std::move(buf) } });
+				buf.clear();
+			};
+			std::string out;
+			out.reserve(64 * 1024);
+			Value data = args.size() > 1 ? args[1] : Value{ std::monostate{} };
+			Renderer(interpPtr, *state, optionalObject(args, 2, "Template.renderTo partials"), out, flush).run(*h->program, data);
+			flush(out);
+			return Value{ total };
+		});
+
+		// compile(source[, options]) -> Template：相同源码命中缓存，不会重复解析
+		(*pkg)["compile"] = Value{ builtin([state](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			auto inst = std::make_shared<InstanceExt>();
+			inst->klass = state->templateClass.lock();
+			attachProgram(inst.get(), compileWithOptions(*state, args, "template.compile"));
+			return Value{ std::shared_ptr<Instance>(inst) };
+		}) };
+		// render(source, data[, options]) -> string：一次性渲染，编译结果同样按源码缓存
+		(*pkg)["render"] = Value{ builtin([interpPtr, state](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			if (args.empty() || args.size() > 3) throw std::runtime_error("template.render expects (source, data[, options])");
+			std::vector<Value> compileArgs{ args[0] };
+			if (args.size() > 2) compileArgs.push_back(args[2]);
+			auto prog = compileWithOptions(*state, compileArgs, "template.render");
+			return Value{ renderToString(interpPtr, *state, *prog, args.size() > 1 ? args[1] : Value{ std::monostate{} }, nullptr) };
+		}) };
+		// registerPartial(name, source | Template)：供所有模板以 {{> name}} 引用
+		(*pkg)["registerPartial"] = Value{ builtin([state](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			if (args.size() != 2 || !std::holds_alternative<std::string>(args[0])) throw std::runtime_error("template.registerPartial expects (name, source or Template)");
+			const std::string& name = std::get<std::string>(args[0]);
+			if (auto s = std::get_if<std::string>(&args[1])) {
+				state->partials[name] = state->compile(*s, true);
+			} else if (auto pins = std::get_if<std::shared_ptr<Instance>>(&args[1]); pins && *pins && (*pins)->klass == state->templateClass.lock()) {
+				auto h = static_cast<TemplateHandle*>(static_cast<InstanceExt*>(pins->get())->nativeHandle);
+				if (!h || !h->program) throw std::runtime_error("template.registerPartial: template not initialized");
+				state->partials[name] = h->program;
+			} else {
+				throw std::runtime_error("template.registerPartial expects (name, source or Template)");
+			}
+			return Value{ std::monostate{} };
+		}) };
+		(*pkg)["escapeHtml"] = Value{ builtin([](const std::vector<Value>& args, std::shared_ptr<Environment>)->Value {
+			if (args.size() != 1) throw std::runtime_error("template.escapeHtml expects 1 argument");
+			std::string out;
+			appendEscaped(out, toString(args[0]));
+			return Value{ out };
+		}) };
+		(*pkg)["Template"] = templateClass;
+	});
+}
+
+PackageMeta getStdTemplatePackageMeta() {
+	PackageMeta pkg;
+	pkg.name = "std.template";
+	pkg.exports = { "compile", "render", "registerPartial", "escapeHtml" };
+
+	ClassMeta templateClass;
+	templateClass.name = "Template";
+	templateClass.methods = { {"constructor"}, {"render"}, {"renderTo"} };
+	pkg.classes.push_back(templateClass);
+
+	return pkg;
+}
+
+} // namespace asul
@@ -0,0 +1,16 @@
+#ifndef STD_TEMPLATE_H
+#define STD_TEMPLATE_H
+
+#include "../../PackageMeta.h"
+
+namespace asul {
+
+class Interpreter;
+
+// Register the std.template package (Mustache-style templates compiled once into an instruction list) with the interpreter
+void registerStdTemplatePackage(Interpreter& interp);
+PackageMeta getStdTemplatePackageMeta();
+
+} // namespace asul
+
+#endif // STD_TEMPLATE_H
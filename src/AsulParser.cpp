@@ -201,6 +201,8 @@ StmtPtr Parser::declaration() {
 	}
 	
 	StmtPtr target = nullptr;
+	// import.reload(...) 等是表达式语句，不是 import 声明
+	bool importMember = check(TokenType::Import) && current + 1 < tokens.size() && tokens[current + 1].type == TokenType::Dot;
 	if (match({TokenType::Async})) { 
 		consume(TokenType::Function, "在 'async' 后缺少 'function'"); 
 		target = functionDecl(true, isExported); 
@@ -214,7 +216,7 @@ StmtPtr Parser::declaration() {
 	} else if (match({TokenType::Interface})) {
 		if (!decorators.empty()) error(previous(), "装饰器不能应用于 'interface' 声明");
 		return interfaceDeclaration(isExported);
-	} else if (match({TokenType::Import})) {
+	} else if (!importMember && match({TokenType::Import})) {
 		if (!decorators.empty()) error(previous(), "装饰器不能应用于 'import' 语句");
 		return importDeclaration(false);
 	} else if (match({TokenType::From})) {
@@ -580,7 +582,7 @@ StmtPtr Parser::varDeclaration(bool isExported) {
 	ExprPtr typeExpr = nullptr;
 	if (match({TokenType::Colon})) {
 		// allow a non-assignment expression (e.g. typeof(...)) as the type annotation
-		typeExpr = logicalOr();
+		typeExpr = binary(2);
 	}
 	ExprPtr init;
 	if (match({TokenType::Equal})) init = expression();
@@ -623,6 +625,7 @@ StmtPtr Parser::statement() {
 }
 
 StmtPtr Parser::forStatement() {
+	if (match({TokenType::Await})) return forAwaitStatement();
 	consume(TokenType::LeftParen, "缺少 '('");
 	StmtPtr init;
 	if (match({TokenType::Semicolon})) {
@@ -660,6 +663,23 @@ StmtPtr Parser::forEachStatement() {
 	return std::make_shared<ForEachStmt>(varName, iterable, body);
 }
 
+StmtPtr Parser::forAwaitStatement() {
+	// for await ([let|const|var] varName in source) body
+	consume(TokenType::LeftParen, "'for await' 后缺少 '('");
+	match({TokenType::Let, TokenType::Var, TokenType::Const});
+	if (!check(TokenType::Identifier)) {
+		error("for await 中缺少变量名");
+	}
+	std::string varName = advance().lexeme;
+	consume(TokenType::In, "for await 变量名后缺少 'in'");
+	ExprPtr source = expression();
+	consume(TokenType::RightParen, "for await 子句后缺少 ')'");
+	auto body = statement();
+	auto stmt = std::make_shared<ForEachStmt>(varName, source, body);
+	stmt->isAwait = true;
+	return stmt;
+}
+
 StmtPtr Parser::switchStatement() {
 	// switch (expr) { case val: ... case val2: ... default: ... }
 	consume(TokenType::LeftParen, "'switch' 后缺少 '('");
@@ -856,8 +876,27 @@ static PatternPtr exprToPattern(ExprPtr e) {
 	throw std::runtime_error("Invalid destructuring assignment target");
 }
 
+static bool isAssignmentOperator(TokenType type) {
+	switch (type) {
+		case TokenType::Equal:
+		case TokenType::PlusEqual:
+		case TokenType::MinusEqual:
+		case TokenType::StarEqual:
+		case TokenType::SlashEqual:
+		case TokenType::PercentEqual:
+		case TokenType::QuestionQuestionEqual:
+		case TokenType::AndAndEqual:
+		case TokenType::OrOrEqual:
+			return true;
+		default:
+			return false;
+	}
+}
+
 ExprPtr Parser::assignment() {
 	auto expr = conditional();
+	// 绝大多数表达式后面不是赋值运算符，直接返回
+	if (!isAssignmentOperator(peek().type)) return expr;
 	
 	// Logical assignment operators: ??=, &&=, ||= (short-circuiting)
 	if (match({TokenType::QuestionQuestionEqual, TokenType::AndAndEqual, TokenType::OrOrEqual})) {
@@ -953,7 +992,7 @@ ExprPtr Parser::assignment() {
 
 ExprPtr Parser::conditional() {
 	// 三元运算符：condition ? thenExpr : elseExpr
-	auto expr = nullishCoalescing();
+	auto expr = binary(1);
 	
 	if (match({TokenType::Question})) {
 		Token questionToken = previous();
@@ -970,150 +1009,95 @@ ExprPtr Parser::conditional() {
 	return expr;
 }
 
-ExprPtr Parser::nullishCoalescing() {
-	// Nullish coalescing: expr ?? defaultExpr
-	auto expr = logicalOr();
-	while (match({TokenType::QuestionQuestion})) {
-		Token op = previous();
-		auto right = logicalOr();
-		expr = std::make_shared<LogicalExpr>(expr, op, right);
-	}
-	return expr;
-}
-
-ExprPtr Parser::logicalOr() {
-	auto expr = logicalAnd();
-	while (match({TokenType::OrOr})) {
-		Token op = previous();
-		auto right = logicalAnd();
-		expr = std::make_shared<LogicalExpr>(expr, op, right);
-	}
-	return expr;
-}
-
-ExprPtr Parser::logicalAnd() {
-	auto expr = bitwiseOr();
-	while (match({TokenType::AndAnd})) {
-		Token op = previous();
-		auto right = bitwiseOr();
-		expr = std::make_shared<LogicalExpr>(expr, op, right);
-	}
-	return expr;
-}
-
-// bitwise OR level
-ExprPtr Parser::bitwiseOr() {
-	auto expr = bitwiseXor();
-	while (match({TokenType::Pipe})) {
-		Token op = previous();
-		auto right = bitwiseXor();
-		expr = std::make_shared<BinaryExpr>(expr, op, right);
-	}
-	return expr;
-}
-
-ExprPtr Parser::bitwiseXor() {
-	auto expr = bitwiseAnd();
-	while (match({TokenType::Caret})) {
-		Token op = previous();
-		auto right = bitwiseAnd();
-		expr = std::make_shared<BinaryExpr>(expr, op, right);
-	}
-	return expr;
-}
-
-ExprPtr Parser::bitwiseAnd() {
-	auto expr = equality();
-	while (match({TokenType::Ampersand})) {
-		Token op = previous();
-		auto right = equality();
-		expr = std::make_shared<BinaryExpr>(expr, op, right);
-	}
-	return expr;
-}
-
-ExprPtr Parser::equality() {
-	auto expr = comparison();
-	while (match({TokenType::BangEqual, TokenType::EqualEqual, TokenType::StrictEqual, TokenType::StrictNotEqual})) {
-		Token op = previous();
-		auto right = comparison();
-		expr = std::make_shared<BinaryExpr>(expr, op, right);
-	}
-	return expr;
-}
-
-ExprPtr Parser::comparison() {
-	auto expr = shift();
-	while (match({TokenType::Greater, TokenType::GreaterEqual, TokenType::Less, TokenType::LessEqual, TokenType::MatchInterface})) {
-		Token op = previous();
-		auto right = shift();
-		expr = std::make_shared<BinaryExpr>(expr, op, right);
+// ----------- Binary operators (precedence climbing) -----------
+// 绑定力表：数值越大结合越紧；0 表示不是二元运算符。
+// 所有二元运算符均为左结合；??、||、&& 生成 LogicalExpr (短路求值)，其余生成 BinaryExpr。
+static int binaryPrecedence(TokenType type) {
+	switch (type) {
+		case TokenType::QuestionQuestion: return 1;
+		case TokenType::OrOr: return 2;
+		case TokenType::AndAnd: return 3;
+		case TokenType::Pipe: return 4;
+		case TokenType::Caret: return 5;
+		case TokenType::Ampersand: return 6;
+		case TokenType::BangEqual:
+		case TokenType::EqualEqual:
+		case TokenType::StrictEqual:
+		case TokenType::StrictNotEqual: return 7;
+		case TokenType::Greater:
+		case TokenType::GreaterEqual:
+		case TokenType::Less:
+		case TokenType::LessEqual:
+		case TokenType::MatchInterface: return 8;
+		case TokenType::ShiftLeft:
+		case TokenType::ShiftRight: return 9;
+		case TokenType::Plus:
+		case TokenType::Minus: return 10;
+		case TokenType::Star:
+		case TokenType::Slash:
+		case TokenType::Percent: return 11;
+		default: return 0;
 	}
-	return expr;
 }
 
-ExprPtr Parser::shift() {
-	auto expr = term();
-	while (match({TokenType::ShiftLeft, TokenType::ShiftRight})) {
-		Token op = previous();
-		auto right = term();
-		expr = std::make_shared<BinaryExpr>(expr, op, right);
-	}
-	return expr;
+static bool isLogicalOperator(TokenType type) {
+	return type == TokenType::QuestionQuestion || type == TokenType::OrOr || type == TokenType::AndAnd;
 }
 
-ExprPtr Parser::term() {
-	auto expr = factor();
-	while (match({TokenType::Plus, TokenType::Minus})) {
-		Token op = previous();
-		auto right = factor();
-		expr = std::make_shared<BinaryExpr>(expr, op, right);
-	}
-	return expr;
-}
-
-ExprPtr Parser::factor() {
+// 解析绑定力 >= minPrec 的二元表达式；一次 unary() 之后按表循环，
+// 不再为每个操作数逐层下降所有优先级函数。
+ExprPtr Parser::binary(int minPrec) {
 	auto expr = unary();
-	while (match({TokenType::Star, TokenType::Slash, TokenType::Percent})) {
-		Token op = previous();
-		auto right = unary();
-		expr = std::make_shared<BinaryExpr>(expr, op, right);
+	for (;;) {
+		int prec = binaryPrecedence(peek().type);
+		if (prec < minPrec || prec == 0) break;
+		Token op = advance();
+		auto right = binary(prec + 1);
+		if (isLogicalOperator(op.type)) expr = std::make_shared<LogicalExpr>(expr, op, right);
+		else expr = std::make_shared<BinaryExpr>(expr, op, right);
 	}
 	return expr;
 }
 
 ExprPtr Parser::unary() {
-	// 前置递增/递减：++x, --x
-	if (match({TokenType::PlusPlus, TokenType::MinusMinus})) {
-		Token op = previous();
-		auto operand = unary();
-		return std::make_shared<UpdateExpr>(op, operand, true, op.line, op.column, std::max(1, op.length));
-	}
-	if (match({TokenType::Bang, TokenType::Minus, TokenType::Tilde})) {
-		Token op = previous();
-		auto right = unary();
-		return std::make_shared<UnaryExpr>(op, right);
-	}
-	if (match({TokenType::Await})) {
-		Token awTok = previous();
-		auto inner = unary();
-		return std::make_shared<AwaitExpr>(inner, awTok.line, awTok.column, std::max(1, awTok.length));
-	}
-	if (match({TokenType::Yield})) {
-		Token yieldTok = previous();
-		bool isDelegate = false;
-		ExprPtr value = nullptr;
-		// yield* for delegating to another generator
-		if (match({TokenType::Star})) {
-			isDelegate = true;
+	// 前缀运算符按 token 类型直接分派，普通操作数直接落到 postfix()
+	switch (peek().type) {
+		case TokenType::PlusPlus:
+		case TokenType::MinusMinus: {
+			// 前置递增/递减：++x, --x
+			Token op = advance();
+			auto operand = unary();
+			return std::make_shared<UpdateExpr>(op, operand, true, op.line, op.column, std::max(1, op.length));
+		}
+		case TokenType::Bang:
+		case TokenType::Minus:
+		case TokenType::Tilde: {
+			Token op = advance();
+			auto right = unary();
+			return std::make_shared<UnaryExpr>(op, right);
 		}
-		// yield can have an optional value
-		if (!check(TokenType::Semicolon) && !check(TokenType::RightParen) && !check(TokenType::RightBrace)) {
-			value = unary();
+		case TokenType::Await: {
+			Token awTok = advance();
+			auto inner = unary();
+			return std::make_shared<AwaitExpr>(inner, awTok.line, awTok.column, std::max(1, awTok.length));
 		}
-		return std::make_shared<YieldExpr>(value, isDelegate, yieldTok.line, yieldTok.column, std::max(1, yieldTok.length));
+		case TokenType::Yield: {
+			Token yieldTok = advance();
+			bool isDelegate = false;
+			ExprPtr value = nullptr;
+			// yield* for delegating to another generator
+			if (match({TokenType::Star})) {
+				isDelegate = true;
+			}
+			// yield can have an optional value
+			if (!check(TokenType::Semicolon) && !check(TokenType::RightParen) && !check(TokenType::RightBrace)) {
+				value = unary();
+			}
+			return std::make_shared<YieldExpr>(value, isDelegate, yieldTok.line, yieldTok.column, std::max(1, yieldTok.length));
+		}
+		default:
+			return postfix();
 	}
-	return postfix();
 }
 
 ExprPtr Parser::postfix() {
@@ -1265,6 +1249,12 @@ ExprPtr Parser::primary() {
 		return parseInterpolatedString(s, tok.line, tok.column, std::max(1, tok.length));
 	}
 	if (match({TokenType::Identifier})) { auto tok = previous(); return std::make_shared<VariableExpr>(tok.lexeme, tok.line, tok.column, tok.length); }
+	// import.reload(path) / import.onReload(fn)：import 只能作为成员访问的对象出现
+	if (match({TokenType::Import})) {
+		auto tok = previous();
+		if (!check(TokenType::Dot)) error(tok, "'import' 只能用于导入声明或 import.xxx 成员访问");
+		return std::make_shared<VariableExpr>(tok.lexeme, tok.line, tok.column, tok.length);
+	}
 	if (match({TokenType::LeftBracket})) {
 		std::vector<ExprPtr> elems;
 		if (!check(TokenType::RightBracket)) {
@@ -60,6 +60,7 @@ private:
 	StmtPtr statement();
 	StmtPtr forStatement();
 	StmtPtr forEachStatement();
+	StmtPtr forAwaitStatement();
 	StmtPtr switchStatement();
 	StmtPtr matchStatement();
 	StmtPtr returnStatement();
@@ -72,17 +73,7 @@ private:
 	ExprPtr expression();
 	ExprPtr assignment();
 	ExprPtr conditional();
-	ExprPtr nullishCoalescing();
-	ExprPtr logicalOr();
-	ExprPtr logicalAnd();
-	ExprPtr bitwiseOr();
-	ExprPtr bitwiseXor();
-	ExprPtr bitwiseAnd();
-	ExprPtr equality();
-	ExprPtr comparison();
-	ExprPtr shift();
-	ExprPtr term();
-	ExprPtr factor();
+	ExprPtr binary(int minPrec);
 	ExprPtr unary();
 	ExprPtr postfix();
 	ExprPtr finishCall(ExprPtr callee);
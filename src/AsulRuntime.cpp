@@ -1,6 +1,9 @@
 #include "AsulRuntime.h"
 
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 
@@ -50,33 +53,133 @@ bool valueEqual(const Value& a, const Value& b) {
 	}
 }
 
-size_t valueHash(const Value& v) {
-	std::hash<std::string> sh;
-	std::hash<double> dh;
+// ----------- Hashing -----------
+// wyhash (public domain, Wang Yi) 的核心：64x64->128 乘法折叠
+static inline void wyMultiply(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = *a;
+	r *= *b;
+	*a = static_cast<uint64_t>(r);
+	*b = static_cast<uint64_t>(r >> 64);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32, la = static_cast<uint32_t>(*a), lb = static_cast<uint32_t>(*b);
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+	*a = lo;
+	*b = hi;
+#endif
+}
+
+uint64_t hashMix(uint64_t a, uint64_t b) { wyMultiply(&a, &b); return a ^ b; }
+
+static inline uint64_t readU64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+static inline uint64_t readU32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+static inline uint64_t readU24(const uint8_t* p, size_t k) { return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1]; }
+
+static const uint64_t kHashSecret[4] = { 0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL };
+
+// seed 已经过 premixSeed 处理
+static uint64_t hashBytesPremixed(const void* data, size_t len, uint64_t seed) {
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	uint64_t a, b;
+	if (len <= 16) {
+		if (len >= 4) {
+			a = (readU32(p) << 32) | readU32(p + ((len >> 3) << 2));
+			b = (readU32(p + len - 4) << 32) | readU32(p + len - 4 - ((len >> 3) << 2));
+		} else if (len > 0) {
+			a = readU24(p, len);
+			b = 0;
+		} else {
+			a = b = 0;
+		}
+	} else {
+		size_t i = len;
+		if (i >= 48) {
+			uint64_t see1 = seed, see2 = seed;
+			do {
+				seed = hashMix(readU64(p) ^ kHashSecret[1], readU64(p + 8) ^ seed);
+				see1 = hashMix(readU64(p + 16) ^ kHashSecret[2], readU64(p + 24) ^ see1);
+				see2 = hashMix(readU64(p + 32) ^ kHashSecret[3], readU64(p + 40) ^ see2);
+				p += 48; i -= 48;
+			} while (i >= 48);
+			seed ^= see1 ^ see2;
+		}
+		while (i > 16) {
+			seed = hashMix(readU64(p) ^ kHashSecret[1], readU64(p + 8) ^ seed);
+			i -= 16; p += 16;
+		}
+		a = readU64(p + i - 16);
+		b = readU64(p + i - 8);
+	}
+	a ^= kHashSecret[1];
+	b ^= seed;
+	wyMultiply(&a, &b);
+	return hashMix(a ^ kHashSecret[0] ^ len, b ^ kHashSecret[1]);
+}
+
+static inline uint64_t premixSeed(uint64_t seed) { return seed ^ hashMix(seed ^ kHashSecret[0], kHashSecret[1]); }
+
+uint64_t hashBytes(const void* data, size_t len, uint64_t seed) { return hashBytesPremixed(data, len, premixSeed(seed)); }
+
+// 首次使用时生成；函数内静态变量保证其他翻译单元的静态初始化也能安全使用
+uint64_t hashSeed() {
+	static const uint64_t seed = [] {
+		if (const char* fixed = std::getenv("ASUL_HASH_SEED")) {
+			return static_cast<uint64_t>(std::strtoull(fixed, nullptr, 0));
+		}
+		std::random_device rd;
+		uint64_t s = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+		s ^= static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+		s ^= reinterpret_cast<uintptr_t>(&rd);
+		return hashMix(s, kHashSecret[2]);
+	}();
+	return seed;
+}
+
+uint64_t hashBytes(const void* data, size_t len) {
+	static const uint64_t premixed = premixSeed(hashSeed());
+	return hashBytesPremixed(data, len, premixed);
+}
+
+// 每种类型带不同的标签，避免 1 / true / 指针等跨类型的系统性碰撞
+template <typename BytesHash>
+static uint64_t valueHashImpl(const Value& v, uint64_t seed, BytesHash&& bytesHash) {
+	auto ptrHash = [seed](const void* p, size_t tag) {
+		return hashMix(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p)) ^ seed, kHashSecret[tag & 3] + tag);
+	};
 	switch (v.index()) {
-		case 0: return 0x9e3779b97f4a7c15ULL; // null const
+		case 0: return hashMix(seed, kHashSecret[0]); // null const
 		case 1: { // number
 			double d = std::get<double>(v);
-			return dh(d) ^ (0x9e3779b97f4a7c15ULL + (dh(d)<<6) + (dh(d)>>2));
-		}
-		case 2: { // string
-			const std::string &s = std::get<std::string>(v);
-			return sh(s);
+			if (d == 0.0) d = 0.0; // -0 与 0 相等，必须同哈希
+			uint64_t bits; std::memcpy(&bits, &d, sizeof(bits));
+			return hashMix(bits ^ seed, kHashSecret[1]);
 		}
+		case 2: return bytesHash(std::get<std::string>(v)); // string
 		case 3: { // bool
 			bool b = std::get<bool>(v);
-			return b ? 1231u : 3413u;
+			return hashMix(seed ^ (b ? 1u : 2u), kHashSecret[3]);
 		}
-		case 4: { auto p = std::get<std::shared_ptr<Function>>(v).get(); return reinterpret_cast<size_t>(p); }
-		case 5: { auto p = std::get<std::shared_ptr<Array>>(v).get(); return reinterpret_cast<size_t>(p); }
-		case 6: { auto p = std::get<std::shared_ptr<Object>>(v).get(); return reinterpret_cast<size_t>(p); }
-		case 7: { auto p = std::get<std::shared_ptr<ClassInfo>>(v).get(); return reinterpret_cast<size_t>(p); }
-		case 8: { auto p = std::get<std::shared_ptr<Instance>>(v).get(); return reinterpret_cast<size_t>(p); }
-		case 9: { auto p = std::get<std::shared_ptr<PromiseState>>(v).get(); return reinterpret_cast<size_t>(p); }
+		case 4: return ptrHash(std::get<std::shared_ptr<Function>>(v).get(), 4);
+		case 5: return ptrHash(std::get<std::shared_ptr<Array>>(v).get(), 5);
+		case 6: return ptrHash(std::get<std::shared_ptr<Object>>(v).get(), 6);
+		case 7: return ptrHash(std::get<std::shared_ptr<ClassInfo>>(v).get(), 7);
+		case 8: return ptrHash(std::get<std::shared_ptr<Instance>>(v).get(), 8);
+		case 9: return ptrHash(std::get<std::shared_ptr<PromiseState>>(v).get(), 9);
 		default: return 0;
 	}
 }
 
+size_t valueHash(const Value& v) {
+	return static_cast<size_t>(valueHashImpl(v, hashSeed(), [](const std::string& s) { return hashBytes(s.data(), s.size()); }));
+}
+
+uint64_t valueHash(const Value& v, uint64_t seed) {
+	return valueHashImpl(v, seed, [seed](const std::string& s) { return hashBytes(s.data(), s.size(), seed); });
+}
+
 std::string toString(const Value& v) {
 	if (std::holds_alternative<std::monostate>(v)) return "null";
 	if (auto n = std::get_if<double>(&v)) {
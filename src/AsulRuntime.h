@@ -2,6 +2,7 @@
 #define ASUL_RUNTIME_H
 
 #include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
 #include <deque>
 #include <fstream>
@@ -29,9 +30,20 @@ struct Expr;
 using StmtPtr = std::shared_ptr<Stmt>;
 using ExprPtr = std::shared_ptr<Expr>;
 
+// ----------- Hashing -----------
+// 带进程级随机种子的 wyhash 风格哈希。Object / Environment / Map / Set 的键都经由这里，
+// 外部输入 (HTTP 头、查询参数、JSON 键) 无法离线构造出落在同一桶里的键 (HashDoS)。
+// 设置环境变量 ASUL_HASH_SEED 可以固定种子，便于复现迭代顺序。
+uint64_t hashSeed();
+uint64_t hashBytes(const void* data, size_t len, uint64_t seed);
+uint64_t hashBytes(const void* data, size_t len); // 使用进程种子
+uint64_t hashMix(uint64_t a, uint64_t b);
+
+struct StringHash { size_t operator()(const std::string& s) const noexcept { return static_cast<size_t>(hashBytes(s.data(), s.size())); } };
+
 // ----------- Value Types -----------
 using Array = std::vector<struct ValueTag>;
-using Object = std::unordered_map<std::string, struct ValueTag>;
+using Object = std::unordered_map<std::string, struct ValueTag, StringHash>;
 
 // Recursive variant wrapper to allow shared_ptr recursive types.
 struct ValueTag : public std::variant<std::monostate,double,std::string,bool,std::shared_ptr<Function>,std::shared_ptr<Array>,std::shared_ptr<Object>,std::shared_ptr<ClassInfo>,std::shared_ptr<Instance>,std::shared_ptr<PromiseState>> {
@@ -46,6 +58,9 @@ bool isTruthy(const Value& v);
 std::string toString(const Value& v);
 bool valueEqual(const Value& a, const Value& b);
 size_t valueHash(const Value& v);
+// 固定种子版本：null / 数字 / 字符串 / 布尔的结果与进程无关，供需要序列化的结构使用 (Bloom filter 等)；
+// 引用类型仍按地址哈希，只在本进程内有意义
+uint64_t valueHash(const Value& v, uint64_t seed);
 
 // Utility: get numeric value from Value or throw
 inline double getNumber(const Value& v, const char* where) {
@@ -69,9 +84,9 @@ struct NativeStack { std::vector<Value> v; };
 // ----------- Environment -----------
 struct Environment : std::enable_shared_from_this<Environment> {
 	std::shared_ptr<Environment> parent;
-	std::unordered_map<std::string, Value> values;
+	std::unordered_map<std::string, Value, StringHash> values;
 	// declared types for variables (optional): maps variable name -> declared type name
-	std::unordered_map<std::string, std::string> declaredTypes;
+	std::unordered_map<std::string, std::string, StringHash> declaredTypes;
 	// Explicitly exported symbols in this environment (for module scopes)
 	std::unordered_set<std::string> explicitExports;
 
@@ -95,6 +110,8 @@ struct Function {
 	bool isBuiltin{false};
 	bool isAsync{false};
 	bool isGenerator{false};
+	bool capturesScope{true}; // 作用域分析：函数体内是否可能创建捕获调用帧的闭包（false 时调用帧可从环境池复用）
+	bool offloadable{false}; // builtin 只做纯本地计算、不访问解释器状态，可由 offload() 放到工作线程执行
 	std::function<Value(const std::vector<Value>&, std::shared_ptr<Environment>)> builtin;
 };
 
@@ -182,6 +199,8 @@ struct PromiseState {
 	// then/catch 回调以及链式的下一 Promise
 	std::vector<std::pair<std::shared_ptr<Function>, std::shared_ptr<PromiseState>>> thenCallbacks;
 	std::vector<std::pair<std::shared_ptr<Function>, std::shared_ptr<PromiseState>>> catchCallbacks;
+	// settle 时调用一次（任意线程），用于恢复 await 中挂起的协程
+	std::vector<std::function<void()>> waiters;
 };
 
 } // namespace asul
@@ -0,0 +1,137 @@
+#include "AsulScopeAnalysis.h"
+
+namespace asul {
+
+namespace {
+
+// depth == 0 表示语句直接在被分析的作用域中执行；嵌套块 (depth > 0) 中的声明属于各自的环境，
+// 但嵌套块里创建的闭包会经由 parent 链引用当前环境，因此捕获标记需要向外传播。
+struct ScopeScanner {
+	int flags{ScopeNone};
+	std::vector<std::string>* names{nullptr}; // 可选：收集所有可能绑定在该作用域（含嵌套块）中的名字
+
+	void declare(int depth) { if (depth == 0) flags |= ScopeDeclares; }
+	void bind(const std::string& name, int depth) {
+		declare(depth);
+		if (names && !name.empty()) names->push_back(name);
+	}
+
+	void pattern(const DestructuringPattern* p, int depth) {
+		if (!p) return;
+		declare(depth);
+		if (auto id = dynamic_cast<const IdentifierPattern*>(p)) { bind(id->name, depth); expr(id->defaultValue.get(), depth); return; }
+		if (auto arr = dynamic_cast<const ArrayPattern*>(p)) {
+			for (auto& e : arr->elements) pattern(e.get(), depth);
+			if (arr->hasRest) bind(arr->restName, depth);
+			return;
+		}
+		if (auto obj = dynamic_cast<const ObjectPattern*>(p)) {
+			for (auto& prop : obj->properties) { pattern(prop.pattern.get(), depth); expr(prop.defaultValue.get(), depth); }
+			if (obj->hasRest) bind(obj->restName, depth);
+		}
+	}
+
+	void exprs(const std::vector<ExprPtr>& es, int depth) { for (auto& e : es) expr(e.get(), depth); }
+
+	void expr(const Expr* e, int depth) {
+		if (!e) return;
+		if (dynamic_cast<const LiteralExpr*>(e) || dynamic_cast<const VariableExpr*>(e)) return;
+		// 闭包：函数体会在调用时创建自己的帧，但其 closure 指向当前环境
+		if (dynamic_cast<const FunctionExpr*>(e)) { flags |= ScopeCaptures; return; }
+		if (auto a = dynamic_cast<const AssignExpr*>(e)) { expr(a->value.get(), depth); return; }
+		if (auto da = dynamic_cast<const DestructuringAssignExpr*>(e)) { pattern(da->pattern.get(), depth); expr(da->value.get(), depth); return; }
+		if (auto u = dynamic_cast<const UnaryExpr*>(e)) { expr(u->right.get(), depth); return; }
+		if (auto up = dynamic_cast<const UpdateExpr*>(e)) { expr(up->operand.get(), depth); return; }
+		if (auto b = dynamic_cast<const BinaryExpr*>(e)) { expr(b->left.get(), depth); expr(b->right.get(), depth); return; }
+		if (auto l = dynamic_cast<const LogicalExpr*>(e)) { expr(l->left.get(), depth); expr(l->right.get(), depth); return; }
+		if (auto c = dynamic_cast<const ConditionalExpr*>(e)) { expr(c->condition.get(), depth); expr(c->thenBranch.get(), depth); expr(c->elseBranch.get(), depth); return; }
+		if (auto c = dynamic_cast<const CallExpr*>(e)) { expr(c->callee.get(), depth); exprs(c->args, depth); return; }
+		if (auto n = dynamic_cast<const NewExpr*>(e)) { expr(n->callee.get(), depth); exprs(n->args, depth); return; }
+		if (auto g = dynamic_cast<const GetPropExpr*>(e)) { expr(g->object.get(), depth); return; }
+		if (auto i = dynamic_cast<const IndexExpr*>(e)) { expr(i->object.get(), depth); expr(i->index.get(), depth); return; }
+		if (auto s = dynamic_cast<const SetPropExpr*>(e)) { expr(s->object.get(), depth); expr(s->value.get(), depth); return; }
+		if (auto s = dynamic_cast<const SetIndexExpr*>(e)) { expr(s->object.get(), depth); expr(s->index.get(), depth); expr(s->value.get(), depth); return; }
+		if (auto a = dynamic_cast<const ArrayLiteralExpr*>(e)) { exprs(a->elements, depth); return; }
+		if (auto o = dynamic_cast<const ObjectLiteralExpr*>(e)) {
+			for (auto& p : o->props) { expr(p.keyExpr.get(), depth); expr(p.value.get(), depth); }
+			return;
+		}
+		if (auto s = dynamic_cast<const SpreadExpr*>(e)) { expr(s->expr.get(), depth); return; }
+		if (auto a = dynamic_cast<const AwaitExpr*>(e)) { expr(a->expr.get(), depth); return; }
+		if (auto o = dynamic_cast<const OptionalChainingExpr*>(e)) { expr(o->object.get(), depth); return; }
+		if (auto y = dynamic_cast<const YieldExpr*>(e)) { expr(y->value.get(), depth); return; }
+		// 未知节点：保守处理
+		flags |= ScopeDeclares | ScopeCaptures;
+	}
+
+	void stmts(const std::vector<StmtPtr>& ss, int depth) { for (auto& s : ss) stmt(s.get(), depth); }
+
+	void stmt(const Stmt* s, int depth) {
+		if (!s) return;
+		if (auto e = dynamic_cast<const ExprStmt*>(s)) { expr(e->expr.get(), depth); return; }
+		if (auto v = dynamic_cast<const VarDecl*>(s)) { bind(v->name, depth); expr(v->typeExpr.get(), depth); expr(v->init.get(), depth); return; }
+		if (auto vd = dynamic_cast<const VarDeclDestructuring*>(s)) { pattern(vd->pattern.get(), depth); expr(vd->init.get(), depth); return; }
+		if (auto b = dynamic_cast<const BlockStmt*>(s)) { stmts(b->statements, depth + 1); return; }
+		if (auto i = dynamic_cast<const IfStmt*>(s)) { expr(i->cond.get(), depth); stmt(i->thenB.get(), depth); stmt(i->elseB.get(), depth); return; }
+		if (auto w = dynamic_cast<const WhileStmt*>(s)) { expr(w->cond.get(), depth); stmt(w->body.get(), depth); return; }
+		if (auto dw = dynamic_cast<const DoWhileStmt*>(s)) { expr(dw->cond.get(), depth); stmt(dw->body.get(), depth); return; }
+		// for 的 init 在当前环境中执行
+		if (auto f = dynamic_cast<const ForStmt*>(s)) { stmt(f->init.get(), depth); expr(f->cond.get(), depth); expr(f->post.get(), depth); stmt(f->body.get(), depth); return; }
+		// foreach 为循环变量单独建环境
+		if (auto fe = dynamic_cast<const ForEachStmt*>(s)) { expr(fe->iterable.get(), depth); bind(fe->varName, depth + 1); stmt(fe->body.get(), depth + 1); return; }
+		// switch/match 的分支体直接在当前环境执行
+		if (auto sw = dynamic_cast<const SwitchStmt*>(s)) {
+			expr(sw->expr.get(), depth);
+			for (auto& c : sw->cases) { expr(c.value.get(), depth); stmts(c.body, depth); }
+			return;
+		}
+		if (auto m = dynamic_cast<const MatchStmt*>(s)) {
+			expr(m->expr.get(), depth);
+			for (auto& arm : m->arms) { expr(arm.pattern.get(), depth); expr(arm.guard.get(), depth); stmt(arm.body.get(), depth); }
+			return;
+		}
+		if (auto r = dynamic_cast<const ReturnStmt*>(s)) { expr(r->value.get(), depth); return; }
+		if (auto t = dynamic_cast<const ThrowStmt*>(s)) { expr(t->value.get(), depth); return; }
+		if (auto tc = dynamic_cast<const TryCatchStmt*>(s)) {
+			stmt(tc->tryBlock.get(), depth);
+			bind(tc->catchName, depth + 1);
+			stmt(tc->catchBlock.get(), depth + 1);
+			stmt(tc->finallyBlock.get(), depth);
+			return;
+		}
+		if (dynamic_cast<const BreakStmt*>(s) || dynamic_cast<const ContinueStmt*>(s) || dynamic_cast<const EmptyStmt*>(s)) return;
+		if (dynamic_cast<const ImportStmt*>(s)) { declare(depth); return; }
+		// 函数/类/接口声明：定义绑定且 closure 指向当前环境
+		if (auto f = dynamic_cast<const FunctionStmt*>(s)) { bind(f->name, depth); flags |= ScopeCaptures; return; }
+		if (auto c = dynamic_cast<const ClassStmt*>(s)) { bind(c->name, depth); flags |= ScopeCaptures; return; }
+		if (auto itf = dynamic_cast<const InterfaceStmt*>(s)) { bind(itf->name, depth); flags |= ScopeCaptures; return; }
+		if (dynamic_cast<const ExtendStmt*>(s)) { declare(depth); flags |= ScopeCaptures; return; }
+		if (auto d = dynamic_cast<const DecoratorStmt*>(s)) { exprs(d->decorators, depth); stmt(d->target.get(), depth); return; }
+		// go 任务保存当前环境快照
+		if (auto g = dynamic_cast<const GoStmt*>(s)) { expr(g->call.get(), depth); flags |= ScopeCaptures; return; }
+		flags |= ScopeDeclares | ScopeCaptures;
+	}
+};
+
+} // namespace
+
+int analyzeScope(const std::vector<StmtPtr>& stmts, std::vector<std::string>* boundNames) {
+	ScopeScanner scanner;
+	scanner.names = boundNames;
+	scanner.stmts(stmts, 0);
+	return scanner.flags;
+}
+
+int analyzeFunctionScope(const std::vector<Param>& params, const StmtPtr& body, std::vector<std::string>* boundNames) {
+	ScopeScanner scanner;
+	scanner.names = boundNames;
+	// 参数总是绑定在函数帧上
+	for (auto& p : params) { scanner.bind(p.name, 0); scanner.expr(p.defaultValue.get(), 0); }
+	scanner.flags |= ScopeDeclares;
+	// 函数体块与参数共享同一个帧 (fn->body = block->statements)
+	if (auto block = dynamic_cast<const BlockStmt*>(body.get())) scanner.stmts(block->statements, 0);
+	else scanner.stmt(body.get(), 0);
+	return scanner.flags;
+}
+
+} // namespace asul
@@ -0,0 +1,29 @@
+#ifndef ASUL_SCOPE_ANALYSIS_H
+#define ASUL_SCOPE_ANALYSIS_H
+
+#include "AsulAst.h"
+
+#include <string>
+#include <vector>
+
+namespace asul {
+
+// ----------- Scope Analysis -----------
+// 对块/函数体做一次静态扫描，结果缓存在 AST 节点上 (scopeFlags)。
+// ScopeDeclares: 该作用域内会直接定义绑定 (let/function/class/import/解构...)
+// ScopeCaptures: 该作用域（或其嵌套块）会创建可能捕获当前环境的闭包 (函数/类/go)
+// 不声明任何绑定的块无需新环境；声明了但没有捕获的块/函数帧可以从环境池复用。
+// boundNames (可选) 收集可能在该作用域及其嵌套块中绑定的名字（不含嵌套函数体），
+// 供全局符号缓存判断哪些名字可能遮蔽全局绑定。
+enum ScopeFlags : int {
+	ScopeNone = 0,
+	ScopeDeclares = 1 << 0,
+	ScopeCaptures = 1 << 1,
+};
+
+int analyzeScope(const std::vector<StmtPtr>& stmts, std::vector<std::string>* boundNames = nullptr);
+int analyzeFunctionScope(const std::vector<Param>& params, const StmtPtr& body, std::vector<std::string>* boundNames = nullptr);
+
+} // namespace asul
+
+#endif // ASUL_SCOPE_ANALYSIS_H
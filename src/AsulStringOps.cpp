@@ -0,0 +1,286 @@
+#include "AsulStringOps.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ASUL_STROPS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace asul {
+namespace strops {
+
+namespace {
+
+inline bool isSpaceByte(unsigned char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+// ----------- Scalar -----------
+
+void caseMapScalar(const char* src, char* dst, size_t n, bool upper) {
+	const char lo = upper ? 'a' : 'A', hi = upper ? 'z' : 'Z';
+	for (size_t i = 0; i < n; ++i) {
+		char c = src[i];
+		dst[i] = (c >= lo && c <= hi) ? static_cast<char>(c ^ 0x20) : c;
+	}
+}
+
+size_t skipForwardScalar(const char* p, size_t from, size_t n) {
+	while (from < n && isSpaceByte(static_cast<unsigned char>(p[from]))) ++from;
+	return from;
+}
+
+size_t skipBackwardScalar(const char* p, size_t end) {
+	while (end > 0 && isSpaceByte(static_cast<unsigned char>(p[end - 1]))) --end;
+	return end;
+}
+
+size_t findScalar(const char* h, size_t n, const char* nd, size_t k, size_t from) {
+	return std::string_view(h, n).find(std::string_view(nd, k), from);
+}
+
+size_t findAny4Scalar(const char* p, size_t from, size_t n, const char* set) {
+	for (; from < n; ++from) {
+		char c = p[from];
+		if (c == set[0] || c == set[1] || c == set[2] || c == set[3]) return from;
+	}
+	return npos;
+}
+
+#ifdef ASUL_STROPS_X86
+
+// ----------- SSE2 -----------
+// 有符号字节比较：>= 0x80 的字节为负数，天然落在 ASCII 区间之外
+
+#ifdef __SSE2__
+inline __m128i spaceMask128(__m128i v) {
+	__m128i sp = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+	__m128i ctl = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('\t' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('\r' + 1)));
+	return _mm_or_si128(sp, ctl);
+}
+
+void caseMapSse2(const char* src, char* dst, size_t n, bool upper) {
+	const __m128i lo = _mm_set1_epi8(upper ? 'a' - 1 : 'A' - 1);
+	const __m128i hi = _mm_set1_epi8(upper ? 'z' + 1 : 'Z' + 1);
+	const __m128i flip = _mm_set1_epi8(0x20);
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i m = _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmplt_epi8(v, hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(v, _mm_and_si128(m, flip)));
+	}
+	caseMapScalar(src + i, dst + i, n - i, upper);
+}
+
+size_t skipForwardSse2(const char* p, size_t from, size_t n) {
+	for (; from + 16 <= n; from += 16) {
+		unsigned m = static_cast<unsigned>(_mm_movemask_epi8(spaceMask128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + from)))));
+		if (m != 0xFFFFu) return from + static_cast<size_t>(__builtin_ctz(~m & 0xFFFFu));
+	}
+	return skipForwardScalar(p, from, n);
+}
+
+size_t skipBackwardSse2(const char* p, size_t end) {
+	for (; end >= 16; end -= 16) {
+		unsigned m = static_cast<unsigned>(_mm_movemask_epi8(spaceMask128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + end - 16)))));
+		if (m != 0xFFFFu) return end - 16 + static_cast<size_t>(32 - __builtin_clz(~m & 0xFFFFu));
+	}
+	return skipBackwardScalar(p, end);
+}
+
+// 首尾字节同时匹配的位置才做完整比较 (k >= 2)
+size_t findSse2(const char* h, size_t n, const char* nd, size_t k, size_t from) {
+	const __m128i first = _mm_set1_epi8(nd[0]);
+	const __m128i last = _mm_set1_epi8(nd[k - 1]);
+	size_t i = from;
+	for (; i + k - 1 + 16 <= n; i += 16) {
+		__m128i bf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+		__m128i bl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + k - 1));
+		unsigned m = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, bf), _mm_cmpeq_epi8(last, bl))));
+		while (m) {
+			size_t bit = static_cast<size_t>(__builtin_ctz(m));
+			if (k == 2 || std::memcmp(h + i + bit + 1, nd + 1, k - 2) == 0) return i + bit;
+			m &= m - 1;
+		}
+	}
+	return findScalar(h, n, nd, k, i);
+}
+
+size_t findAny4Sse2(const char* p, size_t from, size_t n, const char* set) {
+	const __m128i a = _mm_set1_epi8(set[0]), b = _mm_set1_epi8(set[1]);
+	const __m128i c = _mm_set1_epi8(set[2]), d = _mm_set1_epi8(set[3]);
+	for (; from + 16 <= n; from += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + from));
+		__m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, a), _mm_cmpeq_epi8(v, b)), _mm_or_si128(_mm_cmpeq_epi8(v, c), _mm_cmpeq_epi8(v, d)));
+		unsigned m = static_cast<unsigned>(_mm_movemask_epi8(hit));
+		if (m) return from + static_cast<size_t>(__builtin_ctz(m));
+	}
+	return findAny4Scalar(p, from, n, set);
+}
+#endif // __SSE2__
+
+// ----------- AVX2 -----------
+
+__attribute__((target("avx2"))) inline __m256i spaceMask256(__m256i v) {
+	__m256i sp = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+	__m256i ctl = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('\t' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), v));
+	return _mm256_or_si256(sp, ctl);
+}
+
+__attribute__((target("avx2"))) void caseMapAvx2(const char* src, char* dst, size_t n, bool upper) {
+	const __m256i lo = _mm256_set1_epi8(upper ? 'a' - 1 : 'A' - 1);
+	const __m256i hi = _mm256_set1_epi8(upper ? 'z' + 1 : 'Z' + 1);
+	const __m256i flip = _mm256_set1_epi8(0x20);
+	size_t i = 0;
+	for (; i + 32 <= n; i += 32) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		__m256i m = _mm256_and_si256(_mm256_cmpgt_epi8(v, lo), _mm256_cmpgt_epi8(hi, v));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(v, _mm256_and_si256(m, flip)));
+	}
+	caseMapScalar(src + i, dst + i, n - i, upper);
+}
+
+__attribute__((target("avx2"))) size_t skipForwardAvx2(const char* p, size_t from, size_t n) {
+	for (; from + 32 <= n; from += 32) {
+		unsigned m = static_cast<unsigned>(_mm256_movemask_epi8(spaceMask256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + from)))));
+		if (m != 0xFFFFFFFFu) return from + static_cast<size_t>(__builtin_ctz(~m));
+	}
+	return skipForwardScalar(p, from, n);
+}
+
+__attribute__((target("avx2"))) size_t skipBackwardAvx2(const char* p, size_t end) {
+	for (; end >= 32; end -= 32) {
+		unsigned m = static_cast<unsigned>(_mm256_movemask_epi8(spaceMask256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + end - 32)))));
+		if (m != 0xFFFFFFFFu) return end - 32 + static_cast<size_t>(32 - __builtin_clz(~m));
+	}
+	return skipBackwardScalar(p, end);
+}
+
+__attribute__((target("avx2"))) size_t findAvx2(const char* h, size_t n, const char* nd, size_t k, size_t from) {
+	const __m256i first = _mm256_set1_epi8(nd[0]);
+	const __m256i last = _mm256_set1_epi8(nd[k - 1]);
+	size_t i = from;
+	for (; i + k - 1 + 32 <= n; i += 32) {
+		__m256i bf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+		__m256i bl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + k - 1));
+		unsigned m = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, bf), _mm256_cmpeq_epi8(last, bl))));
+		while (m) {
+			size_t bit = static_cast<size_t>(__builtin_ctz(m));
+			if (k == 2 || std::memcmp(h + i + bit + 1, nd + 1, k - 2) == 0) return i + bit;
+			m &= m - 1;
+		}
+	}
+	return findScalar(h, n, nd, k, i);
+}
+
+__attribute__((target("avx2"))) size_t findAny4Avx2(const char* p, size_t from, size_t n, const char* set) {
+	const __m256i a = _mm256_set1_epi8(set[0]), b = _mm256_set1_epi8(set[1]);
+	const __m256i c = _mm256_set1_epi8(set[2]), d = _mm256_set1_epi8(set[3]);
+	for (; from + 32 <= n; from += 32) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + from));
+		__m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, a), _mm256_cmpeq_epi8(v, b)), _mm256_or_si256(_mm256_cmpeq_epi8(v, c), _mm256_cmpeq_epi8(v, d)));
+		unsigned m = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+		if (m) return from + static_cast<size_t>(__builtin_ctz(m));
+	}
+	return findAny4Scalar(p, from, n, set);
+}
+
+#endif // ASUL_STROPS_X86
+
+// ----------- Dispatch -----------
+
+struct Impl {
+	const char* name;
+	void (*caseMap)(const char*, char*, size_t, bool);
+	size_t (*skipForward)(const char*, size_t, size_t);
+	size_t (*skipBackward)(const char*, size_t);
+	size_t (*findSub)(const char*, size_t, const char*, size_t, size_t); // needle 长度 >= 2
+	size_t (*findAny4)(const char*, size_t, size_t, const char*);
+};
+
+// 首次使用时按 CPU 能力选择；环境变量 ASUL_SIMD=scalar|sse2 可强制降级 (用于对比测试)
+const Impl& impl() {
+	static const Impl selected = [] {
+		const Impl scalar{ "scalar", caseMapScalar, skipForwardScalar, skipBackwardScalar, findScalar, findAny4Scalar };
+		const char* force = std::getenv("ASUL_SIMD");
+		std::string_view forced = force ? force : "";
+		if (forced == "scalar") return scalar;
+#ifdef ASUL_STROPS_X86
+		__builtin_cpu_init();
+		if (forced != "sse2" && __builtin_cpu_supports("avx2")) {
+			return Impl{ "avx2", caseMapAvx2, skipForwardAvx2, skipBackwardAvx2, findAvx2, findAny4Avx2 };
+		}
+#ifdef __SSE2__
+		return Impl{ "sse2", caseMapSse2, skipForwardSse2, skipBackwardSse2, findSse2, findAny4Sse2 };
+#endif
+#endif
+		return scalar;
+	}();
+	return selected;
+}
+
+} // namespace
+
+std::string toLowerAscii(std::string_view s) {
+	std::string out(s.size(), '\0');
+	if (!s.empty()) impl().caseMap(s.data(), &out[0], s.size(), false);
+	return out;
+}
+
+std::string toUpperAscii(std::string_view s) {
+	std::string out(s.size(), '\0');
+	if (!s.empty()) impl().caseMap(s.data(), &out[0], s.size(), true);
+	return out;
+}
+
+size_t skipSpaceForward(std::string_view s, size_t from) {
+	if (from >= s.size()) return s.size();
+	return impl().skipForward(s.data(), from, s.size());
+}
+
+size_t skipSpaceBackward(std::string_view s, size_t end) {
+	if (end > s.size()) end = s.size();
+	return impl().skipBackward(s.data(), end);
+}
+
+size_t findByte(std::string_view haystack, char c, size_t from) {
+	if (from >= haystack.size()) return npos;
+	// memchr 在主流 libc 中已是向量化实现
+	auto p = static_cast<const char*>(std::memchr(haystack.data() + from, c, haystack.size() - from));
+	return p ? static_cast<size_t>(p - haystack.data()) : npos;
+}
+
+size_t find(std::string_view haystack, std::string_view needle, size_t from) {
+	if (needle.empty()) return from <= haystack.size() ? from : npos;
+	if (from >= haystack.size() || needle.size() > haystack.size() - from) return npos;
+	if (needle.size() == 1) return findByte(haystack, needle[0], from);
+	return impl().findSub(haystack.data(), haystack.size(), needle.data(), needle.size(), from);
+}
+
+size_t findAnyOf4(std::string_view s, char a, char b, char c, char d, size_t from) {
+	if (from >= s.size()) return npos;
+	const char set[4] = { a, b, c, d };
+	return impl().findAny4(s.data(), from, s.size(), set);
+}
+
+std::string replaceAll(std::string_view s, std::string_view search, std::string_view replacement) {
+	if (search.empty()) return std::string(s);
+	size_t found = find(s, search, 0);
+	if (found == npos) return std::string(s);
+	std::string out;
+	out.reserve(replacement.size() > search.size() ? s.size() + (replacement.size() - search.size()) * 4 : s.size());
+	size_t pos = 0;
+	while (found != npos) {
+		out.append(s.data() + pos, found - pos);
+		out.append(replacement.data(), replacement.size());
+		pos = found + search.size();
+		found = find(s, search, pos);
+	}
+	out.append(s.data() + pos, s.size() - pos);
+	return out;
+}
+
+const char* simdLevel() { return impl().name; }
+
+} // namespace strops
+} // namespace asul
@@ -0,0 +1,58 @@
+#ifndef ASUL_STRING_OPS_H
+#define ASUL_STRING_OPS_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace asul {
+namespace strops {
+
+// ----------- String primitives -----------
+// 字符串内建方法使用的底层操作。x86 上按 CPU 能力在运行时选择 AVX2 / SSE2 实现，
+// 其他平台使用标量实现；所有实现的结果完全一致。
+// 空白字符与 C locale 的 isspace 相同：' ' \t \n \v \f \r；大小写映射只处理 ASCII。
+
+constexpr size_t npos = std::string_view::npos;
+
+std::string toLowerAscii(std::string_view s);
+std::string toUpperAscii(std::string_view s);
+
+// 跳过 [from, size) 开头的空白，返回第一个非空白字符的位置 (全是空白则返回 size)
+size_t skipSpaceForward(std::string_view s, size_t from = 0);
+// 去掉 [0, end) 末尾的空白，返回新的 end
+size_t skipSpaceBackward(std::string_view s, size_t end);
+
+// 从 from 开始查找 needle，找不到返回 npos；语义同 std::string_view::find
+size_t find(std::string_view haystack, std::string_view needle, size_t from = 0);
+size_t findByte(std::string_view haystack, char c, size_t from = 0);
+// 查找 [from, size) 中第一个等于 a/b/c/d 之一的字节，找不到返回 npos (CSV 字段的引号判断等)
+size_t findAnyOf4(std::string_view s, char a, char b, char c, char d, size_t from = 0);
+
+// 一次扫描完成全部替换；search 为空时原样返回
+std::string replaceAll(std::string_view s, std::string_view search, std::string_view replacement);
+
+// 当前使用的实现："avx2" / "sse2" / "scalar"
+const char* simdLevel();
+
+// 按 delim 切分，每个片段调用一次 emit(std::string_view)；delim 为空时逐字节切分
+template <typename Emit>
+void split(std::string_view s, std::string_view delim, Emit&& emit) {
+	if (delim.empty()) {
+		for (size_t i = 0; i < s.size(); ++i) emit(s.substr(i, 1));
+		return;
+	}
+	size_t pos = 0;
+	for (;;) {
+		size_t found = find(s, delim, pos);
+		if (found == npos) break;
+		emit(s.substr(pos, found - pos));
+		pos = found + delim.size();
+	}
+	emit(s.substr(pos));
+}
+
+} // namespace strops
+} // namespace asul
+
+#endif // ASUL_STRING_OPS_H
@@ -0,0 +1,66 @@
+#include "AsulWorkerPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace asul {
+
+static size_t defaultWorkerCount() {
+	if (const char* env = std::getenv("ASUL_WORKER_THREADS")) {
+		char* end = nullptr;
+		long n = std::strtol(env, &end, 10);
+		if (end != env && n > 0) return static_cast<size_t>(std::min(n, 256L));
+	}
+	size_t hw = std::thread::hardware_concurrency();
+	return std::clamp<size_t>(hw, 2, 16);
+}
+
+WorkerPool& WorkerPool::shared() {
+	// 故意不析构：进程退出时仍在运行的任务不应阻塞 exit
+	static WorkerPool* pool = new WorkerPool(defaultWorkerCount());
+	return *pool;
+}
+
+WorkerPool::WorkerPool(size_t threads) {
+	if (threads == 0) threads = 1;
+	workers.reserve(threads);
+	for (size_t i = 0; i < threads; ++i) workers.emplace_back([this]{ run(); });
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lk(mtx);
+		stopping = true;
+	}
+	cv.notify_all();
+	for (auto& t : workers) if (t.joinable()) t.join();
+}
+
+void WorkerPool::submit(std::function<void()> job) {
+	{
+		std::lock_guard<std::mutex> lk(mtx);
+		jobs.push_back(std::move(job));
+	}
+	cv.notify_one();
+}
+
+size_t WorkerPool::pending() const {
+	std::lock_guard<std::mutex> lk(mtx);
+	return jobs.size();
+}
+
+void WorkerPool::run() {
+	for (;;) {
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lk(mtx);
+			cv.wait(lk, [this]{ return stopping || !jobs.empty(); });
+			if (jobs.empty()) return; // stopping 且队列已清空
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+		job();
+	}
+}
+
+} // namespace asul
@@ -0,0 +1,44 @@
+#ifndef ASUL_WORKER_POOL_H
+#define ASUL_WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace asul {
+
+// ----------- Worker pool -----------
+// 固定线程数的后台工作池，用来执行不触碰解释器状态的纯本地计算 (offload / *Async 变体)。
+// 结果由提交者自行投递回事件循环；池本身不了解 Value / Promise。
+class WorkerPool {
+public:
+	// 进程共享的池：首次使用时才启动线程。线程数取环境变量 ASUL_WORKER_THREADS，
+	// 未设置时为 hardware_concurrency，限制在 [2, 16]。
+	static WorkerPool& shared();
+
+	explicit WorkerPool(size_t threads);
+	~WorkerPool();
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	void submit(std::function<void()> job);
+	size_t size() const { return workers.size(); }
+	size_t pending() const; // 排队中尚未开始的任务数
+
+private:
+	void run();
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> jobs;
+	mutable std::mutex mtx;
+	std::condition_variable cv;
+	bool stopping{false};
+};
+
+} // namespace asul
+
+#endif // ASUL_WORKER_POOL_H